@@ -0,0 +1,29 @@
+#include "lattice_life.h"
+
+namespace {
+    int countAlive(const int* neighborStates, int count) {
+        int alive = 0;
+        for (int i = 0; i < count; ++i) {
+            if (neighborStates[i] == 1) {
+                alive++;
+            }
+        }
+        return alive;
+    }
+}
+
+extern "C" LATTICE_LIFE_PLUGIN_API int hex_life(const int* neighborStates) {
+    int alive = countAlive(neighborStates, 6);
+    if (neighborStates[6] == 1) {
+        return (alive == 3 || alive == 4) ? 1 : 0;
+    }
+    return alive == 2 ? 1 : 0;
+}
+
+extern "C" LATTICE_LIFE_PLUGIN_API int triangle_life(const int* neighborStates) {
+    int alive = countAlive(neighborStates, 12);
+    if (neighborStates[12] == 1) {
+        return (alive >= 3 && alive <= 5) ? 1 : 0;
+    }
+    return alive == 4 ? 1 : 0;
+}
@@ -0,0 +1,33 @@
+#ifndef LATTICE_LIFE_PLUGIN_H
+#define LATTICE_LIFE_PLUGIN_H
+
+// Define the export macro for DLLs
+#ifdef _WIN32
+    #ifdef LATTICE_LIFE_PLUGIN_EXPORTS // This should be defined by the DLL project
+        #define LATTICE_LIFE_PLUGIN_API __declspec(dllexport)
+    #else
+        #define LATTICE_LIFE_PLUGIN_API __declspec(dllimport)
+    #endif
+#else // GCC/Clang on Linux/macOS
+    #define LATTICE_LIFE_PLUGIN_API __attribute__((visibility("default")))
+#endif
+
+/**
+ * @brief Life-like rule B2/S34 on the hexagonal lattice.
+ * States: 0 for dead, 1 for alive.
+ *
+ * @param neighborStates The 6 edge neighbors followed by the cell itself.
+ * @return The new state for the cell (0 or 1).
+ */
+extern "C" LATTICE_LIFE_PLUGIN_API int hex_life(const int* neighborStates);
+
+/**
+ * @brief Life-like rule B4/S345 on the triangular lattice.
+ * States: 0 for dead, 1 for alive.
+ *
+ * @param neighborStates The 12 neighbors sharing an edge or a vertex, followed by the cell itself.
+ * @return The new state for the cell (0 or 1).
+ */
+extern "C" LATTICE_LIFE_PLUGIN_API int triangle_life(const int* neighborStates);
+
+#endif // LATTICE_LIFE_PLUGIN_H
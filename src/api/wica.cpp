@@ -0,0 +1,281 @@
+#include "wica.h"
+
+#include "../core/rule.h"
+#include "../ca/cell_space.h"
+#include "../ca/rule_engine.h"
+#include "../ca/persistent_world.h"
+#include "../snap/snapshot.h"
+#include "../utils/logger.h"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <vector>
+
+static_assert(std::is_same_v<int, std::int32_t>, "Chunk states are exposed to C as int32_t");
+static_assert(PersistentWorld::CHUNK_SIZE == WICA_CHUNK_SIZE, "WICA_CHUNK_SIZE must match PersistentWorld");
+static_assert(EpochManager::MAX_READERS == WICA_MAX_VIEWS, "WICA_MAX_VIEWS must match EpochManager");
+
+struct WicaWorld {
+    Rule rule;
+    RuleEngine engine;
+    CellSpace cells;
+    PersistentWorld versions;         // Published on wica_view_acquire() for zero-copy readers
+    std::unordered_set<int> states;   // Allowed states, for validating wica_world_set_region()
+    std::uint64_t generation = 0;
+    mutable std::string lastError;    // Set by failing calls, including those taking a const world
+
+    WicaWorld() : cells(0, {}) {}
+};
+
+struct WicaView {
+    PersistentWorld::WorldView view;
+    std::vector<const PersistentWorld::Chunk*> chunks;
+};
+
+namespace {
+    thread_local std::string createError;
+    std::once_flag loggingOnce;
+
+    bool initializeLogging(const char* logPath, spdlog::level::level_enum level) {
+        bool initialized = false;
+        std::call_once(loggingOnce, [&]() {
+            Logger::initialize(logPath ? logPath : "wica.log", level);
+            initialized = true;
+        });
+        return initialized;
+    }
+
+    WicaStatus fail(const WicaWorld* world, WicaStatus status, const std::string& message) {
+        if (world) {
+            world->lastError = message;
+        } else {
+            createError = message;
+        }
+        return status;
+    }
+
+    bool regionArgumentsValid(std::int32_t x, std::int32_t y, std::int32_t width, std::int32_t height, const void* states) {
+        if (!states || width <= 0 || height <= 0) return false;
+        // The last cell must not overflow the coordinate range.
+        return static_cast<std::int64_t>(x) + width - 1 <= std::numeric_limits<std::int32_t>::max() &&
+               static_cast<std::int64_t>(y) + height - 1 <= std::numeric_limits<std::int32_t>::max();
+    }
+}
+
+extern "C" {
+
+int wica_api_version(void) {
+    return WICA_API_VERSION;
+}
+
+int wica_init_logging(const char* log_path, int verbose) {
+    return initializeLogging(log_path, verbose ? spdlog::level::debug : spdlog::level::warn) ? 1 : 0;
+}
+
+WicaStatus wica_world_create(const char* rule_json, WicaWorld** out_world) {
+    if (!out_world) return fail(nullptr, WICA_ERROR_INVALID_ARGUMENT, "out_world is NULL");
+    *out_world = nullptr;
+    if (!rule_json) return fail(nullptr, WICA_ERROR_INVALID_ARGUMENT, "rule_json is NULL");
+    try {
+        initializeLogging(nullptr, spdlog::level::warn);
+        auto world = std::make_unique<WicaWorld>();
+        if (!world->rule.loadFromJsonString(rule_json)) {
+            return fail(nullptr, WICA_ERROR_RULE, "Invalid rule JSON (details are in the WiCA log)");
+        }
+        if (world->rule.getDimensions() != 2 || world->rule.getRuleType() == Rule::RuleType::ReactionDiffusion) {
+            return fail(nullptr, WICA_ERROR_UNSUPPORTED, "Only 2D cell rules are available through the C API");
+        }
+        if (!world->engine.initialize(world->rule)) {
+            return fail(nullptr, WICA_ERROR_RULE, "Rule engine could not be initialized (plugin not found?)");
+        }
+        world->cells = CellSpace(world->rule.getDefaultState(), world->rule.getNeighborhood(), world->rule.getLattice());
+        world->cells.setJournaling(true);
+        world->states.insert(world->rule.getStates().begin(), world->rule.getStates().end());
+        *out_world = world.release();
+        return WICA_OK;
+    } catch (const std::exception& e) {
+        return fail(nullptr, WICA_ERROR_RULE, std::string("Failed to create world: ") + e.what());
+    }
+}
+
+void wica_world_destroy(WicaWorld* world) {
+    delete world;
+}
+
+const char* wica_last_error(const WicaWorld* world) {
+    return world ? world->lastError.c_str() : createError.c_str();
+}
+
+WicaStatus wica_world_step(WicaWorld* world, uint64_t generations) {
+    if (!world) return fail(nullptr, WICA_ERROR_INVALID_ARGUMENT, "world is NULL");
+    try {
+        for (uint64_t i = 0; i < generations; ++i) {
+            std::unordered_map<Point, int> changes = world->engine.calculateForUpdate(world->cells);
+            ++world->generation;
+            if (!changes.empty()) world->cells.updateCells(changes);
+        }
+        return WICA_OK;
+    } catch (const std::exception& e) {
+        return fail(world, WICA_ERROR_RULE, std::string("Step failed: ") + e.what());
+    }
+}
+
+uint64_t wica_world_generation(const WicaWorld* world) {
+    return world ? world->generation : 0;
+}
+
+uint64_t wica_world_population(const WicaWorld* world) {
+    return world ? world->cells.getNonDefaultCells().size() : 0;
+}
+
+int32_t wica_world_default_state(const WicaWorld* world) {
+    return world ? world->cells.getDefaultState() : 0;
+}
+
+int wica_world_bounds(const WicaWorld* world, int32_t* min_x, int32_t* min_y, int32_t* max_x, int32_t* max_y) {
+    if (!world || !world->cells.areBoundsInitialized() || world->cells.getNonDefaultCells().empty()) return 0;
+    Point minBounds = world->cells.getMinBounds();
+    Point maxBounds = world->cells.getMaxBounds();
+    if (min_x) *min_x = minBounds.x;
+    if (min_y) *min_y = minBounds.y;
+    if (max_x) *max_x = maxBounds.x;
+    if (max_y) *max_y = maxBounds.y;
+    return 1;
+}
+
+void wica_world_clear(WicaWorld* world) {
+    if (!world) return;
+    world->cells.clear();
+    world->generation = 0;
+}
+
+WicaStatus wica_world_get_region(const WicaWorld* world, int32_t x, int32_t y,
+                                 int32_t width, int32_t height, int32_t* states) {
+    if (!world) return fail(nullptr, WICA_ERROR_INVALID_ARGUMENT, "world is NULL");
+    if (!regionArgumentsValid(x, y, width, height, states)) {
+        return fail(world, WICA_ERROR_INVALID_ARGUMENT, "Invalid region");
+    }
+    const std::size_t area = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    const auto& cells = world->cells.getNonDefaultCells();
+    if (area <= cells.size()) {
+        // Small region: one lookup per cell.
+        for (int32_t row = 0; row < height; ++row) {
+            for (int32_t column = 0; column < width; ++column) {
+                states[static_cast<std::size_t>(row) * width + column] = world->cells.getCellState(Point(x + column, y + row));
+            }
+        }
+    } else {
+        // Large region: fill with the default state and scatter the live cells inside it.
+        std::fill(states, states + area, world->cells.getDefaultState());
+        for (const auto& pair : cells) {
+            std::int64_t column = static_cast<std::int64_t>(pair.first.x) - x;
+            std::int64_t row = static_cast<std::int64_t>(pair.first.y) - y;
+            if (column >= 0 && column < width && row >= 0 && row < height) {
+                states[static_cast<std::size_t>(row) * width + static_cast<std::size_t>(column)] = pair.second;
+            }
+        }
+    }
+    return WICA_OK;
+}
+
+WicaStatus wica_world_set_region(WicaWorld* world, int32_t x, int32_t y,
+                                 int32_t width, int32_t height, const int32_t* states) {
+    if (!world) return fail(nullptr, WICA_ERROR_INVALID_ARGUMENT, "world is NULL");
+    if (!regionArgumentsValid(x, y, width, height, states)) {
+        return fail(world, WICA_ERROR_INVALID_ARGUMENT, "Invalid region");
+    }
+    const std::size_t area = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    for (std::size_t i = 0; i < area; ++i) {
+        if (!world->states.count(states[i])) {
+            return fail(world, WICA_ERROR_OUT_OF_RANGE, "State " + std::to_string(states[i]) + " is not part of the rule");
+        }
+    }
+    try {
+        // Only cells that actually change go into the batch, so rewriting a mostly unchanged region is cheap.
+        std::unordered_map<Point, int> changes;
+        for (int32_t row = 0; row < height; ++row) {
+            for (int32_t column = 0; column < width; ++column) {
+                Point cell(x + column, y + row);
+                int state = states[static_cast<std::size_t>(row) * width + column];
+                if (world->cells.getCellState(cell) != state) changes[cell] = state;
+            }
+        }
+        if (!changes.empty()) world->cells.updateCells(changes);
+        return WICA_OK;
+    } catch (const std::exception& e) {
+        return fail(world, WICA_ERROR_INVALID_ARGUMENT, std::string("Region update failed: ") + e.what());
+    }
+}
+
+WicaStatus wica_world_save(const WicaWorld* world, const char* path, const char* rule_id) {
+    if (!world) return fail(nullptr, WICA_ERROR_INVALID_ARGUMENT, "world is NULL");
+    if (!path) return fail(world, WICA_ERROR_INVALID_ARGUMENT, "path is NULL");
+    SnapshotManager snapshots;
+    if (!snapshots.saveState(path, world->cells, rule_id ? rule_id : "", world->generation)) {
+        return fail(world, WICA_ERROR_IO, std::string("Failed to save snapshot ") + path);
+    }
+    return WICA_OK;
+}
+
+WicaStatus wica_world_load(WicaWorld* world, const char* path) {
+    if (!world) return fail(nullptr, WICA_ERROR_INVALID_ARGUMENT, "world is NULL");
+    if (!path) return fail(world, WICA_ERROR_INVALID_ARGUMENT, "path is NULL");
+    SnapshotManager snapshots;
+    SnapshotInfo info;
+    if (!snapshots.loadState(path, world->cells, &info)) {
+        return fail(world, WICA_ERROR_IO, std::string("Failed to load snapshot ") + path);
+    }
+    world->generation = info.generation;
+    return WICA_OK;
+}
+
+WicaStatus wica_view_acquire(WicaWorld* world, WicaView** out_view) {
+    if (!world) return fail(nullptr, WICA_ERROR_INVALID_ARGUMENT, "world is NULL");
+    if (!out_view) return fail(world, WICA_ERROR_INVALID_ARGUMENT, "out_view is NULL");
+    *out_view = nullptr;
+    try {
+        world->versions.publish(world->cells, world->generation);
+        auto view = std::make_unique<WicaView>();
+        view->view = world->versions.tryView();
+        if (!view->view.isValid()) {
+            return fail(world, WICA_ERROR_LIMIT, "all " + std::to_string(WICA_MAX_VIEWS) + " views of this world are held; release one first");
+        }
+        view->chunks.reserve(view->view.getVersion().chunkCount);
+        view->view.forEachChunk([&](const PersistentWorld::Chunk& chunk) { view->chunks.push_back(&chunk); });
+        *out_view = view.release();
+        return WICA_OK;
+    } catch (const std::exception& e) {
+        return fail(world, WICA_ERROR_INVALID_ARGUMENT, std::string("Failed to acquire view: ") + e.what());
+    }
+}
+
+void wica_view_release(WicaView* view) {
+    delete view;
+}
+
+uint64_t wica_view_generation(const WicaView* view) {
+    return view && view->view.isValid() ? view->view.getVersion().generation : 0;
+}
+
+size_t wica_view_chunk_count(const WicaView* view) {
+    return view ? view->chunks.size() : 0;
+}
+
+WicaStatus wica_view_get_chunk(const WicaView* view, size_t index, WicaChunk* chunk) {
+    if (!view || !chunk) return WICA_ERROR_INVALID_ARGUMENT;
+    if (index >= view->chunks.size()) return WICA_ERROR_OUT_OF_RANGE;
+    const PersistentWorld::Chunk* source = view->chunks[index];
+    chunk->chunk_x = source->chunkX;
+    chunk->chunk_y = source->chunkY;
+    chunk->population = source->population;
+    chunk->states = source->states;
+    return WICA_OK;
+}
+
+} // extern "C"
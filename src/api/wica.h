@@ -0,0 +1,159 @@
+#ifndef WICA_H
+#define WICA_H
+
+/**
+ * @file wica.h
+ * @brief C API of libwica: runs WiCA worlds in-process from other languages.
+ *
+ * Every function works on its own WicaWorld, so different worlds can be created, stepped and
+ * read from different threads at the same time. A single world must not be used from two
+ * threads at once, with one exception: WicaView objects may be read on any thread while the
+ * owning thread keeps stepping the world.
+ *
+ * Only 2D cell rules (plugin and Generations rules) are supported; 3D and reaction-diffusion
+ * rules are rejected by wica_world_create().
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+    #if defined(WICA_BUILD_LIBRARY)
+        #define WICA_API __declspec(dllexport)
+    #else
+        #define WICA_API __declspec(dllimport)
+    #endif
+#else
+    #define WICA_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Incremented whenever a function or struct of this header changes incompatibly. */
+#define WICA_API_VERSION 1
+
+/** @brief Edge length of the chunks returned by wica_view_get_chunk(). */
+#define WICA_CHUNK_SIZE 32
+
+/** @brief Views that can be held on one world at the same time. */
+#define WICA_MAX_VIEWS 64
+
+typedef enum WicaStatus {
+    WICA_OK = 0,
+    WICA_ERROR_INVALID_ARGUMENT = 1,
+    WICA_ERROR_RULE = 2,          /* Rule JSON could not be parsed or its engine not loaded */
+    WICA_ERROR_UNSUPPORTED = 3,   /* Rule kind not available through the C API */
+    WICA_ERROR_IO = 4,            /* Snapshot could not be written or read */
+    WICA_ERROR_OUT_OF_RANGE = 5,
+    WICA_ERROR_LIMIT = 6          /* All WICA_MAX_VIEWS views of a world are held */
+} WicaStatus;
+
+typedef struct WicaWorld WicaWorld;
+typedef struct WicaView WicaView;
+
+/**
+ * @brief Read-only chunk of a view. states points into the view's storage (no copy) and stays
+ * valid until the view is released.
+ */
+typedef struct WicaChunk {
+    int32_t chunk_x;              /* Chunk coordinates; the chunk covers cells chunk_x * 32 .. chunk_x * 32 + 31 */
+    int32_t chunk_y;
+    uint32_t population;          /* Cells not in the default state */
+    const int32_t* states;        /* WICA_CHUNK_SIZE * WICA_CHUNK_SIZE states, row-major */
+} WicaChunk;
+
+/** @brief Returns WICA_API_VERSION of the library, to detect a header/library mismatch. */
+WICA_API int wica_api_version(void);
+
+/**
+ * @brief Sends the library's log to log_path (console and file, like the WiCA application).
+ * Only the first call has an effect; without it the first wica_world_create() logs warnings
+ * and errors to "wica.log" in the working directory.
+ * @param verbose Nonzero to also log info and debug messages.
+ * @return 1 if this call configured logging, 0 if it was already configured.
+ */
+WICA_API int wica_init_logging(const char* log_path, int verbose);
+
+/**
+ * @brief Creates an empty world running the rule given as JSON text (the rule file format).
+ * Plugin paths in the rule are resolved relative to the working directory.
+ * @param out_world Receives the world; set to NULL on failure.
+ */
+WICA_API WicaStatus wica_world_create(const char* rule_json, WicaWorld** out_world);
+
+/** @brief Destroys a world. Views of it must be released first. NULL is ignored. */
+WICA_API void wica_world_destroy(WicaWorld* world);
+
+/**
+ * @brief Message describing the last failed call on world, or on this thread's last failed
+ * wica_world_create() when world is NULL. Valid until the next call on the same world or thread.
+ */
+WICA_API const char* wica_last_error(const WicaWorld* world);
+
+/** @brief Advances the world by generations steps. */
+WICA_API WicaStatus wica_world_step(WicaWorld* world, uint64_t generations);
+
+WICA_API uint64_t wica_world_generation(const WicaWorld* world);
+WICA_API uint64_t wica_world_population(const WicaWorld* world);
+WICA_API int32_t wica_world_default_state(const WicaWorld* world);
+
+/**
+ * @brief Bounding box of the non-default cells.
+ * @return 0 if the world is empty (the outputs are then left unchanged), 1 otherwise.
+ */
+WICA_API int wica_world_bounds(const WicaWorld* world, int32_t* min_x, int32_t* min_y, int32_t* max_x, int32_t* max_y);
+
+/** @brief Resets every cell to the default state and the generation counter to 0. */
+WICA_API void wica_world_clear(WicaWorld* world);
+
+/**
+ * @brief Copies the width x height region with top-left cell (x, y) into states (row-major,
+ * width * height values).
+ */
+WICA_API WicaStatus wica_world_get_region(const WicaWorld* world, int32_t x, int32_t y,
+                                          int32_t width, int32_t height, int32_t* states);
+
+/**
+ * @brief Overwrites the width x height region with top-left cell (x, y) from states (row-major).
+ * Every value must be one of the rule's states.
+ */
+WICA_API WicaStatus wica_world_set_region(WicaWorld* world, int32_t x, int32_t y,
+                                          int32_t width, int32_t height, const int32_t* states);
+
+/**
+ * @brief Saves the world in WiCA's snapshot format (".snapshot" is appended if missing).
+ * @param rule_id Rule name stored in the header; may be NULL.
+ */
+WICA_API WicaStatus wica_world_save(const WicaWorld* world, const char* path, const char* rule_id);
+
+/** @brief Replaces the world's cells and generation with a snapshot. */
+WICA_API WicaStatus wica_world_load(WicaWorld* world, const char* path);
+
+/**
+ * @brief Pins the current generation for zero-copy reading. Unchanged chunks are shared
+ * with the world's storage, so acquiring a view costs time proportional to the chunks changed
+ * since the previous view, not to the world size. The view stays valid and unchanged while
+ * the world keeps stepping. At most WICA_MAX_VIEWS views of one world can be held at once;
+ * beyond that WICA_ERROR_LIMIT is returned until a view is released.
+ */
+WICA_API WicaStatus wica_view_acquire(WicaWorld* world, WicaView** out_view);
+
+/** @brief Releases a view; its chunk pointers become invalid. NULL is ignored. */
+WICA_API void wica_view_release(WicaView* view);
+
+WICA_API uint64_t wica_view_generation(const WicaView* view);
+WICA_API size_t wica_view_chunk_count(const WicaView* view);
+
+/**
+ * @brief Fills chunk with the index-th chunk of the view (0 <= index < wica_view_chunk_count()).
+ * Chunks are in no particular order.
+ */
+WICA_API WicaStatus wica_view_get_chunk(const WicaView* view, size_t index, WicaChunk* chunk);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* WICA_H */
@@ -4,15 +4,90 @@
 #include "../utils/logger.h" // New logger
 #include <set>
 #include "../utils/timer.h"
+#include "../utils/metrics.h"
+
+namespace {
+    constexpr std::uint64_t SHAPE_HASH_MOD = (1ULL << 61) - 1;
+    constexpr std::uint64_t SHAPE_HASH_BASE_X = 0x1F3D5B79A2C4E6F1ULL % SHAPE_HASH_MOD;
+    constexpr std::uint64_t SHAPE_HASH_BASE_Y = 0x0B1D2F3A4C5E6D7FULL % SHAPE_HASH_MOD;
+
+    std::uint64_t splitMix64(std::uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    std::uint64_t zobristKey(Point coordinates, int state) {
+        std::uint64_t packed = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(coordinates.x)) << 32) |
+                               static_cast<std::uint32_t>(coordinates.y);
+        return splitMix64(packed ^ splitMix64(static_cast<std::uint32_t>(state)));
+    }
+
+    std::uint64_t powMod(std::uint64_t base, std::uint64_t exponent) {
+        std::uint64_t result = 1;
+        while (exponent > 0) {
+            if (exponent & 1) result = CellSpace::mulModShapeHash(result, base);
+            base = CellSpace::mulModShapeHash(base, base);
+            exponent >>= 1;
+        }
+        return result;
+    }
+
+    // base^e for a 32-bit exponent as the product of four byte-indexed tables (32 KB for all four).
+    struct PowerTable {
+        std::uint64_t bytes[4][256];
+
+        explicit PowerTable(std::uint64_t base) {
+            std::uint64_t step = base; // base^(256^k)
+            for (int k = 0; k < 4; ++k) {
+                bytes[k][0] = 1;
+                for (int i = 1; i < 256; ++i) {
+                    bytes[k][i] = CellSpace::mulModShapeHash(bytes[k][i - 1], step);
+                }
+                step = CellSpace::mulModShapeHash(bytes[k][255], step);
+            }
+        }
+
+        std::uint64_t pow(std::uint32_t e) const {
+            return CellSpace::mulModShapeHash(
+                CellSpace::mulModShapeHash(bytes[0][e & 0xFF], bytes[1][(e >> 8) & 0xFF]),
+                CellSpace::mulModShapeHash(bytes[2][(e >> 16) & 0xFF], bytes[3][e >> 24]));
+        }
+    };
+
+    // axis 0 = x, 1 = y; negative exponents use the modular inverse of the base.
+    std::uint64_t axisPower(int axis, std::int64_t exponent) {
+        static const PowerTable tables[4] = {
+            PowerTable(SHAPE_HASH_BASE_X), PowerTable(powMod(SHAPE_HASH_BASE_X, SHAPE_HASH_MOD - 2)),
+            PowerTable(SHAPE_HASH_BASE_Y), PowerTable(powMod(SHAPE_HASH_BASE_Y, SHAPE_HASH_MOD - 2))
+        };
+        if (exponent >= 0) {
+            return tables[axis * 2].pow(static_cast<std::uint32_t>(exponent));
+        }
+        return tables[axis * 2 + 1].pow(static_cast<std::uint32_t>(-exponent));
+    }
+
+    std::uint64_t stateWeight(int state) {
+        return splitMix64(static_cast<std::uint32_t>(state) ^ 0x5EEDULL) % (SHAPE_HASH_MOD - 1) + 1;
+    }
+}
 
 /**
  * @brief Constructor for CellSpace.
  * @param defaultState The default state for cells in the grid.
  */
-CellSpace::CellSpace(int defState, std::vector<Point> neighborhood)
+CellSpace::CellSpace(int defState, std::vector<Point> neighborhood, Lattice lattice)
     : defaultState_(defState),
     boundsInitialized_(false),
-    neighborhood_(neighborhood) {
+    neighborhood_(neighborhood),
+    lattice_(lattice),
+    hash_(0),
+    shapeHash_(0),
+    coordinateSumX_(0),
+    coordinateSumY_(0),
+    journaling_(false),
+    journalReset_(true) {
 
     auto logger = Logger::getLogger(Logger::Module::CellSpace);
     if (logger) logger->info("Start to initialize cellspace.");
@@ -20,9 +95,17 @@ CellSpace::CellSpace(int defState, std::vector<Point> neighborhood)
     minGridBounds_ = Point(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
     maxGridBounds_ = Point(std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
 
-    std::set<Point> generalNeighborhoodSet;
-    for (Point cell : neighborhood) {
+    // On hex and triangle lattices the offsets depend on the cell's parity; cover all of them.
+    std::set<Point> parityNeighborhood;
+    for (int parity = 0; parity < 2; ++parity) {
         for (Point offset : neighborhood) {
+            parityNeighborhood.insert(latticeNeighborOffset(lattice_, offset, parity));
+        }
+    }
+    std::set<Point> generalNeighborhoodSet;
+    for (Point cell : parityNeighborhood) {
+        generalNeighborhoodSet.insert(Point(0, 0) - cell);
+        for (Point offset : parityNeighborhood) {
             generalNeighborhoodSet.insert(cell + offset);
         }
     }
@@ -32,6 +115,59 @@ CellSpace::CellSpace(int defState, std::vector<Point> neighborhood)
 
 }
 
+/**
+ * @brief Adds or removes one non-default cell's contribution to the state counts and world signature.
+ */
+void CellSpace::trackCell(Point coordinates, int state, bool adding) {
+    hash_ ^= zobristKey(coordinates, state);
+    std::uint64_t term = mulModShapeHash(mulModShapeHash(stateWeight(state), axisPower(0, coordinates.x)),
+                                         axisPower(1, coordinates.y));
+    if (adding) {
+        ++stateCounts_[state];
+        shapeHash_ += term;
+        if (shapeHash_ >= SHAPE_HASH_MOD) shapeHash_ -= SHAPE_HASH_MOD;
+        coordinateSumX_ += coordinates.x;
+        coordinateSumY_ += coordinates.y;
+    } else {
+        auto it = stateCounts_.find(state);
+        if (it != stateCounts_.end() && --it->second == 0) stateCounts_.erase(it);
+        shapeHash_ += SHAPE_HASH_MOD - term;
+        if (shapeHash_ >= SHAPE_HASH_MOD) shapeHash_ -= SHAPE_HASH_MOD;
+        coordinateSumX_ -= coordinates.x;
+        coordinateSumY_ -= coordinates.y;
+    }
+}
+
+void CellSpace::journalChange(Point coordinates, int state) {
+    if (!journaling_ || journalReset_) return;
+    // Past a few entries per live cell, rebuilding is cheaper than replaying.
+    if (journal_.size() >= 4 * nonDefaultCells_.size() + 65536) {
+        resetJournal();
+        return;
+    }
+    journal_.emplace_back(coordinates, state);
+}
+
+void CellSpace::resetJournal() {
+    journal_.clear();
+    journal_.shrink_to_fit();
+    journalReset_ = true;
+}
+
+/**
+ * @brief Recomputes the state counts and world signature from all non-default cells.
+ */
+void CellSpace::rebuildTracking() {
+    stateCounts_.clear();
+    hash_ = 0;
+    shapeHash_ = 0;
+    coordinateSumX_ = 0;
+    coordinateSumY_ = 0;
+    for (const auto& pair : nonDefaultCells_) {
+        trackCell(pair.first, pair.second, true);
+    }
+}
+
 /**
  * @brief Updates the minimum and maximum grid bounds.
  * @param coordinates The coordinates of the cell that might expand the bounds.
@@ -95,6 +231,9 @@ void CellSpace::setCellState(Point coordinates, int state) {
         for(Point offset : reverseNeighborhood_){
             cellsToEvaluate_.insert(coordinates+offset);
         }
+        if (currentState != defaultState_) trackCell(coordinates, currentState, false);
+        if (state != defaultState_) trackCell(coordinates, state, true);
+        journalChange(coordinates, state);
     }
     if (state == defaultState_) {
         if (currentState != defaultState_) {
@@ -121,11 +260,21 @@ void CellSpace::setCellState(Point coordinates, int state) {
  * @return Vector of neighbor states.
  */
 std::vector<int> CellSpace::getNeighborStates(Point centerCoordinates) const {
+    switch (lattice_) {
+        case Lattice::Hex: return collectNeighborStates<Lattice::Hex>(centerCoordinates);
+        case Lattice::Triangle: return collectNeighborStates<Lattice::Triangle>(centerCoordinates);
+        default: return collectNeighborStates<Lattice::Square>(centerCoordinates);
+    }
+}
+
+template <Lattice L>
+std::vector<int> CellSpace::collectNeighborStates(Point centerCoordinates) const {
     std::vector<int> neighborStates;
     neighborStates.reserve(neighborhood_.size());
 
+    const int parity = LatticeKernel<L>::parity(centerCoordinates);
     for (const Point& offset : neighborhood_) {
-        neighborStates.push_back(getCellState(centerCoordinates + offset));
+        neighborStates.push_back(getCellState(centerCoordinates + LatticeKernel<L>::neighborOffset(offset, parity)));
     }
     return neighborStates;
 }
@@ -139,6 +288,7 @@ std::vector<int> CellSpace::getNeighborStates(Point centerCoordinates) const {
 void CellSpace::updateCells(const std::unordered_map<Point, int>& cellsToUpdate) {
     auto logger = Logger::getLogger(Logger::Module::CellSpace);
     auto timer = Timer::getTimer(Timer::Module::applyUpdate);
+    Metrics::ScopedObservation applyObservation(Metrics::Histogram::ApplySeconds);
     timer.start();
     if (logger) logger->debug("Received cells to update. Start to apply update.");
 
@@ -164,6 +314,10 @@ void CellSpace::updateCells(const std::unordered_map<Point, int>& cellsToUpdate)
     } else if (boundaryPotentiallyAffected) {
 
     }
+    Metrics::increment(Metrics::Counter::CellsChanged, cellsToUpdate.size());
+    Metrics::setGauge(Metrics::Gauge::Population, static_cast<double>(nonDefaultCells_.size()));
+    Metrics::setGauge(Metrics::Gauge::ActiveCells, static_cast<double>(cellsToEvaluate_.size()));
+    timer.setItemCount(cellsToUpdate.size());
     timer.stop();
     return;
 }
@@ -182,6 +336,7 @@ void CellSpace::loadCells(const std::unordered_map<Point, int>& cells, Point min
     if (logger) logger->info("Received cells to load. Start to load cells.");
 
     nonDefaultCells_ = cells;
+    resetJournal();
     if (nonDefaultCells_.empty()) {
         boundsInitialized_ = false;
         minGridBounds_ = Point(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
@@ -198,6 +353,7 @@ void CellSpace::loadCells(const std::unordered_map<Point, int>& cells, Point min
             cellsToEvaluate_.insert(offset+pair.first);
         }
     }
+    rebuildTracking();
 
     if (logger) logger->info("Cells loaded.");
 
@@ -221,12 +377,37 @@ bool CellSpace::areBoundsInitialized() const {
     return boundsInitialized_;
 }
 
+void CellSpace::mergeCells(const std::unordered_map<Point, int>& cells) {
+    nonDefaultCells_.reserve(nonDefaultCells_.size() + cells.size());
+    for (const auto& pair : cells) {
+        if (pair.second == defaultState_) continue;
+        auto it = nonDefaultCells_.find(pair.first);
+        if (it != nonDefaultCells_.end()) {
+            if (it->second == pair.second) continue;
+            trackCell(pair.first, it->second, false);
+        }
+        trackCell(pair.first, pair.second, true);
+        journalChange(pair.first, pair.second);
+        nonDefaultCells_[pair.first] = pair.second;
+        updateBounds(pair.first);
+        for (Point offset : reverseNeighborhood_) {
+            cellsToEvaluate_.insert(pair.first + offset);
+        }
+    }
+}
+
 void CellSpace::clear() {
     auto logger = Logger::getLogger(Logger::Module::CellSpace);
     if (logger) logger->info("Start to clear the cellspace.");
 
     nonDefaultCells_.clear();
     cellsToEvaluate_.clear();
+    resetJournal();
+    stateCounts_.clear();
+    hash_ = 0;
+    shapeHash_ = 0;
+    coordinateSumX_ = 0;
+    coordinateSumY_ = 0;
     boundsInitialized_ = false;
     minGridBounds_ = Point(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
     maxGridBounds_ = Point(std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
@@ -242,3 +423,66 @@ void CellSpace::clearCellsToEvaluate() {
 int CellSpace::getDefaultState() const {
     return defaultState_;
 }
+
+Lattice CellSpace::getLattice() const {
+    return lattice_;
+}
+
+void CellSpace::setJournaling(bool enabled) {
+    journaling_ = enabled;
+    resetJournal();
+}
+
+std::vector<std::pair<Point, int>> CellSpace::takeJournal(bool& reset) {
+    reset = journalReset_ || !journaling_;
+    journalReset_ = false;
+    std::vector<std::pair<Point, int>> changes;
+    changes.swap(journal_);
+    return changes;
+}
+
+std::uint64_t CellSpace::getHash() const {
+    return hash_;
+}
+
+const std::unordered_map<int, std::size_t>& CellSpace::getStateCounts() const {
+    return stateCounts_;
+}
+
+std::size_t CellSpace::getStateCount(int state) const {
+    auto it = stateCounts_.find(state);
+    return it != stateCounts_.end() ? it->second : 0;
+}
+
+std::uint64_t CellSpace::getShapeHash() const {
+    return shapeHash_;
+}
+
+std::int64_t CellSpace::getCoordinateSumX() const {
+    return coordinateSumX_;
+}
+
+std::int64_t CellSpace::getCoordinateSumY() const {
+    return coordinateSumY_;
+}
+
+std::uint64_t CellSpace::cellHashKey(Point coordinates, int state) {
+    return zobristKey(coordinates, state);
+}
+
+std::uint64_t CellSpace::translationFactor(std::int64_t dx, std::int64_t dy) {
+    return mulModShapeHash(axisPower(0, dx), axisPower(1, dy));
+}
+
+std::uint64_t CellSpace::mulModShapeHash(std::uint64_t a, std::uint64_t b) {
+    // Portable 61-bit modular multiply: split into 32-bit halves and fold using 2^61 == 1.
+    std::uint64_t aHi = a >> 32, aLo = a & 0xFFFFFFFFULL;
+    std::uint64_t bHi = b >> 32, bLo = b & 0xFFFFFFFFULL;
+    std::uint64_t hi = aHi * bHi;                 // weight 2^64 == 2^3
+    std::uint64_t mid = aLo * bHi + aHi * bLo;    // weight 2^32
+    std::uint64_t lo = aLo * bLo;
+    std::uint64_t r = (hi << 3) + (mid >> 29) + ((mid & ((1ULL << 29) - 1)) << 32) + (lo >> 61) + (lo & SHAPE_HASH_MOD);
+    r = (r & SHAPE_HASH_MOD) + (r >> 61);
+    if (r >= SHAPE_HASH_MOD) r -= SHAPE_HASH_MOD;
+    return r;
+}
@@ -1,10 +1,12 @@
 #ifndef CELL_SPACE_H
 #define CELL_SPACE_H
 
+#include <cstdint>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include "../utils/point.h"
+#include "../utils/lattice.h"
 #include <limits>
 /**
  * @class CellSpace
@@ -21,15 +23,38 @@ private:
 
     std::vector<Point> neighborhood_;
     std::vector<Point> reverseNeighborhood_;
+    Lattice lattice_;
 
     Point minGridBounds_;
     Point maxGridBounds_;
 
+    // Per-state counts and world signature, kept current in O(1) per change
+    std::uint64_t hash_;
+    std::uint64_t shapeHash_;
+    std::int64_t coordinateSumX_;
+    std::int64_t coordinateSumY_;
+    std::unordered_map<int, std::size_t> stateCounts_; // Non-default cells per state
+
+    // Cells changed since the last takeJournal(), for PersistentWorld::publish()
+    bool journaling_;
+    bool journalReset_;
+    std::vector<std::pair<Point, int>> journal_;
+
+    void trackCell(Point coordinates, int state, bool adding);
+    void journalChange(Point coordinates, int state);
+    void resetJournal();
+    void rebuildTracking();
     void updateBounds(Point coordinates);
     void recalculateBounds();
+    template <Lattice L>
+    std::vector<int> collectNeighborStates(Point centerCoordinates) const;
 
 public:
-    CellSpace(int defaultState, std::vector<Point> neighborhood);
+    /**
+     * @param neighborhood Neighbor offsets; on hex and triangle lattices they are given for
+     * parity-0 cells and adapted per cell by LatticeKernel.
+     */
+    CellSpace(int defaultState, std::vector<Point> neighborhood, Lattice lattice = Lattice::Square);
 
     int getCellState(Point coordinates) const;
     void setCellState(Point coordinates, int state);
@@ -46,6 +71,11 @@ public:
     const std::unordered_map<Point, int>& getNonDefaultCells() const;
     const std::unordered_set<Point>& getCellsToEvaluate() const;
     void loadCells(const std::unordered_map<Point, int>& cells, Point minBounds, Point maxBounds);
+    /**
+     * @brief Adds cells to the current contents without clearing them (e.g. streamed snapshot chunks).
+     * Bounds grow to include the new cells and the cells' neighborhoods are queued for evaluation.
+     */
+    void mergeCells(const std::unordered_map<Point, int>& cells);
 
     Point getMinBounds() const;
     Point getMaxBounds() const;
@@ -54,6 +84,45 @@ public:
     void clear();
     void clearCellsToEvaluate();
     int getDefaultState() const;
+    Lattice getLattice() const;
+
+    /**
+     * @brief Starts or stops recording changed cells for takeJournal(). Off by default.
+     */
+    void setJournaling(bool enabled);
+    /**
+     * @brief Returns the cells changed since the previous call, in order (later entries win).
+     * @param reset Set if the world was replaced (load, clear, or a journal too long to be
+     * worth replaying) since the previous call; the caller must then rebuild from getNonDefaultCells().
+     */
+    std::vector<std::pair<Point, int>> takeJournal(bool& reset);
+
+    /**
+     * @brief Zobrist hash of all non-default cells (XOR of per-cell keys).
+     * Independent of insertion order, so equal worlds hash equally across engines and thread counts.
+     */
+    std::uint64_t getHash() const;
+    /**
+     * @brief Number of cells per non-default state, maintained in O(1) per change.
+     */
+    const std::unordered_map<int, std::size_t>& getStateCounts() const;
+    std::size_t getStateCount(int state) const;
+    /**
+     * @brief Polynomial hash sum(w(state) * A^x * B^y) mod 2^61-1.
+     * Translating the world by (dx, dy) multiplies it by translationFactor(dx, dy).
+     */
+    std::uint64_t getShapeHash() const;
+    std::int64_t getCoordinateSumX() const;
+    std::int64_t getCoordinateSumY() const;
+    /**
+     * @brief Factor relating the shape hashes of a world and its copy translated by (dx, dy).
+     */
+    static std::uint64_t translationFactor(std::int64_t dx, std::int64_t dy);
+    /**
+     * @brief Zobrist key of one non-default cell; getHash() is the XOR of these over the world.
+     */
+    static std::uint64_t cellHashKey(Point coordinates, int state);
+    static std::uint64_t mulModShapeHash(std::uint64_t a, std::uint64_t b);
 };
 
 #endif // CELL_SPACE_H
@@ -0,0 +1,86 @@
+#include "cycle_detector.h"
+#include "cell_space.h"
+#include "../utils/logger.h"
+
+CycleDetector::CycleDetector(std::size_t historySize)
+    : history_(historySize > 0 ? historySize : 1),
+      next_(0),
+      count_(0),
+      action_(Action::Off),
+      translationAware_(false),
+      inCycle_(false) {
+}
+
+void CycleDetector::setAction(Action action) {
+    action_ = action;
+    reset();
+}
+
+CycleDetector::Action CycleDetector::getAction() const {
+    return action_;
+}
+
+void CycleDetector::setTranslationAware(bool enabled) {
+    translationAware_ = enabled;
+    reset();
+}
+
+bool CycleDetector::isTranslationAware() const {
+    return translationAware_;
+}
+
+void CycleDetector::reset() {
+    next_ = 0;
+    count_ = 0;
+    inCycle_ = false;
+}
+
+CycleDetector::Detection CycleDetector::observe(std::uint64_t generation, const CellSpace& cellSpace) {
+    Detection detection;
+    if (action_ == Action::Off) return detection;
+
+    Sample current{generation, cellSpace.getHash(), cellSpace.getShapeHash(),
+                   cellSpace.getCoordinateSumX(), cellSpace.getCoordinateSumY(),
+                   cellSpace.getNonDefaultCells().size()};
+
+    // Newest first, so the smallest period wins.
+    for (std::size_t age = 1; age <= count_; ++age) {
+        const Sample& past = history_[(next_ + history_.size() - age) % history_.size()];
+        if (past.population != current.population || past.generation >= current.generation) continue;
+
+        if (past.hash == current.hash) {
+            detection.found = true;
+            detection.period = current.generation - past.generation;
+            break;
+        }
+        if (!translationAware_ || current.population == 0) continue;
+
+        // A translated copy has its coordinate sums shifted by population * displacement.
+        std::int64_t population = static_cast<std::int64_t>(current.population);
+        std::int64_t deltaX = current.sumX - past.sumX;
+        std::int64_t deltaY = current.sumY - past.sumY;
+        if (deltaX % population != 0 || deltaY % population != 0) continue;
+        std::int64_t dx = deltaX / population;
+        std::int64_t dy = deltaY / population;
+        if (CellSpace::mulModShapeHash(past.shapeHash, CellSpace::translationFactor(dx, dy)) == current.shapeHash) {
+            detection.found = true;
+            detection.period = current.generation - past.generation;
+            detection.dx = dx;
+            detection.dy = dy;
+            break;
+        }
+    }
+
+    history_[next_] = current;
+    next_ = (next_ + 1) % history_.size();
+    if (count_ < history_.size()) ++count_;
+
+    detection.isNew = detection.found && !inCycle_;
+    inCycle_ = detection.found;
+    if (detection.isNew) {
+        auto logger = Logger::getLogger(Logger::Module::Core);
+        if (logger) logger->info("Cycle detected at generation {}: period {}, displacement ({}, {}).",
+                                 generation, detection.period, detection.dx, detection.dy);
+    }
+    return detection;
+}
@@ -0,0 +1,72 @@
+#ifndef CYCLE_DETECTOR_H
+#define CYCLE_DETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class CellSpace;
+
+/**
+ * @class CycleDetector
+ * @brief Detects global cycles from a ring of recent world signatures.
+ *
+ * Each generation the world hash is compared with the last historySize generations. A
+ * repeat with period P means the world is periodic; with translation detection enabled,
+ * a world that reappears shifted (a spaceship or a field of them) is also reported. The
+ * displacement is recovered from the change of the coordinate sums and confirmed with the
+ * shape hash, so each comparison is O(1).
+ */
+class CycleDetector {
+public:
+    enum class Action {
+        Off,
+        Notify,
+        Pause
+    };
+
+    struct Detection {
+        bool found = false;         // The current world repeats an earlier one
+        bool isNew = false;         // First generation of this cycle (not yet reported)
+        std::uint64_t period = 0;
+        std::int64_t dx = 0;        // Displacement per period; 0,0 for a stationary cycle
+        std::int64_t dy = 0;
+    };
+
+private:
+    struct Sample {
+        std::uint64_t generation;
+        std::uint64_t hash;
+        std::uint64_t shapeHash;
+        std::int64_t sumX;
+        std::int64_t sumY;
+        std::size_t population;
+    };
+
+    std::vector<Sample> history_;   // Ring buffer
+    std::size_t next_;
+    std::size_t count_;
+    Action action_;
+    bool translationAware_;
+    bool inCycle_;
+
+public:
+    explicit CycleDetector(std::size_t historySize = 256);
+
+    void setAction(Action action);
+    Action getAction() const;
+    void setTranslationAware(bool enabled);
+    bool isTranslationAware() const;
+
+    /**
+     * @brief Forgets the history, e.g. after the world was edited or reloaded.
+     */
+    void reset();
+
+    /**
+     * @brief Records the world after a generation and checks it against the history.
+     */
+    Detection observe(std::uint64_t generation, const CellSpace& cellSpace);
+};
+
+#endif // CYCLE_DETECTOR_H
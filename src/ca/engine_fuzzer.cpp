@@ -0,0 +1,346 @@
+#include "engine_fuzzer.h"
+#include "cell_space.h"
+#include "rule_engine.h"
+#include "../utils/logger.h"
+#include <algorithm>
+#include <fstream>
+#include <random>
+
+namespace {
+    /**
+     * @brief The production path: sparse storage with an active set of cells to evaluate.
+     */
+    class SparseEngine : public FuzzEngine {
+    private:
+        const RuleEngine& ruleEngine_;
+        CellSpace cellSpace_;
+
+    public:
+        SparseEngine(const Rule& rule, const RuleEngine& ruleEngine)
+            : ruleEngine_(ruleEngine), cellSpace_(rule.getDefaultState(), rule.getNeighborhood(), rule.getLattice()) {}
+
+        const char* getName() const override { return "sparse"; }
+
+        void load(const std::vector<std::pair<Point, int>>& cells) override {
+            cellSpace_.clear();
+            for (const auto& cell : cells) cellSpace_.setCellState(cell.first, cell.second);
+        }
+
+        void step() override {
+            cellSpace_.updateCells(ruleEngine_.calculateForUpdate(cellSpace_));
+        }
+
+        std::uint64_t getHash() const override { return cellSpace_.getHash(); }
+        std::size_t getPopulation() const override { return cellSpace_.getNonDefaultCells().size(); }
+    };
+
+    /**
+     * @brief Straightforward reference: a dense grid over the bounding box, every cell evaluated.
+     * Shares nothing with the sparse path except the rule function.
+     */
+    class DenseReferenceEngine : public FuzzEngine {
+    private:
+        const RuleEngine& ruleEngine_;
+        std::vector<Point> neighborhood_;
+        Lattice lattice_;
+        int defaultState_;
+        int radius_;
+        Point origin_;
+        int width_;
+        int height_;
+        std::vector<int> grid_;
+
+        int at(int x, int y) const {
+            int gx = x - origin_.x;
+            int gy = y - origin_.y;
+            if (gx < 0 || gy < 0 || gx >= width_ || gy >= height_) return defaultState_;
+            return grid_[static_cast<std::size_t>(gy) * width_ + gx];
+        }
+
+    public:
+        DenseReferenceEngine(const Rule& rule, const RuleEngine& ruleEngine)
+            : ruleEngine_(ruleEngine), neighborhood_(rule.getNeighborhood()), lattice_(rule.getLattice()),
+              defaultState_(rule.getDefaultState()), radius_(0), origin_(0, 0), width_(0), height_(0) {
+            for (int parity = 0; parity < 2; ++parity) {
+                for (const Point& offset : neighborhood_) {
+                    Point adapted = latticeNeighborOffset(lattice_, offset, parity);
+                    radius_ = std::max({radius_, std::abs(adapted.x), std::abs(adapted.y)});
+                }
+            }
+        }
+
+        const char* getName() const override { return "dense-reference"; }
+
+        void load(const std::vector<std::pair<Point, int>>& cells) override {
+            width_ = height_ = 0;
+            grid_.clear();
+            if (cells.empty()) return;
+            Point minP = cells[0].first, maxP = cells[0].first;
+            for (const auto& cell : cells) {
+                minP = Point(std::min(minP.x, cell.first.x), std::min(minP.y, cell.first.y));
+                maxP = Point(std::max(maxP.x, cell.first.x), std::max(maxP.y, cell.first.y));
+            }
+            origin_ = minP;
+            width_ = maxP.x - minP.x + 1;
+            height_ = maxP.y - minP.y + 1;
+            grid_.assign(static_cast<std::size_t>(width_) * height_, defaultState_);
+            for (const auto& cell : cells) {
+                grid_[static_cast<std::size_t>(cell.first.y - origin_.y) * width_ + (cell.first.x - origin_.x)] = cell.second;
+            }
+        }
+
+        void step() override {
+            // Anything that can change lies within one neighborhood radius of the current grid.
+            Point newOrigin(origin_.x - radius_, origin_.y - radius_);
+            int newWidth = width_ + 2 * radius_;
+            int newHeight = height_ + 2 * radius_;
+            std::vector<int> next(static_cast<std::size_t>(newWidth) * newHeight, defaultState_);
+            std::vector<int> neighborStates(neighborhood_.size());
+            for (int y = 0; y < newHeight; ++y) {
+                for (int x = 0; x < newWidth; ++x) {
+                    int wx = newOrigin.x + x;
+                    int wy = newOrigin.y + y;
+                    int parity = latticeParity(lattice_, Point(wx, wy));
+                    for (std::size_t i = 0; i < neighborhood_.size(); ++i) {
+                        Point offset = latticeNeighborOffset(lattice_, neighborhood_[i], parity);
+                        neighborStates[i] = at(wx + offset.x, wy + offset.y);
+                    }
+                    next[static_cast<std::size_t>(y) * newWidth + x] = ruleEngine_.applyRule(neighborStates);
+                }
+            }
+            origin_ = newOrigin;
+            width_ = newWidth;
+            height_ = newHeight;
+            grid_.swap(next);
+
+            // Trim default rows/columns so the grid tracks the live region.
+            int minX = width_, minY = height_, maxX = -1, maxY = -1;
+            for (int y = 0; y < height_; ++y) {
+                for (int x = 0; x < width_; ++x) {
+                    if (grid_[static_cast<std::size_t>(y) * width_ + x] == defaultState_) continue;
+                    minX = std::min(minX, x); maxX = std::max(maxX, x);
+                    minY = std::min(minY, y); maxY = std::max(maxY, y);
+                }
+            }
+            std::vector<std::pair<Point, int>> cells;
+            for (int y = minY; y <= maxY; ++y) {
+                for (int x = minX; x <= maxX; ++x) {
+                    int state = grid_[static_cast<std::size_t>(y) * width_ + x];
+                    if (state != defaultState_) cells.emplace_back(Point(origin_.x + x, origin_.y + y), state);
+                }
+            }
+            load(cells);
+        }
+
+        std::uint64_t getHash() const override {
+            std::uint64_t hash = 0;
+            for (int y = 0; y < height_; ++y) {
+                for (int x = 0; x < width_; ++x) {
+                    int state = grid_[static_cast<std::size_t>(y) * width_ + x];
+                    if (state != defaultState_) hash ^= CellSpace::cellHashKey(Point(origin_.x + x, origin_.y + y), state);
+                }
+            }
+            return hash;
+        }
+
+        std::size_t getPopulation() const override {
+            return static_cast<std::size_t>(std::count_if(grid_.begin(), grid_.end(),
+                                                          [this](int s) { return s != defaultState_; }));
+        }
+    };
+
+    std::uint64_t mixSeed(std::uint64_t x) {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+}
+
+EngineFuzzer::EngineFuzzer(Options options)
+    : options_(std::move(options)) {
+}
+
+std::vector<std::unique_ptr<FuzzEngine>> EngineFuzzer::createEngines(const Rule& rule, const RuleEngine& ruleEngine) {
+    std::vector<std::unique_ptr<FuzzEngine>> engines;
+    engines.push_back(std::make_unique<SparseEngine>(rule, ruleEngine));
+    engines.push_back(std::make_unique<DenseReferenceEngine>(rule, ruleEngine));
+    return engines;
+}
+
+int EngineFuzzer::firstDivergence(const Rule& rule, const RuleEngine& ruleEngine,
+                                  const std::vector<std::pair<Point, int>>& cells, int generations,
+                                  std::string* engineName) {
+    auto engines = createEngines(rule, ruleEngine);
+    for (auto& engine : engines) engine->load(cells);
+    for (int generation = 1; generation <= generations; ++generation) {
+        for (auto& engine : engines) engine->step();
+        for (std::size_t i = 1; i < engines.size(); ++i) {
+            if (engines[i]->getHash() != engines[0]->getHash() ||
+                engines[i]->getPopulation() != engines[0]->getPopulation()) {
+                if (engineName) *engineName = engines[i]->getName();
+                return generation;
+            }
+        }
+    }
+    return 0;
+}
+
+std::vector<std::pair<Point, int>> EngineFuzzer::minimize(const Rule& rule, const RuleEngine& ruleEngine,
+                                                          std::vector<std::pair<Point, int>> cells, int& generations) {
+    // Delta debugging: drop ever smaller blocks of cells while the engines still disagree.
+    std::size_t block = std::max<std::size_t>(cells.size() / 2, 1);
+    while (!cells.empty()) {
+        bool reduced = false;
+        for (std::size_t start = 0; start < cells.size();) {
+            std::vector<std::pair<Point, int>> candidate;
+            candidate.reserve(cells.size());
+            candidate.insert(candidate.end(), cells.begin(), cells.begin() + static_cast<std::ptrdiff_t>(start));
+            std::size_t end = std::min(start + block, cells.size());
+            candidate.insert(candidate.end(), cells.begin() + static_cast<std::ptrdiff_t>(end), cells.end());
+
+            int generation = firstDivergence(rule, ruleEngine, candidate, generations, nullptr);
+            if (generation > 0) {
+                cells.swap(candidate);
+                generations = generation;
+                reduced = true;
+            } else {
+                start += block;
+            }
+        }
+        if (!reduced) {
+            if (block == 1) break;
+            block /= 2;
+        }
+    }
+    return cells;
+}
+
+bool EngineFuzzer::writeReproducer(const Divergence& divergence) const {
+    auto logger = Logger::getLogger(Logger::Module::RuleEngine);
+    std::ofstream out(options_.reproducerPath);
+    if (!out.is_open()) {
+        if (logger) logger->error("Failed to write fuzz reproducer: " + options_.reproducerPath);
+        return false;
+    }
+    out << "# Engine divergence: load the cells, step 'generation' times, compare the engines\n";
+    out << "# A random rule is rebuilt from its rulestring: {\"rule_type\": \"generations\", \"rulestring\": ...}\n";
+    out << "rule " << divergence.rulePath << '\n';
+    if (!divergence.rulestring.empty()) out << "rulestring " << divergence.rulestring << '\n';
+    out << "seed " << divergence.seed << '\n';
+    out << "engine " << divergence.engineName << '\n';
+    out << "generation " << divergence.generation << '\n';
+    out << "cells " << divergence.cells.size() << '\n';
+    for (const auto& cell : divergence.cells) {
+        out << cell.first.x << ' ' << cell.first.y << ' ' << cell.second << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+bool EngineFuzzer::fuzzSoup(const Rule& rule, const RuleEngine& ruleEngine, const std::string& ruleName,
+                            std::uint64_t soupSeed, Divergence& divergence) const {
+    auto logger = Logger::getLogger(Logger::Module::RuleEngine);
+    std::vector<int> liveStates;
+    for (int state : rule.getStates()) {
+        if (state != rule.getDefaultState()) liveStates.push_back(state);
+    }
+    if (liveStates.empty()) return true;
+
+    std::mt19937_64 rng(soupSeed);
+    int size = 2 + static_cast<int>(rng() % static_cast<std::uint64_t>(std::max(options_.soupSize - 1, 1)));
+    double density = 0.1 + 0.6 * std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+    // Random placement, so tile and sign boundaries of future engines get exercised.
+    int originX = static_cast<int>(rng() % 512) - 256;
+    int originY = static_cast<int>(rng() % 512) - 256;
+    std::vector<std::pair<Point, int>> cells;
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            if (std::uniform_real_distribution<double>(0.0, 1.0)(rng) < density) {
+                cells.emplace_back(Point(originX + x, originY + y), liveStates[rng() % liveStates.size()]);
+            }
+        }
+    }
+
+    std::string engineName;
+    int generation = firstDivergence(rule, ruleEngine, cells, options_.generations, &engineName);
+    if (generation == 0) return true;
+
+    if (logger) logger->error("Fuzz: {} diverged from the sparse engine on {} (seed {}) at generation {}; minimizing {} cells.",
+                              engineName, ruleName, soupSeed, generation, cells.size());
+    divergence.seed = soupSeed;
+    divergence.engineName = engineName;
+    divergence.cells = minimize(rule, ruleEngine, cells, generation);
+    divergence.generation = generation;
+    if (writeReproducer(divergence) && logger) {
+        logger->error("Fuzz: reproducer with {} cells, {} generations written to {}",
+                      divergence.cells.size(), divergence.generation, options_.reproducerPath);
+    }
+    return false;
+}
+
+std::string EngineFuzzer::randomRulestring(std::uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::string birth;
+    std::string survival;
+    for (int count = 0; count <= 8; ++count) {
+        if (count > 0 && rng() % 3 == 0) birth += static_cast<char>('0' + count);
+        if (rng() % 3 == 0) survival += static_cast<char>('0' + count);
+    }
+    if (birth.empty()) birth = std::string(1, static_cast<char>('1' + rng() % 8)); // A rule without births only decays
+    int states = 2 + static_cast<int>(rng() % (MAX_RANDOM_STATES - 1));
+    return "B" + birth + "/S" + survival + "/C" + std::to_string(states);
+}
+
+bool EngineFuzzer::run(Divergence& divergence) {
+    auto logger = Logger::getLogger(Logger::Module::RuleEngine);
+    for (const std::string& rulePath : options_.rulePaths) {
+        Rule rule;
+        RuleEngine ruleEngine;
+        if (!rule.loadFromFile(rulePath) || !ruleEngine.initialize(rule)) {
+            if (logger) logger->error("Fuzz: cannot load rule " + rulePath + ", skipping.");
+            continue;
+        }
+        if (rule.getDimensions() != 2) {
+            if (logger) logger->info("Fuzz: " + rulePath + " is a 3D rule, skipping.");
+            continue;
+        }
+        if (rule.getRuleType() == Rule::RuleType::ReactionDiffusion) {
+            if (logger) logger->info("Fuzz: " + rulePath + " is a reaction-diffusion rule, skipping.");
+            continue;
+        }
+        divergence.rulePath = rulePath;
+        divergence.rulestring = rule.getRuleType() == Rule::RuleType::Generations ? rule.getRulestring() : "";
+        for (int iteration = 0; iteration < options_.iterations; ++iteration) {
+            std::uint64_t soupSeed = mixSeed(options_.seed + static_cast<std::uint64_t>(iteration));
+            if (!fuzzSoup(rule, ruleEngine, rulePath, soupSeed, divergence)) return false;
+        }
+        if (logger) logger->info("Fuzz: {} soups agreed on {}.", options_.iterations, rulePath);
+    }
+
+    if (!options_.randomRules) return true;
+    for (int iteration = 0; iteration < options_.iterations; ++iteration) {
+        // Separate stream from the soup seeds, so a rule and its soup are not correlated.
+        std::uint64_t ruleSeed = mixSeed(~(options_.seed + static_cast<std::uint64_t>(iteration)));
+        std::string rulestring = randomRulestring(ruleSeed);
+        nlohmann::json ruleJson = {{"rule_type", "generations"}, {"rulestring", rulestring}};
+        int states = 0;
+        std::uint32_t birthMask = 0, survivalMask = 0;
+        Rule::parseGenerationsRulestring(rulestring, birthMask, survivalMask, states, 8);
+        for (int state = 0; state < states; ++state) {
+            int shade = 255 - 255 * state / std::max(states - 1, 1); // Colors are unused; given to keep the log quiet
+            ruleJson["state_color_map"].push_back({shade, shade, shade});
+        }
+        Rule rule;
+        RuleEngine ruleEngine;
+        if (!rule.loadFromJsonString(ruleJson.dump()) || !ruleEngine.initialize(rule)) {
+            if (logger) logger->error("Fuzz: cannot build random rule " + rulestring + ", skipping.");
+            continue;
+        }
+        divergence.rulePath = "random";
+        divergence.rulestring = rulestring;
+        std::uint64_t soupSeed = mixSeed(options_.seed + static_cast<std::uint64_t>(iteration));
+        if (!fuzzSoup(rule, ruleEngine, rulestring, soupSeed, divergence)) return false;
+    }
+    if (logger) logger->info("Fuzz: {} random Generations rules agreed.", options_.iterations);
+    return true;
+}
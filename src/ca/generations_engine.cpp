@@ -0,0 +1,218 @@
+#include "generations_engine.h"
+#include "cell_space.h"
+
+#include <bit>
+#include <memory>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+
+namespace {
+    constexpr int TILE = GenerationsEngine::TILE_SIZE;
+
+    struct Tile {
+        std::int32_t tileX = 0;
+        std::int32_t tileY = 0;
+        bool hasFiring = false;
+        std::uint64_t firing[TILE] = {};   // Bit x of row y: cell in state 1
+        std::uint64_t occupied[TILE] = {}; // Bit x of row y: cell in any non-dead state
+        std::uint8_t state[TILE * TILE] = {};
+    };
+
+    std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+        std::int64_t q = value / divisor;
+        return (value % divisor != 0 && value < 0) ? q - 1 : q;
+    }
+
+    std::uint64_t packTileKey(std::int64_t tileX, std::int64_t tileY) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(tileX)) << 32) |
+               static_cast<std::uint32_t>(tileY);
+    }
+
+    // Cells of a row shifted so that bit x holds the neighbor at x-1 (west) or x+1 (east).
+    inline std::uint64_t westOf(std::uint64_t center, std::uint64_t left) {
+        return (center << 1) | (left >> (TILE - 1));
+    }
+    inline std::uint64_t eastOf(std::uint64_t center, std::uint64_t right) {
+        return (center >> 1) | (right << (TILE - 1));
+    }
+
+    // Four bitplanes of a per-bit counter (0..8).
+    struct BitCounter {
+        std::uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+
+        inline void add(std::uint64_t x) {
+            std::uint64_t c0 = s0 & x;
+            s0 ^= x;
+            std::uint64_t c1 = s1 & c0;
+            s1 ^= c0;
+            std::uint64_t c2 = s2 & c1;
+            s2 ^= c1;
+            s3 |= c2;
+        }
+
+        // Bits whose count is in the set described by mask (bit n: count n).
+        inline std::uint64_t matching(std::uint16_t mask) const {
+            std::uint64_t result = 0;
+            for (int n = 0; n <= 8; ++n) {
+                if (!(mask & (1u << n))) continue;
+                result |= ((n & 1) ? s0 : ~s0) & ((n & 2) ? s1 : ~s1) &
+                          ((n & 4) ? s2 : ~s2) & ((n & 8) ? s3 : ~s3);
+            }
+            return result;
+        }
+    };
+}
+
+GenerationsEngine::GenerationsEngine(std::uint16_t birthMask, std::uint16_t survivalMask, int stateCount)
+    : birthMask_(birthMask),
+      survivalMask_(survivalMask),
+      stateCount_(stateCount) {
+}
+
+int GenerationsEngine::nextState(int state, int firingNeighbors) const {
+    if (state == 0) {
+        return (birthMask_ & (1u << firingNeighbors)) ? 1 : 0;
+    }
+    if (state == 1 && (survivalMask_ & (1u << firingNeighbors))) {
+        return 1;
+    }
+    // Firing cells that do not survive and refractory cells age by one; the last state dies.
+    if (state < 1 || state + 1 >= stateCount_) return 0;
+    return state + 1;
+}
+
+int GenerationsEngine::applyRule(const int* neighborStates) const {
+    int firing = 0;
+    for (int i = 0; i < 8; ++i) {
+        if (neighborStates[i] == 1) ++firing;
+    }
+    return nextState(neighborStates[8], firing);
+}
+
+std::unordered_map<Point, int> GenerationsEngine::calculateForUpdate(const CellSpace& cellSpace) const {
+    std::unordered_map<Point, int> cellsToUpdate;
+    const auto& cells = cellSpace.getNonDefaultCells();
+    if (cells.empty()) return cellsToUpdate;
+
+    // Bin the live cells into tiles.
+    std::vector<std::unique_ptr<Tile>> tiles;
+    std::unordered_map<std::uint64_t, Tile*> tileIndex;
+    for (const auto& pair : cells) {
+        std::int64_t tileX = floorDiv(pair.first.x, TILE);
+        std::int64_t tileY = floorDiv(pair.first.y, TILE);
+        Tile*& tile = tileIndex[packTileKey(tileX, tileY)];
+        if (!tile) {
+            tiles.push_back(std::make_unique<Tile>());
+            tile = tiles.back().get();
+            tile->tileX = static_cast<std::int32_t>(tileX);
+            tile->tileY = static_cast<std::int32_t>(tileY);
+        }
+        int localX = static_cast<int>(pair.first.x - tileX * TILE);
+        int localY = static_cast<int>(pair.first.y - tileY * TILE);
+        // States outside 1..C-1 are treated as being in their last generation.
+        int state = (pair.second >= 1 && pair.second < stateCount_) ? pair.second : stateCount_ - 1;
+        tile->state[localY * TILE + localX] = static_cast<std::uint8_t>(state);
+        tile->occupied[localY] |= std::uint64_t(1) << localX;
+        if (state == 1) {
+            tile->firing[localY] |= std::uint64_t(1) << localX;
+            tile->hasFiring = true;
+        }
+    }
+
+    // Occupied tiles change through survival and decay; births can only happen next to firing cells.
+    std::vector<std::pair<std::int32_t, std::int32_t>> work;
+    std::unordered_set<std::uint64_t> queued;
+    auto enqueue = [&](std::int64_t tileX, std::int64_t tileY) {
+        if (queued.insert(packTileKey(tileX, tileY)).second) {
+            work.emplace_back(static_cast<std::int32_t>(tileX), static_cast<std::int32_t>(tileY));
+        }
+    };
+    for (const auto& tile : tiles) {
+        enqueue(tile->tileX, tile->tileY);
+        if (!tile->hasFiring) continue;
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                enqueue(static_cast<std::int64_t>(tile->tileX) + dx, static_cast<std::int64_t>(tile->tileY) + dy);
+            }
+        }
+    }
+
+    std::vector<std::vector<std::pair<Point, int>>> changes(work.size());
+    tbb::parallel_for(std::size_t(0), work.size(), [&](std::size_t index) {
+        const std::int64_t tileX = work[index].first;
+        const std::int64_t tileY = work[index].second;
+        const Tile* around[3][3];
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                auto it = tileIndex.find(packTileKey(tileX + dx, tileY + dy));
+                around[dy + 1][dx + 1] = (it != tileIndex.end()) ? it->second : nullptr;
+            }
+        }
+        const Tile* tile = around[1][1];
+        auto firingRow = [&](int tileRow, int column, int y) -> std::uint64_t {
+            const Tile* t = around[tileRow][column];
+            return t ? t->firing[y] : 0;
+        };
+
+        std::vector<std::pair<Point, int>>& out = changes[index];
+        for (int y = 0; y < TILE; ++y) {
+            int upperTile = (y == 0) ? 0 : 1;
+            int upperY = (y == 0) ? TILE - 1 : y - 1;
+            int lowerTile = (y == TILE - 1) ? 2 : 1;
+            int lowerY = (y == TILE - 1) ? 0 : y + 1;
+
+            std::uint64_t up = firingRow(upperTile, 1, upperY);
+            std::uint64_t mid = firingRow(1, 1, y);
+            std::uint64_t down = firingRow(lowerTile, 1, lowerY);
+            std::uint64_t upWest = westOf(up, firingRow(upperTile, 0, upperY));
+            std::uint64_t upEast = eastOf(up, firingRow(upperTile, 2, upperY));
+            std::uint64_t midWest = westOf(mid, firingRow(1, 0, y));
+            std::uint64_t midEast = eastOf(mid, firingRow(1, 2, y));
+            std::uint64_t downWest = westOf(down, firingRow(lowerTile, 0, lowerY));
+            std::uint64_t downEast = eastOf(down, firingRow(lowerTile, 2, lowerY));
+            std::uint64_t occupied = tile ? tile->occupied[y] : 0;
+            if ((up | down | upWest | upEast | midWest | midEast | downWest | downEast | occupied) == 0) continue;
+
+            BitCounter count;
+            count.add(upWest);
+            count.add(up);
+            count.add(upEast);
+            count.add(midWest);
+            count.add(midEast);
+            count.add(downWest);
+            count.add(down);
+            count.add(downEast);
+
+            std::uint64_t born = ~occupied & count.matching(birthMask_);
+            std::uint64_t dying = mid & ~count.matching(survivalMask_);
+            std::uint64_t decaying = occupied & ~mid;
+            std::uint64_t changed = born | dying | decaying;
+
+            const int worldY = static_cast<int>(tileY * TILE + y);
+            while (changed) {
+                int x = std::countr_zero(changed);
+                changed &= changed - 1;
+                std::uint64_t bit = std::uint64_t(1) << x;
+                int next;
+                if (born & bit) {
+                    next = 1;
+                } else {
+                    int state = tile->state[y * TILE + x];
+                    next = (state + 1 >= stateCount_) ? 0 : state + 1;
+                }
+                out.emplace_back(Point(static_cast<int>(tileX * TILE + x), worldY), next);
+            }
+        }
+    });
+
+    std::size_t total = 0;
+    for (const auto& list : changes) total += list.size();
+    cellsToUpdate.reserve(total);
+    for (const auto& list : changes) {
+        for (const auto& change : list) cellsToUpdate.emplace(change.first, change.second);
+    }
+    return cellsToUpdate;
+}
@@ -0,0 +1,49 @@
+#ifndef GENERATIONS_ENGINE_H
+#define GENERATIONS_ENGINE_H
+
+#include <cstdint>
+#include <unordered_map>
+#include "../utils/point.h"
+
+class CellSpace;
+
+/**
+ * @class GenerationsEngine
+ * @brief Built-in stepper for "Generations" rules (B/S/C notation, e.g. Brian's Brain B2/S/C3).
+ *
+ * State 0 is dead, 1 is firing and 2..C-1 are refractory states that decay by one each
+ * generation. Only firing cells count as neighbors (Moore neighborhood). Each step bins the
+ * live cells into 64x64 tiles holding a firing bitplane, an occupancy bitplane and a narrow
+ * uint8 state array; neighbor counts are summed 64 cells at a time with a bit-sliced adder,
+ * so no per-cell function call or hash lookup is made.
+ */
+class GenerationsEngine {
+public:
+    static constexpr int TILE_SIZE = 64;
+
+private:
+    std::uint16_t birthMask_;    // Bit n set: a dead cell with n firing neighbors starts firing
+    std::uint16_t survivalMask_; // Bit n set: a firing cell with n firing neighbors keeps firing
+    int stateCount_;             // C: number of states including dead and firing
+
+public:
+    GenerationsEngine(std::uint16_t birthMask, std::uint16_t survivalMask, int stateCount);
+
+    /**
+     * @brief Computes the changes for the next generation of the given world.
+     */
+    std::unordered_map<Point, int> calculateForUpdate(const CellSpace& cellSpace) const;
+
+    /**
+     * @brief Next state of one cell from its Moore neighbors followed by the cell itself
+     * (the order of Rule's generations neighborhood). Used by reference implementations.
+     */
+    int applyRule(const int* neighborStates) const;
+
+    /**
+     * @brief Next state of a cell given its state and its number of firing neighbors.
+     */
+    int nextState(int state, int firingNeighbors) const;
+};
+
+#endif // GENERATIONS_ENGINE_H
@@ -0,0 +1,380 @@
+#include "graph_space.h"
+#include "rule_engine.h"
+#include "../utils/logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#include <tbb/blocked_range.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+GraphSpace::GraphSpace()
+    : defaultState_(0),
+      maxDegree_(0),
+      bandwidthBefore_(0),
+      bandwidthAfter_(0),
+      slotCount_(0),
+      centerSlot_(-1) {
+}
+
+std::uint64_t GraphSpace::bandwidth(const std::vector<std::uint32_t>& offsets, const std::vector<std::uint32_t>& adjacency) {
+    std::uint64_t result = 0;
+    for (std::size_t v = 0; v + 1 < offsets.size(); ++v) {
+        for (std::uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+            std::uint64_t distance = adjacency[i] > v ? adjacency[i] - v : v - adjacency[i];
+            result = std::max(result, distance);
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Reverse Cuthill-McKee ordering; each component starts from a pseudo-peripheral vertex.
+ * @return order[newIndex] = old vertex.
+ */
+std::vector<std::uint32_t> GraphSpace::reverseCuthillMcKee(const std::vector<std::uint32_t>& offsets,
+                                                           const std::vector<std::uint32_t>& adjacency) {
+    const std::uint32_t vertexCount = static_cast<std::uint32_t>(offsets.size() - 1);
+    auto degree = [&](std::uint32_t v) { return offsets[v + 1] - offsets[v]; };
+
+    std::vector<std::uint32_t> byDegree(vertexCount);
+    for (std::uint32_t v = 0; v < vertexCount; ++v) byDegree[v] = v;
+    std::stable_sort(byDegree.begin(), byDegree.end(),
+                     [&](std::uint32_t a, std::uint32_t b) { return degree(a) < degree(b); });
+
+    std::vector<bool> placed(vertexCount, false);
+    std::vector<std::int32_t> distance(vertexCount, -1);
+    std::vector<std::uint32_t> order;
+    order.reserve(vertexCount);
+    std::vector<std::uint32_t> queue;
+    queue.reserve(vertexCount);
+
+    // BFS over the unplaced component; returns the min-degree vertex of the last level and its depth.
+    auto farthest = [&](std::uint32_t start, std::int32_t& depth) {
+        queue.clear();
+        queue.push_back(start);
+        distance[start] = 0;
+        for (std::size_t head = 0; head < queue.size(); ++head) {
+            std::uint32_t v = queue[head];
+            for (std::uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                std::uint32_t w = adjacency[i];
+                if (!placed[w] && distance[w] < 0) {
+                    distance[w] = distance[v] + 1;
+                    queue.push_back(w);
+                }
+            }
+        }
+        depth = distance[queue.back()];
+        std::uint32_t best = queue.back();
+        for (std::uint32_t v : queue) {
+            if (distance[v] == depth && degree(v) < degree(best)) best = v;
+            distance[v] = -1;
+        }
+        return best;
+    };
+
+    std::vector<std::uint32_t> neighbors;
+    for (std::uint32_t seed : byDegree) {
+        if (placed[seed]) continue;
+        std::uint32_t start = seed;
+        std::int32_t depth = 0;
+        std::uint32_t candidate = farthest(start, depth);
+        for (int iteration = 0; iteration < 8; ++iteration) {
+            std::int32_t candidateDepth = 0;
+            std::uint32_t next = farthest(candidate, candidateDepth);
+            if (candidateDepth <= depth) break;
+            start = candidate;
+            depth = candidateDepth;
+            candidate = next;
+        }
+
+        // Cuthill-McKee: BFS visiting each vertex's neighbors by increasing degree.
+        std::size_t head = order.size();
+        order.push_back(start);
+        placed[start] = true;
+        for (; head < order.size(); ++head) {
+            std::uint32_t v = order[head];
+            neighbors.clear();
+            for (std::uint32_t i = offsets[v]; i < offsets[v + 1]; ++i) {
+                if (!placed[adjacency[i]]) {
+                    placed[adjacency[i]] = true;
+                    neighbors.push_back(adjacency[i]);
+                }
+            }
+            std::stable_sort(neighbors.begin(), neighbors.end(),
+                             [&](std::uint32_t a, std::uint32_t b) { return degree(a) < degree(b); });
+            order.insert(order.end(), neighbors.begin(), neighbors.end());
+        }
+    }
+    std::reverse(order.begin(), order.end());
+    return order;
+}
+
+bool GraphSpace::loadFromFile(const std::string& filePath, int defaultState, Ordering ordering, std::string& error) {
+    auto logger = Logger::getLogger(Logger::Module::CellSpace);
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        error = "Cannot open graph file " + filePath;
+        return false;
+    }
+
+    std::unordered_map<long long, std::uint32_t> ids;
+    auto vertexId = [&ids](long long id) {
+        auto it = ids.find(id);
+        if (it != ids.end()) return it->second;
+        std::uint32_t index = static_cast<std::uint32_t>(ids.size());
+        ids.emplace(id, index);
+        return index;
+    };
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> arcs;
+    std::unordered_map<std::uint32_t, Point> givenPositions;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::istringstream stream(line);
+        std::string first;
+        if (!(stream >> first)) continue;
+        if (first == "pos") {
+            long long id;
+            int x, y;
+            if (!(stream >> id >> x >> y) || id < 0) {
+                error = "Graph line " + std::to_string(lineNumber) + ": expected 'pos <vertex> <x> <y>'";
+                return false;
+            }
+            givenPositions[vertexId(id)] = Point(x, y);
+            continue;
+        }
+        long long u, v;
+        try {
+            u = std::stoll(first);
+        } catch (const std::exception&) {
+            u = -1;
+        }
+        if (u < 0 || !(stream >> v) || v < 0) {
+            error = "Graph line " + std::to_string(lineNumber) + ": expected '<u> <v>' or 'pos <vertex> <x> <y>'";
+            return false;
+        }
+        std::uint32_t a = vertexId(u), b = vertexId(v);
+        if (a == b) continue;
+        arcs.emplace_back(a, b);
+        arcs.emplace_back(b, a);
+    }
+    if (ids.empty()) {
+        error = "Graph file " + filePath + " has no vertices";
+        return false;
+    }
+
+    const std::uint32_t vertexCount = static_cast<std::uint32_t>(ids.size());
+    std::sort(arcs.begin(), arcs.end());
+    arcs.erase(std::unique(arcs.begin(), arcs.end()), arcs.end());
+    std::vector<std::uint32_t> offsets(vertexCount + 1, 0);
+    std::vector<std::uint32_t> adjacency(arcs.size());
+    for (const auto& arc : arcs) ++offsets[arc.first + 1];
+    for (std::uint32_t v = 0; v < vertexCount; ++v) offsets[v + 1] += offsets[v];
+    for (std::size_t i = 0; i < arcs.size(); ++i) adjacency[i] = arcs[i].second; // arcs are sorted by source
+
+    bandwidthBefore_ = bandwidth(offsets, adjacency);
+    std::vector<std::uint32_t> order(vertexCount);
+    if (ordering == Ordering::ReverseCuthillMcKee) {
+        order = reverseCuthillMcKee(offsets, adjacency);
+    } else {
+        for (std::uint32_t v = 0; v < vertexCount; ++v) order[v] = v;
+    }
+    std::vector<std::uint32_t> newIndex(vertexCount);
+    for (std::uint32_t v = 0; v < vertexCount; ++v) newIndex[order[v]] = v;
+
+    offsets_.assign(vertexCount + 1, 0);
+    adjacency_.clear();
+    adjacency_.reserve(adjacency.size());
+    maxDegree_ = 0;
+    for (std::uint32_t v = 0; v < vertexCount; ++v) {
+        std::uint32_t old = order[v];
+        std::size_t first = adjacency_.size();
+        for (std::uint32_t i = offsets[old]; i < offsets[old + 1]; ++i) {
+            adjacency_.push_back(newIndex[adjacency[i]]);
+        }
+        std::sort(adjacency_.begin() + first, adjacency_.end());
+        offsets_[v + 1] = static_cast<std::uint32_t>(adjacency_.size());
+        maxDegree_ = std::max(maxDegree_, offsets_[v + 1] - offsets_[v]);
+    }
+    bandwidthAfter_ = bandwidth(offsets_, adjacency_);
+
+    // Display positions: as given, or a square grid in vertex order (which RCM keeps local).
+    positions_.assign(vertexCount, Point(0, 0));
+    bool allPositioned = givenPositions.size() == vertexCount;
+    if (!allPositioned && !givenPositions.empty() && logger) {
+        logger->warn("Graph {}: only {} of {} vertices have positions; using a grid layout.", filePath,
+                     givenPositions.size(), vertexCount);
+    }
+    int gridWidth = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(vertexCount))));
+    for (std::uint32_t v = 0; v < vertexCount; ++v) {
+        positions_[v] = allPositioned ? givenPositions[order[v]]
+                                      : Point(static_cast<int>(v) % gridWidth, static_cast<int>(v) / gridWidth);
+    }
+    vertexAt_.clear();
+    vertexAt_.reserve(vertexCount);
+    std::size_t overlapping = 0;
+    for (std::uint32_t v = 0; v < vertexCount; ++v) {
+        if (!vertexAt_.emplace(positions_[v], v).second) ++overlapping;
+    }
+    if (overlapping > 0 && logger) {
+        logger->warn("Graph {}: {} vertices share a display cell with another vertex and cannot be edited.",
+                     filePath, overlapping);
+    }
+
+    defaultState_ = defaultState;
+    states_.assign(vertexCount, defaultState);
+    nextStates_.assign(vertexCount, defaultState);
+    path_ = filePath;
+    if (logger) logger->info("Graph {} loaded: {} vertices, {} edges, max degree {}, bandwidth {} -> {}.", filePath,
+                             vertexCount, adjacency_.size() / 2, maxDegree_, bandwidthBefore_, bandwidthAfter_);
+    return true;
+}
+
+void GraphSpace::clear() {
+    offsets_.clear();
+    adjacency_.clear();
+    states_.clear();
+    nextStates_.clear();
+    positions_.clear();
+    vertexAt_.clear();
+    maxDegree_ = 0;
+    bandwidthBefore_ = 0;
+    bandwidthAfter_ = 0;
+    path_.clear();
+}
+
+bool GraphSpace::isLoaded() const {
+    return !states_.empty();
+}
+
+bool GraphSpace::bindRule(const std::vector<Point>& neighborhood, std::string& error) {
+    centerSlot_ = -1;
+    neighborSlots_.clear();
+    for (std::size_t i = 0; i < neighborhood.size(); ++i) {
+        if (neighborhood[i] == Point(0, 0) && centerSlot_ < 0) {
+            centerSlot_ = static_cast<int>(i);
+        } else {
+            neighborSlots_.push_back(static_cast<int>(i));
+        }
+    }
+    slotCount_ = static_cast<int>(neighborhood.size());
+    if (centerSlot_ < 0) {
+        error = "The rule's neighborhood needs a (0, 0) entry to run on a graph.";
+        return false;
+    }
+    if (maxDegree_ > neighborSlots_.size()) {
+        error = "Graph degree " + std::to_string(maxDegree_) + " exceeds the rule's " +
+                std::to_string(neighborSlots_.size()) + " neighbor slots.";
+        return false;
+    }
+    return true;
+}
+
+void GraphSpace::step(const RuleEngine& ruleEngine, std::vector<std::uint32_t>& changedVertices) {
+    changedVertices.clear();
+    if (states_.empty() || centerSlot_ < 0) return;
+
+    tbb::enumerable_thread_specific<std::vector<std::uint32_t>> changedPerThread;
+    tbb::parallel_for(tbb::blocked_range<std::uint32_t>(0, static_cast<std::uint32_t>(states_.size()), 4096),
+                      [&](const tbb::blocked_range<std::uint32_t>& range) {
+        std::vector<int> slots(static_cast<std::size_t>(slotCount_), defaultState_);
+        std::vector<std::uint32_t>& changed = changedPerThread.local();
+        for (std::uint32_t v = range.begin(); v != range.end(); ++v) {
+            const std::uint32_t begin = offsets_[v], degree = offsets_[v + 1] - begin;
+            for (std::uint32_t i = 0; i < degree; ++i) {
+                slots[neighborSlots_[i]] = states_[adjacency_[begin + i]];
+            }
+            for (std::size_t i = degree; i < neighborSlots_.size(); ++i) {
+                slots[neighborSlots_[i]] = defaultState_;
+            }
+            slots[centerSlot_] = states_[v];
+            int next = ruleEngine.applyRule(slots.data());
+            nextStates_[v] = next;
+            if (next != states_[v]) changed.push_back(v);
+        }
+    });
+    states_.swap(nextStates_);
+    for (const auto& changed : changedPerThread) {
+        changedVertices.insert(changedVertices.end(), changed.begin(), changed.end());
+    }
+}
+
+int GraphSpace::getState(std::uint32_t vertex) const {
+    return states_[vertex];
+}
+
+void GraphSpace::setState(std::uint32_t vertex, int state) {
+    states_[vertex] = state;
+}
+
+void GraphSpace::resetStates() {
+    std::fill(states_.begin(), states_.end(), defaultState_);
+}
+
+std::int64_t GraphSpace::vertexAt(Point cell) const {
+    auto it = vertexAt_.find(cell);
+    return it != vertexAt_.end() ? static_cast<std::int64_t>(it->second) : -1;
+}
+
+Point GraphSpace::getPosition(std::uint32_t vertex) const {
+    return positions_[vertex];
+}
+
+bool GraphSpace::getLayoutBounds(Point& minBounds, Point& maxBounds) const {
+    if (positions_.empty()) return false;
+    minBounds = maxBounds = positions_[0];
+    for (Point position : positions_) {
+        minBounds.x = std::min(minBounds.x, position.x);
+        minBounds.y = std::min(minBounds.y, position.y);
+        maxBounds.x = std::max(maxBounds.x, position.x);
+        maxBounds.y = std::max(maxBounds.y, position.y);
+    }
+    return true;
+}
+
+std::unordered_map<Point, int> GraphSpace::toCells() const {
+    std::unordered_map<Point, int> cells;
+    for (std::uint32_t v = 0; v < states_.size(); ++v) {
+        if (states_[v] != defaultState_) cells[positions_[v]] = states_[v];
+    }
+    return cells;
+}
+
+void GraphSpace::setStatesFromCells(const std::unordered_map<Point, int>& cells) {
+    for (std::uint32_t v = 0; v < states_.size(); ++v) {
+        auto it = cells.find(positions_[v]);
+        states_[v] = it != cells.end() ? it->second : defaultState_;
+    }
+}
+
+std::size_t GraphSpace::getVertexCount() const {
+    return states_.size();
+}
+
+std::size_t GraphSpace::getEdgeCount() const {
+    return adjacency_.size() / 2;
+}
+
+std::uint32_t GraphSpace::getMaxDegree() const {
+    return maxDegree_;
+}
+
+std::uint64_t GraphSpace::getBandwidthBefore() const {
+    return bandwidthBefore_;
+}
+
+std::uint64_t GraphSpace::getBandwidthAfter() const {
+    return bandwidthAfter_;
+}
+
+const std::string& GraphSpace::getPath() const {
+    return path_;
+}
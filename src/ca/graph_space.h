@@ -0,0 +1,110 @@
+#ifndef GRAPH_SPACE_H
+#define GRAPH_SPACE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../utils/point.h"
+
+class RuleEngine;
+
+/**
+ * @class GraphSpace
+ * @brief A world whose cells are the vertices of an undirected graph, stored in CSR form.
+ *
+ * Graph file format (text, '#' starts a comment):
+ * - `<u> <v>`: an undirected edge between vertex ids u and v (any non-negative integers)
+ * - `pos <v> <x> <y>`: optional integer display position of vertex v
+ * Duplicate edges and self loops are dropped. Ids are compacted in order of appearance.
+ *
+ * Vertices are renumbered with reverse Cuthill-McKee so neighbors sit close together in
+ * the state and adjacency arrays. Rules run through the usual plugin ABI: the rule's
+ * (0, 0) offset receives the vertex state and the other offsets receive the neighbor
+ * states in CSR order, padded with the default state, so totalistic rules work on any
+ * graph whose degree does not exceed the rule's neighbor count.
+ */
+class GraphSpace {
+public:
+    enum class Ordering {
+        None,
+        ReverseCuthillMcKee
+    };
+
+private:
+    std::vector<std::uint32_t> offsets_;   // Vertex v's neighbors are adjacency_[offsets_[v], offsets_[v + 1])
+    std::vector<std::uint32_t> adjacency_;
+    std::vector<int> states_;
+    std::vector<int> nextStates_;
+    std::vector<Point> positions_;         // Display cell of each vertex
+    std::unordered_map<Point, std::uint32_t> vertexAt_;
+    int defaultState_;
+    std::uint32_t maxDegree_;
+    std::uint64_t bandwidthBefore_;        // max |u - v| over edges, before and after reordering
+    std::uint64_t bandwidthAfter_;
+    std::string path_;
+
+    // Rule binding
+    int slotCount_;
+    int centerSlot_;
+    std::vector<int> neighborSlots_;       // Slot of the i-th neighbor
+
+    static std::vector<std::uint32_t> reverseCuthillMcKee(const std::vector<std::uint32_t>& offsets,
+                                                          const std::vector<std::uint32_t>& adjacency);
+    static std::uint64_t bandwidth(const std::vector<std::uint32_t>& offsets, const std::vector<std::uint32_t>& adjacency);
+
+public:
+    GraphSpace();
+
+    /**
+     * @brief Loads a graph; all vertices start in defaultState.
+     * @param error Receives a message for the user on failure.
+     */
+    bool loadFromFile(const std::string& filePath, int defaultState, Ordering ordering, std::string& error);
+    void clear();
+    bool isLoaded() const;
+
+    /**
+     * @brief Maps the rule's neighborhood onto vertex neighbors.
+     * @return False (with error set) if the rule has no (0, 0) offset or too few neighbor slots.
+     */
+    bool bindRule(const std::vector<Point>& neighborhood, std::string& error);
+
+    /**
+     * @brief Advances all vertices by one generation, in parallel over vertex ranges.
+     * @param changedVertices Receives the vertices whose state changed.
+     */
+    void step(const RuleEngine& ruleEngine, std::vector<std::uint32_t>& changedVertices);
+
+    int getState(std::uint32_t vertex) const;
+    void setState(std::uint32_t vertex, int state);
+    void resetStates();
+    /**
+     * @brief Vertex displayed at a cell, or -1.
+     */
+    std::int64_t vertexAt(Point cell) const;
+    Point getPosition(std::uint32_t vertex) const;
+    /**
+     * @brief Bounding box of the display positions.
+     * @return False if no graph is loaded.
+     */
+    bool getLayoutBounds(Point& minBounds, Point& maxBounds) const;
+
+    /**
+     * @brief Display cells of all non-default vertices.
+     */
+    std::unordered_map<Point, int> toCells() const;
+    /**
+     * @brief Takes vertex states from the cells at their display positions (e.g. after a snapshot load).
+     */
+    void setStatesFromCells(const std::unordered_map<Point, int>& cells);
+
+    std::size_t getVertexCount() const;
+    std::size_t getEdgeCount() const;
+    std::uint32_t getMaxDegree() const;
+    std::uint64_t getBandwidthBefore() const;
+    std::uint64_t getBandwidthAfter() const;
+    const std::string& getPath() const;
+};
+
+#endif // GRAPH_SPACE_H
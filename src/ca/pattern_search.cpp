@@ -0,0 +1,291 @@
+#include "pattern_search.h"
+#include "cell_space.h"
+#include "../utils/logger.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <tbb/parallel_for.h>
+
+namespace {
+    constexpr std::uint64_t ROW_BASE = 0x100000001B3ULL;
+    constexpr std::uint64_t COLUMN_BASE = 0x9E3779B97F4A7C15ULL;
+    constexpr int TILE = PatternSearch::TILE_SIZE;
+
+    const char* ORIENTATION_NAMES[8] = {
+        "", "rot90", "rot180", "rot270", "flip", "flip+rot90", "flip+rot180", "flip+rot270"
+    };
+
+    std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+        std::int64_t q = value / divisor;
+        return (value % divisor != 0 && value < 0) ? q - 1 : q;
+    }
+
+    std::uint64_t packTileKey(std::int64_t tileX, std::int64_t tileY) {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(tileX)) << 32) |
+               static_cast<std::uint32_t>(tileY);
+    }
+
+    // Hash value of a cell; the default state hashes to 0 so empty space is cheap to roll over.
+    std::uint64_t cellValue(int state, int defaultState) {
+        if (state == defaultState) return 0;
+        return static_cast<std::uint64_t>(static_cast<std::uint32_t>(state)) * 0xD6E8FEB86659FD93ULL + 0x632BE59BD9B4E019ULL;
+    }
+
+    std::uint64_t power(std::uint64_t base, int exponent) {
+        std::uint64_t result = 1;
+        for (int i = 0; i < exponent; ++i) result *= base;
+        return result;
+    }
+
+    // Rotates a row-major grid 90 degrees clockwise; width and height are swapped.
+    std::vector<int> rotateClockwise(const std::vector<int>& states, int& width, int& height) {
+        std::vector<int> rotated(states.size());
+        for (int y = 0; y < width; ++y) {
+            for (int x = 0; x < height; ++x) {
+                rotated[static_cast<std::size_t>(y) * height + x] = states[static_cast<std::size_t>(height - 1 - x) * width + y];
+            }
+        }
+        std::swap(width, height);
+        return rotated;
+    }
+}
+
+PatternSearch::PatternSearch()
+    : width_(0), height_(0), defaultState_(0) {
+}
+
+bool PatternSearch::loadFromFile(const std::string& filePath, int defaultState, int aliveState) {
+    auto logger = Logger::getLogger(Logger::Module::CellSpace);
+    std::ifstream file(filePath);
+    if (!file.is_open()) {
+        if (logger) logger->error("Failed to open pattern file: " + filePath);
+        return false;
+    }
+
+    std::vector<std::string> rows;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty() && line[0] == '!') continue;
+        rows.push_back(line);
+    }
+    while (!rows.empty() && rows.back().empty()) rows.pop_back();
+
+    int width = 0;
+    for (const std::string& row : rows) width = std::max(width, static_cast<int>(row.size()));
+    int height = static_cast<int>(rows.size());
+    std::vector<int> states(static_cast<std::size_t>(width) * height, defaultState);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < static_cast<int>(rows[y].size()); ++x) {
+            char c = rows[y][x];
+            int state = defaultState;
+            if (std::isdigit(static_cast<unsigned char>(c))) {
+                state = c - '0';
+            } else if (c != '.' && c != ' ') {
+                state = aliveState;
+            }
+            states[static_cast<std::size_t>(y) * width + x] = state;
+        }
+    }
+    if (!setPattern(width, height, states, defaultState)) {
+        if (logger) logger->error("Unusable pattern in " + filePath);
+        return false;
+    }
+    return true;
+}
+
+bool PatternSearch::setPattern(int width, int height, const std::vector<int>& states, int defaultState) {
+    auto logger = Logger::getLogger(Logger::Module::CellSpace);
+    if (width <= 0 || height <= 0 || states.size() != static_cast<std::size_t>(width) * height) {
+        if (logger) logger->error("Pattern is empty or malformed.");
+        return false;
+    }
+    if (width > MAX_PATTERN_SIZE || height > MAX_PATTERN_SIZE) {
+        if (logger) logger->error("Pattern is {}x{}; at most {}x{} is supported.", width, height, MAX_PATTERN_SIZE, MAX_PATTERN_SIZE);
+        return false;
+    }
+    if (std::all_of(states.begin(), states.end(), [defaultState](int s) { return s == defaultState; })) {
+        if (logger) logger->error("Pattern has no non-default cells.");
+        return false;
+    }
+    width_ = width;
+    height_ = height;
+    defaultState_ = defaultState;
+    states_ = states;
+    buildVariants();
+    return true;
+}
+
+void PatternSearch::buildVariants() {
+    variants_.clear();
+    for (int orientation = 0; orientation < 8; ++orientation) {
+        int width = width_;
+        int height = height_;
+        std::vector<int> states = states_;
+        if (orientation & 4) {
+            for (int y = 0; y < height; ++y) {
+                std::reverse(states.begin() + static_cast<std::ptrdiff_t>(y) * width,
+                             states.begin() + static_cast<std::ptrdiff_t>(y + 1) * width);
+            }
+        }
+        for (int r = 0; r < (orientation & 3); ++r) {
+            states = rotateClockwise(states, width, height);
+        }
+
+        // Symmetric patterns repeat orientations; keep one so each placement is reported once.
+        bool duplicate = std::any_of(variants_.begin(), variants_.end(), [&](const Variant& v) {
+            return v.width == width && v.height == height && v.states == states;
+        });
+        if (duplicate) continue;
+
+        Variant variant{width, height, orientation, std::move(states), 0};
+        for (int y = 0; y < height; ++y) {
+            std::uint64_t rowHash = 0;
+            for (int x = 0; x < width; ++x) {
+                rowHash = rowHash * ROW_BASE + cellValue(variant.states[static_cast<std::size_t>(y) * width + x], defaultState_);
+            }
+            variant.hash = variant.hash * COLUMN_BASE + rowHash;
+        }
+        variants_.push_back(std::move(variant));
+    }
+}
+
+std::vector<PatternSearch::Match> PatternSearch::find(const CellSpace& cellSpace) const {
+    std::vector<Match> matches;
+    if (variants_.empty()) return matches;
+
+    auto logger = Logger::getLogger(Logger::Module::CellSpace);
+    const int defaultState = cellSpace.getDefaultState();
+    if (defaultState != defaultState_ && logger) {
+        logger->warn("Pattern was loaded for default state {}, world uses {}.", defaultState_, defaultState);
+    }
+
+    // Bin the sparse world into dense tiles.
+    std::unordered_map<std::uint64_t, std::vector<int>> tiles;
+    for (const auto& pair : cellSpace.getNonDefaultCells()) {
+        std::int64_t tileX = floorDiv(pair.first.x, TILE);
+        std::int64_t tileY = floorDiv(pair.first.y, TILE);
+        std::vector<int>& tile = tiles[packTileKey(tileX, tileY)];
+        if (tile.empty()) tile.assign(static_cast<std::size_t>(TILE) * TILE, defaultState);
+        tile[static_cast<std::size_t>(pair.first.y - tileY * TILE) * TILE + (pair.first.x - tileX * TILE)] = pair.second;
+    }
+
+    // A match window holds a non-default cell, so its top-left lies in an occupied tile or in
+    // the tile left of, above, or diagonally above-left of one (patterns are at most one tile).
+    std::unordered_set<std::uint64_t> candidateKeys;
+    std::vector<std::pair<std::int64_t, std::int64_t>> candidates;
+    for (const auto& pair : tiles) {
+        std::int64_t tileX = static_cast<std::int32_t>(pair.first >> 32);
+        std::int64_t tileY = static_cast<std::int32_t>(pair.first & 0xFFFFFFFFULL);
+        for (int dy = -1; dy <= 0; ++dy) {
+            for (int dx = -1; dx <= 0; ++dx) {
+                if (candidateKeys.insert(packTileKey(tileX + dx, tileY + dy)).second) {
+                    candidates.emplace_back(tileX + dx, tileY + dy);
+                }
+            }
+        }
+    }
+
+    // Orientations grouped by dimensions; rotations of a non-square pattern form two groups.
+    std::vector<std::pair<int, int>> dimensions;
+    for (const Variant& v : variants_) {
+        if (std::find(dimensions.begin(), dimensions.end(), std::make_pair(v.width, v.height)) == dimensions.end()) {
+            dimensions.emplace_back(v.width, v.height);
+        }
+    }
+    const int border = std::max(width_, height_) - 1;
+    const int span = TILE + border;
+
+    std::vector<std::vector<Match>> tileMatches(candidates.size());
+    tbb::parallel_for(std::size_t(0), candidates.size(), [&](std::size_t index) {
+        const std::int64_t tileX = candidates[index].first;
+        const std::int64_t tileY = candidates[index].second;
+
+        // Dense copy of this tile plus the right/bottom border that placements overlap.
+        std::vector<int> states(static_cast<std::size_t>(span) * span, defaultState);
+        for (int ny = 0; ny <= 1; ++ny) {
+            for (int nx = 0; nx <= 1; ++nx) {
+                auto it = tiles.find(packTileKey(tileX + nx, tileY + ny));
+                if (it == tiles.end()) continue;
+                int rows = std::min(TILE, span - ny * TILE);
+                int cols = std::min(TILE, span - nx * TILE);
+                for (int y = 0; y < rows; ++y) {
+                    std::copy_n(it->second.begin() + static_cast<std::ptrdiff_t>(y) * TILE, cols,
+                                states.begin() + static_cast<std::ptrdiff_t>(ny * TILE + y) * span + nx * TILE);
+                }
+            }
+        }
+
+        std::vector<std::uint64_t> rowHashes(static_cast<std::size_t>(span) * TILE);
+        for (const auto& [width, height] : dimensions) {
+            // Horizontal pass: hash of every width-long run starting in the tile.
+            const std::uint64_t rowLead = power(ROW_BASE, width - 1);
+            for (int y = 0; y < TILE + height - 1; ++y) {
+                const int* row = states.data() + static_cast<std::size_t>(y) * span;
+                std::uint64_t hash = 0;
+                for (int i = 0; i < width; ++i) hash = hash * ROW_BASE + cellValue(row[i], defaultState);
+                std::uint64_t* out = rowHashes.data() + static_cast<std::size_t>(y) * TILE;
+                out[0] = hash;
+                for (int x = 1; x < TILE; ++x) {
+                    hash = (hash - cellValue(row[x - 1], defaultState) * rowLead) * ROW_BASE +
+                           cellValue(row[x + width - 1], defaultState);
+                    out[x] = hash;
+                }
+            }
+
+            // Vertical pass over the row hashes, checking each placement against the orientations.
+            const std::uint64_t columnLead = power(COLUMN_BASE, height - 1);
+            for (int x = 0; x < TILE; ++x) {
+                std::uint64_t hash = 0;
+                for (int j = 0; j < height; ++j) hash = hash * COLUMN_BASE + rowHashes[static_cast<std::size_t>(j) * TILE + x];
+                for (int y = 0; y < TILE; ++y) {
+                    if (y > 0) {
+                        hash = (hash - rowHashes[static_cast<std::size_t>(y - 1) * TILE + x] * columnLead) * COLUMN_BASE +
+                               rowHashes[static_cast<std::size_t>(y + height - 1) * TILE + x];
+                    }
+                    for (const Variant& variant : variants_) {
+                        if (variant.hash != hash || variant.width != width || variant.height != height) continue;
+                        bool equal = true;
+                        for (int j = 0; j < height && equal; ++j) {
+                            equal = std::equal(variant.states.begin() + static_cast<std::ptrdiff_t>(j) * width,
+                                               variant.states.begin() + static_cast<std::ptrdiff_t>(j + 1) * width,
+                                               states.begin() + static_cast<std::ptrdiff_t>(y + j) * span + x);
+                        }
+                        if (equal) {
+                            tileMatches[index].push_back(Match{
+                                Point(static_cast<int>(tileX * TILE + x), static_cast<int>(tileY * TILE + y)),
+                                width, height, variant.orientation});
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    for (const auto& found : tileMatches) {
+        matches.insert(matches.end(), found.begin(), found.end());
+    }
+    std::sort(matches.begin(), matches.end(), [](const Match& a, const Match& b) {
+        return a.topLeft.y != b.topLeft.y ? a.topLeft.y < b.topLeft.y : a.topLeft.x < b.topLeft.x;
+    });
+    if (logger) logger->info("Pattern search: {} candidate tiles, {} matches.", candidates.size(), matches.size());
+    return matches;
+}
+
+int PatternSearch::getWidth() const {
+    return width_;
+}
+
+int PatternSearch::getHeight() const {
+    return height_;
+}
+
+std::size_t PatternSearch::getVariantCount() const {
+    return variants_.size();
+}
+
+const char* PatternSearch::getOrientationName(int orientation) {
+    return (orientation >= 0 && orientation < 8) ? ORIENTATION_NAMES[orientation] : "";
+}
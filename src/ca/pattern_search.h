@@ -0,0 +1,76 @@
+#ifndef PATTERN_SEARCH_H
+#define PATTERN_SEARCH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "../utils/point.h"
+
+class CellSpace;
+
+/**
+ * @class PatternSearch
+ * @brief Finds every placement of a small pattern in the world, in any of its 8 orientations.
+ *
+ * The world is binned into TILE_SIZE x TILE_SIZE tiles. Each tile that can hold the
+ * top-left corner of a match is searched in parallel: 2D Rabin-Karp hashes of all
+ * placements are rolled over a dense copy of the tile (plus the pattern-sized border it
+ * overlaps) and compared against the precomputed hashes of the distinct orientations.
+ * Candidates are verified cell by cell, so a match is always an exact window match,
+ * including the default cells inside the pattern's bounding box.
+ */
+class PatternSearch {
+public:
+    static constexpr int TILE_SIZE = 64;
+    static constexpr int MAX_PATTERN_SIZE = TILE_SIZE;
+
+    struct Match {
+        Point topLeft;
+        int width;
+        int height;
+        int orientation;    // Index into getOrientationName()
+    };
+
+private:
+    struct Variant {
+        int width;
+        int height;
+        int orientation;
+        std::vector<int> states;    // Row-major
+        std::uint64_t hash;
+    };
+
+    int width_;
+    int height_;
+    int defaultState_;
+    std::vector<int> states_;       // Row-major, as loaded
+    std::vector<Variant> variants_; // Distinct orientations
+
+    void buildVariants();
+
+public:
+    PatternSearch();
+
+    /**
+     * @brief Loads a pattern in plaintext (.cells) form: '.' is the default state, digits are
+     * explicit states and any other character is aliveState. Lines starting with '!' are comments.
+     * @return False for unreadable, empty, all-default or oversized patterns. Errors are logged.
+     */
+    bool loadFromFile(const std::string& filePath, int defaultState, int aliveState);
+    /**
+     * @brief Sets the pattern directly (row-major states).
+     */
+    bool setPattern(int width, int height, const std::vector<int>& states, int defaultState);
+
+    /**
+     * @brief Searches the whole world. Matches are sorted by row, then column.
+     */
+    std::vector<Match> find(const CellSpace& cellSpace) const;
+
+    int getWidth() const;
+    int getHeight() const;
+    std::size_t getVariantCount() const;
+    static const char* getOrientationName(int orientation);
+};
+
+#endif // PATTERN_SEARCH_H
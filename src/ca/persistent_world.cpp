@@ -0,0 +1,377 @@
+#include "persistent_world.h"
+#include "cell_space.h"
+#include "../utils/logger.h"
+#include <algorithm>
+#include <bit>
+#include <unordered_map>
+
+namespace {
+    constexpr int BITS_PER_LEVEL = 5;
+    constexpr std::uint64_t LEVEL_MASK = (1u << BITS_PER_LEVEL) - 1;
+
+    std::int32_t floorDiv(std::int32_t value, std::int32_t divisor) {
+        std::int32_t q = value / divisor;
+        return (value % divisor != 0 && value < 0) ? q - 1 : q;
+    }
+}
+
+struct PersistentWorld::Node {
+    struct Slot {
+        std::uint64_t hash;      // Chunk hash for leaves, unused for child nodes
+        const void* pointer;     // const Chunk* or const Node*
+    };
+    std::uint32_t bitmap = 0;     // Occupied slots of the 32
+    std::uint32_t leafBitmap = 0; // Occupied slots holding a chunk
+    std::uint64_t batch = 0;      // publish() that created this node
+    std::vector<Slot> slots;      // Occupied slots in index order
+};
+
+// The packing is injective and splitmix64's finalizer is a bijection, so distinct chunks
+// never share a hash and the trie needs no collision lists.
+std::uint64_t PersistentWorld::chunkHash(std::int32_t chunkX, std::int32_t chunkY) {
+    std::uint64_t x = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkX)) << 32) |
+                      static_cast<std::uint32_t>(chunkY);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+const PersistentWorld::Chunk* PersistentWorld::find(const Node* node, std::uint64_t hash) {
+    for (int shift = 0; node; shift += BITS_PER_LEVEL) {
+        std::uint32_t bit = 1u << ((hash >> shift) & LEVEL_MASK);
+        if (!(node->bitmap & bit)) return nullptr;
+        const Node::Slot& slot = node->slots[std::popcount(node->bitmap & (bit - 1))];
+        if (node->leafBitmap & bit) {
+            return slot.hash == hash ? static_cast<const Chunk*>(slot.pointer) : nullptr;
+        }
+        node = static_cast<const Node*>(slot.pointer);
+    }
+    return nullptr;
+}
+
+PersistentWorld::Node* PersistentWorld::editable(const Node* node) {
+    if (node->batch == batch_) return const_cast<Node*>(node);
+    Node* copy = new Node(*node);
+    copy->batch = batch_;
+    epochs_.retire(node);
+    ++copiedNodes_;
+    return copy;
+}
+
+const PersistentWorld::Node* PersistentWorld::insert(const Node* node, int shift, std::uint64_t hash,
+                                                     const Chunk* chunk) {
+    std::uint32_t bit = 1u << ((hash >> shift) & LEVEL_MASK);
+    if (!node) {
+        Node* created = new Node();
+        created->batch = batch_;
+        created->bitmap = bit;
+        created->leafBitmap = bit;
+        created->slots.push_back({hash, chunk});
+        ++copiedNodes_;
+        return created;
+    }
+    std::size_t position = std::popcount(node->bitmap & (bit - 1));
+    if (!(node->bitmap & bit)) {
+        Node* edited = editable(node);
+        edited->bitmap |= bit;
+        edited->leafBitmap |= bit;
+        edited->slots.insert(edited->slots.begin() + position, {hash, chunk});
+        return edited;
+    }
+    Node::Slot slot = node->slots[position];
+    if (node->leafBitmap & bit) {
+        Node* edited;
+        if (slot.hash == hash) {
+            edited = editable(node);
+            edited->slots[position].pointer = chunk;
+            return edited;
+        }
+        // Two chunks share this slot: push both one level down.
+        const Node* child = insert(insert(nullptr, shift + BITS_PER_LEVEL, slot.hash, static_cast<const Chunk*>(slot.pointer)),
+                                   shift + BITS_PER_LEVEL, hash, chunk);
+        edited = editable(node);
+        edited->leafBitmap &= ~bit;
+        edited->slots[position] = {0, child};
+        return edited;
+    }
+    const Node* child = static_cast<const Node*>(slot.pointer);
+    const Node* updated = insert(child, shift + BITS_PER_LEVEL, hash, chunk);
+    if (updated == child) return node; // Edited in place, so this node is already owned by the batch
+    Node* edited = editable(node);
+    edited->slots[position].pointer = updated;
+    return edited;
+}
+
+const PersistentWorld::Node* PersistentWorld::remove(const Node* node, int shift, std::uint64_t hash) {
+    std::uint32_t bit = 1u << ((hash >> shift) & LEVEL_MASK);
+    if (!node || !(node->bitmap & bit)) return node;
+    std::size_t position = std::popcount(node->bitmap & (bit - 1));
+    Node::Slot slot = node->slots[position];
+    if (node->leafBitmap & bit) {
+        if (slot.hash != hash) return node;
+    } else {
+        const Node* child = static_cast<const Node*>(slot.pointer);
+        const Node* updated = remove(child, shift + BITS_PER_LEVEL, hash);
+        if (updated == child) return node;
+        if (updated) {
+            Node* edited = editable(node);
+            edited->slots[position].pointer = updated;
+            return edited;
+        }
+    }
+    // The slot becomes empty.
+    if (node->slots.size() == 1) {
+        if (node->batch == batch_) {
+            delete node; // Never published
+        } else {
+            epochs_.retire(node);
+        }
+        return nullptr;
+    }
+    Node* edited = editable(node);
+    edited->bitmap &= ~bit;
+    edited->leafBitmap &= ~bit;
+    edited->slots.erase(edited->slots.begin() + position);
+    return edited;
+}
+
+void PersistentWorld::retireTree(const Node* node) {
+    if (!node) return;
+    for (std::size_t i = 0, bitIndex = 0; i < node->slots.size(); ++bitIndex) {
+        std::uint32_t bit = 1u << bitIndex;
+        if (!(node->bitmap & bit)) continue;
+        if (node->leafBitmap & bit) {
+            epochs_.retire(static_cast<const Chunk*>(node->slots[i].pointer));
+        } else {
+            retireTree(static_cast<const Node*>(node->slots[i].pointer));
+        }
+        ++i;
+    }
+    epochs_.retire(node);
+}
+
+void PersistentWorld::deleteTree(const Node* node) {
+    if (!node) return;
+    for (std::size_t i = 0, bitIndex = 0; i < node->slots.size(); ++bitIndex) {
+        std::uint32_t bit = 1u << bitIndex;
+        if (!(node->bitmap & bit)) continue;
+        if (node->leafBitmap & bit) {
+            delete static_cast<const Chunk*>(node->slots[i].pointer);
+        } else {
+            deleteTree(static_cast<const Node*>(node->slots[i].pointer));
+        }
+        ++i;
+    }
+    delete node;
+}
+
+PersistentWorld::PersistentWorld()
+    : current_(nullptr),
+      batch_(0),
+      chunkCount_(0),
+      copiedChunks_(0),
+      copiedNodes_(0) {
+}
+
+PersistentWorld::~PersistentWorld() {
+    const Version* version = current_.load();
+    if (version) {
+        deleteTree(version->root);
+        delete version;
+    }
+}
+
+void PersistentWorld::publish(CellSpace& cellSpace, std::uint64_t generation) {
+    bool reset = false;
+    std::vector<std::pair<Point, int>> changes = cellSpace.takeJournal(reset);
+    const Version* previous = current_.load();
+    const int defaultState = cellSpace.getDefaultState();
+
+    ++batch_;
+    copiedChunks_ = 0;
+    copiedNodes_ = 0;
+    const Node* root = previous ? previous->root : nullptr;
+    if (reset || !previous || previous->defaultState != defaultState) {
+        retireTree(root);
+        root = nullptr;
+        chunkCount_ = 0;
+        changes.assign(cellSpace.getNonDefaultCells().begin(), cellSpace.getNonDefaultCells().end());
+    }
+
+    // Copy-on-write: each touched chunk is copied once per publish, then edited in place.
+    struct PendingChunk {
+        Chunk* chunk;
+        const Chunk* replaced;
+    };
+    std::unordered_map<std::uint64_t, PendingChunk> pending;
+    for (const auto& change : changes) {
+        std::int32_t chunkX = floorDiv(change.first.x, CHUNK_SIZE);
+        std::int32_t chunkY = floorDiv(change.first.y, CHUNK_SIZE);
+        std::uint64_t hash = chunkHash(chunkX, chunkY);
+        auto it = pending.find(hash);
+        if (it == pending.end()) {
+            const Chunk* replaced = find(root, hash);
+            Chunk* chunk = new Chunk();
+            if (replaced) {
+                *chunk = *replaced;
+            } else {
+                chunk->chunkX = chunkX;
+                chunk->chunkY = chunkY;
+                std::fill(std::begin(chunk->states), std::end(chunk->states), defaultState);
+            }
+            it = pending.emplace(hash, PendingChunk{chunk, replaced}).first;
+        }
+        Chunk* chunk = it->second.chunk;
+        int& cell = chunk->states[(change.first.y - chunkY * CHUNK_SIZE) * CHUNK_SIZE + (change.first.x - chunkX * CHUNK_SIZE)];
+        if (cell != defaultState) --chunk->population;
+        cell = change.second;
+        if (cell != defaultState) ++chunk->population;
+    }
+    copiedChunks_ = pending.size();
+
+    for (const auto& entry : pending) {
+        const PendingChunk& update = entry.second;
+        if (update.chunk->population == 0) {
+            if (update.replaced) {
+                root = remove(root, 0, entry.first);
+                --chunkCount_;
+            }
+            delete update.chunk;
+        } else {
+            root = insert(root, 0, entry.first, update.chunk);
+            if (!update.replaced) ++chunkCount_;
+        }
+        if (update.replaced) epochs_.retire(update.replaced);
+    }
+
+    Version* version = new Version();
+    version->root = root;
+    version->generation = generation;
+    version->population = cellSpace.getNonDefaultCells().size();
+    version->chunkCount = chunkCount_;
+    version->boundsValid = cellSpace.areBoundsInitialized() && version->population > 0;
+    version->minBounds = cellSpace.getMinBounds();
+    version->maxBounds = cellSpace.getMaxBounds();
+    version->defaultState = defaultState;
+    version->hash = cellSpace.getHash();
+    current_.store(version);
+    if (previous) epochs_.retire(previous);
+    epochs_.advance();
+
+    auto logger = Logger::getLogger(Logger::Module::CellSpace);
+    if (logger) logger->trace("Published generation {}: {} chunks copied, {} nodes copied, {} retired objects pending.",
+                              generation, copiedChunks_, copiedNodes_, epochs_.getRetiredCount());
+}
+
+PersistentWorld::WorldView PersistentWorld::view() {
+    EpochManager::Guard guard = epochs_.pin();
+    const Version* version = current_.load();
+    return WorldView(std::move(guard), version);
+}
+
+PersistentWorld::WorldView PersistentWorld::tryView() {
+    EpochManager::Guard guard = epochs_.tryPin();
+    if (!guard.isActive()) return WorldView();
+    const Version* version = current_.load();
+    return WorldView(std::move(guard), version);
+}
+
+std::size_t PersistentWorld::getChunkCount() const {
+    return chunkCount_;
+}
+
+std::size_t PersistentWorld::getLastCopiedChunks() const {
+    return copiedChunks_;
+}
+
+std::size_t PersistentWorld::getLastCopiedNodes() const {
+    return copiedNodes_;
+}
+
+std::size_t PersistentWorld::getRetiredCount() const {
+    return epochs_.getRetiredCount();
+}
+
+PersistentWorld::WorldView::WorldView()
+    : version_(nullptr) {
+}
+
+PersistentWorld::WorldView::WorldView(EpochManager::Guard guard, const Version* version)
+    : guard_(std::move(guard)),
+      version_(version) {
+}
+
+PersistentWorld::WorldView::WorldView(WorldView&& other) noexcept
+    : guard_(std::move(other.guard_)),
+      version_(other.version_) {
+    other.version_ = nullptr;
+}
+
+PersistentWorld::WorldView& PersistentWorld::WorldView::operator=(WorldView&& other) noexcept {
+    if (this != &other) {
+        guard_ = std::move(other.guard_);
+        version_ = other.version_;
+        other.version_ = nullptr;
+    }
+    return *this;
+}
+
+bool PersistentWorld::WorldView::isValid() const {
+    return version_ != nullptr;
+}
+
+const PersistentWorld::Version& PersistentWorld::WorldView::getVersion() const {
+    return *version_;
+}
+
+int PersistentWorld::WorldView::getCellState(Point coordinates) const {
+    std::int32_t chunkX = floorDiv(coordinates.x, CHUNK_SIZE);
+    std::int32_t chunkY = floorDiv(coordinates.y, CHUNK_SIZE);
+    const Chunk* chunk = find(version_->root, chunkHash(chunkX, chunkY));
+    if (!chunk) return version_->defaultState;
+    return chunk->states[(coordinates.y - chunkY * CHUNK_SIZE) * CHUNK_SIZE + (coordinates.x - chunkX * CHUNK_SIZE)];
+}
+
+const PersistentWorld::Chunk* PersistentWorld::WorldView::findChunk(std::int32_t chunkX, std::int32_t chunkY) const {
+    if (!version_) return nullptr;
+    return find(version_->root, chunkHash(chunkX, chunkY));
+}
+
+void PersistentWorld::WorldView::forEachChunk(const std::function<void(const Chunk&)>& visitor) const {
+    if (!version_) return;
+    std::vector<const Node*> stack;
+    if (version_->root) stack.push_back(version_->root);
+    while (!stack.empty()) {
+        const Node* node = stack.back();
+        stack.pop_back();
+        for (std::size_t i = 0, bitIndex = 0; i < node->slots.size(); ++bitIndex) {
+            std::uint32_t bit = 1u << bitIndex;
+            if (!(node->bitmap & bit)) continue;
+            if (node->leafBitmap & bit) {
+                visitor(*static_cast<const Chunk*>(node->slots[i].pointer));
+            } else {
+                stack.push_back(static_cast<const Node*>(node->slots[i].pointer));
+            }
+            ++i;
+        }
+    }
+}
+
+void PersistentWorld::WorldView::forEachCell(const std::function<void(Point, int)>& visitor) const {
+    const int defaultState = version_ ? version_->defaultState : 0;
+    forEachChunk([&](const Chunk& chunk) {
+        const int originX = chunk.chunkX * CHUNK_SIZE;
+        const int originY = chunk.chunkY * CHUNK_SIZE;
+        for (int y = 0; y < CHUNK_SIZE; ++y) {
+            for (int x = 0; x < CHUNK_SIZE; ++x) {
+                int state = chunk.states[y * CHUNK_SIZE + x];
+                if (state != defaultState) visitor(Point(originX + x, originY + y), state);
+            }
+        }
+    });
+}
+
+void PersistentWorld::WorldView::release() {
+    guard_.release();
+    version_ = nullptr;
+}
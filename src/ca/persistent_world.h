@@ -0,0 +1,139 @@
+#ifndef PERSISTENT_WORLD_H
+#define PERSISTENT_WORLD_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "../utils/epoch_manager.h"
+#include "../utils/point.h"
+
+class CellSpace;
+
+/**
+ * @class PersistentWorld
+ * @brief Immutable, structurally shared versions of a CellSpace for readers on other threads.
+ *
+ * Cells are stored in CHUNK_SIZE x CHUNK_SIZE chunks held by a hash array mapped trie (32-way,
+ * bitmap-compressed nodes) keyed by a bijective hash of the chunk coordinates. publish() copies
+ * only the chunks touched since the previous version plus the trie nodes on their paths; all
+ * other chunks and nodes are shared with the previous version. The replaced chunks, nodes and
+ * version header are retired through an EpochManager, so a reader holding a WorldView keeps a
+ * consistent world without locks while the simulation moves on.
+ *
+ * publish() must be called from a single (simulation) thread; view() from any thread.
+ */
+class PersistentWorld {
+public:
+    static constexpr int CHUNK_SIZE = 32;
+    static constexpr int CHUNK_AREA = CHUNK_SIZE * CHUNK_SIZE;
+
+    struct Chunk {
+        std::int32_t chunkX = 0;
+        std::int32_t chunkY = 0;
+        std::uint32_t population = 0;  // Non-default cells
+        int states[CHUNK_AREA];        // Row-major, local (x, y) -> y * CHUNK_SIZE + x
+    };
+
+    struct Node;
+
+    /**
+     * @brief Header of one published generation.
+     */
+    struct Version {
+        const Node* root = nullptr;
+        std::uint64_t generation = 0;
+        std::size_t population = 0;
+        std::size_t chunkCount = 0;
+        bool boundsValid = false;
+        Point minBounds;
+        Point maxBounds;
+        int defaultState = 0;
+        std::uint64_t hash = 0;        // CellSpace::getHash() of this generation
+    };
+
+    /**
+     * @class WorldView
+     * @brief A pinned, read-only version. Movable; unpins when destroyed.
+     */
+    class WorldView {
+    private:
+        EpochManager::Guard guard_;
+        const Version* version_;
+
+    public:
+        WorldView();
+        WorldView(EpochManager::Guard guard, const Version* version);
+        WorldView(WorldView&& other) noexcept;
+        WorldView& operator=(WorldView&& other) noexcept;
+
+        bool isValid() const;
+        const Version& getVersion() const;
+        int getCellState(Point coordinates) const;
+        /**
+         * @brief The chunk with the given chunk coordinates, or nullptr if all its cells are default.
+         */
+        const Chunk* findChunk(std::int32_t chunkX, std::int32_t chunkY) const;
+        void forEachChunk(const std::function<void(const Chunk&)>& visitor) const;
+        /**
+         * @brief Visits every non-default cell.
+         */
+        void forEachCell(const std::function<void(Point, int)>& visitor) const;
+        /**
+         * @brief Unpins the version early.
+         */
+        void release();
+    };
+
+private:
+    EpochManager epochs_;
+    std::atomic<const Version*> current_;
+    std::uint64_t batch_;              // Nodes created during the running publish() are edited in place
+    std::size_t chunkCount_;
+    std::size_t copiedChunks_;         // Statistics of the last publish()
+    std::size_t copiedNodes_;
+
+    static std::uint64_t chunkHash(std::int32_t chunkX, std::int32_t chunkY);
+    static const Chunk* find(const Node* root, std::uint64_t hash);
+
+    Node* editable(const Node* node);
+    const Node* insert(const Node* node, int shift, std::uint64_t hash, const Chunk* chunk);
+    const Node* remove(const Node* node, int shift, std::uint64_t hash);
+    void retireTree(const Node* node);
+    static void deleteTree(const Node* node);
+
+public:
+    PersistentWorld();
+    /**
+     * @brief Frees all versions. No WorldView may outlive the PersistentWorld.
+     */
+    ~PersistentWorld();
+
+    PersistentWorld(const PersistentWorld&) = delete;
+    PersistentWorld& operator=(const PersistentWorld&) = delete;
+
+    /**
+     * @brief Publishes the current contents of cellSpace as a new version.
+     *
+     * Consumes cellSpace's change journal (which must be enabled); after a load or clear
+     * the whole world is rebuilt, otherwise only the chunks of changed cells are copied.
+     */
+    void publish(CellSpace& cellSpace, std::uint64_t generation);
+
+    /**
+     * @brief Pins and returns the latest published version.
+     */
+    WorldView view();
+
+    /**
+     * @brief Like view(), but returns an invalid view instead of waiting when every reader slot is pinned.
+     */
+    WorldView tryView();
+
+    std::size_t getChunkCount() const;
+    std::size_t getLastCopiedChunks() const;
+    std::size_t getLastCopiedNodes() const;
+    std::size_t getRetiredCount() const;
+};
+
+#endif // PERSISTENT_WORLD_H
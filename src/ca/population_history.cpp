@@ -0,0 +1,109 @@
+#include "population_history.h"
+#include "cell_space.h"
+#include "../utils/logger.h"
+#include <fstream>
+
+PopulationHistory::PopulationHistory(std::size_t capacity)
+    : capacity_(capacity > 0 ? capacity : 1),
+      start_(0),
+      size_(0) {
+    generations_.resize(capacity_);
+}
+
+void PopulationHistory::reset(const std::vector<int>& states, int defaultState) {
+    states_.clear();
+    for (int state : states) {
+        if (state != defaultState) states_.push_back(state);
+    }
+    counts_.assign(capacity_ * states_.size(), 0);
+    clear();
+}
+
+void PopulationHistory::clear() {
+    start_ = 0;
+    size_ = 0;
+}
+
+std::size_t PopulationHistory::rowIndex(std::size_t index) const {
+    return (start_ + index) % capacity_;
+}
+
+void PopulationHistory::record(std::uint64_t generation, const CellSpace& cellSpace) {
+    std::size_t row;
+    if (size_ > 0 && generations_[rowIndex(size_ - 1)] == generation) {
+        row = rowIndex(size_ - 1); // Edit between generations: refresh the newest sample
+    } else {
+        if (size_ > 0 && generations_[rowIndex(size_ - 1)] > generation) {
+            clear(); // World was reset or reloaded at an earlier generation
+        }
+        if (size_ < capacity_) {
+            row = rowIndex(size_);
+            ++size_;
+        } else {
+            row = start_;
+            start_ = (start_ + 1) % capacity_;
+        }
+    }
+
+    generations_[row] = generation;
+    std::size_t* columns = counts_.data() + row * states_.size();
+    for (std::size_t i = 0; i < states_.size(); ++i) {
+        columns[i] = cellSpace.getStateCount(states_[i]);
+    }
+}
+
+std::size_t PopulationHistory::size() const {
+    return size_;
+}
+
+std::size_t PopulationHistory::getCapacity() const {
+    return capacity_;
+}
+
+const std::vector<int>& PopulationHistory::getStates() const {
+    return states_;
+}
+
+std::uint64_t PopulationHistory::getGeneration(std::size_t index) const {
+    return generations_[rowIndex(index)];
+}
+
+std::size_t PopulationHistory::getCount(std::size_t index, std::size_t stateIndex) const {
+    return counts_[rowIndex(index) * states_.size() + stateIndex];
+}
+
+std::size_t PopulationHistory::getTotal(std::size_t index) const {
+    std::size_t total = 0;
+    for (std::size_t i = 0; i < states_.size(); ++i) {
+        total += getCount(index, i);
+    }
+    return total;
+}
+
+bool PopulationHistory::writeCsv(const std::string& filePath) const {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    std::ofstream out(filePath);
+    if (!out.is_open()) {
+        if (logger) logger->error("Failed to open population CSV for writing: " + filePath);
+        return false;
+    }
+    out << "generation,total";
+    for (int state : states_) {
+        out << ",state_" << state;
+    }
+    out << '\n';
+    for (std::size_t i = 0; i < size_; ++i) {
+        out << getGeneration(i) << ',' << getTotal(i);
+        for (std::size_t s = 0; s < states_.size(); ++s) {
+            out << ',' << getCount(i, s);
+        }
+        out << '\n';
+    }
+    out.close();
+    if (!out) {
+        if (logger) logger->error("Failed to write population CSV: " + filePath);
+        return false;
+    }
+    if (logger) logger->info("Population history ({} samples) written to {}", size_, filePath);
+    return true;
+}
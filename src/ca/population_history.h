@@ -0,0 +1,58 @@
+#ifndef POPULATION_HISTORY_H
+#define POPULATION_HISTORY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CellSpace;
+
+/**
+ * @class PopulationHistory
+ * @brief Fixed-size ring buffer of per-state cell counts, one sample per generation.
+ *
+ * Samples are read from CellSpace's incrementally maintained counts, so recording is
+ * O(number of states) and never scans the world. Index 0 is the oldest retained sample.
+ */
+class PopulationHistory {
+private:
+    std::vector<int> states_;                 // Tracked (non-default) states, column order
+    std::vector<std::uint64_t> generations_;  // Ring of generation numbers
+    std::vector<std::size_t> counts_;         // Ring of rows, states_.size() counts each
+    std::size_t capacity_;
+    std::size_t start_;                       // Ring index of the oldest sample
+    std::size_t size_;
+
+    std::size_t rowIndex(std::size_t index) const;
+
+public:
+    explicit PopulationHistory(std::size_t capacity = 4096);
+
+    /**
+     * @brief Clears the history and sets the states to track (the default state is skipped).
+     */
+    void reset(const std::vector<int>& states, int defaultState);
+    void clear();
+
+    /**
+     * @brief Appends the counts of cellSpace for a generation.
+     * Re-recording the newest generation replaces it; an older generation restarts the history.
+     */
+    void record(std::uint64_t generation, const CellSpace& cellSpace);
+
+    std::size_t size() const;
+    std::size_t getCapacity() const;
+    const std::vector<int>& getStates() const;
+    std::uint64_t getGeneration(std::size_t index) const;
+    std::size_t getCount(std::size_t index, std::size_t stateIndex) const;
+    std::size_t getTotal(std::size_t index) const;
+
+    /**
+     * @brief Writes "generation,total,state_<s>..." rows for every retained sample.
+     * @return False if the file could not be written. Errors are logged.
+     */
+    bool writeCsv(const std::string& filePath) const;
+};
+
+#endif // POPULATION_HISTORY_H
@@ -0,0 +1,99 @@
+#ifndef REACTION_DIFFUSION_H
+#define REACTION_DIFFUSION_H
+
+#include <cstdint>
+#include <vector>
+#include "../core/rule.h"
+
+/**
+ * @class ReactionDiffusionField
+ * @brief Dense two-channel float world for Gray-Scott reaction-diffusion rules.
+ *
+ * u and v are stored as separate arrays (structure of arrays) with a one-cell halo on every
+ * side, so the stencil loop over a row has no wrap-around branches and vectorizes: the halo
+ * is refreshed from the opposite edges before each step, giving a periodic field. Each step
+ * reads the current buffers and writes the next ones, which are then swapped; rows are
+ * split into bands processed in parallel.
+ */
+class ReactionDiffusionField {
+private:
+    ReactionDiffusionSettings settings_;
+    int width_;
+    int height_;
+    int stride_;                  // width + 2 halo columns
+    std::vector<float> u_;        // (height + 2) * stride, row 0 and column 0 are halo
+    std::vector<float> v_;
+    std::vector<float> nextU_;
+    std::vector<float> nextV_;
+    std::uint64_t version_;       // Bumped on every change; lets the renderer skip unchanged uploads
+
+    std::size_t index(int x, int y) const { return static_cast<std::size_t>(y + 1) * stride_ + (x + 1); }
+    void refreshHalo();
+    template <int STENCIL>
+    void integrateRows(int firstRow, int endRow);
+
+public:
+    ReactionDiffusionField();
+
+    ReactionDiffusionField(const ReactionDiffusionField&) = delete;
+    ReactionDiffusionField& operator=(const ReactionDiffusionField&) = delete;
+
+    /**
+     * @brief Allocates a field of the configured size and resets it to u = 1, v = 0.
+     */
+    void configure(const ReactionDiffusionSettings& settings);
+
+    /**
+     * @brief Releases the field (the current rule is not a reaction-diffusion rule).
+     */
+    void clear();
+    bool isConfigured() const;
+
+    /**
+     * @brief Sets every cell to the trivial steady state u = 1, v = 0.
+     */
+    void reset();
+
+    /**
+     * @brief Paints a square of cells: state 0 resets them, any other state seeds
+     * u = 0.5, v = 0.25. Cells outside the field are ignored.
+     */
+    void paint(int centerX, int centerY, int halfSize, int state);
+
+    /**
+     * @brief Seeds count random squares of side 2 * halfSize + 1.
+     */
+    void seedRandom(int count, int halfSize, std::uint32_t seed);
+
+    /**
+     * @brief Advances the field by settings.stepsPerGeneration integration steps.
+     */
+    void step();
+
+    int getWidth() const;
+    int getHeight() const;
+    const ReactionDiffusionSettings& getSettings() const;
+    std::uint64_t getVersion() const;
+
+    float getU(int x, int y) const;
+    float getV(int x, int y) const;
+
+    /**
+     * @brief Pointers to the first cell of row y; the row holds getWidth() values.
+     */
+    const float* rowU(int y) const;
+    const float* rowV(int y) const;
+
+    /**
+     * @brief Replaces both channels with row-major width * height arrays (snapshot loading).
+     * @return False if the sizes do not match the configured field.
+     */
+    bool setChannels(int width, int height, const std::vector<float>& u, const std::vector<float>& v);
+
+    /**
+     * @brief Mean of v over the field, a cheap activity measure.
+     */
+    double getMeanV() const;
+};
+
+#endif // REACTION_DIFFUSION_H
@@ -4,6 +4,7 @@
 #include <filesystem>   // For path manipulation (C++17)
 #include <unordered_map> // Make sure it's included
 #include "../utils/timer.h"
+#include "../utils/metrics.h"
 
 // Constructor
 RuleEngine::RuleEngine()
@@ -97,6 +98,7 @@ bool RuleEngine::initialize(const Rule& config) {
     if (logger) logger->info("Start to initialize rule engine.");
     initialized_ = false;
     unloadRuleLibrary();
+    generationsEngine_.reset();
 
     if (!config.isLoaded()) {
         if (logger) logger->error("Cannot initialize. Configuration is not loaded.");
@@ -106,6 +108,29 @@ bool RuleEngine::initialize(const Rule& config) {
     neighborhood_ = config.getNeighborhood();
     defaultState_ = config.getDefaultState();
 
+    if (config.getDimensions() == 3) {
+        // Voxel worlds are stepped by VoxelSpace; there is no 2D rule to evaluate.
+        if (logger) logger->info("Rule engine initialized for 3D rule " + config.getRulestring() + ".");
+        initialized_ = true;
+        return true;
+    }
+
+    if (config.getRuleType() == Rule::RuleType::ReactionDiffusion) {
+        // Float fields are stepped by ReactionDiffusionField.
+        if (logger) logger->info("Rule engine initialized for a reaction-diffusion rule.");
+        initialized_ = true;
+        return true;
+    }
+
+    if (config.getRuleType() == Rule::RuleType::Generations) {
+        generationsEngine_ = std::make_unique<GenerationsEngine>(static_cast<std::uint16_t>(config.getBirthMask()),
+                                                                 static_cast<std::uint16_t>(config.getSurvivalMask()),
+                                                                 config.getGenerationCount());
+        if (logger) logger->info("Rule engine initialized with built-in generations rule " + config.getRulestring() + ".");
+        initialized_ = true;
+        return true;
+    }
+
     std::string dllPathFromConfig = config.getRuleDllPath();
     std::string funcName = config.getRuleFunctionName();
     if (!loadRuleLibrary(dllPathFromConfig, funcName)) {
@@ -121,6 +146,7 @@ bool RuleEngine::initialize(const Rule& config) {
 std::unordered_map<Point, int> RuleEngine::calculateForUpdate(const CellSpace& currentCellSpace) const {
     auto logger = Logger::getLogger(Logger::Module::RuleEngine);
     auto timer = Timer::getTimer(Timer::Module::calculateForUpdate);
+    Metrics::ScopedObservation stepObservation(Metrics::Histogram::StepSeconds);
     timer.start();
 
     std::unordered_map<Point, int> cellsToUpdate;
@@ -131,6 +157,15 @@ std::unordered_map<Point, int> RuleEngine::calculateForUpdate(const CellSpace& c
         timer.stop();
     }
 
+    if (generationsEngine_) {
+        cellsToUpdate = generationsEngine_->calculateForUpdate(currentCellSpace);
+        Metrics::increment(Metrics::Counter::Generations);
+        Metrics::increment(Metrics::Counter::CellsEvaluated, currentCellSpace.getNonDefaultCells().size());
+        timer.setItemCount(currentCellSpace.getNonDefaultCells().size());
+        timer.stop();
+        return cellsToUpdate;
+    }
+
     const auto& cellsToEvaluate = currentCellSpace.getCellsToEvaluate();
 
     for (const Point& cellCoord : cellsToEvaluate) {
@@ -150,10 +185,22 @@ std::unordered_map<Point, int> RuleEngine::calculateForUpdate(const CellSpace& c
             cellsToUpdate[cellCoord] = nextState; // Insert/update in the map
         }
     }
+    Metrics::increment(Metrics::Counter::Generations);
+    Metrics::increment(Metrics::Counter::CellsEvaluated, cellsToEvaluate.size());
+    timer.setItemCount(cellsToEvaluate.size());
     timer.stop();
     return cellsToUpdate;
 }
 
+int RuleEngine::applyRule(const std::vector<int>& neighborStates) const {
+    return applyRule(neighborStates.empty() ? nullptr : neighborStates.data());
+}
+
+int RuleEngine::applyRule(const int* neighborStates) const {
+    if (generationsEngine_) return generationsEngine_->applyRule(neighborStates);
+    return dllRuleFunction_(neighborStates);
+}
+
 bool RuleEngine::isInitialized() const {
     return initialized_;
 }
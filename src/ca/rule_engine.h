@@ -4,8 +4,10 @@
 #include <vector>
 #include <string>
 #include <unordered_map> // Added for the return type
+#include <memory>
 #include "../core/rule.h"
 #include "cell_space.h"
+#include "generations_engine.h"
 #include "../utils/point.h" // For Point, and std::hash<Point> via cell_space.h or directly
 
 // Platform-specific includes for dynamic library loading
@@ -29,6 +31,9 @@ private:
 #endif
     RuleUpdateFunction dllRuleFunction_;
 
+    // Built-in engine (used if the rule type is "generations")
+    std::unique_ptr<GenerationsEngine> generationsEngine_;
+
     std::vector<Point> neighborhood_;
     int defaultState_;
     bool initialized_;
@@ -60,6 +65,13 @@ public:
      */
     std::unordered_map<Point, int> calculateForUpdate(const CellSpace& currentCellSpace) const;
 
+    /**
+     * @brief Applies the rule to one neighborhood (states in the order of the rule's neighborhood).
+     * Used by reference implementations that do not go through CellSpace.
+     */
+    int applyRule(const std::vector<int>& neighborStates) const;
+    int applyRule(const int* neighborStates) const;
+
     /**
      * @brief Checks if the RuleEngine has been successfully initialized.
      * @return True if initialized, false otherwise.
@@ -0,0 +1,330 @@
+#include "voxel_space.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_set>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+
+namespace {
+    constexpr int CS = VoxelSpace::CHUNK_SIZE;
+    constexpr int PADDED = CS + 2;
+    constexpr int MAX_COUNT = 26;
+
+    std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+        std::int64_t q = value / divisor;
+        return (value % divisor != 0 && value < 0) ? q - 1 : q;
+    }
+
+    inline int localIndex(int x, int y, int z) {
+        return (z * CS + y) * CS + x;
+    }
+
+    // Transition table next[state * 27 + count], built from the Generations semantics.
+    std::vector<std::uint8_t> buildTransitions(std::uint32_t birthMask, std::uint32_t survivalMask, int stateCount) {
+        std::vector<std::uint8_t> table(static_cast<std::size_t>(stateCount) * (MAX_COUNT + 1), 0);
+        for (int state = 0; state < stateCount; ++state) {
+            for (int count = 0; count <= MAX_COUNT; ++count) {
+                int next;
+                if (state == 0) {
+                    next = (birthMask >> count) & 1u;
+                } else if (state == 1 && ((survivalMask >> count) & 1u)) {
+                    next = 1;
+                } else {
+                    next = (state + 1 >= stateCount) ? 0 : state + 1;
+                }
+                table[static_cast<std::size_t>(state) * (MAX_COUNT + 1) + count] = static_cast<std::uint8_t>(next);
+            }
+        }
+        return table;
+    }
+}
+
+VoxelSpace::VoxelSpace()
+    : birthMask_(0),
+      survivalMask_(0),
+      stateCount_(2),
+      neighborhood_(Neighborhood::Moore),
+      population_(0),
+      transitions_(buildTransitions(0, 0, 2)) {
+}
+
+std::uint64_t VoxelSpace::packChunkKey(std::int64_t chunkX, std::int64_t chunkY, std::int64_t chunkZ) {
+    constexpr std::uint64_t MASK = (1ULL << 21) - 1; // 21 bits per axis: +-2^20 chunks
+    return ((static_cast<std::uint64_t>(chunkX) & MASK) << 42) |
+           ((static_cast<std::uint64_t>(chunkY) & MASK) << 21) |
+           (static_cast<std::uint64_t>(chunkZ) & MASK);
+}
+
+void VoxelSpace::configure(std::uint32_t birthMask, std::uint32_t survivalMask, int stateCount, Neighborhood neighborhood) {
+    birthMask_ = birthMask;
+    survivalMask_ = survivalMask;
+    stateCount_ = std::clamp(stateCount, 2, 256);
+    neighborhood_ = neighborhood;
+    transitions_ = buildTransitions(birthMask_, survivalMask_, stateCount_);
+    clear();
+}
+
+int VoxelSpace::getState(Point3 p) const {
+    std::int64_t chunkX = floorDiv(p.x, CS), chunkY = floorDiv(p.y, CS), chunkZ = floorDiv(p.z, CS);
+    auto it = chunks_.find(packChunkKey(chunkX, chunkY, chunkZ));
+    if (it == chunks_.end()) return 0;
+    return it->second->states[localIndex(static_cast<int>(p.x - chunkX * CS), static_cast<int>(p.y - chunkY * CS),
+                                         static_cast<int>(p.z - chunkZ * CS))];
+}
+
+void VoxelSpace::setState(Point3 p, int state) {
+    if (state < 0 || state >= stateCount_) state = 0;
+    std::int64_t chunkX = floorDiv(p.x, CS), chunkY = floorDiv(p.y, CS), chunkZ = floorDiv(p.z, CS);
+    std::uint64_t key = packChunkKey(chunkX, chunkY, chunkZ);
+    auto it = chunks_.find(key);
+    if (it == chunks_.end()) {
+        if (state == 0) return;
+        auto chunk = std::make_unique<Chunk>();
+        chunk->chunkX = static_cast<std::int32_t>(chunkX);
+        chunk->chunkY = static_cast<std::int32_t>(chunkY);
+        chunk->chunkZ = static_cast<std::int32_t>(chunkZ);
+        it = chunks_.emplace(key, std::move(chunk)).first;
+    }
+    Chunk& chunk = *it->second;
+    std::uint8_t& cell = chunk.states[localIndex(static_cast<int>(p.x - chunkX * CS), static_cast<int>(p.y - chunkY * CS),
+                                                 static_cast<int>(p.z - chunkZ * CS))];
+    if (cell == state) return;
+    if (cell == 0) { ++chunk.population; ++population_; }
+    if (state == 0) { --chunk.population; --population_; }
+    cell = static_cast<std::uint8_t>(state);
+    if (state == 1) chunk.hasFiring = true; // May stay set after the cell changes; it only widens step()
+    if (chunk.population == 0) chunks_.erase(it);
+}
+
+template <VoxelSpace::Neighborhood N>
+std::unique_ptr<VoxelSpace::Chunk> VoxelSpace::stepChunk(std::int64_t chunkX, std::int64_t chunkY, std::int64_t chunkZ) const {
+    const Chunk* around[3][3][3];
+    for (int dz = -1; dz <= 1; ++dz) {
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                auto it = chunks_.find(packChunkKey(chunkX + dx, chunkY + dy, chunkZ + dz));
+                around[dz + 1][dy + 1][dx + 1] = (it != chunks_.end()) ? it->second.get() : nullptr;
+            }
+        }
+    }
+    const Chunk* center = around[1][1][1];
+
+    // Firing cells of the chunk plus a one-cell halo from the 26 surrounding chunks.
+    static thread_local std::uint8_t firing[PADDED][PADDED][PADDED];
+    for (int pz = 0; pz < PADDED; ++pz) {
+        int zi = pz == 0 ? 0 : (pz == PADDED - 1 ? 2 : 1);
+        int lz = pz == 0 ? CS - 1 : (pz == PADDED - 1 ? 0 : pz - 1);
+        for (int py = 0; py < PADDED; ++py) {
+            int yi = py == 0 ? 0 : (py == PADDED - 1 ? 2 : 1);
+            int ly = py == 0 ? CS - 1 : (py == PADDED - 1 ? 0 : py - 1);
+            std::uint8_t* row = firing[pz][py];
+            const Chunk* left = around[zi][yi][0];
+            const Chunk* middle = around[zi][yi][1];
+            const Chunk* right = around[zi][yi][2];
+            row[0] = left ? left->states[localIndex(CS - 1, ly, lz)] == 1 : 0;
+            row[PADDED - 1] = right ? right->states[localIndex(0, ly, lz)] == 1 : 0;
+            if (middle) {
+                const std::uint8_t* source = middle->states + localIndex(0, ly, lz);
+                for (int x = 0; x < CS; ++x) row[x + 1] = source[x] == 1;
+            } else {
+                std::fill(row + 1, row + 1 + CS, std::uint8_t(0));
+            }
+        }
+    }
+
+    static thread_local std::uint8_t count[CS][CS][CS];
+    if constexpr (N == Neighborhood::Moore) {
+        // Separable 3x3x3 box sum, minus the cell itself.
+        static thread_local std::uint8_t sumX[PADDED][PADDED][CS];
+        static thread_local std::uint8_t sumXY[PADDED][CS][CS];
+        for (int pz = 0; pz < PADDED; ++pz) {
+            for (int py = 0; py < PADDED; ++py) {
+                const std::uint8_t* row = firing[pz][py];
+                for (int x = 0; x < CS; ++x) sumX[pz][py][x] = row[x] + row[x + 1] + row[x + 2];
+            }
+            for (int y = 0; y < CS; ++y) {
+                for (int x = 0; x < CS; ++x) sumXY[pz][y][x] = sumX[pz][y][x] + sumX[pz][y + 1][x] + sumX[pz][y + 2][x];
+            }
+        }
+        for (int z = 0; z < CS; ++z) {
+            for (int y = 0; y < CS; ++y) {
+                for (int x = 0; x < CS; ++x) {
+                    count[z][y][x] = sumXY[z][y][x] + sumXY[z + 1][y][x] + sumXY[z + 2][y][x] - firing[z + 1][y + 1][x + 1];
+                }
+            }
+        }
+    } else {
+        for (int z = 0; z < CS; ++z) {
+            for (int y = 0; y < CS; ++y) {
+                for (int x = 0; x < CS; ++x) {
+                    count[z][y][x] = firing[z + 1][y + 1][x] + firing[z + 1][y + 1][x + 2] +
+                                     firing[z + 1][y][x + 1] + firing[z + 1][y + 2][x + 1] +
+                                     firing[z][y + 1][x + 1] + firing[z + 2][y + 1][x + 1];
+                }
+            }
+        }
+    }
+
+    auto result = std::make_unique<Chunk>();
+    result->chunkX = static_cast<std::int32_t>(chunkX);
+    result->chunkY = static_cast<std::int32_t>(chunkY);
+    result->chunkZ = static_cast<std::int32_t>(chunkZ);
+    std::uint32_t population = 0;
+    bool hasFiring = false;
+    const std::uint8_t* counts = &count[0][0][0];
+    for (int i = 0; i < CHUNK_VOLUME; ++i) {
+        std::uint8_t state = center ? center->states[i] : 0;
+        std::uint8_t next = transitions_[static_cast<std::size_t>(state) * (MAX_COUNT + 1) + counts[i]];
+        result->states[i] = next;
+        population += next != 0;
+        hasFiring |= next == 1;
+    }
+    if (population == 0) return nullptr;
+    result->population = population;
+    result->hasFiring = hasFiring;
+    return result;
+}
+
+void VoxelSpace::step() {
+    if (chunks_.empty()) return;
+
+    // Occupied chunks change through survival and decay; births only happen next to firing cells.
+    std::vector<Point3> work;
+    std::unordered_set<std::uint64_t> queued;
+    auto enqueue = [&](std::int64_t chunkX, std::int64_t chunkY, std::int64_t chunkZ) {
+        if (queued.insert(packChunkKey(chunkX, chunkY, chunkZ)).second) {
+            work.emplace_back(static_cast<int>(chunkX), static_cast<int>(chunkY), static_cast<int>(chunkZ));
+        }
+    };
+    for (const auto& pair : chunks_) {
+        const Chunk& chunk = *pair.second;
+        enqueue(chunk.chunkX, chunk.chunkY, chunk.chunkZ);
+        if (!chunk.hasFiring) continue;
+        for (int dz = -1; dz <= 1; ++dz) {
+            for (int dy = -1; dy <= 1; ++dy) {
+                for (int dx = -1; dx <= 1; ++dx) {
+                    enqueue(static_cast<std::int64_t>(chunk.chunkX) + dx, static_cast<std::int64_t>(chunk.chunkY) + dy,
+                            static_cast<std::int64_t>(chunk.chunkZ) + dz);
+                }
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Chunk>> next(work.size());
+    tbb::parallel_for(std::size_t(0), work.size(), [&](std::size_t index) {
+        const Point3& c = work[index];
+        next[index] = neighborhood_ == Neighborhood::Moore ? stepChunk<Neighborhood::Moore>(c.x, c.y, c.z)
+                                                           : stepChunk<Neighborhood::VonNeumann>(c.x, c.y, c.z);
+    });
+
+    chunks_.clear();
+    population_ = 0;
+    for (auto& chunk : next) {
+        if (!chunk) continue;
+        population_ += chunk->population;
+        std::uint64_t key = packChunkKey(chunk->chunkX, chunk->chunkY, chunk->chunkZ);
+        chunks_.emplace(key, std::move(chunk));
+    }
+}
+
+void VoxelSpace::clear() {
+    chunks_.clear();
+    population_ = 0;
+}
+
+std::size_t VoxelSpace::getPopulation() const {
+    return population_;
+}
+
+std::size_t VoxelSpace::getChunkCount() const {
+    return chunks_.size();
+}
+
+int VoxelSpace::getStateCount() const {
+    return stateCount_;
+}
+
+bool VoxelSpace::getBounds(Point3& minBounds, Point3& maxBounds) const {
+    if (chunks_.empty()) return false;
+    constexpr int MAX = std::numeric_limits<int>::max(), MIN = std::numeric_limits<int>::min();
+    minBounds = Point3(MAX, MAX, MAX);
+    maxBounds = Point3(MIN, MIN, MIN);
+    for (const auto& pair : chunks_) {
+        const Chunk& chunk = *pair.second;
+        for (int z = 0; z < CS; ++z) {
+            for (int y = 0; y < CS; ++y) {
+                for (int x = 0; x < CS; ++x) {
+                    if (chunk.states[localIndex(x, y, z)] == 0) continue;
+                    Point3 p(chunk.chunkX * CS + x, chunk.chunkY * CS + y, chunk.chunkZ * CS + z);
+                    minBounds = Point3(std::min(minBounds.x, p.x), std::min(minBounds.y, p.y), std::min(minBounds.z, p.z));
+                    maxBounds = Point3(std::max(maxBounds.x, p.x), std::max(maxBounds.y, p.y), std::max(maxBounds.z, p.z));
+                }
+            }
+        }
+    }
+    return true;
+}
+
+std::unordered_map<Point, int> VoxelSpace::slice(int z) const {
+    std::unordered_map<Point, int> cells;
+    const std::int64_t chunkZ = floorDiv(z, CS);
+    const int localZ = static_cast<int>(z - chunkZ * CS);
+    for (const auto& pair : chunks_) {
+        const Chunk& chunk = *pair.second;
+        if (chunk.chunkZ != chunkZ) continue;
+        for (int y = 0; y < CS; ++y) {
+            for (int x = 0; x < CS; ++x) {
+                int state = chunk.states[localIndex(x, y, localZ)];
+                if (state != 0) cells.emplace(Point(chunk.chunkX * CS + x, chunk.chunkY * CS + y), state);
+            }
+        }
+    }
+    return cells;
+}
+
+std::unordered_map<Point, int> VoxelSpace::projectMax() const {
+    std::unordered_map<Point, int> cells;
+    for (const auto& pair : chunks_) {
+        const Chunk& chunk = *pair.second;
+        for (int y = 0; y < CS; ++y) {
+            for (int x = 0; x < CS; ++x) {
+                int columnMax = 0;
+                for (int z = 0; z < CS; ++z) {
+                    columnMax = std::max(columnMax, static_cast<int>(chunk.states[localIndex(x, y, z)]));
+                }
+                if (columnMax == 0) continue;
+                int& cell = cells[Point(chunk.chunkX * CS + x, chunk.chunkY * CS + y)];
+                cell = std::max(cell, columnMax);
+            }
+        }
+    }
+    return cells;
+}
+
+const std::unordered_map<std::uint64_t, std::unique_ptr<VoxelSpace::Chunk>>& VoxelSpace::getChunks() const {
+    return chunks_;
+}
+
+void VoxelSpace::setChunk(std::int32_t chunkX, std::int32_t chunkY, std::int32_t chunkZ, const std::uint8_t* states) {
+    std::uint64_t key = packChunkKey(chunkX, chunkY, chunkZ);
+    auto it = chunks_.find(key);
+    if (it != chunks_.end()) {
+        population_ -= it->second->population;
+        chunks_.erase(it);
+    }
+    auto chunk = std::make_unique<Chunk>();
+    chunk->chunkX = chunkX;
+    chunk->chunkY = chunkY;
+    chunk->chunkZ = chunkZ;
+    for (int i = 0; i < CHUNK_VOLUME; ++i) {
+        std::uint8_t state = states[i] < stateCount_ ? states[i] : 0;
+        chunk->states[i] = state;
+        chunk->population += state != 0;
+        chunk->hasFiring |= state == 1;
+    }
+    if (chunk->population == 0) return;
+    population_ += chunk->population;
+    chunks_.emplace(key, std::move(chunk));
+}
@@ -0,0 +1,101 @@
+#ifndef VOXEL_SPACE_H
+#define VOXEL_SPACE_H
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "../utils/point.h"
+#include "../utils/point3.h"
+
+/**
+ * @class VoxelSpace
+ * @brief Sparse 3D world for totalistic rules, stored as 16x16x16 chunks of uint8 states.
+ *
+ * Only chunks containing live cells exist, so memory follows the population rather than the
+ * bounding volume. Rules use the Generations semantics of GenerationsEngine (0 dead, 1 firing,
+ * 2..C-1 decaying; C = 2 gives plain life-like rules) with neighbor counts up to 26.
+ * step() processes chunks in parallel with a kernel specialized for the 26-cell Moore or
+ * 6-cell von Neumann neighborhood; the Moore count is a separable 3x3x3 box sum.
+ */
+class VoxelSpace {
+public:
+    static constexpr int CHUNK_SIZE = 16;
+    static constexpr int CHUNK_VOLUME = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+    enum class Neighborhood {
+        Moore,      // 26 neighbors
+        VonNeumann  // 6 neighbors
+    };
+
+    struct Chunk {
+        std::int32_t chunkX = 0;
+        std::int32_t chunkY = 0;
+        std::int32_t chunkZ = 0;
+        std::uint32_t population = 0;
+        bool hasFiring = false;
+        std::uint8_t states[CHUNK_VOLUME] = {}; // Index (z * 16 + y) * 16 + x
+    };
+
+private:
+    std::unordered_map<std::uint64_t, std::unique_ptr<Chunk>> chunks_;
+    std::uint32_t birthMask_;    // Bit n: a dead cell with n firing neighbors starts firing
+    std::uint32_t survivalMask_; // Bit n: a firing cell with n firing neighbors keeps firing
+    int stateCount_;
+    Neighborhood neighborhood_;
+    std::size_t population_;
+    std::vector<std::uint8_t> transitions_; // Next state at [state * 27 + firing neighbors]
+
+    static std::uint64_t packChunkKey(std::int64_t chunkX, std::int64_t chunkY, std::int64_t chunkZ);
+    template <Neighborhood N>
+    std::unique_ptr<Chunk> stepChunk(std::int64_t chunkX, std::int64_t chunkY, std::int64_t chunkZ) const;
+
+public:
+    VoxelSpace();
+
+    VoxelSpace(const VoxelSpace&) = delete;
+    VoxelSpace& operator=(const VoxelSpace&) = delete;
+
+    /**
+     * @brief Sets the rule and clears the world.
+     */
+    void configure(std::uint32_t birthMask, std::uint32_t survivalMask, int stateCount, Neighborhood neighborhood);
+
+    int getState(Point3 coordinates) const;
+    void setState(Point3 coordinates, int state);
+
+    /**
+     * @brief Advances the world by one generation.
+     */
+    void step();
+
+    void clear();
+    std::size_t getPopulation() const;
+    std::size_t getChunkCount() const;
+    int getStateCount() const;
+
+    /**
+     * @brief Bounding box of all live cells.
+     * @return False if the world is empty.
+     */
+    bool getBounds(Point3& minBounds, Point3& maxBounds) const;
+
+    /**
+     * @brief Live cells of the plane z, as 2D cells.
+     */
+    std::unordered_map<Point, int> slice(int z) const;
+
+    /**
+     * @brief Maximum state along z for every (x, y) column with a live cell.
+     */
+    std::unordered_map<Point, int> projectMax() const;
+
+    const std::unordered_map<std::uint64_t, std::unique_ptr<Chunk>>& getChunks() const;
+
+    /**
+     * @brief Replaces (or removes, if all states are 0) one chunk; used by snapshot loading.
+     */
+    void setChunk(std::int32_t chunkX, std::int32_t chunkY, std::int32_t chunkZ, const std::uint8_t* states);
+};
+
+#endif // VOXEL_SPACE_H
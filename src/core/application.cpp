@@ -3,9 +3,19 @@
 #include <SDL3_ttf/SDL_ttf.h>
 #include "../utils/logger.h" // New logger
 #include "../utils/error_handler.h"
+#include "../utils/metrics.h"
+#include "../utils/perf_counters.h"
+#include "../utils/task_arenas.h"
+#include "../ca/pattern_search.h"
+#include "../snap/npy_io.h"
+#include "../snap/snapshot_io.h"
+#include "../input/brush_stroke.h"
 #include <algorithm>
+#include <cstdio>
 #include <limits>
+#include <random>
 #include <filesystem> // For checking file existence
+#include <sstream>
 
 // Constructor
 Application::Application()
@@ -34,7 +44,29 @@ Application::Application()
       userMessage_(""),
       userMessageDisplayTime_(0),
       userMessageIsMultiLine_(false),
-      showBrushInfo_(true)
+      showBrushInfo_(true),
+      headless_(false),
+      generation_(0),
+      framePublisher_(),
+      lastPublishedGeneration_(0),
+      frameDirty_(false),
+      controlServer_(*this),
+      messageCapture_(nullptr),
+      metricsExporter_(),
+      populationHistory_(),
+      showPopulationGraph_(false),
+      replayActive_(false),
+      replayMaxSpeed_(false),
+      replayQuitWhenDone_(false),
+      replayStartNs_(0),
+      replayLastFrameNs_(0),
+      worldVersions_(),
+      asyncSaver_(),
+      asyncSavesQueued_(0),
+      checkpointer_(),
+      voxelSpace_(),
+      sliceZ_(0),
+      voxelProjection_(false)
        {
 }
 
@@ -49,6 +81,16 @@ Application::~Application() {
 bool Application::initializeSDL() {
     auto logger = Logger::getLogger(Logger::Module::Core);
 
+    if (headless_) {
+        // Only the event subsystem is needed so SIGINT/SIGTERM arrive as SDL_EVENT_QUIT.
+        if (!SDL_Init(SDL_INIT_EVENTS)) {
+            ErrorHandler::failure("SDL_Init (events) failed.");
+            return false;
+        }
+        if (logger) logger->info("SDL initialized in headless mode (no window).");
+        return true;
+    }
+
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         ErrorHandler::failure("SDL_Init failed.");
         return false;
@@ -85,7 +127,11 @@ bool Application::initializeSubsystems(const std::string& configPath) {
 
     int configDefaultState = rule_.getDefaultState(); // Will use internal default if not loaded
     std::vector<Point> configNeighborhood = rule_.getNeighborhood();
-    cellSpace_ = CellSpace(configDefaultState, configNeighborhood);
+    cellSpace_ = CellSpace(configDefaultState, configNeighborhood, rule_.getLattice());
+    cellSpace_.setJournaling(true);
+    viewport_.setLattice(rule_.getLattice());
+    configureVoxelSpace();
+    configureField();
 
     const auto& availableStates = rule_.getStates();
 
@@ -114,9 +160,10 @@ bool Application::initializeSubsystems(const std::string& configPath) {
         ErrorHandler::failure("Failed to initialize RuleEngine.");
         return false;
     }
+    populationHistory_.reset(rule_.getStates(), configDefaultState);
 
     // Renderer initialization depends on a valid window and config for colors
-    if (!renderer_.initialize(window_, rule_)) { // Pass the loaded or default config
+    if (!headless_ && !renderer_.initialize(window_, rule_)) { // Pass the loaded or default config
         ErrorHandler::failure("Failed to initialize Renderer.");
         return false;
     }
@@ -137,6 +184,9 @@ bool Application::initializeSubsystems(const std::string& configPath) {
         }
          if (logger) logger->info("No initial cells, centering view on origin with default zoom.");
     }
+    if (isFieldWorld()) {
+        frameField();
+    }
 
     if (logger) logger->info("All subsystems initialized successfully.");
     return true;
@@ -158,12 +208,21 @@ void Application::cleanupSDL() {
 
 void Application::cleanupSubsystems() {
     auto logger = Logger::getLogger(Logger::Module::Core);
+    controlServer_.close();
+    metricsExporter_.stop();
+    asyncSaver_.stop();
+    checkpointer_.stop();
+    PerfCounters::disable();
+    if (inputHandler_.getRecorder().getMode() == InputRecorder::Mode::Recording) {
+        inputHandler_.getRecorder().stopRecording();
+    }
     renderer_.cleanup();
     if (logger) logger->info("Subsystems cleaned up.");
 }
 
 
-bool Application::initialize(const std::string& configPath) {
+bool Application::initialize(const std::string& configPath, bool headless) {
+    headless_ = headless;
     if (!initializeSDL()) {
         return false;
     }
@@ -175,6 +234,9 @@ bool Application::initialize(const std::string& configPath) {
     lastUpdateTime_ = SDL_GetTicks();
     simulationLag_ = 0;
     postMessageToUser("Welcome! Type 'help' or press 'H' for commands.", 5000);
+    if (headless_) {
+        resumeSimulation();
+    }
     return true;
 }
 
@@ -199,7 +261,15 @@ void Application::loadRule(const std::string& configPath) {
     // Re-initialize CellSpace
     int newDefaultState = rule_.getDefaultState();
     std::vector<Point> newNeighborhood = rule_.getNeighborhood();
-    cellSpace_ = CellSpace(newDefaultState, newNeighborhood); // Creates a new CellSpace, clearing old one
+    cellSpace_ = CellSpace(newDefaultState, newNeighborhood, rule_.getLattice()); // Creates a new CellSpace, clearing old one
+    cellSpace_.setJournaling(true);
+    viewport_.setLattice(rule_.getLattice());
+    configureVoxelSpace();
+    configureField();
+    graphSpace_.clear();
+    lazySnapshot_.close();
+    populationHistory_.reset(rule_.getStates(), newDefaultState);
+    patternHighlights_.clear();
 
     // Re-initialize RuleEngine
     if (!ruleEngine_.initialize(rule_)) {
@@ -213,6 +283,12 @@ void Application::loadRule(const std::string& configPath) {
     // Re-initialize Renderer colors
     renderer_.reinitializeColors(rule_);
     if (logger) logger->info("Renderer colors re-initialized.");
+    if (framePublisher_.isOpen()) {
+        framePublisher_.setPalette(rule_);
+    }
+    generation_ = 0;
+    frameDirty_ = true;
+    onWorldEdited();
 
     // Update brush state based on new config
     const auto& availableStates = rule_.getStates();
@@ -235,7 +311,9 @@ void Application::loadRule(const std::string& configPath) {
     if (logger) logger->info("Brush state updated for new config: ", currentBrushState_);
 
     // Reset view
-    if (viewport_.isAutoFitEnabled()) {
+    if (isFieldWorld()) {
+        frameField();
+    } else if (viewport_.isAutoFitEnabled()) {
         viewport_.updateAutoFit(cellSpace_);
     } else {
         centerViewOnGrid(); // Center on (potentially empty) grid
@@ -259,6 +337,11 @@ void Application::run() {
         refreshLag_ += elapsedTime;
 
         processInput();
+        // Scripted commands run here, between generations, so they never see a half-applied step.
+        controlServer_.poll();
+        pollAsyncSaves();
+        pollCheckpoints();
+        streamVisibleChunks();
 
         if (!simulationPaused_ && timePerUpdate_ > 0) {
             while (simulationLag_ >= timePerUpdate_) {
@@ -270,33 +353,132 @@ void Application::run() {
             simulationLag_ = 0;
         }
 
-        if (timePerFrame_ > 0) {
+        publishFrameIfNeeded();
+
+        if (headless_) {
+            // Nothing to draw; yield briefly so a paused headless run does not spin.
+            refreshLag_ = 0;
+            if (replayActive_) recordReplayFrame();
+            if (replayMaxSpeed_) continue;
+            if (simulationPaused_ || simulationLag_ < timePerUpdate_) SDL_Delay(1);
+            continue;
+        }
+
+        if (replayMaxSpeed_) {
+            // Benchmark replay: every iteration consumes one recorded batch, so render each one.
+            renderScene();
+            refreshLag_ = 0;
+            recordReplayFrame();
+        } else if (timePerFrame_ > 0) {
+            bool rendered = false;
             while (refreshLag_ >= timePerFrame_) {
                 renderScene();
                 refreshLag_ -= timePerFrame_;
+                rendered = true;
             }
+            if (rendered && replayActive_) recordReplayFrame();
         } else if (timePerFrame_ == 0) {
             renderScene();
             refreshLag_ = 0;
+            if (replayActive_) recordReplayFrame();
         }
     }
 }
 
+void Application::recordReplayFrame() {
+    std::uint64_t now = SDL_GetTicksNS();
+    if (replayLastFrameNs_ != 0) {
+        replayFrameTimesNs_.push_back(now - replayLastFrameNs_);
+    }
+    replayLastFrameNs_ = now;
+}
+
 void Application::processInput() {
     inputHandler_.processEvents(viewport_);
 }
 
 void Application::updateSimulation() {
-    if (simulationPaused_ || !ruleEngine_.isInitialized()) {
+    if (simulationPaused_) {
+        return;
+    }
+    computeGeneration();
+}
+
+void Application::computeGeneration() {
+    if (!ruleEngine_.isInitialized()) {
+        return;
+    }
+    if (!finishLazyLoad("stepping")) {
+        pauseSimulation();
+        return;
+    }
+    if (isVoxelWorld()) {
+        TaskArenas::execute(TaskArenas::Domain::Simulation, [this] { voxelSpace_.step(); });
+        ++generation_;
+        refreshVoxelView();
+        Metrics::setGauge(Metrics::Gauge::Population, static_cast<double>(voxelSpace_.getPopulation()));
+        return;
+    }
+    if (isFieldWorld()) {
+        TaskArenas::execute(TaskArenas::Domain::Simulation, [this] { field_.step(); });
+        ++generation_;
+        frameDirty_ = true;
+        Metrics::increment(Metrics::Counter::Generations);
+        Metrics::increment(Metrics::Counter::CellsEvaluated, static_cast<std::uint64_t>(field_.getWidth()) * field_.getHeight() *
+                                                                 field_.getSettings().stepsPerGeneration);
         return;
     }
-    std::unordered_map<Point, int> changes = ruleEngine_.calculateForUpdate(cellSpace_);
+    std::unordered_map<Point, int> changes;
+    if (isGraphWorld()) {
+        TaskArenas::execute(TaskArenas::Domain::Simulation, [this] { graphSpace_.step(ruleEngine_, changedVertices_); });
+        changes.reserve(changedVertices_.size());
+        for (std::uint32_t vertex : changedVertices_) {
+            changes[graphSpace_.getPosition(vertex)] = graphSpace_.getState(vertex);
+        }
+        Metrics::increment(Metrics::Counter::Generations);
+        Metrics::increment(Metrics::Counter::CellsEvaluated, graphSpace_.getVertexCount());
+    } else {
+        TaskArenas::execute(TaskArenas::Domain::Simulation, [&] { changes = ruleEngine_.calculateForUpdate(cellSpace_); });
+    }
+    ++generation_;
     if (!changes.empty()) {
         cellSpace_.updateCells(changes);
         if (viewport_.isAutoFitEnabled()) {
             viewport_.updateAutoFit(cellSpace_);
         }
     }
+    publishWorldVersion();
+    if (checkpointer_.isDue(generation_)) {
+        std::string ruleId = currentConfigPath_.substr(currentConfigPath_.find_last_of("/\\") + 1);
+        checkpointer_.request(worldVersions_.view(), ruleId);
+    }
+
+    populationHistory_.record(generation_, cellSpace_);
+
+    CycleDetector::Detection cycle = cycleDetector_.observe(generation_, cellSpace_);
+    if (cycle.isNew) {
+        std::string message = "Cycle detected at generation " + std::to_string(generation_) +
+                              ": period " + std::to_string(cycle.period);
+        if (cycle.dx != 0 || cycle.dy != 0) {
+            message += ", moving (" + std::to_string(cycle.dx) + ", " + std::to_string(cycle.dy) + ") per period";
+        }
+        if (cycleDetector_.getAction() == CycleDetector::Action::Pause) {
+            pauseSimulation();
+        }
+        postMessageToUser(message, 5000);
+    }
+}
+
+void Application::publishFrameIfNeeded() {
+    if (!framePublisher_.isOpen()) return;
+    if (generation_ == lastPublishedGeneration_ && !frameDirty_) return;
+
+    // Only the newest generation is exported; intermediate ones computed in the same
+    // loop iteration are skipped, so publishing cost is bounded by the loop rate.
+    SDL_Rect visible = viewport_.getVisibleWorldRect();
+    framePublisher_.publish(cellSpace_, Point(visible.x, visible.y), visible.w, visible.h, generation_);
+    lastPublishedGeneration_ = generation_;
+    frameDirty_ = false;
 }
 
 void Application::renderScene() {
@@ -315,7 +497,18 @@ void Application::renderScene() {
                           " (Size: " + std::to_string(currentBrushSize_) + ")";
     }
 
-    renderer_.renderGrid(cellSpace_, viewport_);
+    // The render arena keeps frame work from queuing behind a long generation step.
+    TaskArenas::execute(TaskArenas::Domain::Render, [&] {
+        if (isFieldWorld()) {
+            renderer_.renderField(field_, viewport_);
+        } else {
+            renderer_.renderGrid(cellSpace_, viewport_);
+        }
+    });
+    renderer_.renderHighlights(patternHighlights_, viewport_);
+    if (showPopulationGraph_) {
+        renderer_.renderPopulationGraph(populationHistory_, viewport_);
+    }
     // The commandInputBuffer_ is passed directly; Renderer adds the '/' for display
     renderer_.renderUI(commandInputBuffer_, commandInputActive_, currentMessageToDisplay, brushInfoString, viewport_);
     renderer_.presentScreen();
@@ -363,6 +556,14 @@ void Application::resumeSimulation() {
 }
 
 
+bool Application::isStateAllowed(int state) const {
+    const auto& availableStates = rule_.getStates();
+    if (rule_.isLoaded() && !availableStates.empty()) {
+        return std::find(availableStates.begin(), availableStates.end(), state) != availableStates.end();
+    }
+    return !rule_.isLoaded() && (state == 0 || state == 1);
+}
+
 void Application::setBrushState(int state) {
     auto logger = Logger::getLogger(Logger::Module::Core);
     bool isValidState = false;
@@ -405,13 +606,63 @@ void Application::setBrushSize(int size) {
 }
 
 void Application::applyBrush(Point worldPos) {
-    int halfSize = (currentBrushSize_ -1) / 2;
-    for (int dy = -halfSize; dy <= halfSize; ++dy) {
-        for (int dx = -halfSize; dx <= halfSize; ++dx) {
-            Point cellToChange(worldPos.x + dx, worldPos.y + dy);
-            cellSpace_.setCellState(cellToChange, currentBrushState_);
+    applyBrushStroke({worldPos});
+}
+
+void Application::applyBrushStroke(const std::vector<Point>& path) {
+    if (path.empty()) return;
+    if (!finishLazyLoad("editing")) return;
+    std::vector<BrushStroke::Span> spans = BrushStroke::rasterize(path, (currentBrushSize_ - 1) / 2);
+    if (isFieldWorld()) {
+        for (const BrushStroke::Span& span : spans) {
+            for (int x = span.x0; x <= span.x1; ++x) {
+                field_.paint(x, span.y, 0, currentBrushState_);
+            }
+        }
+        frameDirty_ = true;
+        onWorldEdited();
+        return;
+    }
+    if (isVoxelWorld()) {
+        for (const BrushStroke::Span& span : spans) {
+            for (int x = span.x0; x <= span.x1; ++x) {
+                voxelSpace_.setState(Point3(x, span.y, sliceZ_), currentBrushState_);
+            }
+        }
+        refreshVoxelView();
+        frameDirty_ = true;
+        onWorldEdited();
+        return;
+    }
+    if (isGraphWorld()) {
+        // Only cells showing a vertex can be painted.
+        for (const BrushStroke::Span& span : spans) {
+            for (int x = span.x0; x <= span.x1; ++x) {
+                Point cell(x, span.y);
+                std::int64_t vertex = graphSpace_.vertexAt(cell);
+                if (vertex < 0) continue;
+                graphSpace_.setState(static_cast<std::uint32_t>(vertex), currentBrushState_);
+                cellSpace_.setCellState(cell, currentBrushState_);
+            }
+        }
+        frameDirty_ = true;
+        onWorldEdited();
+        return;
+    }
+    // Writes go through setCellState rather than updateCells, which would drop the cells the
+    // last generation scheduled for evaluation.
+    std::size_t changed = 0;
+    for (const BrushStroke::Span& span : spans) {
+        for (int x = span.x0; x <= span.x1; ++x) {
+            Point cell(x, span.y);
+            if (cellSpace_.getCellState(cell) == currentBrushState_) continue;
+            cellSpace_.setCellState(cell, currentBrushState_);
+            ++changed;
         }
     }
+    if (changed == 0) return;
+    frameDirty_ = true;
+    onWorldEdited();
     if (viewport_.isAutoFitEnabled()) {
         viewport_.updateAutoFit(cellSpace_);
     }
@@ -553,6 +804,19 @@ void Application::setGridLineColor(int r, int g, int b, int a) {
     postMessageToUser("Grid line color set.");
 }
 
+void Application::setFrameBudget(double milliseconds) {
+    if (milliseconds < 0.0) {
+        postMessageToUser("Error: Frame budget must be positive (or 'off').");
+        return;
+    }
+    renderer_.getQualityController().setBudgetMs(milliseconds);
+    postMessageToUser(renderer_.getQualityController().describe());
+}
+
+void Application::showFrameBudget() {
+    postMessageToUser(renderer_.getQualityController().describe());
+}
+
 
 bool Application::isViewportAutoFitEnabled() const {
     return viewport_.isAutoFitEnabled();
@@ -592,7 +856,14 @@ void Application::centerViewOnGrid() {
 
 void Application::saveSnapshot(const std::string& filename) {
     auto logger = Logger::getLogger(Logger::Module::Core);
-    if (snapshotManager_.saveState(filename, cellSpace_)) {
+    std::string ruleId = currentConfigPath_.substr(currentConfigPath_.find_last_of("/\\") + 1);
+    bool saved = false;
+    TaskArenas::execute(TaskArenas::Domain::IO, [&] {
+        saved = isVoxelWorld()   ? snapshotManager_.saveVoxelState(filename, voxelSpace_, ruleId, generation_)
+                : isFieldWorld() ? snapshotManager_.saveFieldState(filename, field_, ruleId, generation_)
+                                 : snapshotManager_.saveState(filename, cellSpace_, ruleId, generation_);
+    });
+    if (saved) {
         if (logger) logger->info("Snapshot saved to {}",filename);
         postMessageToUser("Snapshot saved: " + filename);
     } else {
@@ -601,15 +872,136 @@ void Application::saveSnapshot(const std::string& filename) {
     }
 }
 
-void Application::loadSnapshot(const std::string& filename) {
+void Application::saveSnapshotAsync(const std::string& filename) {
+    if (isVoxelWorld()) {
+        postMessageToUser("Error: Background saves are not supported for 3D worlds; use save.");
+        return;
+    }
+    if (isFieldWorld()) {
+        postMessageToUser("Error: Background saves are not supported for reaction-diffusion fields; use save.");
+        return;
+    }
+    std::string ruleId = currentConfigPath_.substr(currentConfigPath_.find_last_of("/\\") + 1);
+    publishWorldVersion(); // Cheap if nothing changed since the last generation
+    asyncSaver_.enqueue(filename, worldVersions_.view(), ruleId);
+    ++asyncSavesQueued_;
+    postMessageToUser("Saving generation " + std::to_string(generation_) + " to " + filename + " in the background.");
+}
+
+void Application::pollAsyncSaves() {
+    if (asyncSavesQueued_ == 0) return;
+    for (const AsyncSnapshotSaver::Result& result : asyncSaver_.takeResults()) {
+        --asyncSavesQueued_;
+        char seconds[32];
+        std::snprintf(seconds, sizeof(seconds), "%.2f", result.seconds);
+        if (result.success) {
+            postMessageToUser("Snapshot saved: " + result.path + " (generation " + std::to_string(result.generation) +
+                              ", " + seconds + " s in the background)");
+        } else {
+            postMessageToUser("Error: Failed to save snapshot " + result.path);
+        }
+    }
+}
+
+void Application::pollCheckpoints() {
+    for (const Checkpointer::Result& result : checkpointer_.takeResults()) {
+        // Successful checkpoints are only logged; an unattended run should not flash a message every interval.
+        if (!result.success) {
+            postMessageToUser("Error: Failed to write checkpoint " + result.path, 5000);
+        }
+    }
+}
+
+void Application::configureAutosave(bool seconds, std::uint64_t every, std::size_t keep, const std::string& directory,
+                                    std::uint64_t bytesPerSecond) {
+    if (isVoxelWorld() || isFieldWorld()) {
+        postMessageToUser("Error: Autosave is only supported for 2D worlds; use save.");
+        return;
+    }
+    Checkpointer::Settings settings = checkpointer_.getSettings();
+    settings.unit = seconds ? Checkpointer::Unit::Seconds : Checkpointer::Unit::Generations;
+    settings.every = every;
+    settings.keep = keep;
+    settings.bytesPerSecond = bytesPerSecond;
+    if (!directory.empty()) settings.directory = directory;
+    std::string error;
+    if (!checkpointer_.configure(settings, generation_, error)) {
+        postMessageToUser("Error: Cannot enable autosave: " + error + ".");
+        return;
+    }
+    postMessageToUser(checkpointer_.describe());
+}
+
+void Application::disableAutosave() {
+    checkpointer_.disable();
+    postMessageToUser(checkpointer_.describe());
+}
+
+void Application::showAutosave() {
+    postMessageToUser(checkpointer_.describe());
+}
+
+bool Application::resumeFromCheckpoints(const std::string& directory) {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    checkpointer_.setDirectory(directory);
+    for (const std::string& path : Checkpointer::listCheckpoints(directory)) {
+        // A checkpoint damaged after it was written is skipped in favour of the previous one.
+        if (!Checkpointer::isComplete(path)) {
+            if (logger) logger->warn("Skipping incomplete checkpoint {}", path);
+            continue;
+        }
+        if (loadSnapshot(path)) {
+            if (logger) logger->info("Resumed from checkpoint {} (generation {}).", path, generation_);
+            return true;
+        }
+    }
+    if (logger) logger->warn("No valid checkpoint in {}; starting fresh.", directory);
+    postMessageToUser("No valid checkpoint in " + directory + "; starting fresh.");
+    return false;
+}
+
+void Application::publishWorldVersion() {
+    if (isVoxelWorld() || isFieldWorld()) return;
+    worldVersions_.publish(cellSpace_, generation_);
+}
+
+bool Application::loadSnapshot(const std::string& filename) {
     auto logger = Logger::getLogger(Logger::Module::Core);
     bool wasPaused = simulationPaused_;
     if(!wasPaused) pauseSimulation();
 
-    if (snapshotManager_.loadState(filename, cellSpace_)) {
+    lazySnapshot_.close();
+    SnapshotInfo info;
+    bool loaded = false;
+    if (isVoxelWorld()) {
+        loaded = snapshotManager_.loadVoxelState(filename, voxelSpace_, &info);
+        if (loaded) refreshVoxelView();
+    } else if (isFieldWorld()) {
+        loaded = snapshotManager_.loadFieldState(filename, field_, &info);
+    } else {
+        loaded = snapshotManager_.loadState(filename, cellSpace_, &info);
+        if (loaded && isGraphWorld()) {
+            // The snapshot holds the vertices' display cells; cells without a vertex are dropped.
+            graphSpace_.setStatesFromCells(cellSpace_.getNonDefaultCells());
+            std::unordered_map<Point, int> cells = graphSpace_.toCells();
+            cellSpace_.loadCells(cells, cellSpace_.getMinBounds(), cellSpace_.getMaxBounds());
+        }
+    }
+    if (loaded) {
         if (logger) logger->info("Snapshot loaded from {}", filename);
-        postMessageToUser("Snapshot loaded: " + filename);
-        if (viewport_.isAutoFitEnabled()) {
+        std::string currentRuleId = currentConfigPath_.substr(currentConfigPath_.find_last_of("/\\") + 1);
+        if (!info.legacy && !info.ruleId.empty() && info.ruleId != currentRuleId) {
+            if (logger) logger->warn("Snapshot {} was saved with rule '{}', current rule is '{}'.", filename, info.ruleId, currentRuleId);
+            postMessageToUser("Snapshot loaded: " + filename + " (saved with rule " + info.ruleId + ")");
+        } else {
+            postMessageToUser("Snapshot loaded: " + filename);
+        }
+        generation_ = info.generation;
+        frameDirty_ = true;
+        onWorldEdited();
+        if (isFieldWorld()) {
+            frameField();
+        } else if (viewport_.isAutoFitEnabled()) {
             viewport_.updateAutoFit(cellSpace_);
         } else {
             centerViewOnGrid();
@@ -620,6 +1012,274 @@ void Application::loadSnapshot(const std::string& filename) {
     }
 
     if (!wasPaused && isRunning_) resumeSimulation();
+    return loaded;
+}
+
+void Application::loadSnapshotRegion(const std::string& filename, int x, int y, int width, int height) {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    if (width <= 0 || height <= 0) {
+        postMessageToUser("Error: Region width and height must be positive.");
+        return;
+    }
+    bool wasPaused = simulationPaused_;
+    if (!wasPaused) pauseSimulation();
+
+    lazySnapshot_.close();
+    SnapshotInfo info;
+    if (snapshotManager_.loadRegion(filename, cellSpace_, x, y, width, height, &info)) {
+        if (logger) logger->info("Snapshot region loaded from {}", filename);
+        postMessageToUser("Region loaded: " + filename + " (" + std::to_string(cellSpace_.getNonDefaultCells().size()) +
+                          " cells, " + std::to_string(width) + "x" + std::to_string(height) + " at " +
+                          std::to_string(x) + "," + std::to_string(y) + ")");
+        generation_ = info.generation;
+        frameDirty_ = true;
+        onWorldEdited();
+        if (viewport_.isAutoFitEnabled()) {
+            viewport_.updateAutoFit(cellSpace_);
+        } else {
+            centerViewOnGrid();
+        }
+    } else {
+        if (logger) logger->error("Failed to load snapshot region from " + filename);
+        postMessageToUser("Error: Failed to load region of snapshot " + filename);
+    }
+
+    if (!wasPaused && isRunning_) resumeSimulation();
+}
+
+void Application::openSnapshotLazy(const std::string& filename) {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    pauseSimulation(); // Simulating a partially loaded world would give wrong results at chunk edges
+
+    if (!lazySnapshot_.open(filename)) {
+        postMessageToUser("Error: Cannot open " + filename + " lazily (missing file or legacy format without chunk index).");
+        return;
+    }
+    const SnapshotInfo& info = lazySnapshot_.getInfo();
+    cellSpace_.clear();
+    generation_ = info.generation;
+    frameDirty_ = true;
+    onWorldEdited();
+
+    // Autofit would zoom out to the whole world and pull in every chunk, so start at default zoom instead.
+    viewport_.setAutoFit(false, cellSpace_);
+    if (info.boundsValid) {
+        viewport_.setCenter(Viewport::PointF(
+            static_cast<float>(info.minBounds.x) + static_cast<float>(static_cast<std::int64_t>(info.maxBounds.x) - info.minBounds.x + 1) / 2.0f,
+            static_cast<float>(info.minBounds.y) + static_cast<float>(static_cast<std::int64_t>(info.maxBounds.y) - info.minBounds.y + 1) / 2.0f));
+    } else {
+        viewport_.setCenter({0.0f, 0.0f});
+    }
+    viewport_.zoomToCellSize(viewport_.getDefaultCellSize(), Point(viewport_.getScreenWidth() / 2, viewport_.getScreenHeight() / 2));
+
+    if (logger) logger->info("Opened {} lazily: {} chunks, population {}.", filename, lazySnapshot_.getTotalChunkCount(), info.population);
+    postMessageToUser("Viewing " + filename + " lazily (" + std::to_string(lazySnapshot_.getTotalChunkCount()) +
+                      " chunks, pop " + std::to_string(info.population) + "). Chunks load as you pan; stepping or editing loads the rest first.");
+}
+
+void Application::exportNpy(const std::string& filename, int x, int y, int width, int height) {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    if (isVoxelWorld() || isFieldWorld()) {
+        postMessageToUser("Error: export-npy works on 2D cell worlds only.");
+        return;
+    }
+    if (width <= 0 || height <= 0) {
+        postMessageToUser("Error: Region width and height must be positive.");
+        return;
+    }
+    NpyIO::DType dtype;
+    if (!NpyIO::chooseDType(rule_.getStates(), dtype)) {
+        postMessageToUser("Error: The rule's states do not fit in uint16.");
+        return;
+    }
+    publishWorldVersion(); // Cheap if nothing changed since the last generation
+    bool exported = false;
+    TaskArenas::execute(TaskArenas::Domain::IO, [&] {
+        exported = NpyIO::exportRegion(filename, worldVersions_.view(), x, y, width, height, dtype);
+    });
+    if (exported) {
+        if (logger) logger->info("Exported {}x{} region to {}", width, height, filename);
+        postMessageToUser("Exported " + std::to_string(width) + "x" + std::to_string(height) + " " +
+                          NpyIO::dtypeName(dtype) + " array at " + std::to_string(x) + "," + std::to_string(y) +
+                          " to " + filename);
+    } else {
+        postMessageToUser("Error: Failed to export " + filename);
+    }
+}
+
+void Application::exportNpy(const std::string& filename) {
+    if (isVoxelWorld() || isFieldWorld()) {
+        postMessageToUser("Error: export-npy works on 2D cell worlds only.");
+        return;
+    }
+    if (cellSpace_.getNonDefaultCells().empty()) {
+        postMessageToUser("Error: The world is empty; give a region to export.");
+        return;
+    }
+    Point minBounds = cellSpace_.getMinBounds();
+    Point maxBounds = cellSpace_.getMaxBounds();
+    std::int64_t width = static_cast<std::int64_t>(maxBounds.x) - minBounds.x + 1;
+    std::int64_t height = static_cast<std::int64_t>(maxBounds.y) - minBounds.y + 1;
+    if (width > std::numeric_limits<int>::max() || height > std::numeric_limits<int>::max()) {
+        postMessageToUser("Error: The world is too wide to export at once; give a region.");
+        return;
+    }
+    exportNpy(filename, minBounds.x, minBounds.y, static_cast<int>(width), static_cast<int>(height));
+}
+
+void Application::importNpy(const std::string& filename, int x, int y) {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    if (isVoxelWorld() || isFieldWorld() || isGraphWorld()) {
+        postMessageToUser("Error: import-npy works on 2D grid worlds only.");
+        return;
+    }
+    if (!finishLazyLoad("importing")) return;
+    bool wasPaused = simulationPaused_;
+    if (!wasPaused) pauseSimulation();
+
+    publishWorldVersion();
+    std::unordered_map<Point, int> changes;
+    NpyIO::ArrayHeader header;
+    bool imported = false;
+    TaskArenas::execute(TaskArenas::Domain::IO, [&] {
+        imported = NpyIO::importArray(filename, worldVersions_.view(), x, y, rule_.getStates(), changes, &header);
+    });
+    if (imported) {
+        if (!changes.empty()) cellSpace_.updateCells(changes);
+        if (logger) logger->info("Imported {} at {},{}", filename, x, y);
+        postMessageToUser("Imported " + std::to_string(header.width) + "x" + std::to_string(header.height) + " " +
+                          NpyIO::dtypeName(header.dtype) + " array at " + std::to_string(x) + "," + std::to_string(y) +
+                          " (" + std::to_string(changes.size()) + " cells changed)");
+        frameDirty_ = true;
+        onWorldEdited();
+        if (viewport_.isAutoFitEnabled()) {
+            viewport_.updateAutoFit(cellSpace_);
+        }
+    } else {
+        postMessageToUser("Error: Failed to import " + filename + " (see the log for details)");
+    }
+
+    if (!wasPaused && isRunning_) resumeSimulation();
+}
+
+bool Application::finishLazyLoad(const std::string& action) {
+    // Chunks streamed in after a step or an edit would hold the snapshot's generation next to
+    // cells that have moved on, so the rest of the file is decoded before the world changes.
+    if (!lazySnapshot_.isOpen()) return true;
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    std::string path = lazySnapshot_.getPath();
+    std::size_t decoded = lazySnapshot_.loadRemaining(cellSpace_);
+    if (decoded > 0) {
+        frameDirty_ = true;
+        onWorldEdited();
+    }
+    std::size_t failed = lazySnapshot_.getFailedChunkCount();
+    if (failed > 0 || lazySnapshot_.getLoadedChunkCount() != lazySnapshot_.getTotalChunkCount()) {
+        // The loader stays open and keeps its failures, so every later step or edit is refused too.
+        if (logger) logger->error("{} chunk(s) of {} could not be decoded; refusing to change a partial world.", failed, path);
+        postMessageToUser("Error: " + std::to_string(failed) + " chunk(s) of " + path + " are corrupt; not " + action +
+                          " a partly loaded world. Load another snapshot.", 5000);
+        return false;
+    }
+    lazySnapshot_.close();
+    if (logger) logger->info("Loaded the remaining {} chunk(s) of {} before {}.", decoded, path, action);
+    postMessageToUser("Loaded the remaining " + std::to_string(decoded) + " chunk(s) of " + path + " before " + action + ".");
+    return true;
+}
+
+void Application::streamVisibleChunks() {
+    if (!lazySnapshot_.isOpen() || lazySnapshot_.isExhausted()) return;
+
+    // Prefetch half a screen around the view so short pans do not show empty chunks.
+    const std::size_t chunksPerIteration = 8;
+    SDL_Rect visible = viewport_.getVisibleWorldRect();
+    int marginX = visible.w / 2;
+    int marginY = visible.h / 2;
+    std::size_t failedBefore = lazySnapshot_.getFailedChunkCount();
+    std::size_t decoded = lazySnapshot_.loadVisible(cellSpace_, visible.x - marginX, visible.y - marginY,
+                                                    visible.w + 2 * marginX, visible.h + 2 * marginY,
+                                                    chunksPerIteration);
+    std::size_t failed = lazySnapshot_.getFailedChunkCount();
+    if (failed > failedBefore) {
+        auto logger = Logger::getLogger(Logger::Module::Core);
+        if (logger) logger->error("{} chunk(s) of {} could not be decoded.", failed - failedBefore, lazySnapshot_.getPath());
+        postMessageToUser("Error: " + std::to_string(failed) + " chunk(s) of " + lazySnapshot_.getPath() +
+                          " are corrupt; the world shown is incomplete.", 5000);
+    }
+    if (decoded > 0) {
+        frameDirty_ = true;
+        onWorldEdited();
+        if (lazySnapshot_.getLoadedChunkCount() == lazySnapshot_.getTotalChunkCount()) {
+            postMessageToUser("All chunks of " + lazySnapshot_.getPath() + " loaded.");
+        }
+    }
+}
+
+void Application::browseSnapshots(const std::string& directory) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (!fs::is_directory(directory, ec)) {
+        postMessageToUser("Error: Not a directory: " + directory);
+        return;
+    }
+
+    std::vector<std::pair<fs::file_time_type, fs::path>> files;
+    for (const auto& entry : fs::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file(ec) && entry.path().extension() == ".snapshot") {
+            files.emplace_back(entry.last_write_time(ec), entry.path());
+        }
+    }
+    if (files.empty()) {
+        postMessageToUser("No .snapshot files in " + directory);
+        return;
+    }
+    std::sort(files.begin(), files.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    const size_t maxListed = 20;
+    std::string listing = "Snapshots in " + directory + " (newest first):\n";
+    for (size_t i = 0; i < files.size() && i < maxListed; ++i) {
+        SnapshotInfo info;
+        std::string name = files[i].second.filename().string();
+        if (snapshotManager_.readHeader(files[i].second.string(), info)) {
+            listing += "  " + name + "  gen " + std::to_string(info.generation) +
+                       "  pop " + std::to_string(info.population) +
+                       "  " + (info.ruleId.empty() ? "-" : info.ruleId);
+            if (info.boundsValid) {
+                listing += "  [" + std::to_string(info.minBounds.x) + "," + std::to_string(info.minBounds.y) +
+                           " .. " + std::to_string(info.maxBounds.x) + "," + std::to_string(info.maxBounds.y) + "]";
+            }
+        } else {
+            listing += "  " + name + (info.legacy ? "  (legacy, no header)" : "  (unreadable)");
+        }
+        listing += "\n";
+    }
+    if (files.size() > maxListed) {
+        listing += "  ... " + std::to_string(files.size() - maxListed) + " more\n";
+    }
+    listing += "Use 'preview <file>' to see a thumbnail.";
+    postMessageToUser(listing, 0, true);
+}
+
+void Application::previewSnapshot(const std::string& filename) {
+    SnapshotInfo info;
+    if (!snapshotManager_.readHeader(filename, info)) {
+        postMessageToUser(info.legacy ? "Error: " + filename + " is a legacy snapshot without a preview header."
+                                      : "Error: Could not read snapshot header: " + filename);
+        return;
+    }
+    std::string text = filename + "\n" +
+                       "rule " + (info.ruleId.empty() ? "-" : info.ruleId) +
+                       " | gen " + std::to_string(info.generation) +
+                       " | pop " + std::to_string(info.population) +
+                       " | chunks " + std::to_string(info.chunks.size()) + "\n";
+    if (info.boundsValid) {
+        text += "bounds [" + std::to_string(info.minBounds.x) + "," + std::to_string(info.minBounds.y) +
+                " .. " + std::to_string(info.maxBounds.x) + "," + std::to_string(info.maxBounds.y) + "]\n";
+        text += SnapshotManager::thumbnailToAscii(info);
+    } else {
+        text += "(empty)\n";
+    }
+    postMessageToUser(text, 0, true);
 }
 
 void Application::clearSimulation() {
@@ -627,9 +1287,19 @@ void Application::clearSimulation() {
     bool wasPaused = simulationPaused_;
     if(!wasPaused) pauseSimulation();
 
+    lazySnapshot_.close();
     cellSpace_.clear();
-
-    if (viewport_.isAutoFitEnabled()) {
+    voxelSpace_.clear();
+    graphSpace_.resetStates();
+    field_.reset();
+    patternHighlights_.clear();
+    generation_ = 0;
+    frameDirty_ = true;
+    onWorldEdited();
+
+    if (isFieldWorld()) {
+        frameField();
+    } else if (viewport_.isAutoFitEnabled()) {
         viewport_.updateAutoFit(cellSpace_);
     } else {
          viewport_.setCenter({0.0f, 0.0f});
@@ -642,6 +1312,676 @@ void Application::clearSimulation() {
     if (!wasPaused && isRunning_) resumeSimulation();
 }
 
+std::uint64_t Application::getGeneration() const {
+    return generation_;
+}
+
+void Application::onWorldEdited() {
+    // The history no longer describes the trajectory of the current world.
+    cycleDetector_.reset();
+    populationHistory_.record(generation_, cellSpace_);
+    // updateCells() keeps these current during a run; edits between generations refresh them here.
+    std::size_t population = isVoxelWorld() ? voxelSpace_.getPopulation() : cellSpace_.getNonDefaultCells().size();
+    Metrics::setGauge(Metrics::Gauge::Population, static_cast<double>(population));
+    Metrics::setGauge(Metrics::Gauge::ActiveCells, static_cast<double>(cellSpace_.getCellsToEvaluate().size()));
+}
+
+void Application::reportStatus() {
+    std::size_t population = isVoxelWorld() ? voxelSpace_.getPopulation() : cellSpace_.getNonDefaultCells().size();
+    postMessageToUser("generation=" + std::to_string(generation_) +
+                      " population=" + std::to_string(population) +
+                      " paused=" + (simulationPaused_ ? "1" : "0") +
+                      " speed=" + std::to_string(simulationSpeed_) +
+                      " rule=" + currentConfigPath_);
+}
+
+bool Application::isFieldWorld() const {
+    return rule_.getRuleType() == Rule::RuleType::ReactionDiffusion;
+}
+
+void Application::configureField() {
+    if (!isFieldWorld()) {
+        field_.clear();
+        return;
+    }
+    field_.configure(rule_.getReactionDiffusionSettings());
+    // A small square in the middle gets a new field going; the brush and rd-seed add more.
+    field_.paint(field_.getWidth() / 2, field_.getHeight() / 2, 4, 1);
+}
+
+void Application::frameField() {
+    viewport_.setAutoFit(false, cellSpace_);
+    viewport_.setCenter({field_.getWidth() / 2.0f, field_.getHeight() / 2.0f});
+    float cellSize = 0.95f * std::min(viewport_.getScreenWidth() / static_cast<float>(field_.getWidth()),
+                                      viewport_.getScreenHeight() / static_cast<float>(field_.getHeight()));
+    viewport_.zoomToCellSize(cellSize, Point(viewport_.getScreenWidth() / 2, viewport_.getScreenHeight() / 2));
+}
+
+void Application::seedField(int count) {
+    if (!isFieldWorld()) {
+        postMessageToUser("Error: rd-seed needs a reaction-diffusion rule.");
+        return;
+    }
+    if (count < 1 || count > 10000) {
+        postMessageToUser("Error: rd-seed count must be 1-10000.");
+        return;
+    }
+    field_.seedRandom(count, 4, std::random_device{}());
+    frameDirty_ = true;
+    onWorldEdited();
+    postMessageToUser("Seeded " + std::to_string(count) + " squares.");
+}
+
+bool Application::isGraphWorld() const {
+    return graphSpace_.isLoaded();
+}
+
+void Application::loadGraph(const std::string& filename, bool reorder) {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    if (isVoxelWorld() || isFieldWorld()) {
+        postMessageToUser("Error: Graphs need a 2D cell rule.");
+        return;
+    }
+    bool wasPaused = simulationPaused_;
+    if (!wasPaused) pauseSimulation();
+
+    std::string error;
+    if (!graphSpace_.loadFromFile(filename, rule_.getDefaultState(),
+                                  reorder ? GraphSpace::Ordering::ReverseCuthillMcKee : GraphSpace::Ordering::None, error) ||
+        !graphSpace_.bindRule(rule_.getNeighborhood(), error)) {
+        graphSpace_.clear();
+        if (logger) logger->error(error);
+        postMessageToUser("Error: " + error, 5000);
+        if (!wasPaused && isRunning_) resumeSimulation();
+        return;
+    }
+
+    lazySnapshot_.close();
+    cellSpace_.clear();
+    patternHighlights_.clear();
+    generation_ = 0;
+    frameDirty_ = true;
+    onWorldEdited();
+
+    // Every vertex is still in the default state, so frame the layout rather than the (empty) cells.
+    Point minLayout, maxLayout;
+    if (graphSpace_.getLayoutBounds(minLayout, maxLayout)) {
+        viewport_.setAutoFit(false, cellSpace_);
+        viewport_.setCenter({(minLayout.x + maxLayout.x + 1) / 2.0f, (minLayout.y + maxLayout.y + 1) / 2.0f});
+        float cellSize = 0.9f * std::min(viewport_.getScreenWidth() / static_cast<float>(maxLayout.x - minLayout.x + 1),
+                                         viewport_.getScreenHeight() / static_cast<float>(maxLayout.y - minLayout.y + 1));
+        viewport_.zoomToCellSize(cellSize, Point(viewport_.getScreenWidth() / 2, viewport_.getScreenHeight() / 2));
+    }
+    char summary[160];
+    std::snprintf(summary, sizeof(summary), "%zu vertices, %zu edges, max degree %u, bandwidth %llu -> %llu",
+                  graphSpace_.getVertexCount(), graphSpace_.getEdgeCount(), graphSpace_.getMaxDegree(),
+                  static_cast<unsigned long long>(graphSpace_.getBandwidthBefore()),
+                  static_cast<unsigned long long>(graphSpace_.getBandwidthAfter()));
+    postMessageToUser("Graph loaded: " + filename + " (" + summary + ")", 5000);
+
+    if (!wasPaused && isRunning_) resumeSimulation();
+}
+
+void Application::seedGraphSoup(float density) {
+    if (!isGraphWorld()) {
+        postMessageToUser("Error: graph-soup needs a graph (load-graph <file>).");
+        return;
+    }
+    if (density <= 0.0f || density > 1.0f) {
+        postMessageToUser("Error: Density must be in (0, 1].");
+        return;
+    }
+    std::vector<int> liveStates;
+    for (int state : rule_.getStates()) {
+        if (state != rule_.getDefaultState()) liveStates.push_back(state);
+    }
+    if (liveStates.empty()) return;
+    std::mt19937 random(std::random_device{}());
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (std::uint32_t vertex = 0; vertex < graphSpace_.getVertexCount(); ++vertex) {
+        int state = unit(random) < density ? liveStates[random() % liveStates.size()] : rule_.getDefaultState();
+        graphSpace_.setState(vertex, state);
+    }
+    std::unordered_map<Point, int> cells = graphSpace_.toCells();
+    Point minLayout, maxLayout;
+    graphSpace_.getLayoutBounds(minLayout, maxLayout);
+    cellSpace_.clear();
+    cellSpace_.loadCells(cells, minLayout, maxLayout);
+    frameDirty_ = true;
+    onWorldEdited();
+    postMessageToUser("Seeded " + std::to_string(cells.size()) + " of " + std::to_string(graphSpace_.getVertexCount()) +
+                      " vertices.");
+}
+
+void Application::unloadGraph() {
+    if (!isGraphWorld()) {
+        postMessageToUser("No graph loaded.");
+        return;
+    }
+    graphSpace_.clear();
+    clearSimulation();
+    postMessageToUser("Back to the " + std::string(latticeName(rule_.getLattice())) + " lattice.");
+}
+
+bool Application::isVoxelWorld() const {
+    return rule_.getDimensions() == 3;
+}
+
+void Application::configureVoxelSpace() {
+    sliceZ_ = 0;
+    voxelProjection_ = false;
+    if (!isVoxelWorld()) {
+        voxelSpace_.clear();
+        return;
+    }
+    voxelSpace_.configure(rule_.getBirthMask(), rule_.getSurvivalMask(), rule_.getGenerationCount(),
+                          rule_.getVoxelNeighborCount() == 26 ? VoxelSpace::Neighborhood::Moore
+                                                              : VoxelSpace::Neighborhood::VonNeumann);
+}
+
+void Application::refreshVoxelView() {
+    std::unordered_map<Point, int> cells = voxelProjection_ ? voxelSpace_.projectMax() : voxelSpace_.slice(sliceZ_);
+    Point minBounds(0, 0), maxBounds(0, 0);
+    bool first = true;
+    for (const auto& pair : cells) {
+        if (first) {
+            minBounds = maxBounds = pair.first;
+            first = false;
+            continue;
+        }
+        minBounds.x = std::min(minBounds.x, pair.first.x);
+        minBounds.y = std::min(minBounds.y, pair.first.y);
+        maxBounds.x = std::max(maxBounds.x, pair.first.x);
+        maxBounds.y = std::max(maxBounds.y, pair.first.y);
+    }
+    cellSpace_.loadCells(cells, minBounds, maxBounds);
+    if (viewport_.isAutoFitEnabled()) {
+        viewport_.updateAutoFit(cellSpace_);
+    }
+}
+
+void Application::setVoxelSlice(int z) {
+    if (!isVoxelWorld()) {
+        postMessageToUser("Error: slice needs a 3D rule.");
+        return;
+    }
+    sliceZ_ = z;
+    voxelProjection_ = false;
+    refreshVoxelView();
+    frameDirty_ = true;
+    postMessageToUser("Showing plane z=" + std::to_string(sliceZ_) + ".");
+}
+
+void Application::stepVoxelSlice(int dz) {
+    setVoxelSlice(sliceZ_ + dz);
+}
+
+void Application::setVoxelProjection(bool enabled) {
+    if (!isVoxelWorld()) {
+        postMessageToUser("Error: slice needs a 3D rule.");
+        return;
+    }
+    voxelProjection_ = enabled;
+    refreshVoxelView();
+    frameDirty_ = true;
+    postMessageToUser(enabled ? "Showing max projection along z." : "Showing plane z=" + std::to_string(sliceZ_) + ".");
+}
+
+void Application::seedVoxelSoup(int size, float density) {
+    if (!isVoxelWorld()) {
+        postMessageToUser("Error: soup3d needs a 3D rule.");
+        return;
+    }
+    if (size < 1 || size > 512 || density <= 0.0f || density > 1.0f) {
+        postMessageToUser("Error: soup3d size must be 1-512 and density in (0, 1].");
+        return;
+    }
+    std::mt19937 random(std::random_device{}());
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    int origin = -size / 2;
+    for (int z = origin; z < origin + size; ++z) {
+        for (int y = origin; y < origin + size; ++y) {
+            for (int x = origin; x < origin + size; ++x) {
+                if (unit(random) < density) voxelSpace_.setState(Point3(x, y, z), 1);
+            }
+        }
+    }
+    refreshVoxelView();
+    frameDirty_ = true;
+    onWorldEdited();
+    postMessageToUser("Seeded " + std::to_string(size) + "^3 soup, population " +
+                      std::to_string(voxelSpace_.getPopulation()) + ".");
+}
+
+void Application::reportHash() {
+    char text[128];
+    std::snprintf(text, sizeof(text), "generation=%llu population=%zu hash=%016llx shape=%016llx",
+                  static_cast<unsigned long long>(generation_), cellSpace_.getNonDefaultCells().size(),
+                  static_cast<unsigned long long>(cellSpace_.getHash()),
+                  static_cast<unsigned long long>(cellSpace_.getShapeHash()));
+    postMessageToUser(text);
+}
+
+void Application::showStats() {
+    std::string text = "Generation " + std::to_string(generation_) +
+                       ", population " + std::to_string(cellSpace_.getNonDefaultCells().size());
+    const std::vector<int>& states = populationHistory_.getStates();
+    for (std::size_t s = 0; s < states.size(); ++s) {
+        text += "\n  state " + std::to_string(states[s]) + ": " + std::to_string(cellSpace_.getStateCount(states[s]));
+        if (populationHistory_.size() > 1) {
+            std::size_t low = populationHistory_.getCount(0, s);
+            std::size_t high = low;
+            for (std::size_t i = 1; i < populationHistory_.size(); ++i) {
+                low = std::min(low, populationHistory_.getCount(i, s));
+                high = std::max(high, populationHistory_.getCount(i, s));
+            }
+            text += " (min " + std::to_string(low) + ", max " + std::to_string(high) + ")";
+        }
+    }
+    if (populationHistory_.size() > 1) {
+        text += "\nRange over generations " + std::to_string(populationHistory_.getGeneration(0)) + "-" +
+                std::to_string(populationHistory_.getGeneration(populationHistory_.size() - 1));
+    }
+    postMessageToUser(text, 8000);
+}
+
+void Application::exportStatsCsv(const std::string& filename) {
+    if (populationHistory_.size() == 0) {
+        postMessageToUser("Error: No population history recorded yet.");
+        return;
+    }
+    if (!populationHistory_.writeCsv(filename)) {
+        postMessageToUser("Error: Failed to write " + filename + ". Check logs.");
+        return;
+    }
+    postMessageToUser("Population history (" + std::to_string(populationHistory_.size()) + " generations) written to " + filename);
+}
+
+void Application::setPopulationGraph(bool enabled) {
+    showPopulationGraph_ = enabled;
+    postMessageToUser(enabled ? "Population graph: ON" : "Population graph: OFF", 1500);
+}
+
+bool Application::isPopulationGraphShown() const {
+    return showPopulationGraph_;
+}
+
+void Application::findPattern(const std::string& filename) {
+    PatternSearch search;
+    if (!search.loadFromFile(filename, cellSpace_.getDefaultState(), currentBrushState_)) {
+        postMessageToUser("Error: Could not load pattern " + filename + ". Check logs.");
+        return;
+    }
+
+    Uint64 start = SDL_GetTicksNS();
+    std::vector<PatternSearch::Match> matches = search.find(cellSpace_);
+    double elapsedMs = static_cast<double>(SDL_GetTicksNS() - start) / 1e6;
+
+    patternHighlights_.clear();
+    for (const PatternSearch::Match& match : matches) {
+        patternHighlights_.push_back(SDL_Rect{match.topLeft.x, match.topLeft.y, match.width, match.height});
+    }
+
+    std::string text = "Found " + std::to_string(matches.size()) + " match(es) of " +
+                       filename.substr(filename.find_last_of("/\\") + 1) + " (" +
+                       std::to_string(search.getVariantCount()) + " orientations, " +
+                       std::to_string(static_cast<int>(elapsedMs)) + " ms)";
+    const std::size_t MAX_LISTED = 10;
+    for (std::size_t i = 0; i < matches.size() && i < MAX_LISTED; ++i) {
+        text += "\n  (" + std::to_string(matches[i].topLeft.x) + ", " + std::to_string(matches[i].topLeft.y) + ")";
+        const char* orientation = PatternSearch::getOrientationName(matches[i].orientation);
+        if (orientation[0] != '\0') text += std::string(" ") + orientation;
+    }
+    if (matches.size() > MAX_LISTED) {
+        text += "\n  ... " + std::to_string(matches.size() - MAX_LISTED) + " more";
+    }
+    postMessageToUser(text, 8000);
+}
+
+void Application::clearPatternHighlights() {
+    patternHighlights_.clear();
+    postMessageToUser("Pattern highlights cleared.");
+}
+
+void Application::setCycleDetection(CycleDetector::Action action, bool translationAware) {
+    cycleDetector_.setAction(action);
+    cycleDetector_.setTranslationAware(translationAware);
+    if (action == CycleDetector::Action::Off) {
+        postMessageToUser("Cycle detection off.");
+        return;
+    }
+    postMessageToUser(std::string("Cycle detection: ") + (action == CycleDetector::Action::Pause ? "pause" : "notify") +
+                      (translationAware ? " (including translated copies)." : "."));
+}
+
+void Application::startFramePublishing(const std::string& channelName) {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    if (!framePublisher_.open(channelName)) {
+        postMessageToUser("Error: Could not open frame channel '" + channelName + "'. Check logs.");
+        return;
+    }
+    framePublisher_.setPalette(rule_);
+    frameDirty_ = true;
+    if (logger) logger->info("Publishing frames to shared memory '{}'.", framePublisher_.getName());
+    postMessageToUser("Publishing frames to " + framePublisher_.getName() + ". Attach with --viewer.");
+}
+
+void Application::stopFramePublishing() {
+    if (!framePublisher_.isOpen()) {
+        postMessageToUser("Frame publishing is not active.");
+        return;
+    }
+    framePublisher_.close();
+    postMessageToUser("Frame publishing stopped.");
+}
+
+void Application::startControlServer(const std::string& socketPath) {
+    if (controlServer_.isOpen()) {
+        postMessageToUser("Error: Control socket already listening on " + controlServer_.getSocketPath() + ". Use 'control off' first.");
+        return;
+    }
+    if (!controlServer_.open(socketPath)) {
+        postMessageToUser("Error: Could not open control socket '" + socketPath + "'. Check logs.");
+        return;
+    }
+    postMessageToUser("Control socket listening on " + socketPath);
+}
+
+void Application::stopControlServer() {
+    if (!controlServer_.isOpen()) {
+        postMessageToUser("Control socket is not active.");
+        return;
+    }
+    controlServer_.close();
+    postMessageToUser("Control socket closed.");
+}
+
+bool Application::executeControlCommand(const std::string& commandString, std::string& output) {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    if (logger) logger->debug("Executing control command: {}", commandString);
+
+    std::string captured;
+    messageCapture_ = &captured;
+    bool recognized = commandParser_.parseAndExecute(commandString);
+    messageCapture_ = nullptr;
+
+    output = captured;
+    // Commands report failures through user messages, so classify on the captured lines.
+    bool failed = false;
+    std::istringstream lines(captured);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.rfind("Error", 0) == 0 || line.rfind("Usage:", 0) == 0) {
+            failed = true;
+            break;
+        }
+    }
+    return recognized && !failed;
+}
+
+bool Application::applyCellUpload(const std::vector<std::pair<Point, int>>& cells, std::string& output) {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    for (const auto& cell : cells) {
+        if (!isStateAllowed(cell.second)) {
+            output = "Error: Invalid state " + std::to_string(cell.second) + " at (" +
+                     std::to_string(cell.first.x) + ", " + std::to_string(cell.first.y) + "). No cells applied.";
+            return false;
+        }
+    }
+    if (!finishLazyLoad("editing")) {
+        output = "Error: The lazily opened snapshot has corrupt chunks. No cells applied.";
+        return false;
+    }
+    for (const auto& cell : cells) {
+        cellSpace_.setCellState(cell.first, cell.second);
+    }
+    frameDirty_ = true;
+    onWorldEdited();
+    if (viewport_.isAutoFitEnabled()) {
+        viewport_.updateAutoFit(cellSpace_);
+    }
+    if (logger) logger->info("Applied {} uploaded cells.", cells.size());
+    output = std::to_string(cells.size()) + " cells applied.";
+    return true;
+}
+
+void Application::startMetricsServer(int port) {
+    if (!metricsExporter_.startHttp(port)) {
+        postMessageToUser("Error: Could not serve metrics on port " + std::to_string(port) + ". Check logs.");
+        return;
+    }
+    postMessageToUser("Serving metrics on http://127.0.0.1:" + std::to_string(port) + "/metrics");
+}
+
+void Application::startMetricsDump(const std::string& path, float intervalSeconds) {
+    if (intervalSeconds <= 0.0f) {
+        postMessageToUser("Error: Metrics dump interval must be positive.");
+        return;
+    }
+    auto interval = std::chrono::milliseconds(static_cast<long long>(intervalSeconds * 1000.0f));
+    if (interval.count() < 1) interval = std::chrono::milliseconds(1);
+    if (!metricsExporter_.startFileDump(path, interval)) {
+        postMessageToUser("Error: Could not start metrics dump to " + path + ".");
+        return;
+    }
+    postMessageToUser("Dumping metrics to " + path);
+}
+
+void Application::stopMetricsExport() {
+    if (!metricsExporter_.isServing() && !metricsExporter_.isDumping()) {
+        postMessageToUser("Metrics export is not active.");
+        return;
+    }
+    metricsExporter_.stop();
+    postMessageToUser("Metrics export stopped.");
+}
+
+void Application::showMetrics() {
+    postMessageToUser(Metrics::summary(), 5000);
+}
+
+void Application::setPerfCounters(bool enabled) {
+    if (!enabled) {
+        PerfCounters::disable();
+        postMessageToUser("Performance counters off. 'perf' still shows the collected totals.");
+        return;
+    }
+    std::string error;
+    if (PerfCounters::enable(error)) {
+        postMessageToUser("Performance counters on. 'perf' shows IPC and misses per cell for each timer zone.");
+    } else {
+        postMessageToUser("Error: Performance counters unavailable: " + error);
+    }
+}
+
+void Application::showPerfReport() {
+    postMessageToUser(PerfCounters::report(), 8000);
+}
+
+void Application::resetPerfCounters() {
+    PerfCounters::reset();
+    postMessageToUser("Performance counter totals cleared.");
+}
+
+void Application::showArenas() {
+    postMessageToUser(TaskArenas::describe(), 5000);
+}
+
+void Application::configureArena(const std::string& domain, int threads, const std::string& priority) {
+    TaskArenas::Domain arenaDomain;
+    if (!TaskArenas::parseDomain(domain, arenaDomain)) {
+        postMessageToUser("Error: Unknown arena '" + domain + "'. Use simulation, render or io.");
+        return;
+    }
+    TaskArenas::Settings settings = TaskArenas::getSettings(arenaDomain);
+    settings.threads = threads;
+    if (!priority.empty() && !TaskArenas::parsePriority(priority, settings.priority)) {
+        postMessageToUser("Error: Unknown priority '" + priority + "'. Use low, normal or high.");
+        return;
+    }
+    std::string error;
+    if (!TaskArenas::configure(arenaDomain, settings, error)) {
+        postMessageToUser("Error: " + error);
+        return;
+    }
+    postMessageToUser(std::string("Arena ") + TaskArenas::domainName(arenaDomain) + ": " + std::to_string(settings.threads) +
+                      " threads, " + TaskArenas::priorityName(settings.priority) + " priority.");
+}
+
+void Application::showSnapshotIO() {
+    std::uint64_t threshold = SnapshotIO::getDirectThreshold();
+    postMessageToUser(std::string("Snapshot I/O: ") + SnapshotIO::backendName(SnapshotIO::getBackend()) +
+                      (SnapshotIO::isIoUringAvailable() ? " (io_uring available)" : " (io_uring unavailable, pwrite)") +
+                      ", O_DIRECT " + (threshold > 0 ? "for files from " + std::to_string(threshold >> 20) + " MiB" : "off"));
+}
+
+void Application::setSnapshotIOBackend(const std::string& backend) {
+    SnapshotIO::Backend selected;
+    if (!SnapshotIO::parseBackend(backend, selected)) {
+        postMessageToUser("Error: Unknown snapshot I/O backend '" + backend + "'. Use auto, uring or pwrite.");
+        return;
+    }
+    SnapshotIO::setBackend(selected);
+    showSnapshotIO();
+}
+
+void Application::setSnapshotDirectThreshold(std::uint64_t megabytes) {
+    SnapshotIO::setDirectThreshold(megabytes << 20);
+    showSnapshotIO();
+}
+
+void Application::stepSimulation(int generations) {
+    if (generations < 1) {
+        postMessageToUser("Error: Step count must be at least 1.");
+        return;
+    }
+    if (!finishLazyLoad("stepping")) return;
+    for (int i = 0; i < generations && isRunning_; ++i) {
+        computeGeneration();
+    }
+    simulationLag_ = 0;
+    postMessageToUser("Stepped " + std::to_string(generations) + " generation(s). Generation: " + std::to_string(generation_));
+}
+
+void Application::startRecording(const std::string& filename) {
+    InputRecorder& recorder = inputHandler_.getRecorder();
+    if (recorder.getMode() != InputRecorder::Mode::Idle) {
+        postMessageToUser("Error: A recording or replay is already active.");
+        return;
+    }
+    InputRecorder::ViewState view;
+    view.screenWidth = viewport_.getScreenWidth();
+    view.screenHeight = viewport_.getScreenHeight();
+    view.cellSize = viewport_.getCurrentCellSize();
+    Viewport::PointF offset = viewport_.getViewOffsetF();
+    view.centerX = offset.x + view.screenWidth / (2.0f * view.cellSize);
+    view.centerY = offset.y + view.screenHeight / (2.0f * view.cellSize);
+    view.autoFit = viewport_.isAutoFitEnabled();
+    if (!recorder.startRecording(filename, view)) {
+        postMessageToUser("Error: Could not start recording to " + filename + ".");
+        return;
+    }
+    postMessageToUser("Recording input to " + filename + ". Use 'record stop' to finish.");
+}
+
+void Application::stopRecording() {
+    InputRecorder& recorder = inputHandler_.getRecorder();
+    if (recorder.getMode() != InputRecorder::Mode::Recording) {
+        postMessageToUser("No recording is active.");
+        return;
+    }
+    std::size_t events = recorder.getEventCount();
+    std::string path = recorder.getPath();
+    if (!recorder.stopRecording()) {
+        postMessageToUser("Error: Failed to write recording " + path + ". Check logs.");
+        return;
+    }
+    postMessageToUser("Recorded " + std::to_string(events) + " events to " + path);
+}
+
+void Application::startReplay(const std::string& filename, bool maxSpeed, bool quitWhenDone) {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    InputRecorder& recorder = inputHandler_.getRecorder();
+    if (recorder.getMode() != InputRecorder::Mode::Idle) {
+        postMessageToUser("Error: A recording or replay is already active.");
+        return;
+    }
+    if (!recorder.startReplay(filename, maxSpeed)) {
+        postMessageToUser("Error: Could not replay " + filename + ". Check logs.");
+        if (quitWhenDone) quit();
+        return;
+    }
+
+    // Restore the recorded view so screen-space events hit the same world cells.
+    const InputRecorder::ViewState& view = recorder.getViewState();
+    if (view.screenWidth > 0 && view.screenHeight > 0) {
+        if (window_) SDL_SetWindowSize(window_, view.screenWidth, view.screenHeight);
+        onWindowResized(view.screenWidth, view.screenHeight);
+    }
+    viewport_.setAutoFit(view.autoFit, cellSpace_);
+    if (!view.autoFit && view.cellSize > 0.0f) {
+        viewport_.zoomToCellSize(view.cellSize, Point(viewport_.getScreenWidth() / 2, viewport_.getScreenHeight() / 2));
+        viewport_.setCenter({view.centerX, view.centerY});
+    }
+    inputHandler_.resetState();
+
+    replayActive_ = true;
+    replayMaxSpeed_ = maxSpeed;
+    replayQuitWhenDone_ = quitWhenDone;
+    replayFrameTimesNs_.clear();
+    replayStartNs_ = SDL_GetTicksNS();
+    replayLastFrameNs_ = 0;
+    if (logger) logger->info("Replaying {} ({}).", filename, maxSpeed ? "max speed" : "recorded speed");
+    postMessageToUser("Replaying " + filename + (maxSpeed ? " at max speed." : ". Esc stops the replay."));
+}
+
+void Application::stopReplay() {
+    InputRecorder& recorder = inputHandler_.getRecorder();
+    if (recorder.getMode() != InputRecorder::Mode::Replaying && !replayActive_) {
+        postMessageToUser("No replay is active.");
+        return;
+    }
+    recorder.stopReplay();
+    finishReplay();
+}
+
+void Application::finishReplay() {
+    auto logger = Logger::getLogger(Logger::Module::Core);
+    if (!replayActive_) return;
+    replayActive_ = false;
+    replayMaxSpeed_ = false;
+    inputHandler_.resetState();
+
+    double totalMs = static_cast<double>(SDL_GetTicksNS() - replayStartNs_) / 1e6;
+    std::string report = "Replay finished: " + std::to_string(inputHandler_.getRecorder().getEventCount()) +
+                         " events, " + std::to_string(replayFrameTimesNs_.size()) + " frames in " +
+                         std::to_string(static_cast<int>(totalMs)) + " ms";
+    if (!replayFrameTimesNs_.empty()) {
+        std::vector<std::uint64_t> sorted = replayFrameTimesNs_;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentileMs = [&sorted](double q) {
+            std::size_t index = static_cast<std::size_t>(q * static_cast<double>(sorted.size() - 1) + 0.5);
+            return static_cast<double>(sorted[index]) / 1e6;
+        };
+        double sumNs = 0.0;
+        for (std::uint64_t frameNs : sorted) sumNs += static_cast<double>(frameNs);
+        char stats[160];
+        std::snprintf(stats, sizeof(stats), "; frame ms: mean %.2f  p50 %.2f  p95 %.2f  p99 %.2f  max %.2f",
+                      sumNs / static_cast<double>(sorted.size()) / 1e6,
+                      percentileMs(0.50), percentileMs(0.95), percentileMs(0.99),
+                      static_cast<double>(sorted.back()) / 1e6);
+        report += stats;
+    }
+    if (logger) logger->info(report);
+    postMessageToUser(report, 10000);
+    replayFrameTimesNs_.clear();
+
+    if (replayQuitWhenDone_) {
+        replayQuitWhenDone_ = false;
+        quit();
+    }
+}
+
 void Application::setSimulationSpeed(float updatesPerSecond) {
     auto logger = Logger::getLogger(Logger::Module::Core);
     if (updatesPerSecond <= 0.0f) {
@@ -677,6 +2017,15 @@ void Application::onWindowResized(int newWidth, int newHeight) {
 }
 
 void Application::postMessageToUser(const std::string& message, Uint32 durationMs, bool isMultiLine) {
+    if (messageCapture_) {
+        if (!messageCapture_->empty()) *messageCapture_ += '\n';
+        *messageCapture_ += message;
+    }
+    if (headless_) {
+        // There is no overlay to show messages on; route them to the log instead.
+        auto logger = Logger::getLogger(Logger::Module::UI);
+        if (logger) logger->info(message);
+    }
     userMessage_ = message;
     userMessageIsMultiLine_ = isMultiLine;
     if (isMultiLine || durationMs == 0) {
@@ -706,7 +2055,16 @@ bool Application::shouldShowBrushInfo() const {
 std::string Application::getHelpString() const {
     return "Available Commands (use '-' for spaces in command names):\n"
            "  save <file>              Saves current state\n"
+           "  save <file> --async      Saves this generation in the background\n"
+           "  autosave every <n> gens|seconds [keep <k>] [dir <path>] [limit <MiB/s>]  Periodic checkpoints\n"
+           "  autosave [off]           Shows or stops autosave\n"
            "  load <file>              Loads state from file\n"
+           "  load <file> --region x y w h  Loads only cells inside a rectangle\n"
+           "  load <file> --lazy       Loads chunks on demand as the view pans\n"
+           "  browse [dir]             Lists snapshots with header info\n"
+           "  preview <file>           Shows a snapshot thumbnail without loading it\n"
+           "  export-npy <file> [x y w h]  Writes a region (default: bounding box) as a .npy array\n"
+           "  import-npy <file> [x y]  Places a uint8/uint16 .npy array with its corner at x,y\n"
            "  load-config <file>       Loads new JSON rules & colors\n"
            "  brush-state <val>        Sets brush state (integer)\n"
            "  brush-size <val>         Sets brush size (e.g. 1, 3)\n"
@@ -716,12 +2074,34 @@ std::string Application::getHelpString() const {
            "  set-grid-threshold <px>  Grid hide threshold for auto mode\n"
            "  set-grid-width <px>      Sets grid line thickness\n"
            "  set-grid-color <r g b [a]> Sets grid line color (0-255)\n"
+           "  frame-budget [<ms>|off]  Lowers grid detail to keep drawing within ms\n"
            "  pause / resume           Toggles simulation pause\n"
            "  autofit <on|off>         Toggles viewport autofit (or toggle)\n"
            "  center                   Centers view on active cells\n"
            "  speed <ups>              Sets simulation speed (updates/sec)\n"
            "  clear-grid / clear       Clears all active cells\n"
            "  toggle-brush-info        Shows/hides brush state on screen\n"
+           "  publish <name|off>       Exports frames to shared memory for --viewer\n"
+           "  control <path|off>       Accepts commands on a Unix domain socket\n"
+           "  step [n]                 Computes n generations immediately\n"
+           "  status                   Shows generation, population and speed\n"
+           "  hash                     Shows the world hash (compare runs)\n"
+           "  slice <z|up|down|max>    3D rules: shows plane z or the max projection\n"
+           "  soup3d <size> [density]  3D rules: seeds a random cube around the origin\n"
+           "  load-graph <file> [--no-reorder]  Runs the rule on a graph's vertices (off: lattice)\n"
+           "  graph-soup [density]     Sets random vertices of the graph alive\n"
+           "  rd-seed [count]          Reaction-diffusion rules: seeds random squares of v\n"
+           "  find <pattern-file>      Finds a .cells pattern in any orientation\n"
+           "  find-clear               Removes the match highlights\n"
+           "  stats [csv <file> | graph [on|off]]  Per-state population and history\n"
+           "  cycle-detect <off|notify|pause> [translate]  Detects repeating worlds\n"
+           "  metrics [serve <port> | dump <file> [sec] | off]  Shows/exports metrics\n"
+           "  perf [on | off | report | reset]  Hardware counters (IPC, misses per cell) per timer zone\n"
+           "  arena [<simulation|render|io> <threads> [low|normal|high]]  Shows/sets TBB arena quotas\n"
+           "  snapshot-io [auto|uring|pwrite | direct <MiB|off>]  Snapshot I/O backend, O_DIRECT size\n"
+           "  record <file|stop>       Records mouse/keyboard input to a file\n"
+           "  replay <file> [max]      Replays recorded input, reports frame times\n"
+           "  replay stop              Stops the replay (or press Esc)\n"
            "  help / h / ?             Shows this help message\n"
            "  quit / exit              Exits the application\n"
            "Shortcuts:\n"
@@ -7,12 +7,24 @@
 
 #include "rule.h"
 #include "../ca/cell_space.h"
+#include "../ca/voxel_space.h"
+#include "../ca/graph_space.h"
+#include "../ca/reaction_diffusion.h"
 #include "../ca/rule_engine.h"
+#include "../ca/cycle_detector.h"
+#include "../ca/population_history.h"
 #include "../render/renderer.h"
 #include "../render/viewport.h"
 #include "../input/input_handler.h"
 #include "../input/command_parser.h"
 #include "../snap/snapshot.h"
+#include "../snap/lazy_snapshot.h"
+#include "../snap/async_saver.h"
+#include "../snap/checkpointer.h"
+#include "../ca/persistent_world.h"
+#include "../ipc/frame_channel.h"
+#include "../ipc/control_server.h"
+#include "../ipc/metrics_exporter.h"
 #include "../utils/point.h"
 
 
@@ -62,6 +74,48 @@ private:
 
     bool showBrushInfo_;
 
+    bool headless_;                     // No window/renderer; simulation only
+    std::uint64_t generation_;          // Generations computed since the world was (re)loaded
+
+    FramePublisher framePublisher_;     // Shared-memory channel for an external viewer
+    std::uint64_t lastPublishedGeneration_;
+    bool frameDirty_;                   // World edited outside of a generation step
+
+    ControlServer controlServer_;       // Unix socket for scripted automation
+    std::string* messageCapture_;       // Receives user messages while a control command runs
+
+    MetricsExporter metricsExporter_;   // Prometheus text over localhost HTTP and/or file dumps
+
+    LazySnapshotLoader lazySnapshot_;   // Streams snapshot chunks in as the viewport pans
+
+    CycleDetector cycleDetector_;       // Pauses or notifies when the world starts repeating
+
+    PopulationHistory populationHistory_; // Per-state counts of recent generations
+    bool showPopulationGraph_;
+
+    std::vector<SDL_Rect> patternHighlights_; // World rectangles of the last `find` matches
+
+    bool replayActive_;                 // Input replay in progress; frame times are collected
+    bool replayMaxSpeed_;               // Render every loop iteration, one recorded batch per frame
+    bool replayQuitWhenDone_;           // Benchmark mode: quit once the replay report is posted
+    std::vector<std::uint64_t> replayFrameTimesNs_;
+    std::uint64_t replayStartNs_;
+    std::uint64_t replayLastFrameNs_;
+
+    PersistentWorld worldVersions_;     // Published generations for readers off the simulation thread
+    AsyncSnapshotSaver asyncSaver_;     // Declared after worldVersions_: must stop before it is destroyed
+    std::size_t asyncSavesQueued_;      // Background saves not yet reported to the user
+    Checkpointer checkpointer_;         // Periodic checkpoints; also holds views of worldVersions_
+
+    VoxelSpace voxelSpace_;             // World of 3D rules; cellSpace_ then holds the 2D view
+    int sliceZ_;                        // Plane shown and edited in 3D
+    bool voxelProjection_;              // Show the max-state projection along z instead of a plane
+
+    GraphSpace graphSpace_;             // Graph world loaded with load-graph; cellSpace_ then shows its vertices
+    std::vector<std::uint32_t> changedVertices_;
+
+    ReactionDiffusionField field_;      // Float field of reaction-diffusion rules; cellSpace_ stays empty
+
 
     bool initializeSDL();
     bool initializeSubsystems(const std::string& configPath); // Takes path for initial load
@@ -70,7 +124,24 @@ private:
 
     void processInput();
     void updateSimulation();
+    void computeGeneration();
+    bool isStateAllowed(int state) const;
+    void onWorldEdited(); // Refreshes metrics and cycle history after edits
+    bool isVoxelWorld() const;
+    void configureVoxelSpace();
+    void refreshVoxelView(); // Rebuilds cellSpace_ from the current slice or projection
+    bool isGraphWorld() const;
+    bool isFieldWorld() const;
+    void configureField();
+    void frameField(); // Fits the whole field in the window
+    void publishWorldVersion();
+    void pollAsyncSaves();
+    void pollCheckpoints();
+    void streamVisibleChunks();
+    bool finishLazyLoad(const std::string& action);
     void renderScene();
+    void publishFrameIfNeeded();
+    void recordReplayFrame();
 
 public:
     Application();
@@ -79,7 +150,12 @@ public:
     Application(const Application&) = delete;
     Application& operator=(const Application&) = delete;
 
-    bool initialize(const std::string& configPath);
+    /**
+     * @brief Initializes SDL and all subsystems.
+     * @param configPath Rule file to load.
+     * @param headless If true, no window or renderer is created and the simulation starts running.
+     */
+    bool initialize(const std::string& configPath, bool headless = false);
     void run();
     void quit();
 
@@ -95,11 +171,20 @@ public:
     void pauseSimulation();
     void resumeSimulation();
     void setSimulationSpeed(float updatesPerSecond);
+    /**
+     * @brief Computes the given number of generations immediately, even while paused.
+     */
+    void stepSimulation(int generations);
 
     // Brush control
     void setBrushState(int state);
     void setBrushSize(int size);
     void applyBrush(Point worldPos);
+    /**
+     * @brief Paints the area the brush sweeps along a polyline of world cells as one edit.
+     * Only cells whose state changes are written.
+     */
+    void applyBrushStroke(const std::vector<Point>& path);
     int getCurrentBrushState() const;
     int getCurrentBrushSize() const;
     void toggleBrushInfoDisplay();
@@ -119,6 +204,11 @@ public:
     void setGridHideThreshold(int threshold);
     void setGridLineWidth(int width); // New: sets grid line width
     void setGridLineColor(int r, int g, int b, int a = 255); // New: sets grid line color
+    /**
+     * @brief Target renderGrid time in ms; detail drops automatically when it is exceeded. 0 turns it off.
+     */
+    void setFrameBudget(double milliseconds);
+    void showFrameBudget();
 
 
     // Viewport control
@@ -128,10 +218,177 @@ public:
 
     // File operations
     void saveSnapshot(const std::string& filename);
-    void loadSnapshot(const std::string& filename);
+    /**
+     * @brief Saves the current generation on a background thread while the simulation continues.
+     */
+    void saveSnapshotAsync(const std::string& filename);
+    bool loadSnapshot(const std::string& filename);
+    /**
+     * @brief Checkpoints the world in the background every n generations or seconds, keeping the newest keep files.
+     * @param directory Empty keeps the current directory; bytesPerSecond 0 means unlimited.
+     */
+    void configureAutosave(bool seconds, std::uint64_t every, std::size_t keep, const std::string& directory,
+                           std::uint64_t bytesPerSecond);
+    void disableAutosave();
+    void showAutosave();
+    /**
+     * @brief Loads the newest complete checkpoint in directory; later autosaves continue there.
+     */
+    bool resumeFromCheckpoints(const std::string& directory);
+    /**
+     * @brief Loads only the cells of a snapshot inside a world rectangle, decoding the covering chunks.
+     */
+    void loadSnapshotRegion(const std::string& filename, int x, int y, int width, int height);
+    /**
+     * @brief Opens a snapshot for viewing: only its header is read, chunks load as they become visible.
+     */
+    void openSnapshotLazy(const std::string& filename);
+    /**
+     * @brief Writes a world rectangle as a dense uint8/uint16 NumPy array (.npy).
+     */
+    void exportNpy(const std::string& filename, int x, int y, int width, int height);
+    /**
+     * @brief Exports the bounding box of the non-default cells.
+     */
+    void exportNpy(const std::string& filename);
+    /**
+     * @brief Overwrites the cells covered by a NumPy array whose element (0, 0) lands on cell (x, y).
+     */
+    void importNpy(const std::string& filename, int x, int y);
+    /**
+     * @brief Lists snapshots in a directory using only their headers (newest first).
+     */
+    void browseSnapshots(const std::string& directory);
+    /**
+     * @brief Shows a snapshot's header and ASCII density thumbnail without decoding its cells.
+     */
+    void previewSnapshot(const std::string& filename);
 
     // Grid operations
     void clearSimulation();
+    std::uint64_t getGeneration() const;
+    void reportStatus();
+    /**
+     * @brief Shows the world hashes, usable to compare runs across engines and thread counts.
+     */
+    void reportHash();
+    void setCycleDetection(CycleDetector::Action action, bool translationAware);
+
+    // 3D worlds
+    /**
+     * @brief Shows and edits the plane z of a 3D world.
+     */
+    void setVoxelSlice(int z);
+    void stepVoxelSlice(int dz);
+    /**
+     * @brief Shows the maximum state along z of every column instead of a single plane.
+     */
+    void setVoxelProjection(bool enabled);
+    /**
+     * @brief Fills a cube of the given edge length centered on the origin with random live cells.
+     */
+    void seedVoxelSoup(int size, float density);
+
+    // Graph worlds
+    /**
+     * @brief Runs the current rule on the vertices of a graph file instead of the lattice.
+     * @param reorder Renumber vertices with reverse Cuthill-McKee for locality.
+     */
+    void loadGraph(const std::string& filename, bool reorder);
+    void unloadGraph();
+    /**
+     * @brief Sets each vertex to a random live state with the given probability.
+     */
+    void seedGraphSoup(float density);
+
+    // Reaction-diffusion fields
+    /**
+     * @brief Seeds count random squares of v into the field.
+     */
+    void seedField(int count);
+
+    // Population statistics
+    /**
+     * @brief Shows per-state counts with their range over the recorded history.
+     */
+    void showStats();
+    void exportStatsCsv(const std::string& filename);
+    void setPopulationGraph(bool enabled);
+    bool isPopulationGraphShown() const;
+
+    // Pattern search
+    /**
+     * @brief Finds every occurrence of a pattern file in any orientation and highlights them.
+     */
+    void findPattern(const std::string& filename);
+    void clearPatternHighlights();
+
+    // External viewer channel
+    /**
+     * @brief Starts exporting the visible region into a shared-memory triple buffer.
+     * @param channelName Name a viewer attaches to with `--viewer <name>`.
+     */
+    void startFramePublishing(const std::string& channelName);
+    void stopFramePublishing();
+
+    // Scripted control
+    /**
+     * @brief Starts accepting commands on a Unix domain socket (see ControlServer for the protocol).
+     */
+    void startControlServer(const std::string& socketPath);
+    void stopControlServer();
+    /**
+     * @brief Runs one command on behalf of a control client.
+     * @param output Receives every message the command posted to the user.
+     * @return False if the command was unknown or reported an error.
+     */
+    bool executeControlCommand(const std::string& commandString, std::string& output);
+    /**
+     * @brief Writes a batch of cells uploaded by a control client.
+     * @return False (and nothing is written) if any state is not valid for the current rule.
+     */
+    bool applyCellUpload(const std::vector<std::pair<Point, int>>& cells, std::string& output);
+
+    // Metrics export
+    void startMetricsServer(int port);
+    void startMetricsDump(const std::string& path, float intervalSeconds);
+    void stopMetricsExport();
+    void showMetrics();
+    /**
+     * @brief Turns hardware performance counters for the Timer zones on or off.
+     */
+    void setPerfCounters(bool enabled);
+    void showPerfReport();
+    void resetPerfCounters();
+    /**
+     * @brief Shows the thread quota and priority of the simulation, render and I/O arenas.
+     */
+    void showArenas();
+    void configureArena(const std::string& domain, int threads, const std::string& priority);
+    /**
+     * @brief Shows or selects the snapshot I/O backend (auto, uring, pwrite) and the O_DIRECT size.
+     */
+    void showSnapshotIO();
+    void setSnapshotIOBackend(const std::string& backend);
+    void setSnapshotDirectThreshold(std::uint64_t megabytes);
+
+    // Input recording
+    /**
+     * @brief Records the input event stream to a file until stopRecording() is called.
+     */
+    void startRecording(const std::string& filename);
+    void stopRecording();
+    /**
+     * @brief Restores the recorded view and feeds the recorded events back through InputHandler.
+     * @param maxSpeed Ignore recorded timestamps and the frame rate limit; one recorded batch per frame.
+     * @param quitWhenDone Exit after the frame-time report (benchmark mode).
+     */
+    void startReplay(const std::string& filename, bool maxSpeed, bool quitWhenDone = false);
+    void stopReplay();
+    /**
+     * @brief Ends the replay statistics and reports frame times. Safe to call more than once.
+     */
+    void finishReplay();
 
     // System events
     void onWindowResized(int newWidth, int newHeight);
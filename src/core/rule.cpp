@@ -3,12 +3,20 @@
 #include <fstream>
 #include <stdexcept>
 #include <algorithm> // Required for std::transform
+#include <cctype>
 
 using json = nlohmann::json;
 
 Rule::Rule()
     : defaultState_(0),
-      loadedSuccessfully_(false)
+      lattice_(Lattice::Square),
+      loadedSuccessfully_(false),
+      ruleType_(RuleType::Plugin),
+      birthMask_(0),
+      survivalMask_(0),
+      generationCount_(0),
+      dimensions_(2),
+      voxelNeighborCount_(26)
 {
 }
 
@@ -32,15 +40,76 @@ bool Rule::loadFromFile(const std::string& filePath) {
         if (logger) logger->error("Generic error reading file " + filePath + " - " + std::string(e.what()));
         return false;
     }
+    return loadFromJson(ruleJson, filePath);
+}
+
+bool Rule::loadFromJsonString(const std::string& jsonText) {
+    auto logger = Logger::getLogger(Logger::Module::Rule);
+    loadedSuccessfully_ = false;
+
+    json ruleJson;
+    try {
+        ruleJson = json::parse(jsonText);
+    } catch (json::parse_error& e) {
+        if (logger) logger->error("JSON parsing error in rule string - " + std::string(e.what()));
+        return false;
+    }
+    return loadFromJson(ruleJson, "<string>");
+}
 
-    if (!parseStates(ruleJson)) return false;
-    if (!parseDefaultState(ruleJson)) return false;
-    if (!parseNeighborhood(ruleJson)) return false;
-    if (!parseRuleSettings(ruleJson)) return false;
-    if (!parseStateColorMap(ruleJson)) return false;
+bool Rule::loadFromJson(const json& ruleJson, const std::string& source) {
+    auto logger = Logger::getLogger(Logger::Module::Rule);
+    loadedSuccessfully_ = false;
+    if (!ruleJson.is_object()) {
+        if (logger) logger->error("Rule " + source + " is not a JSON object.");
+        return false;
+    }
+
+    ruleType_ = RuleType::Plugin;
+    dimensions_ = 2;
+    if (!parseLattice(ruleJson)) return false;
+    if (ruleJson.contains("dimensions")) {
+        if (!ruleJson["dimensions"].is_number_integer() ||
+            (ruleJson["dimensions"].get<int>() != 2 && ruleJson["dimensions"].get<int>() != 3)) {
+            if (logger) logger->error("'dimensions' must be 2 or 3.");
+            return false;
+        }
+        dimensions_ = ruleJson["dimensions"].get<int>();
+    }
+    if (dimensions_ == 3 && !(ruleJson.contains("rule_type") && ruleJson["rule_type"] == "generations")) {
+        if (logger) logger->error("3D rules must be totalistic: set \"rule_type\": \"generations\" and a rulestring.");
+        return false;
+    }
+    if (ruleJson.contains("rule_type") && ruleJson["rule_type"] == "reaction_diffusion") {
+        if (dimensions_ != 2 || lattice_ != Lattice::Square) {
+            if (logger) logger->error("Reaction-diffusion rules are only supported in 2D on the square lattice.");
+            return false;
+        }
+        if (!parseReactionDiffusionRule(ruleJson)) return false;
+    } else if (ruleJson.contains("rule_type") && ruleJson["rule_type"] == "generations") {
+        if (lattice_ != Lattice::Square) {
+            if (logger) logger->error("Generations rules are only supported on the square lattice.");
+            return false;
+        }
+        if (!parseGenerationsRule(ruleJson)) return false;
+    } else {
+        if (!parseStates(ruleJson)) return false;
+        if (!parseDefaultState(ruleJson)) return false;
+        if (!parseNeighborhood(ruleJson)) return false;
+        if (!parseRuleSettings(ruleJson)) return false;
+    }
+    if (ruleType_ == RuleType::ReactionDiffusion && !ruleJson.contains("state_color_map")) {
+        // Brush states 0 (reset) and 1 (seed) take the two ends of the colormap.
+        auto table = buildColormapTable(reactionDiffusion_.colormap);
+        stateColorMap_.clear();
+        stateColorMap_[0] = Color(table[0][0], table[0][1], table[0][2], 255);
+        stateColorMap_[1] = Color(table[255][0], table[255][1], table[255][2], 255);
+    } else if (!parseStateColorMap(ruleJson)) {
+        return false;
+    }
 
     loadedSuccessfully_ = true;
-    if (logger) logger->info("Configuration loaded successfully from " + filePath);
+    if (logger) logger->info("Configuration loaded successfully from " + source);
     return true;
 }
 
@@ -122,6 +191,18 @@ bool Rule::parseNeighborhood(const json& j) {
     return true;
 }
 
+bool Rule::parseLattice(const json& j) {
+    auto logger = Logger::getLogger(Logger::Module::Rule);
+    lattice_ = Lattice::Square;
+    if (!j.contains("lattice")) return true;
+    if (!j["lattice"].is_string() || !::parseLattice(j["lattice"].get<std::string>(), lattice_)) {
+        if (logger) logger->error("'lattice' must be one of \"square\", \"hex\" or \"triangle\".");
+        return false;
+    }
+    if (logger) logger->info(std::string("Lattice: ") + latticeName(lattice_));
+    return true;
+}
+
 bool Rule::parseRuleSettings(const json& j) {
     auto logger = Logger::getLogger(Logger::Module::Rule);
     // Reset member variables related to rules before parsing
@@ -152,6 +233,225 @@ bool Rule::parseRuleSettings(const json& j) {
     }
 }
 
+bool Rule::parseGenerationsRulestring(const std::string& rulestring, std::uint32_t& birthMask,
+                                      std::uint32_t& survivalMask, int& stateCount, int maxNeighbors) {
+    std::vector<std::string> parts(1);
+    for (char ch : rulestring) {
+        if (ch == '/' || ch == '_') {
+            parts.emplace_back();
+        } else if (ch != ' ') {
+            parts.back() += ch;
+        }
+    }
+    if (parts.size() != 3) return false;
+
+    auto parseNumber = [](const std::string& text, int& value) {
+        if (text.empty() || text.size() > 2) return false;
+        for (char ch : text) {
+            if (!std::isdigit(static_cast<unsigned char>(ch))) return false;
+        }
+        value = std::stoi(text);
+        return true;
+    };
+    auto parseCounts = [&](const std::string& body, std::uint32_t& mask) {
+        mask = 0;
+        if (body.find_first_of(",-") == std::string::npos) {
+            // Classic notation: every digit is one count.
+            for (char ch : body) {
+                if (!std::isdigit(static_cast<unsigned char>(ch)) || ch - '0' > maxNeighbors) return false;
+                mask |= 1u << (ch - '0');
+            }
+            return true;
+        }
+        std::size_t start = 0;
+        while (start <= body.size()) {
+            std::size_t end = body.find(',', start);
+            if (end == std::string::npos) end = body.size();
+            std::string item = body.substr(start, end - start);
+            std::size_t dash = item.find('-');
+            int low, high;
+            if (dash == std::string::npos) {
+                if (!parseNumber(item, low)) return false;
+                high = low;
+            } else if (!parseNumber(item.substr(0, dash), low) || !parseNumber(item.substr(dash + 1), high)) {
+                return false;
+            }
+            if (low > high || high > maxNeighbors) return false;
+            for (int n = low; n <= high; ++n) mask |= 1u << n;
+            start = end + 1;
+        }
+        return true;
+    };
+
+    bool hasBirth = false, hasSurvival = false, hasCount = false;
+    std::string countDigits;
+    bool lettered = !parts[0].empty() && std::isalpha(static_cast<unsigned char>(parts[0][0]));
+    for (std::size_t i = 0; i < parts.size(); ++i) {
+        std::string body = parts[i];
+        char kind;
+        if (lettered) {
+            if (body.empty()) return false;
+            kind = static_cast<char>(std::toupper(static_cast<unsigned char>(body[0])));
+            body.erase(0, 1);
+        } else {
+            kind = "SBC"[i]; // Numeric form: survival/birth/count
+        }
+        if (kind == 'B' && !hasBirth) {
+            if (!parseCounts(body, birthMask)) return false;
+            hasBirth = true;
+        } else if (kind == 'S' && !hasSurvival) {
+            if (!parseCounts(body, survivalMask)) return false;
+            hasSurvival = true;
+        } else if ((kind == 'C' || kind == 'G') && !hasCount) {
+            countDigits = body;
+            hasCount = true;
+        } else {
+            return false;
+        }
+    }
+    if (!hasBirth || !hasSurvival || !hasCount || countDigits.empty() || countDigits.size() > 3) return false;
+    for (char ch : countDigits) {
+        if (!std::isdigit(static_cast<unsigned char>(ch))) return false;
+    }
+    stateCount = std::stoi(countDigits);
+    // B0 would turn the infinite dead background on every generation.
+    return stateCount >= 2 && stateCount <= 256 && !(birthMask & 1u);
+}
+
+bool Rule::parseGenerationsRule(const json& j) {
+    auto logger = Logger::getLogger(Logger::Module::Rule);
+    rules_.clear();
+    ruleDllPath_.clear();
+    ruleFunctionName_.clear();
+
+    try {
+        if (!j.contains("rulestring") || !j["rulestring"].is_string()) {
+            if (logger) logger->error("'rulestring' is missing or not a string for generations rule mode.");
+            return false;
+        }
+        rulestring_ = j["rulestring"].get<std::string>();
+        voxelNeighborCount_ = 26;
+        if (dimensions_ == 3 && j.contains("neighborhood")) {
+            std::string name = j["neighborhood"].is_string() ? j["neighborhood"].get<std::string>() : "";
+            if (name == "von_neumann") {
+                voxelNeighborCount_ = 6;
+            } else if (name != "moore") {
+                if (logger) logger->error("'neighborhood' of a 3D rule must be \"moore\" (26) or \"von_neumann\" (6).");
+                return false;
+            }
+        }
+        int maxNeighbors = dimensions_ == 3 ? voxelNeighborCount_ : 8;
+        if (!parseGenerationsRulestring(rulestring_, birthMask_, survivalMask_, generationCount_, maxNeighbors)) {
+            if (logger) logger->error("Invalid generations rulestring '" + rulestring_ + "'. Expected e.g. \"B2/S/C3\", \"345/2/4\" or \"B5-7/S4,6/C2\" (counts up to " +
+                                      std::to_string(maxNeighbors) + ", no B0, 2-256 states).");
+            return false;
+        }
+    } catch (const json::exception& e) {
+        if (logger) logger->error("JSON exception during parsing generations rule: " + std::string(e.what()));
+        return false;
+    }
+
+    // States, default state and neighborhood follow from the rule: 0 dead, 1 firing, then the
+    // refractory states; Moore neighbors followed by the cell itself.
+    if (j.contains("states") || j.contains("default_state") || (dimensions_ == 2 && j.contains("neighborhood"))) {
+        if (logger) logger->warn("'states', 'default_state' and 'neighborhood' are implied by a generations rule and ignored.");
+    }
+    states_.clear();
+    for (int s = 0; s < generationCount_; ++s) states_.push_back(s);
+    defaultState_ = 0;
+    if (dimensions_ == 3) {
+        neighborhood_.clear(); // Voxel worlds are stepped by VoxelSpace; the 2D view has no neighborhood
+    } else {
+        neighborhood_ = {
+            {-1, -1}, {-1, 0}, {-1, 1},
+            { 0, -1},          { 0, 1},
+            { 1, -1}, { 1, 0}, { 1, 1},
+            { 0,  0}
+        };
+    }
+    ruleType_ = RuleType::Generations;
+    if (logger) logger->info("Generations rule parsed: " + rulestring_ + " (" + std::to_string(generationCount_) + " states).");
+    return true;
+}
+
+bool Rule::parseReactionDiffusionRule(const json& j) {
+    auto logger = Logger::getLogger(Logger::Module::Rule);
+    rules_.clear();
+    ruleDllPath_.clear();
+    ruleFunctionName_.clear();
+    rulestring_.clear();
+
+    ReactionDiffusionSettings settings;
+    try {
+        if (j.contains("model") && j["model"] != "gray_scott") {
+            if (logger) logger->error("Unsupported reaction-diffusion 'model'; only \"gray_scott\" is available.");
+            return false;
+        }
+        settings.width = j.value("width", settings.width);
+        settings.height = j.value("height", settings.height);
+        settings.diffusionU = j.value("diffusion_u", settings.diffusionU);
+        settings.diffusionV = j.value("diffusion_v", settings.diffusionV);
+        settings.feed = j.value("feed", settings.feed);
+        settings.kill = j.value("kill", settings.kill);
+        settings.dt = j.value("dt", settings.dt);
+        settings.stencil = j.value("stencil", settings.stencil);
+        settings.stepsPerGeneration = j.value("steps_per_generation", settings.stepsPerGeneration);
+        if (j.contains("colormap")) {
+            std::string name = j["colormap"].get<std::string>();
+            if (!::parseColormap(name, settings.colormap)) {
+                if (logger) logger->error("Unknown 'colormap' \"" + name + "\". Expected grayscale, viridis, inferno or coolwarm.");
+                return false;
+            }
+        }
+        if (j.contains("display_range")) {
+            const auto& range = j["display_range"];
+            if (!range.is_array() || range.size() != 2) {
+                if (logger) logger->error("'display_range' must be [min, max].");
+                return false;
+            }
+            settings.displayMin = range[0].get<float>();
+            settings.displayMax = range[1].get<float>();
+        }
+    } catch (const json::exception& e) {
+        if (logger) logger->error("JSON exception during parsing reaction-diffusion rule: " + std::string(e.what()));
+        return false;
+    }
+
+    if (settings.width < 3 || settings.height < 3 || settings.width > 8192 || settings.height > 8192) {
+        if (logger) logger->error("Reaction-diffusion 'width' and 'height' must be between 3 and 8192.");
+        return false;
+    }
+    if (settings.stencil != 5 && settings.stencil != 9) {
+        if (logger) logger->error("'stencil' must be 5 or 9.");
+        return false;
+    }
+    if (settings.stepsPerGeneration < 1 || settings.dt <= 0.0f || settings.diffusionU < 0.0f || settings.diffusionV < 0.0f ||
+        settings.displayMax <= settings.displayMin) {
+        if (logger) logger->error("Reaction-diffusion needs steps_per_generation >= 1, dt > 0, non-negative diffusion and display_range min < max.");
+        return false;
+    }
+    // Explicit Euler is stable while dt * D * |lowest Laplacian eigenvalue| <= 2: 8 for the
+    // 5-point stencil, 1.6 for the 9-point one.
+    float largestEigenvalue = settings.stencil == 5 ? 8.0f : 1.6f;
+    if (settings.dt * std::max(settings.diffusionU, settings.diffusionV) * largestEigenvalue > 2.0f) {
+        if (logger) logger->error("Reaction-diffusion time step is unstable: dt * diffusion must be at most " +
+                                  std::to_string(2.0f / largestEigenvalue) + " for the " + std::to_string(settings.stencil) + "-point stencil.");
+        return false;
+    }
+
+    if (j.contains("states") || j.contains("default_state") || j.contains("neighborhood")) {
+        if (logger) logger->warn("'states', 'default_state' and 'neighborhood' are implied by a reaction-diffusion rule and ignored.");
+    }
+    reactionDiffusion_ = settings;
+    states_ = {0, 1}; // Brush states: 0 resets (u=1, v=0), 1 seeds v
+    defaultState_ = 0;
+    neighborhood_.clear(); // The field is stepped by ReactionDiffusionField, not the cell engine
+    ruleType_ = RuleType::ReactionDiffusion;
+    if (logger) logger->info("Reaction-diffusion rule parsed: {}x{}, F={}, k={}, {}-point stencil.",
+                             settings.width, settings.height, settings.feed, settings.kill, settings.stencil);
+    return true;
+}
+
 // Helper function for default color assignment (to avoid repetition)
 void assignDefaultColors(std::map<int, Color>& mapToFill, const std::vector<int>& states) {
     auto logger = Logger::getLogger(Logger::Module::Rule);
@@ -277,6 +577,10 @@ const std::vector<Point>& Rule::getNeighborhood() const {
     return neighborhood_;
 }
 
+Lattice Rule::getLattice() const {
+    return lattice_;
+}
+
 const std::vector<std::vector<int>>& Rule::getStateUpdateRules() const {
     return rules_;
 }
@@ -293,6 +597,38 @@ const std::map<int, Color>& Rule::getStateColorMap() const {
     return stateColorMap_;
 }
 
+Rule::RuleType Rule::getRuleType() const {
+    return ruleType_;
+}
+
+const std::string& Rule::getRulestring() const {
+    return rulestring_;
+}
+
+std::uint32_t Rule::getBirthMask() const {
+    return birthMask_;
+}
+
+std::uint32_t Rule::getSurvivalMask() const {
+    return survivalMask_;
+}
+
+int Rule::getGenerationCount() const {
+    return generationCount_;
+}
+
+int Rule::getDimensions() const {
+    return dimensions_;
+}
+
+int Rule::getVoxelNeighborCount() const {
+    return voxelNeighborCount_;
+}
+
+const ReactionDiffusionSettings& Rule::getReactionDiffusionSettings() const {
+    return reactionDiffusion_;
+}
+
 Color Rule::getColorForState(int state) const {
     auto logger = Logger::getLogger(Logger::Module::Rule);
     auto it = stateColorMap_.find(state);
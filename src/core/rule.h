@@ -6,11 +6,36 @@
 #include <map>
 #include "../utils/point.h" // For Point (neighborhood definition)
 #include "../utils/color.h"  // For Color (state color mapping)
+#include "../utils/lattice.h" // For Lattice (cell shape and neighbor kernels)
+#include "../utils/colormap.h" // For Colormap (float field display)
 #include <cstdint>
 #include <nlohmann/json.hpp>
 
 
 
+/**
+ * @struct ReactionDiffusionSettings
+ * @brief Parameters of a Gray-Scott reaction-diffusion rule.
+ *
+ * Per step, with L the discrete Laplacian:
+ *   u += dt * (diffusionU * L(u) - u*v*v + feed * (1 - u))
+ *   v += dt * (diffusionV * L(v) + u*v*v - (feed + kill) * v)
+ */
+struct ReactionDiffusionSettings {
+    int width = 256;                  // Field size in cells; edges wrap around
+    int height = 256;
+    float diffusionU = 0.16f;
+    float diffusionV = 0.08f;
+    float feed = 0.03f;
+    float kill = 0.062f;
+    float dt = 1.0f;
+    int stencil = 5;                  // 5-point or 9-point Laplacian
+    int stepsPerGeneration = 1;       // Integration steps per simulation generation
+    Colormap colormap = Colormap::Viridis;
+    float displayMin = 0.0f;          // v mapped to the low end of the colormap
+    float displayMax = 0.5f;          // v mapped to the high end of the colormap
+};
+
 /**
  * @class Config
  * @brief Manages the configuration for the Cellular Automaton.
@@ -20,11 +45,19 @@
  * (either Trie-based or via external DLL), and state-color mappings.
  */
 class Rule {
+public:
+    enum class RuleType {
+        Plugin,      // Update function loaded from a shared library
+        Generations,      // Built-in B/S/C "Generations" rule given by a rulestring
+        ReactionDiffusion // Continuous two-channel Gray-Scott field
+    };
+
 private:
     // --- Configuration Parameters ---
     std::vector<int> states_;                     // List of all possible cell states.
     int defaultState_;                            // The default state for cells not explicitly defined.
     std::vector<Point> neighborhood_;             // Defines neighbor offsets (e.g., Moore, Von Neumann).
+    Lattice lattice_;                             // Cell lattice; neighbor offsets are for parity-0 cells.
 
     bool loadedSuccessfully_;                     // Flag to indicate if configuration was loaded without errors.
 
@@ -37,13 +70,31 @@ private:
 
     std::map<int, Color> stateColorMap_;          // Maps each cell state to a specific color for rendering.
 
+    // For built-in Generations rules
+    RuleType ruleType_;
+    std::string rulestring_;                      // As written in the rule file, e.g. "B2/S/C3".
+    std::uint32_t birthMask_;                     // Bit n: birth with n firing neighbors.
+    std::uint32_t survivalMask_;                  // Bit n: survival with n firing neighbors.
+    int generationCount_;                         // C: number of states including dead and firing.
+
+    // For 3D worlds (always Generations semantics)
+    int dimensions_;                              // 2, or 3 for a voxel world.
+    int voxelNeighborCount_;                      // 26 (Moore) or 6 (von Neumann).
+
+    // For reaction-diffusion fields
+    ReactionDiffusionSettings reactionDiffusion_;
+
 
     // --- Helper methods for parsing JSON ---
     bool parseStates(const nlohmann::json& j);
     bool parseDefaultState(const nlohmann::json& j);
     bool parseNeighborhood(const nlohmann::json& j);
+    bool parseLattice(const nlohmann::json& j);
     bool parseRuleSettings(const nlohmann::json& j); // Handles both Trie and DLL rules
     bool parseStateColorMap(const nlohmann::json& j);
+    bool parseGenerationsRule(const nlohmann::json& j); // Derives states and neighborhood from the rulestring
+    bool parseReactionDiffusionRule(const nlohmann::json& j);
+    bool loadFromJson(const nlohmann::json& ruleJson, const std::string& source);
 
 public:
     /**
@@ -59,6 +110,13 @@ public:
      */
     bool loadFromFile(const std::string& filePath);
 
+    /**
+     * @brief Loads the configuration from JSON text, e.g. a rule passed through the C API.
+     * Plugin paths in the JSON are resolved relative to the working directory.
+     * @return True if parsing and validation succeeded. Errors are logged.
+     */
+    bool loadFromJsonString(const std::string& jsonText);
+
     /**
      * @brief Checks if the configuration was loaded successfully.
      * @return True if loaded successfully, false otherwise.
@@ -70,6 +128,7 @@ public:
     const std::vector<int>& getStates() const;
     int getDefaultState() const;
     const std::vector<Point>& getNeighborhood() const;
+    Lattice getLattice() const;
 
     const std::vector<std::vector<int>>& getStateUpdateRules() const; // For Trie mode
     const std::string& getRuleDllPath() const;                     // For DLL mode
@@ -77,6 +136,26 @@ public:
 
     const std::map<int, Color>& getStateColorMap() const;
 
+    RuleType getRuleType() const;
+    const std::string& getRulestring() const;         // For Generations mode
+    std::uint32_t getBirthMask() const;               // For Generations mode
+    std::uint32_t getSurvivalMask() const;            // For Generations mode
+    int getGenerationCount() const;                   // For Generations mode
+    int getDimensions() const;                        // 2, or 3 for a voxel world
+    int getVoxelNeighborCount() const;                // For 3D: 26 or 6
+    const ReactionDiffusionSettings& getReactionDiffusionSettings() const; // For ReactionDiffusion mode
+
+    /**
+     * @brief Parses a Generations rulestring.
+     * Accepts "B2/S/C3" (letters in any order, C or G for the state count) and the
+     * numeric "S/B/C" form "345/2/4". Counts are single digits, or comma-separated numbers
+     * and ranges for 3D neighborhoods ("B5-7/S4,6,9-12/C2"); B0 is rejected.
+     * @param maxNeighbors Largest allowed count (8 in 2D, 26 or 6 in 3D).
+     * @return False if the rulestring is malformed.
+     */
+    static bool parseGenerationsRulestring(const std::string& rulestring, std::uint32_t& birthMask,
+                                           std::uint32_t& survivalMask, int& stateCount, int maxNeighbors = 8);
+
     /**
      * @brief Gets the color for a specific state.
      * @param state The cell state.
@@ -0,0 +1,73 @@
+#include "brush_stroke.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace BrushStroke {
+
+    namespace {
+        // Bresenham cells from a to b, both ends included.
+        void traceLine(Point a, Point b, std::vector<Point>& cells) {
+            cells.clear();
+            int x = a.x;
+            int y = a.y;
+            const int dx = std::abs(b.x - x);
+            const int dy = -std::abs(b.y - y);
+            const int stepX = x < b.x ? 1 : -1;
+            const int stepY = y < b.y ? 1 : -1;
+            int error = dx + dy;
+            cells.push_back(Point(x, y));
+            while (x != b.x || y != b.y) {
+                int doubled = 2 * error;
+                if (doubled >= dy) {
+                    error += dy;
+                    x += stepX;
+                }
+                if (doubled <= dx) {
+                    error += dx;
+                    y += stepY;
+                }
+                cells.push_back(Point(x, y));
+            }
+        }
+    }
+
+    std::vector<Span> rasterize(const std::vector<Point>& path, int halfSize) {
+        std::vector<Span> stamps;
+        if (path.empty()) return stamps;
+        halfSize = std::max(halfSize, 0);
+
+        // One span per row and segment instead of one per row and line cell: along a Bresenham
+        // line x and y are monotonic and move by at most one per cell, so the stamps covering a
+        // row are a contiguous run of line cells whose union is one interval.
+        std::vector<Point> cells;
+        for (std::size_t i = 0; i < path.size(); ++i) {
+            traceLine(i == 0 ? path[0] : path[i - 1], path[i], cells);
+            if (cells.back().y < cells.front().y) std::reverse(cells.begin(), cells.end());
+            std::size_t first = 0;
+            std::size_t last = 0;
+            for (int row = cells.front().y - halfSize; row <= cells.back().y + halfSize; ++row) {
+                while (first < cells.size() && cells[first].y < row - halfSize) ++first;
+                while (last + 1 < cells.size() && cells[last + 1].y <= row + halfSize) ++last;
+                int x0 = std::min(cells[first].x, cells[last].x);
+                int x1 = std::max(cells[first].x, cells[last].x);
+                stamps.push_back(Span{row, x0 - halfSize, x1 + halfSize});
+            }
+        }
+
+        // Union of the segments: sort by row and start, then merge overlapping or touching spans.
+        std::sort(stamps.begin(), stamps.end(), [](const Span& a, const Span& b) {
+            return a.y != b.y ? a.y < b.y : a.x0 < b.x0;
+        });
+        std::vector<Span> spans;
+        for (const Span& span : stamps) {
+            if (!spans.empty() && spans.back().y == span.y && static_cast<long long>(span.x0) <= static_cast<long long>(spans.back().x1) + 1) {
+                spans.back().x1 = std::max(spans.back().x1, span.x1);
+            } else {
+                spans.push_back(span);
+            }
+        }
+        return spans;
+    }
+
+} // namespace BrushStroke
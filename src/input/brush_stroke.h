@@ -0,0 +1,36 @@
+#ifndef BRUSH_STROKE_H
+#define BRUSH_STROKE_H
+
+#include <vector>
+
+#include "../utils/point.h"
+
+/**
+ * @namespace BrushStroke
+ * @brief Rasterizes the area a square brush sweeps along a polyline of world cells.
+ *
+ * Consecutive path points are joined with Bresenham lines, so fast drags leave no gaps, and
+ * the brush square is stamped on every line cell. Instead of writing each stamp, the stamps
+ * are collected as row spans and merged, so every covered cell appears exactly once however
+ * large the brush is or however many motion samples fell on the same cells.
+ */
+namespace BrushStroke {
+
+    /**
+     * @brief Cells x0..x1 (inclusive) of row y.
+     */
+    struct Span {
+        int y;
+        int x0;
+        int x1;
+    };
+
+    /**
+     * @brief Covered cells as disjoint spans sorted by row, then by x.
+     * @param halfSize The brush covers [-halfSize, halfSize] around each line cell.
+     */
+    std::vector<Span> rasterize(const std::vector<Point>& path, int halfSize);
+
+} // namespace BrushStroke
+
+#endif // BRUSH_STROKE_H
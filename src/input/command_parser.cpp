@@ -87,22 +87,147 @@ bool CommandParser::parseAndExecute(const std::string& commandString) {
 
 
     if (command == "save") {
-        if (tokens.size() >= 2) {
-            std::string filename = joinTokens(tokens, 1, tokens.size());
+        bool async = tokens.size() >= 3 && tokens.back() == "--async";
+        size_t nameEnd = async ? tokens.size() - 1 : tokens.size();
+        if (nameEnd >= 2) {
+            std::string filename = joinTokens(tokens, 1, nameEnd);
             if (filename.rfind(".snapshot") == std::string::npos && filename.rfind('.') == std::string::npos) {
                 filename += ".snapshot";
             }
-            application_.saveSnapshot(filename);
+            if (async) {
+                application_.saveSnapshotAsync(filename);
+            } else {
+                application_.saveSnapshot(filename);
+            }
+        } else {
+            application_.postMessageToUser("Usage: save <filename> [--async]");
+        }
+        return true;
+    } else if (command == "autosave") {
+        std::string mode = tokens.size() >= 2 ? tokens[1] : "";
+        std::transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+        const std::string usage = "Usage: autosave every <n> gens|seconds [keep <k>] [dir <path>] [limit <MiB/s>] | autosave off";
+        if (tokens.size() == 1) {
+            application_.showAutosave();
+        } else if (tokens.size() == 2 && mode == "off") {
+            application_.disableAutosave();
+        } else if (mode == "every" && tokens.size() >= 4 && tokens.size() % 2 == 0) {
+            std::string unit = tokens[3];
+            std::transform(unit.begin(), unit.end(), unit.begin(), ::tolower);
+            bool seconds = unit == "seconds" || unit == "second" || unit == "s";
+            bool generations = unit == "gens" || unit == "gen" || unit == "generations" || unit == "g";
+            try {
+                long long every = std::stoll(tokens[2]);
+                long long keep = 3;
+                std::string directory;
+                double megabytesPerSecond = 0.0;
+                bool valid = seconds || generations;
+                for (size_t i = 4; valid && i + 1 < tokens.size(); i += 2) {
+                    std::string option = tokens[i];
+                    std::transform(option.begin(), option.end(), option.begin(), ::tolower);
+                    if (option == "keep") {
+                        keep = std::stoll(tokens[i + 1]);
+                    } else if (option == "dir") {
+                        directory = tokens[i + 1];
+                    } else if (option == "limit") {
+                        megabytesPerSecond = std::stod(tokens[i + 1]);
+                    } else {
+                        valid = false;
+                    }
+                }
+                if (!valid) {
+                    application_.postMessageToUser(usage);
+                } else if (every <= 0 || keep <= 0 || megabytesPerSecond < 0.0) {
+                    application_.postMessageToUser("Error: Interval and keep must be positive, limit must not be negative.");
+                } else {
+                    application_.configureAutosave(seconds, static_cast<std::uint64_t>(every), static_cast<std::size_t>(keep), directory,
+                                                   static_cast<std::uint64_t>(megabytesPerSecond * (1 << 20)));
+                }
+            } catch (const std::invalid_argument& ia) {
+                application_.postMessageToUser("Error: Interval, keep and limit must be numbers.");
+            } catch (const std::out_of_range& oor) {
+                application_.postMessageToUser("Error: Autosave value out of range.");
+            }
         } else {
-            application_.postMessageToUser("Usage: save <filename>");
+            application_.postMessageToUser(usage);
         }
         return true;
     } else if (command == "load") {
-        if (tokens.size() >= 2) {
+        auto flag = std::find_if(tokens.begin() + 1, tokens.end(),
+                                 [](const std::string& t) { return t == "--region" || t == "--lazy"; });
+        size_t flagIndex = static_cast<size_t>(flag - tokens.begin());
+        if (flagIndex < 2) {
+            application_.postMessageToUser("Usage: load <filename> [--region x y w h | --lazy]");
+        } else if (flag == tokens.end()) {
             std::string filename = joinTokens(tokens, 1, tokens.size());
             application_.loadSnapshot(filename);
+        } else if (*flag == "--lazy" && flagIndex + 1 == tokens.size()) {
+            application_.openSnapshotLazy(joinTokens(tokens, 1, flagIndex));
+        } else if (*flag == "--region" && flagIndex + 5 == tokens.size()) {
+            try {
+                int x = std::stoi(tokens[flagIndex + 1]);
+                int y = std::stoi(tokens[flagIndex + 2]);
+                int w = std::stoi(tokens[flagIndex + 3]);
+                int h = std::stoi(tokens[flagIndex + 4]);
+                application_.loadSnapshotRegion(joinTokens(tokens, 1, flagIndex), x, y, w, h);
+            } catch (const std::invalid_argument& ia) {
+                application_.postMessageToUser("Error: Region values must be integers.");
+            } catch (const std::out_of_range& oor) {
+                application_.postMessageToUser("Error: Region value out of range.");
+            }
         } else {
-            application_.postMessageToUser("Usage: load <filename>");
+            application_.postMessageToUser("Usage: load <filename> [--region x y w h | --lazy]");
+        }
+        return true;
+    } else if (command == "export-npy") {
+        if (tokens.size() != 2 && tokens.size() != 6) {
+            application_.postMessageToUser("Usage: export-npy <file> [x y w h]");
+            return true;
+        }
+        std::string filename = tokens[1];
+        if (filename.find('.', filename.find_last_of("/\\") + 1) == std::string::npos) {
+            filename += ".npy";
+        }
+        if (tokens.size() == 2) {
+            application_.exportNpy(filename);
+            return true;
+        }
+        try {
+            int x = std::stoi(tokens[2]);
+            int y = std::stoi(tokens[3]);
+            int w = std::stoi(tokens[4]);
+            int h = std::stoi(tokens[5]);
+            application_.exportNpy(filename, x, y, w, h);
+        } catch (const std::invalid_argument& ia) {
+            application_.postMessageToUser("Error: Region values must be integers.");
+        } catch (const std::out_of_range& oor) {
+            application_.postMessageToUser("Error: Region value out of range.");
+        }
+        return true;
+    } else if (command == "import-npy") {
+        if (tokens.size() != 2 && tokens.size() != 4) {
+            application_.postMessageToUser("Usage: import-npy <file> [x y]");
+            return true;
+        }
+        try {
+            int x = tokens.size() == 4 ? std::stoi(tokens[2]) : 0;
+            int y = tokens.size() == 4 ? std::stoi(tokens[3]) : 0;
+            application_.importNpy(tokens[1], x, y);
+        } catch (const std::invalid_argument& ia) {
+            application_.postMessageToUser("Error: Position values must be integers.");
+        } catch (const std::out_of_range& oor) {
+            application_.postMessageToUser("Error: Position value out of range.");
+        }
+        return true;
+    } else if (command == "browse") {
+        std::string directory = tokens.size() >= 2 ? joinTokens(tokens, 1, tokens.size()) : ".";
+        application_.browseSnapshots(directory);
+        return true;
+    } else if (command == "preview") {
+        if (tokens.size() >= 2) {
+            application_.previewSnapshot(joinTokens(tokens, 1, tokens.size()));
+        } else {
+            application_.postMessageToUser("Usage: preview <filename>");
         }
         return true;
     } else if (command == "load-rule") { // New command
@@ -220,6 +345,23 @@ bool CommandParser::parseAndExecute(const std::string& commandString) {
             application_.postMessageToUser("Usage: set-grid-color <r> <g> <b> [alpha]");
         }
         return true;
+    } else if (command == "frame-budget") {
+        if (tokens.size() == 1) {
+            application_.showFrameBudget();
+        } else if (tokens.size() == 2) {
+            std::string value = tokens[1];
+            std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+            try {
+                application_.setFrameBudget(value == "off" ? 0.0 : std::stod(value));
+            } catch (const std::invalid_argument& ia) {
+                application_.postMessageToUser("Error: Frame budget must be a number of milliseconds or 'off'.");
+            } catch (const std::out_of_range& oor) {
+                application_.postMessageToUser("Error: Frame budget out of range.");
+            }
+        } else {
+            application_.postMessageToUser("Usage: frame-budget [<ms> | off]");
+        }
+        return true;
     }else if (command == "pause") {
         application_.pauseSimulation();
         return true;
@@ -261,6 +403,269 @@ bool CommandParser::parseAndExecute(const std::string& commandString) {
             application_.postMessageToUser("Usage: speed <updates_per_second>");
         }
         return true;
+    } else if (command == "publish") {
+        if (tokens.size() == 2) {
+            std::string target = tokens[1];
+            std::string targetLower = target;
+            std::transform(targetLower.begin(), targetLower.end(), targetLower.begin(), ::tolower);
+            if (targetLower == "off") {
+                application_.stopFramePublishing();
+            } else {
+                application_.startFramePublishing(target);
+            }
+        } else {
+            application_.postMessageToUser("Usage: publish <channel_name|off>");
+        }
+        return true;
+    } else if (command == "control") {
+        if (tokens.size() >= 2) {
+            std::string target = joinTokens(tokens, 1, tokens.size());
+            std::string targetLower = target;
+            std::transform(targetLower.begin(), targetLower.end(), targetLower.begin(), ::tolower);
+            if (targetLower == "off") {
+                application_.stopControlServer();
+            } else {
+                application_.startControlServer(target);
+            }
+        } else {
+            application_.postMessageToUser("Usage: control <socket_path|off>");
+        }
+        return true;
+    } else if (command == "step") {
+        if (tokens.size() <= 2) {
+            try {
+                int count = tokens.size() == 2 ? std::stoi(tokens[1]) : 1;
+                application_.stepSimulation(count);
+            } catch (const std::invalid_argument& ia) {
+                application_.postMessageToUser("Error: Step count must be an integer.");
+            } catch (const std::out_of_range& oor) {
+                application_.postMessageToUser("Error: Step count out of range.");
+            }
+        } else {
+            application_.postMessageToUser("Usage: step [generations]");
+        }
+        return true;
+    } else if (command == "slice") {
+        std::string target = tokens.size() == 2 ? tokens[1] : "";
+        std::transform(target.begin(), target.end(), target.begin(), ::tolower);
+        try {
+            if (target == "up") {
+                application_.stepVoxelSlice(1);
+            } else if (target == "down") {
+                application_.stepVoxelSlice(-1);
+            } else if (target == "max") {
+                application_.setVoxelProjection(true);
+            } else if (!target.empty()) {
+                application_.setVoxelSlice(std::stoi(target));
+            } else {
+                application_.postMessageToUser("Usage: slice <z|up|down|max>");
+            }
+        } catch (const std::exception&) {
+            application_.postMessageToUser("Usage: slice <z|up|down|max>");
+        }
+        return true;
+    } else if (command == "load-graph") {
+        bool reorder = !(tokens.size() >= 3 && tokens.back() == "--no-reorder");
+        size_t nameEnd = reorder ? tokens.size() : tokens.size() - 1;
+        if (nameEnd < 2) {
+            application_.postMessageToUser("Usage: load-graph <file> [--no-reorder] | load-graph off");
+        } else if (nameEnd == 2 && tokens[1] == "off") {
+            application_.unloadGraph();
+        } else {
+            application_.loadGraph(joinTokens(tokens, 1, nameEnd), reorder);
+        }
+        return true;
+    } else if (command == "graph-soup") {
+        try {
+            float density = tokens.size() >= 2 ? std::stof(tokens[1]) : 0.3f;
+            application_.seedGraphSoup(density);
+        } catch (const std::exception&) {
+            application_.postMessageToUser("Usage: graph-soup [density]");
+        }
+        return true;
+    } else if (command == "rd-seed") {
+        try {
+            int count = tokens.size() >= 2 ? std::stoi(tokens[1]) : 20;
+            application_.seedField(count);
+        } catch (const std::exception&) {
+            application_.postMessageToUser("Usage: rd-seed [count]");
+        }
+        return true;
+    } else if (command == "soup3d") {
+        if (tokens.size() == 2 || tokens.size() == 3) {
+            try {
+                int size = std::stoi(tokens[1]);
+                float density = tokens.size() == 3 ? std::stof(tokens[2]) : 0.3f;
+                application_.seedVoxelSoup(size, density);
+            } catch (const std::exception&) {
+                application_.postMessageToUser("Error: soup3d size and density must be numbers.");
+            }
+        } else {
+            application_.postMessageToUser("Usage: soup3d <size> [density]");
+        }
+        return true;
+    } else if (command == "metrics") {
+        std::string mode = tokens.size() >= 2 ? tokens[1] : "";
+        std::transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+        try {
+            if (tokens.size() == 1) {
+                application_.showMetrics();
+            } else if (mode == "serve" && tokens.size() == 3) {
+                application_.startMetricsServer(std::stoi(tokens[2]));
+            } else if (mode == "dump" && (tokens.size() == 3 || tokens.size() == 4)) {
+                float interval = tokens.size() == 4 ? std::stof(tokens[3]) : 10.0f;
+                application_.startMetricsDump(tokens[2], interval);
+            } else if (mode == "off" && tokens.size() == 2) {
+                application_.stopMetricsExport();
+            } else {
+                application_.postMessageToUser("Usage: metrics [serve <port> | dump <file> [seconds] | off]");
+            }
+        } catch (const std::invalid_argument& ia) {
+            application_.postMessageToUser("Error: Metrics port/interval must be a number.");
+        } catch (const std::out_of_range& oor) {
+            application_.postMessageToUser("Error: Metrics port/interval out of range.");
+        }
+        return true;
+    } else if (command == "perf") {
+        std::string mode = tokens.size() >= 2 ? tokens[1] : "report";
+        std::transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+        if (tokens.size() > 2) {
+            application_.postMessageToUser("Usage: perf [on | off | report | reset]");
+        } else if (mode == "on") {
+            application_.setPerfCounters(true);
+        } else if (mode == "off") {
+            application_.setPerfCounters(false);
+        } else if (mode == "report") {
+            application_.showPerfReport();
+        } else if (mode == "reset") {
+            application_.resetPerfCounters();
+        } else {
+            application_.postMessageToUser("Usage: perf [on | off | report | reset]");
+        }
+        return true;
+    } else if (command == "arena") {
+        if (tokens.size() == 1) {
+            application_.showArenas();
+        } else if (tokens.size() == 3 || tokens.size() == 4) {
+            std::string domain = tokens[1];
+            std::transform(domain.begin(), domain.end(), domain.begin(), ::tolower);
+            std::string priority = tokens.size() == 4 ? tokens[3] : "";
+            std::transform(priority.begin(), priority.end(), priority.begin(), ::tolower);
+            try {
+                application_.configureArena(domain, std::stoi(tokens[2]), priority);
+            } catch (const std::invalid_argument& ia) {
+                application_.postMessageToUser("Error: Thread count must be a number.");
+            } catch (const std::out_of_range& oor) {
+                application_.postMessageToUser("Error: Thread count out of range.");
+            }
+        } else {
+            application_.postMessageToUser("Usage: arena [<simulation|render|io> <threads> [low|normal|high]]");
+        }
+        return true;
+    } else if (command == "snapshot-io") {
+        std::string mode = tokens.size() >= 2 ? tokens[1] : "";
+        std::transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+        if (tokens.size() == 1) {
+            application_.showSnapshotIO();
+        } else if (tokens.size() == 2 && mode != "direct") {
+            application_.setSnapshotIOBackend(mode);
+        } else if (tokens.size() == 3 && mode == "direct") {
+            std::string size = tokens[2];
+            std::transform(size.begin(), size.end(), size.begin(), ::tolower);
+            try {
+                long long megabytes = size == "off" ? 0 : std::stoll(size);
+                if (megabytes < 0) {
+                    application_.postMessageToUser("Error: O_DIRECT size must be positive (or 'off').");
+                } else {
+                    application_.setSnapshotDirectThreshold(static_cast<std::uint64_t>(megabytes));
+                }
+            } catch (const std::invalid_argument& ia) {
+                application_.postMessageToUser("Error: O_DIRECT size must be a number of MiB or 'off'.");
+            } catch (const std::out_of_range& oor) {
+                application_.postMessageToUser("Error: O_DIRECT size out of range.");
+            }
+        } else {
+            application_.postMessageToUser("Usage: snapshot-io [auto | uring | pwrite | direct <MiB | off>]");
+        }
+        return true;
+    } else if (command == "record") {
+        if (tokens.size() >= 2) {
+            std::string target = joinTokens(tokens, 1, tokens.size());
+            std::string targetLower = target;
+            std::transform(targetLower.begin(), targetLower.end(), targetLower.begin(), ::tolower);
+            if (targetLower == "stop") {
+                application_.stopRecording();
+            } else {
+                application_.startRecording(target);
+            }
+        } else {
+            application_.postMessageToUser("Usage: record <file|stop>");
+        }
+        return true;
+    } else if (command == "replay") {
+        std::string last = tokens.size() >= 2 ? tokens.back() : "";
+        std::transform(last.begin(), last.end(), last.begin(), ::tolower);
+        if (tokens.size() == 2 && last == "stop") {
+            application_.stopReplay();
+        } else if (tokens.size() >= 3 && last == "max") {
+            application_.startReplay(joinTokens(tokens, 1, tokens.size() - 1), true);
+        } else if (tokens.size() >= 2) {
+            application_.startReplay(joinTokens(tokens, 1, tokens.size()), false);
+        } else {
+            application_.postMessageToUser("Usage: replay <file> [max] | replay stop");
+        }
+        return true;
+    } else if (command == "stats") {
+        std::string mode = tokens.size() >= 2 ? tokens[1] : "";
+        std::transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+        if (tokens.size() == 1) {
+            application_.showStats();
+        } else if (mode == "csv" && tokens.size() >= 3) {
+            application_.exportStatsCsv(joinTokens(tokens, 2, tokens.size()));
+        } else if (mode == "graph" && tokens.size() <= 3) {
+            std::string value = tokens.size() == 3 ? tokens[2] : "";
+            std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+            if (value == "on") {
+                application_.setPopulationGraph(true);
+            } else if (value == "off") {
+                application_.setPopulationGraph(false);
+            } else if (value.empty()) {
+                application_.setPopulationGraph(!application_.isPopulationGraphShown());
+            } else {
+                application_.postMessageToUser("Usage: stats graph [on|off]");
+            }
+        } else {
+            application_.postMessageToUser("Usage: stats [csv <file> | graph [on|off]]");
+        }
+        return true;
+    } else if (command == "find") {
+        if (tokens.size() >= 2) {
+            application_.findPattern(joinTokens(tokens, 1, tokens.size()));
+        } else {
+            application_.postMessageToUser("Usage: find <pattern-file>");
+        }
+        return true;
+    } else if (command == "find-clear") {
+        application_.clearPatternHighlights();
+        return true;
+    } else if (command == "hash") {
+        application_.reportHash();
+        return true;
+    } else if (command == "cycle-detect") {
+        std::string mode = tokens.size() >= 2 ? tokens[1] : "";
+        std::transform(mode.begin(), mode.end(), mode.begin(), ::tolower);
+        bool translate = tokens.size() == 3 && tokens[2] == "translate";
+        if ((tokens.size() == 2 || translate) && (mode == "off" || mode == "notify" || mode == "pause")) {
+            CycleDetector::Action action = mode == "off" ? CycleDetector::Action::Off :
+                                           mode == "pause" ? CycleDetector::Action::Pause : CycleDetector::Action::Notify;
+            application_.setCycleDetection(action, translate);
+        } else {
+            application_.postMessageToUser("Usage: cycle-detect <off|notify|pause> [translate]");
+        }
+        return true;
+    } else if (command == "status") {
+        application_.reportStatus();
+        return true;
     } else if (command == "toggle-brush-info" || command == "brushinfo") {
         application_.toggleBrushInfoDisplay();
         return true;
@@ -12,7 +12,8 @@ InputHandler::InputHandler(Application &app)
     : application_(app),
       middleMouseDown_(false),
       lastMousePos_(0, 0),
-      leftMouseDown_(false)
+      leftMouseDown_(false),
+      strokeAnchored_(false)
 {
 }
 
@@ -24,43 +25,104 @@ InputHandler::InputHandler(Application &app)
 void InputHandler::processEvents(Viewport &viewport)
 {
     SDL_Event event;
+    bool replaying = recorder_.getMode() == InputRecorder::Mode::Replaying;
     while (SDL_PollEvent(&event))
     {
-        switch (event.type)
+        if (replaying)
         {
-        case SDL_EVENT_QUIT:
-            application_.quit();
-            break;
-        case SDL_EVENT_KEY_DOWN:
-            handleKeyDown(event.key);
-            break;
-        case SDL_EVENT_TEXT_INPUT:
-            if (application_.isCommandInputActive())
+            // Live input is ignored during a replay, except for leaving it.
+            if (event.type == SDL_EVENT_QUIT)
             {
-                // std::cout << "SDL_TEXTINPUT event: " << event.text.text << std::endl; // Debug
-                handleTextInput(event.text);
+                application_.quit();
             }
-            break;
-        case SDL_EVENT_MOUSE_BUTTON_DOWN:
-            // std::cout << "SDL_MOUSEBUTTONDOWN event: " << (int)event.button.button << " at (" << event.button.x << "," << event.button.y << ")" << std::endl; // Debug
-            handleMouseButtonDown(event.button, viewport);
-            break;
-        case SDL_EVENT_MOUSE_BUTTON_UP:
-            handleMouseButtonUp(event.button);
-            break;
-        case SDL_EVENT_MOUSE_MOTION:
-            // std::cout << "SDL_MOUSEMOTION event to (" << event.motion.x << "," << event.motion.y << ")" << std::endl; // Debug
-            handleMouseMotion(event.motion, viewport);
-            break;
-        case SDL_EVENT_MOUSE_WHEEL:
-            handleMouseWheel(event.wheel, viewport);
-            break;
-        case SDL_EVENT_WINDOW_RESIZED:
-            application_.onWindowResized(event.window.data1, event.window.data2);
-            break;
-        default:
-            break;
+            else if (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_ESCAPE)
+            {
+                application_.stopReplay();
+            }
+            continue;
+        }
+        recorder_.recordEvent(event);
+        dispatchEvent(event, viewport);
+    }
+    flushStroke();
+
+    if (replaying)
+    {
+        replayEvents_.clear();
+        bool more = recorder_.nextEvents(replayEvents_);
+        for (const SDL_Event &replayed : replayEvents_)
+        {
+            dispatchEvent(replayed, viewport);
+        }
+        flushStroke();
+        if (!more)
+        {
+            application_.finishReplay();
+        }
+    }
+    else
+    {
+        recorder_.endBatch();
+    }
+}
+
+void InputHandler::resetState()
+{
+    middleMouseDown_ = false;
+    leftMouseDown_ = false;
+    lastMousePos_ = Point(0, 0);
+    strokePath_.clear();
+    strokeAnchored_ = false;
+}
+
+InputRecorder &InputHandler::getRecorder()
+{
+    return recorder_;
+}
+
+/**
+ * @brief Routes one live or replayed event to its handler.
+ */
+void InputHandler::dispatchEvent(const SDL_Event &event, Viewport &viewport)
+{
+    if (event.type != SDL_EVENT_MOUSE_MOTION)
+    {
+        flushStroke();
+    }
+    switch (event.type)
+    {
+    case SDL_EVENT_QUIT:
+        application_.quit();
+        break;
+    case SDL_EVENT_KEY_DOWN:
+        handleKeyDown(event.key);
+        break;
+    case SDL_EVENT_TEXT_INPUT:
+        if (application_.isCommandInputActive())
+        {
+            // std::cout << "SDL_TEXTINPUT event: " << event.text.text << std::endl; // Debug
+            handleTextInput(event.text);
         }
+        break;
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        // std::cout << "SDL_MOUSEBUTTONDOWN event: " << (int)event.button.button << " at (" << event.button.x << "," << event.button.y << ")" << std::endl; // Debug
+        handleMouseButtonDown(event.button, viewport);
+        break;
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        handleMouseButtonUp(event.button);
+        break;
+    case SDL_EVENT_MOUSE_MOTION:
+        // std::cout << "SDL_MOUSEMOTION event to (" << event.motion.x << "," << event.motion.y << ")" << std::endl; // Debug
+        handleMouseMotion(event.motion, viewport);
+        break;
+    case SDL_EVENT_MOUSE_WHEEL:
+        handleMouseWheel(event.wheel, viewport);
+        break;
+    case SDL_EVENT_WINDOW_RESIZED:
+        application_.onWindowResized(event.window.data1, event.window.data2);
+        break;
+    default:
+        break;
     }
 }
 
@@ -110,7 +172,7 @@ void InputHandler::handleKeyDown(const SDL_KeyboardEvent &keyEvent)
             application_.togglePause();
             break;
         case SDLK_SLASH:
-            if (!(SDL_GetModState() & SDL_KMOD_SHIFT))
+            if (!(keyEvent.mod & SDL_KMOD_SHIFT)) // From the event, so replays do not depend on live modifier state
             {
                 application_.toggleCommandInput();
             }
@@ -140,7 +202,8 @@ void InputHandler::handleMouseButtonDown(const SDL_MouseButtonEvent &buttonEvent
         leftMouseDown_ = true;
         Point worldPos = viewport.screenToWorld(lastMousePos_);
         // std::cout << "Brush applied at screen (" << lastMousePos_.x << "," << lastMousePos_.y << ") -> world (" << worldPos.x << "," << worldPos.y << ")" << std::endl; // Debug
-        application_.applyBrush(worldPos);
+        strokePath_.assign(1, worldPos); // Painted with the rest of the batch
+        strokeAnchored_ = false;
     }
     else if (buttonEvent.button == SDL_BUTTON_MIDDLE)
     {
@@ -157,6 +220,8 @@ void InputHandler::handleMouseButtonUp(const SDL_MouseButtonEvent &buttonEvent)
     {
         // std::cout << "Left mouse up." << std::endl; // Debug
         leftMouseDown_ = false;
+        strokePath_.clear(); // Already flushed before this event
+        strokeAnchored_ = false;
     }
     else if (buttonEvent.button == SDL_BUTTON_MIDDLE)
     {
@@ -180,11 +245,33 @@ void InputHandler::handleMouseMotion(const SDL_MouseMotionEvent &motionEvent, Vi
         // std::cout << "Left mouse drag." << std::endl; // Debug
         Point worldPos = viewport.screenToWorld(currentMousePos);
         // std::cout << "Brush dragged at screen (" << currentMousePos.x << "," << currentMousePos.y << ") -> world (" << worldPos.x << "," << worldPos.y << ")" << std::endl; // Debug
-        application_.applyBrush(worldPos);
+        if (strokePath_.empty() || strokePath_.back().x != worldPos.x || strokePath_.back().y != worldPos.y)
+        {
+            strokePath_.push_back(worldPos);
+        }
     }
     lastMousePos_ = currentMousePos; // Update lastMousePos for both panning and next drag if LMD is still down
 }
 
+void InputHandler::flushStroke()
+{
+    // A single point left over from the previous flush has been painted already.
+    if (strokePath_.size() > 1 || (strokePath_.size() == 1 && !strokeAnchored_))
+    {
+        application_.applyBrushStroke(strokePath_);
+    }
+    if (leftMouseDown_ && !strokePath_.empty())
+    {
+        strokePath_.erase(strokePath_.begin(), strokePath_.end() - 1);
+        strokeAnchored_ = true;
+    }
+    else
+    {
+        strokePath_.clear();
+        strokeAnchored_ = false;
+    }
+}
+
 /**
  * @brief Handles mouse wheel events for zooming.
  */
@@ -208,8 +295,7 @@ void InputHandler::handleMouseWheel(const SDL_MouseWheelEvent &wheelEvent, Viewp
 
     if (zoomFactor != 1.0f)
     {
-        float mouseX, mouseY;
-        SDL_GetMouseState(&mouseX, &mouseY);
-        viewport.zoom(zoomFactor, Point(mouseX, mouseY));
+        // The event carries the cursor position, which keeps recorded zooms reproducible.
+        viewport.zoom(zoomFactor, Point(wheelEvent.mouse_x, wheelEvent.mouse_y));
     }
 }
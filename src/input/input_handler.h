@@ -2,7 +2,9 @@
 #define INPUT_HANDLER_H
 
 #include <SDL3/SDL.h>
+#include <vector>
 #include "../utils/point.h"
+#include "input_recorder.h"
 
 // Forward declarations of classes that InputHandler interacts with or calls methods on.
 class Application;
@@ -22,6 +24,20 @@ private:
     Point lastMousePos_;
     bool leftMouseDown_;
 
+    InputRecorder recorder_;
+    std::vector<SDL_Event> replayEvents_;
+
+    // World cells the left-button drag passed through since the last flush. When anchored, the
+    // first point is the (already painted) end of the previous flush, so batches join up.
+    std::vector<Point> strokePath_;
+    bool strokeAnchored_;
+
+    void dispatchEvent(const SDL_Event& event, Viewport& viewport);
+    /**
+     * @brief Paints the pending stroke as one edit; called at the end of each event batch and
+     * before any event other than mouse motion, so edits keep their order relative to commands.
+     */
+    void flushStroke();
     // Helper methods to delegate specific event types
     void handleKeyDown(const SDL_KeyboardEvent& keyEvent);
     // void handleKeyUp(const SDL_KeyboardEvent& keyEvent); // Kept for completeness, but not used much currently
@@ -44,6 +60,13 @@ public:
      * @param viewport Reference to the Viewport for mouse coordinate conversions and view changes.
      */
     void processEvents(Viewport& viewport);
+
+    /**
+     * @brief Clears button/drag state, e.g. before a replay starts.
+     */
+    void resetState();
+
+    InputRecorder& getRecorder();
 };
 
 #endif // INPUT_HANDLER_H
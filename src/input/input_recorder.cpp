@@ -0,0 +1,380 @@
+#include "input_recorder.h"
+#include "../utils/logger.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace {
+    constexpr char RECORDING_MAGIC[8] = {'W', 'I', 'C', 'A', 'R', 'E', 'C', '1'};
+
+    enum RecordType : std::uint8_t {
+        RECORD_MOTION = 1,
+        RECORD_BUTTON_DOWN = 2,
+        RECORD_BUTTON_UP = 3,
+        RECORD_WHEEL = 4,
+        RECORD_KEY_DOWN = 5,
+        RECORD_TEXT = 6,
+        RECORD_RESIZE = 7,
+        RECORD_BATCH = 8
+    };
+
+    std::uint64_t zigzag(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    std::int64_t unzigzag(std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+}
+
+InputRecorder::InputRecorder()
+    : mode_(Mode::Idle),
+      startTicksNs_(0),
+      lastEventUs_(0),
+      eventCount_(0),
+      batchOpen_(false),
+      readOffset_(0),
+      replayClockUs_(0),
+      replayStartNs_(0),
+      maxSpeed_(false),
+      hasPending_(false),
+      pendingIsBatch_(false),
+      pendingTimeUs_(0) {
+    std::memset(&pending_, 0, sizeof(pending_));
+}
+
+// --- Encoding helpers ---
+
+void InputRecorder::writeVarint(std::uint64_t value) {
+    while (value >= 0x80) {
+        buffer_.push_back(static_cast<std::uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer_.push_back(static_cast<std::uint8_t>(value));
+}
+
+void InputRecorder::writeSigned(std::int64_t value) {
+    writeVarint(zigzag(value));
+}
+
+void InputRecorder::writeFloat(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    for (int i = 0; i < 4; ++i) {
+        buffer_.push_back(static_cast<std::uint8_t>((bits >> (8 * i)) & 0xFF));
+    }
+}
+
+bool InputRecorder::readByte(std::uint8_t& value) {
+    if (readOffset_ >= buffer_.size()) return false;
+    value = buffer_[readOffset_++];
+    return true;
+}
+
+bool InputRecorder::readVarint(std::uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        std::uint8_t byte;
+        if (!readByte(byte)) return false;
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+bool InputRecorder::readSigned(std::int64_t& value) {
+    std::uint64_t raw;
+    if (!readVarint(raw)) return false;
+    value = unzigzag(raw);
+    return true;
+}
+
+bool InputRecorder::readFloat(float& value) {
+    if (readOffset_ + 4 > buffer_.size()) return false;
+    std::uint32_t bits = 0;
+    for (int i = 0; i < 4; ++i) {
+        bits |= static_cast<std::uint32_t>(buffer_[readOffset_++]) << (8 * i);
+    }
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+void InputRecorder::writeRecordHeader(std::uint8_t type) {
+    std::uint64_t nowUs = (SDL_GetTicksNS() - startTicksNs_) / 1000;
+    if (nowUs < lastEventUs_) nowUs = lastEventUs_;
+    writeVarint(nowUs - lastEventUs_);
+    buffer_.push_back(type);
+    lastEventUs_ = nowUs;
+}
+
+// --- Recording ---
+
+bool InputRecorder::startRecording(const std::string& filePath, const ViewState& view) {
+    auto logger = Logger::getLogger(Logger::Module::Input);
+    if (mode_ != Mode::Idle) {
+        if (logger) logger->warn("Cannot start recording: recorder is busy.");
+        return false;
+    }
+    path_ = filePath;
+    buffer_.clear();
+    buffer_.insert(buffer_.end(), std::begin(RECORDING_MAGIC), std::end(RECORDING_MAGIC));
+    writeSigned(view.screenWidth);
+    writeSigned(view.screenHeight);
+    writeFloat(view.centerX);
+    writeFloat(view.centerY);
+    writeFloat(view.cellSize);
+    buffer_.push_back(view.autoFit ? 1 : 0);
+
+    viewState_ = view;
+    startTicksNs_ = SDL_GetTicksNS();
+    lastEventUs_ = 0;
+    eventCount_ = 0;
+    batchOpen_ = false;
+    mode_ = Mode::Recording;
+    if (logger) logger->info("Recording input to {}", path_);
+    return true;
+}
+
+void InputRecorder::recordEvent(const SDL_Event& event) {
+    if (mode_ != Mode::Recording) return;
+
+    switch (event.type) {
+    case SDL_EVENT_MOUSE_MOTION:
+        writeRecordHeader(RECORD_MOTION);
+        writeSigned(static_cast<std::int64_t>(event.motion.x));
+        writeSigned(static_cast<std::int64_t>(event.motion.y));
+        break;
+    case SDL_EVENT_MOUSE_BUTTON_DOWN:
+    case SDL_EVENT_MOUSE_BUTTON_UP:
+        writeRecordHeader(event.type == SDL_EVENT_MOUSE_BUTTON_DOWN ? RECORD_BUTTON_DOWN : RECORD_BUTTON_UP);
+        buffer_.push_back(event.button.button);
+        writeSigned(static_cast<std::int64_t>(event.button.x));
+        writeSigned(static_cast<std::int64_t>(event.button.y));
+        break;
+    case SDL_EVENT_MOUSE_WHEEL:
+        writeRecordHeader(RECORD_WHEEL);
+        writeFloat(event.wheel.y);
+        buffer_.push_back(event.wheel.direction == SDL_MOUSEWHEEL_FLIPPED ? 1 : 0);
+        writeSigned(static_cast<std::int64_t>(event.wheel.mouse_x));
+        writeSigned(static_cast<std::int64_t>(event.wheel.mouse_y));
+        break;
+    case SDL_EVENT_KEY_DOWN:
+        writeRecordHeader(RECORD_KEY_DOWN);
+        writeVarint(event.key.key);
+        writeVarint(event.key.mod);
+        buffer_.push_back(event.key.repeat ? 1 : 0);
+        break;
+    case SDL_EVENT_TEXT_INPUT: {
+        std::size_t length = event.text.text ? std::strlen(event.text.text) : 0;
+        writeRecordHeader(RECORD_TEXT);
+        writeVarint(length);
+        buffer_.insert(buffer_.end(), event.text.text, event.text.text + length);
+        break;
+    }
+    case SDL_EVENT_WINDOW_RESIZED:
+        writeRecordHeader(RECORD_RESIZE);
+        writeSigned(event.window.data1);
+        writeSigned(event.window.data2);
+        break;
+    default:
+        return; // Not consumed by InputHandler
+    }
+    ++eventCount_;
+    batchOpen_ = true;
+}
+
+void InputRecorder::endBatch() {
+    if (mode_ != Mode::Recording || !batchOpen_) return;
+    writeRecordHeader(RECORD_BATCH);
+    batchOpen_ = false;
+}
+
+bool InputRecorder::stopRecording() {
+    auto logger = Logger::getLogger(Logger::Module::Input);
+    if (mode_ != Mode::Recording) return false;
+    endBatch();
+    mode_ = Mode::Idle;
+
+    std::ofstream outFile(path_, std::ios::binary | std::ios::trunc);
+    if (!outFile.is_open()) {
+        if (logger) logger->error("Failed to open recording file: " + path_);
+        return false;
+    }
+    outFile.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size());
+    if (outFile.fail()) {
+        if (logger) logger->error("Failed to write recording file: " + path_);
+        return false;
+    }
+    if (logger) logger->info("Recorded {} events ({} bytes) to {}", eventCount_, buffer_.size(), path_);
+    buffer_.clear();
+    return true;
+}
+
+// --- Replay ---
+
+bool InputRecorder::startReplay(const std::string& filePath, bool maxSpeed) {
+    auto logger = Logger::getLogger(Logger::Module::Input);
+    if (mode_ != Mode::Idle) {
+        if (logger) logger->warn("Cannot start replay: recorder is busy.");
+        return false;
+    }
+    std::ifstream inFile(filePath, std::ios::binary);
+    if (!inFile.is_open()) {
+        if (logger) logger->error("Failed to open recording: " + filePath);
+        return false;
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
+    if (buffer_.size() < sizeof(RECORDING_MAGIC) ||
+        !std::equal(std::begin(RECORDING_MAGIC), std::end(RECORDING_MAGIC), buffer_.begin())) {
+        if (logger) logger->error("Not an input recording: " + filePath);
+        buffer_.clear();
+        return false;
+    }
+
+    readOffset_ = sizeof(RECORDING_MAGIC);
+    std::int64_t width = 0, height = 0;
+    std::uint8_t autoFit = 0;
+    if (!readSigned(width) || !readSigned(height) || !readFloat(viewState_.centerX) ||
+        !readFloat(viewState_.centerY) || !readFloat(viewState_.cellSize) || !readByte(autoFit)) {
+        if (logger) logger->error("Truncated recording header: " + filePath);
+        buffer_.clear();
+        return false;
+    }
+    viewState_.screenWidth = static_cast<int>(width);
+    viewState_.screenHeight = static_cast<int>(height);
+    viewState_.autoFit = autoFit != 0;
+
+    path_ = filePath;
+    maxSpeed_ = maxSpeed;
+    replayClockUs_ = 0;
+    replayStartNs_ = SDL_GetTicksNS();
+    hasPending_ = false;
+    eventCount_ = 0;
+    textStorage_.clear();
+    mode_ = Mode::Replaying;
+    if (logger) logger->info("Replaying {} at {} speed.", path_, maxSpeed_ ? "maximum" : "recorded");
+    return true;
+}
+
+void InputRecorder::stopReplay() {
+    if (mode_ != Mode::Replaying) return;
+    mode_ = Mode::Idle;
+    buffer_.clear();
+    hasPending_ = false; // textStorage_ is kept: events from the last nextEvents() call may still point into it
+}
+
+bool InputRecorder::decodeRecord() {
+    std::uint64_t delta;
+    std::uint8_t type;
+    if (!readVarint(delta) || !readByte(type)) return false;
+
+    replayClockUs_ += delta;
+    pendingTimeUs_ = replayClockUs_;
+    pendingIsBatch_ = false;
+    std::memset(&pending_, 0, sizeof(pending_));
+
+    std::int64_t a = 0, b = 0;
+    std::uint64_t u = 0, v = 0;
+    std::uint8_t flag = 0;
+    switch (type) {
+    case RECORD_MOTION:
+        if (!readSigned(a) || !readSigned(b)) return false;
+        pending_.type = SDL_EVENT_MOUSE_MOTION;
+        pending_.motion.x = static_cast<float>(a);
+        pending_.motion.y = static_cast<float>(b);
+        break;
+    case RECORD_BUTTON_DOWN:
+    case RECORD_BUTTON_UP:
+        if (!readByte(flag) || !readSigned(a) || !readSigned(b)) return false;
+        pending_.type = type == RECORD_BUTTON_DOWN ? SDL_EVENT_MOUSE_BUTTON_DOWN : SDL_EVENT_MOUSE_BUTTON_UP;
+        pending_.button.button = flag;
+        pending_.button.down = type == RECORD_BUTTON_DOWN;
+        pending_.button.x = static_cast<float>(a);
+        pending_.button.y = static_cast<float>(b);
+        break;
+    case RECORD_WHEEL: {
+        float wheelY = 0.0f;
+        if (!readFloat(wheelY) || !readByte(flag) || !readSigned(a) || !readSigned(b)) return false;
+        pending_.type = SDL_EVENT_MOUSE_WHEEL;
+        pending_.wheel.y = wheelY;
+        pending_.wheel.direction = flag ? SDL_MOUSEWHEEL_FLIPPED : SDL_MOUSEWHEEL_NORMAL;
+        pending_.wheel.mouse_x = static_cast<float>(a);
+        pending_.wheel.mouse_y = static_cast<float>(b);
+        break;
+    }
+    case RECORD_KEY_DOWN:
+        if (!readVarint(u) || !readVarint(v) || !readByte(flag)) return false;
+        pending_.type = SDL_EVENT_KEY_DOWN;
+        pending_.key.key = static_cast<SDL_Keycode>(u);
+        pending_.key.mod = static_cast<SDL_Keymod>(v);
+        pending_.key.down = true;
+        pending_.key.repeat = flag != 0;
+        break;
+    case RECORD_TEXT:
+        if (!readVarint(u) || readOffset_ + u > buffer_.size()) return false;
+        textStorage_.emplace_back(buffer_.begin() + readOffset_, buffer_.begin() + readOffset_ + u);
+        readOffset_ += static_cast<std::size_t>(u);
+        pending_.type = SDL_EVENT_TEXT_INPUT;
+        pending_.text.text = textStorage_.back().c_str();
+        break;
+    case RECORD_RESIZE:
+        if (!readSigned(a) || !readSigned(b)) return false;
+        pending_.type = SDL_EVENT_WINDOW_RESIZED;
+        pending_.window.data1 = static_cast<Sint32>(a);
+        pending_.window.data2 = static_cast<Sint32>(b);
+        break;
+    case RECORD_BATCH:
+        pendingIsBatch_ = true;
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+bool InputRecorder::nextEvents(std::vector<SDL_Event>& outEvents) {
+    if (mode_ != Mode::Replaying) return false;
+
+    std::uint64_t elapsedUs = (SDL_GetTicksNS() - replayStartNs_) / 1000;
+    while (true) {
+        if (!hasPending_) {
+            if (!decodeRecord()) {
+                // End of file (or a truncated tail): the replay is complete.
+                stopReplay();
+                return false;
+            }
+            hasPending_ = true;
+        }
+        if (!maxSpeed_ && pendingTimeUs_ > elapsedUs) {
+            return true; // Not due yet
+        }
+        hasPending_ = false;
+        if (pendingIsBatch_) {
+            if (maxSpeed_) return true; // One recorded batch per frame
+            continue;
+        }
+        outEvents.push_back(pending_);
+        ++eventCount_;
+    }
+}
+
+InputRecorder::Mode InputRecorder::getMode() const {
+    return mode_;
+}
+
+bool InputRecorder::isMaxSpeed() const {
+    return maxSpeed_;
+}
+
+const InputRecorder::ViewState& InputRecorder::getViewState() const {
+    return viewState_;
+}
+
+std::size_t InputRecorder::getEventCount() const {
+    return eventCount_;
+}
+
+const std::string& InputRecorder::getPath() const {
+    return path_;
+}
@@ -0,0 +1,117 @@
+#ifndef INPUT_RECORDER_H
+#define INPUT_RECORDER_H
+
+#include <SDL3/SDL.h>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+/**
+ * @class InputRecorder
+ * @brief Records the SDL events consumed by InputHandler into a compact file and plays them back.
+ *
+ * File format (little-endian):
+ * - "WICAREC1", then the view at recording start: screen width/height (int32),
+ *   view center x/y and cell size (float32), autofit flag (uint8)
+ * - A stream of records: varint time delta in microseconds, uint8 record type, type-specific payload.
+ *   Coordinates are zigzag varints; a BATCH record closes each processEvents() call so
+ *   maximum-speed replay keeps the original per-frame event grouping.
+ */
+class InputRecorder {
+public:
+    enum class Mode {
+        Idle,
+        Recording,
+        Replaying
+    };
+
+    /**
+     * @brief View state captured at the start of a recording and restored before replay.
+     */
+    struct ViewState {
+        int screenWidth = 0;
+        int screenHeight = 0;
+        float centerX = 0.0f;
+        float centerY = 0.0f;
+        float cellSize = 0.0f;
+        bool autoFit = false;
+    };
+
+private:
+    Mode mode_;
+    std::string path_;
+    std::vector<std::uint8_t> buffer_;
+    std::uint64_t startTicksNs_;
+    std::uint64_t lastEventUs_;
+    std::size_t eventCount_;
+    bool batchOpen_;
+
+    // Replay state
+    std::size_t readOffset_;
+    std::uint64_t replayClockUs_;    // Timestamp of the last decoded record
+    std::uint64_t replayStartNs_;
+    bool maxSpeed_;
+    bool hasPending_;                // A decoded record waiting for its timestamp
+    bool pendingIsBatch_;
+    std::uint64_t pendingTimeUs_;
+    SDL_Event pending_;
+    ViewState viewState_;
+    std::deque<std::string> textStorage_; // Keeps replayed SDL_TextInputEvent::text alive
+
+    void writeVarint(std::uint64_t value);
+    void writeSigned(std::int64_t value);
+    void writeFloat(float value);
+    bool readVarint(std::uint64_t& value);
+    bool readSigned(std::int64_t& value);
+    bool readFloat(float& value);
+    bool readByte(std::uint8_t& value);
+    void writeRecordHeader(std::uint8_t type);
+    bool decodeRecord();
+
+public:
+    InputRecorder();
+
+    /**
+     * @brief Starts buffering events. The file is written by stopRecording().
+     */
+    bool startRecording(const std::string& filePath, const ViewState& view);
+
+    /**
+     * @brief Writes the buffered events to the file given to startRecording().
+     * @return True if the file was written. Errors are logged.
+     */
+    bool stopRecording();
+
+    /**
+     * @brief Records one event; events InputHandler does not consume are ignored.
+     */
+    void recordEvent(const SDL_Event& event);
+
+    /**
+     * @brief Marks the end of one processEvents() call.
+     */
+    void endBatch();
+
+    /**
+     * @brief Loads a recording for replay.
+     * @param maxSpeed If true, one recorded batch is delivered per call to nextEvents()
+     * regardless of timestamps; otherwise events are delivered on their recorded schedule.
+     */
+    bool startReplay(const std::string& filePath, bool maxSpeed);
+    void stopReplay();
+
+    /**
+     * @brief Appends the events that are due to outEvents.
+     * @return False once the recording is exhausted.
+     */
+    bool nextEvents(std::vector<SDL_Event>& outEvents);
+
+    Mode getMode() const;
+    bool isMaxSpeed() const;
+    const ViewState& getViewState() const;
+    std::size_t getEventCount() const;
+    const std::string& getPath() const;
+};
+
+#endif // INPUT_RECORDER_H
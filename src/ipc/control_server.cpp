@@ -0,0 +1,318 @@
+#include "control_server.h"
+#include "../core/application.h"
+#include "../utils/logger.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <utility>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr int MAX_CLIENTS = 16;
+
+    std::int32_t readInt32LE(const unsigned char* p) {
+        std::uint32_t v = static_cast<std::uint32_t>(p[0]) |
+                          (static_cast<std::uint32_t>(p[1]) << 8) |
+                          (static_cast<std::uint32_t>(p[2]) << 16) |
+                          (static_cast<std::uint32_t>(p[3]) << 24);
+        return static_cast<std::int32_t>(v);
+    }
+
+    // Returns the count of a "put-cells <count>" line, or -1 if the line is another command.
+    long long parsePutCells(const std::string& line) {
+        static const std::string prefix = "put-cells";
+        if (line.compare(0, prefix.size(), prefix) != 0) return -1;
+        if (line.size() == prefix.size() || line[prefix.size()] != ' ') return -1;
+        std::string arg = line.substr(prefix.size() + 1);
+        arg.erase(0, arg.find_first_not_of(' '));
+        arg.erase(arg.find_last_not_of(' ') + 1);
+        if (arg.empty() || !std::all_of(arg.begin(), arg.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            return -2;
+        }
+        try {
+            return std::stoll(arg);
+        } catch (...) {
+            return -2;
+        }
+    }
+}
+
+ControlServer::ControlServer(Application& app)
+    : application_(app),
+      listenFd_(-1),
+      polling_(false),
+      closeRequested_(false) {
+}
+
+ControlServer::~ControlServer() {
+    close();
+}
+
+#ifndef _WIN32
+
+bool ControlServer::open(const std::string& socketPath) {
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+    close();
+
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(addr.sun_path)) {
+        if (logger) logger->error("Invalid control socket path '{}'.", socketPath);
+        return false;
+    }
+    std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size());
+
+    // A stale socket file from a previous run would make bind() fail, but anything else at
+    // that path is most likely a mistyped argument and must not be deleted.
+    struct stat existing;
+    if (::lstat(socketPath.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            if (logger) logger->error("Control socket path '{}' exists and is not a socket.", socketPath);
+            return false;
+        }
+        ::unlink(socketPath.c_str());
+    }
+
+    listenFd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listenFd_ < 0) {
+        if (logger) logger->error("socket() failed for control socket: {}", std::strerror(errno));
+        return false;
+    }
+
+    if (::bind(listenFd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listenFd_, MAX_CLIENTS) != 0) {
+        if (logger) logger->error("Could not listen on control socket '{}': {}", socketPath, std::strerror(errno));
+        ::close(listenFd_);
+        listenFd_ = -1;
+        return false;
+    }
+
+    socketPath_ = socketPath;
+    if (logger) logger->info("Control socket listening on '{}'.", socketPath_);
+    return true;
+}
+
+void ControlServer::close() {
+    if (polling_) {
+        // Requested by a command received over the socket: finish the current poll first.
+        closeRequested_ = true;
+        return;
+    }
+    closeRequested_ = false;
+    for (Client& client : clients_) {
+        closeClient(client);
+    }
+    clients_.clear();
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+        ::unlink(socketPath_.c_str());
+        auto logger = Logger::getLogger(Logger::Module::IPC);
+        if (logger) logger->info("Control socket '{}' closed.", socketPath_);
+    }
+    socketPath_.clear();
+}
+
+void ControlServer::acceptClients() {
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+    while (true) {
+        int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                if (logger) logger->warn("accept() failed on control socket: {}", std::strerror(errno));
+            }
+            return;
+        }
+        if (static_cast<int>(clients_.size()) >= MAX_CLIENTS) {
+            if (logger) logger->warn("Rejecting control connection: {} clients already connected.", MAX_CLIENTS);
+            ::close(fd);
+            continue;
+        }
+        clients_.push_back(Client{fd, {}, {}, 0, false, std::chrono::steady_clock::now()});
+        if (logger) logger->debug("Control client connected (fd {}).", fd);
+    }
+}
+
+bool ControlServer::readFromClient(Client& client) {
+    char buffer[64 * 1024];
+    // Past the cap the rest stays in the socket, so a fast sender is throttled by the kernel.
+    while (client.inBuffer.size() < MAX_INPUT_BUFFER) {
+        std::size_t room = std::min(sizeof(buffer), MAX_INPUT_BUFFER - client.inBuffer.size());
+        ssize_t n = ::recv(client.fd, buffer, room, 0);
+        if (n > 0) {
+            client.inBuffer.append(buffer, static_cast<std::size_t>(n));
+            continue;
+        }
+        if (n == 0) {
+            client.closing = true; // Peer finished sending; answer what is buffered, then close.
+            return true;
+        }
+        if (errno == EINTR) continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+    return true;
+}
+
+bool ControlServer::flushClient(Client& client) {
+    std::size_t sent = 0;
+    while (sent < client.outBuffer.size()) {
+        ssize_t n = ::send(client.fd, client.outBuffer.data() + sent, client.outBuffer.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<std::size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) break; // Retry on the next poll
+        client.outBuffer.clear();
+        return false;
+    }
+    client.outBuffer.erase(0, sent);
+    if (sent > 0 || client.outBuffer.empty()) client.lastSend = std::chrono::steady_clock::now();
+    return true;
+}
+
+void ControlServer::closeClient(Client& client) {
+    if (client.fd >= 0) {
+        ::close(client.fd);
+        client.fd = -1;
+    }
+}
+
+#else // _WIN32
+
+bool ControlServer::open(const std::string& socketPath) {
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+    if (logger) logger->error("Control socket '{}' is not supported on this platform.", socketPath);
+    return false;
+}
+
+void ControlServer::close() {
+    clients_.clear();
+    socketPath_.clear();
+}
+
+void ControlServer::acceptClients() {}
+bool ControlServer::readFromClient(Client&) { return false; }
+bool ControlServer::flushClient(Client&) { return false; }
+void ControlServer::closeClient(Client& client) { client.fd = -1; }
+
+#endif // _WIN32
+
+bool ControlServer::isOpen() const {
+    return listenFd_ >= 0;
+}
+
+const std::string& ControlServer::getSocketPath() const {
+    return socketPath_;
+}
+
+void ControlServer::appendResponse(Client& client, bool ok, const std::string& payload) {
+    client.outBuffer += ok ? "ok " : "err ";
+    client.outBuffer += std::to_string(payload.size());
+    client.outBuffer += '\n';
+    client.outBuffer += payload;
+}
+
+// Returns false if requests are left unexecuted because too many responses wait to be sent.
+bool ControlServer::processClient(Client& client) {
+    std::size_t offset = 0;
+    // Requests wait in inBuffer while the client is behind on reading its responses.
+    while (offset < client.inBuffer.size() && client.outBuffer.size() < MAX_OUTPUT_BUFFER) {
+        if (client.pendingCellRecords > 0) {
+            std::size_t needed = client.pendingCellRecords * CELL_RECORD_SIZE;
+            if (client.inBuffer.size() - offset < needed) break; // Wait for the rest of the payload
+
+            std::vector<std::pair<Point, int>> cells;
+            cells.reserve(client.pendingCellRecords);
+            const unsigned char* p = reinterpret_cast<const unsigned char*>(client.inBuffer.data() + offset);
+            for (std::size_t i = 0; i < client.pendingCellRecords; ++i, p += CELL_RECORD_SIZE) {
+                cells.emplace_back(Point(readInt32LE(p), readInt32LE(p + 4)), readInt32LE(p + 8));
+            }
+            offset += needed;
+            client.pendingCellRecords = 0;
+
+            std::string output;
+            bool ok = application_.applyCellUpload(cells, output);
+            appendResponse(client, ok, output);
+            continue;
+        }
+
+        std::size_t newline = client.inBuffer.find('\n', offset);
+        if (newline == std::string::npos) {
+            if (client.inBuffer.size() - offset > MAX_LINE_LENGTH) {
+                appendResponse(client, false, "Request line too long.");
+                client.closing = true;
+                offset = client.inBuffer.size();
+            }
+            break;
+        }
+
+        std::string line = client.inBuffer.substr(offset, newline - offset);
+        offset = newline + 1;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        long long cellCount = parsePutCells(line);
+        if (cellCount == -2 || cellCount > static_cast<long long>(MAX_CELL_RECORDS)) {
+            // The payload length is unknown, so the rest of the stream cannot be framed.
+            appendResponse(client, false, "Usage: put-cells <count> (followed by count * 12 bytes)");
+            client.closing = true;
+            offset = client.inBuffer.size();
+            break;
+        }
+        if (cellCount == 0) {
+            appendResponse(client, true, "0 cells applied.");
+            continue;
+        }
+        if (cellCount > 0) {
+            client.pendingCellRecords = static_cast<std::size_t>(cellCount);
+            continue;
+        }
+
+        std::string output;
+        bool ok = application_.executeControlCommand(line, output);
+        appendResponse(client, ok, output);
+    }
+    client.inBuffer.erase(0, offset);
+    return client.outBuffer.size() < MAX_OUTPUT_BUFFER;
+}
+
+void ControlServer::poll() {
+    if (listenFd_ < 0) return;
+
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+    polling_ = true;
+    acceptClients();
+    auto now = std::chrono::steady_clock::now();
+    for (Client& client : clients_) {
+        if (!client.outBuffer.empty() && now - client.lastSend > CLIENT_STALL_TIMEOUT) {
+            if (logger) logger->warn("Disconnecting control client (fd {}): {} bytes of responses unread for {} s.",
+                                     client.fd, client.outBuffer.size(), CLIENT_STALL_TIMEOUT.count());
+            closeClient(client);
+            continue;
+        }
+        if (!client.closing && !readFromClient(client)) {
+            closeClient(client);
+            continue;
+        }
+        bool caughtUp = processClient(client);
+        if (!flushClient(client) || (client.closing && caughtUp && client.outBuffer.empty())) {
+            closeClient(client);
+        }
+    }
+    clients_.erase(std::remove_if(clients_.begin(), clients_.end(),
+                                  [](const Client& c) { return c.fd < 0; }),
+                   clients_.end());
+    polling_ = false;
+    if (closeRequested_) close();
+}
@@ -0,0 +1,91 @@
+#ifndef CONTROL_SERVER_H
+#define CONTROL_SERVER_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class Application;
+
+/**
+ * @class ControlServer
+ * @brief Exposes the command set over a Unix domain socket for scripted automation.
+ *
+ * Protocol (requests may be pipelined; responses are returned in request order):
+ * - Request: one command per line, exactly as typed in the overlay (e.g. "load run.snapshot").
+ * - Bulk upload: the line "put-cells <count>" followed by count records of
+ *   three little-endian int32 values (x, y, state), with no separator.
+ * - Response: a header line "<ok|err> <payload_bytes>\n" followed by the payload,
+ *   which holds the messages the command posted to the user.
+ *
+ * The server never blocks: poll() is called from the main loop between generations,
+ * so every command runs on the simulation thread. Input is read only while less than
+ * MAX_INPUT_BUFFER bytes are buffered, and requests are executed only while less than
+ * MAX_OUTPUT_BUFFER bytes of responses wait to be sent; a client that reads none of its
+ * responses for CLIENT_STALL_TIMEOUT is disconnected.
+ */
+class ControlServer {
+private:
+    struct Client {
+        int fd;
+        std::string inBuffer;
+        std::string outBuffer;
+        std::size_t pendingCellRecords; // > 0 while waiting for put-cells payload
+        bool closing;
+        std::chrono::steady_clock::time_point lastSend; // Last time outBuffer was empty or shrank
+    };
+
+    Application& application_;
+    int listenFd_;
+    std::string socketPath_;
+    std::vector<Client> clients_;
+    bool polling_;        // Inside poll(); close() is deferred until it returns
+    bool closeRequested_;
+
+    void acceptClients();
+    bool readFromClient(Client& client);
+    bool processClient(Client& client);
+    bool flushClient(Client& client);
+    void closeClient(Client& client);
+    void appendResponse(Client& client, bool ok, const std::string& payload);
+
+public:
+    static constexpr std::size_t CELL_RECORD_SIZE = 12;                  // int32 x, y, state
+    static constexpr std::size_t MAX_CELL_RECORDS = 4u * 1024u * 1024u;  // Upper bound for one put-cells batch
+    static constexpr std::size_t MAX_LINE_LENGTH = 64 * 1024;
+    // Always holds one complete request, so a buffered request can never get stuck.
+    static constexpr std::size_t MAX_INPUT_BUFFER = MAX_CELL_RECORDS * CELL_RECORD_SIZE + MAX_LINE_LENGTH;
+    static constexpr std::size_t MAX_OUTPUT_BUFFER = 16u * 1024u * 1024u;
+    static constexpr std::chrono::seconds CLIENT_STALL_TIMEOUT{30};
+
+    explicit ControlServer(Application& app);
+    ~ControlServer();
+
+    ControlServer(const ControlServer&) = delete;
+    ControlServer& operator=(const ControlServer&) = delete;
+
+    /**
+     * @brief Binds and listens on the given socket path. An existing socket file is replaced;
+     * any other file at that path is left alone and the call fails.
+     * @return True on success. Errors are logged.
+     */
+    bool open(const std::string& socketPath);
+
+    /**
+     * @brief Closes all connections and removes the socket file.
+     */
+    void close();
+
+    bool isOpen() const;
+    const std::string& getSocketPath() const;
+
+    /**
+     * @brief Accepts pending connections, executes every complete request and flushes responses.
+     * Must be called from the simulation thread; it never waits for I/O.
+     */
+    void poll();
+};
+
+#endif // CONTROL_SERVER_H
@@ -0,0 +1,397 @@
+#include "frame_channel.h"
+#include "../ca/cell_space.h"
+#include "../core/rule.h"
+#include "../utils/logger.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace FrameChannel {
+
+    std::string normalizeName(const std::string& name) {
+        if (!name.empty() && name.front() == '/') {
+            return name;
+        }
+        return "/" + name;
+    }
+
+    std::size_t regionSize(std::uint32_t maxWidth, std::uint32_t maxHeight) {
+        return sizeof(Header) + static_cast<std::size_t>(SLOT_COUNT) * maxWidth * maxHeight;
+    }
+
+} // namespace FrameChannel
+
+#ifndef _WIN32
+namespace {
+    // Whether the existing object at shmName may be replaced: a channel whose publisher has
+    // exited, or an empty one left by a publisher that died while creating it. Otherwise
+    // reason says why it must be kept.
+    bool isStaleChannel(const std::string& shmName, std::string& reason) {
+        int fd = shm_open(shmName.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            reason = std::strerror(errno);
+            return errno == ENOENT; // Removed in the meantime
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0 || (status.st_size != 0 && static_cast<std::size_t>(status.st_size) < sizeof(FrameChannel::Header))) {
+            ::close(fd);
+            reason = "it is not a frame channel";
+            return false;
+        }
+        if (status.st_size == 0) {
+            ::close(fd);
+            return true;
+        }
+        void* mapping = mmap(nullptr, sizeof(FrameChannel::Header), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            reason = std::strerror(errno);
+            return false;
+        }
+        const auto* header = static_cast<const FrameChannel::Header*>(mapping);
+        static const char EMPTY_MAGIC[sizeof(FrameChannel::MAGIC)] = {};
+        bool empty = std::memcmp(header->magic, EMPTY_MAGIC, sizeof(EMPTY_MAGIC)) == 0;
+        bool ours = std::memcmp(header->magic, FrameChannel::MAGIC, sizeof(FrameChannel::MAGIC)) == 0;
+        pid_t owner = static_cast<pid_t>(header->publisherPid);
+        munmap(mapping, sizeof(FrameChannel::Header));
+
+        if (empty) return true;
+        if (!ours) {
+            reason = "it is not a frame channel";
+            return false;
+        }
+        if (owner > 0 && (kill(owner, 0) == 0 || errno == EPERM)) {
+            reason = "it is in use by process " + std::to_string(owner);
+            return false;
+        }
+        return true;
+    }
+}
+#endif
+
+// --- FramePublisher ---
+
+FramePublisher::FramePublisher()
+    : fd_(-1),
+      mapping_(nullptr),
+      mappingSize_(0),
+      header_(nullptr),
+      slotData_(nullptr),
+      maxWidth_(0),
+      maxHeight_(0) {
+}
+
+FramePublisher::~FramePublisher() {
+    close();
+}
+
+bool FramePublisher::open(const std::string& name, std::uint32_t maxWidth, std::uint32_t maxHeight) {
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+    close();
+
+    if (name.empty() || maxWidth == 0 || maxHeight == 0) {
+        if (logger) logger->error("Invalid frame channel parameters.");
+        return false;
+    }
+
+#ifdef _WIN32
+    if (logger) logger->error("Shared-memory frame channel is only supported on POSIX systems.");
+    return false;
+#else
+    std::string shmName = FrameChannel::normalizeName(name);
+    std::size_t size = FrameChannel::regionSize(maxWidth, maxHeight);
+
+    fd_ = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd_ < 0 && errno == EEXIST) {
+        // Replace an object left behind by a crashed run, but never a channel still being published.
+        std::string reason;
+        if (!isStaleChannel(shmName, reason)) {
+            if (logger) logger->error("Frame channel '{}' already exists and {}.", shmName, reason);
+            return false;
+        }
+        if (logger) logger->info("Removing stale frame channel '{}'.", shmName);
+        shm_unlink(shmName.c_str());
+        fd_ = shm_open(shmName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd_ < 0) {
+        if (logger) logger->error("shm_open failed for '{}': {}", shmName, std::strerror(errno));
+        return false;
+    }
+    if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        if (logger) logger->error("ftruncate failed for '{}': {}", shmName, std::strerror(errno));
+        ::close(fd_);
+        fd_ = -1;
+        shm_unlink(shmName.c_str());
+        return false;
+    }
+    mapping_ = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (mapping_ == MAP_FAILED) {
+        if (logger) logger->error("mmap failed for '{}': {}", shmName, std::strerror(errno));
+        mapping_ = nullptr;
+        ::close(fd_);
+        fd_ = -1;
+        shm_unlink(shmName.c_str());
+        return false;
+    }
+
+    mappingSize_ = size;
+    name_ = shmName;
+    maxWidth_ = maxWidth;
+    maxHeight_ = maxHeight;
+
+    // The object is freshly truncated, so it is zero-filled; construct the header in place.
+    header_ = new (mapping_) FrameChannel::Header();
+    std::memcpy(header_->magic, FrameChannel::MAGIC, sizeof(header_->magic));
+    header_->version = FrameChannel::VERSION;
+    header_->maxWidth = maxWidth;
+    header_->maxHeight = maxHeight;
+    header_->publisherPid = static_cast<std::uint32_t>(getpid());
+    header_->latestSlot.store(0, std::memory_order_relaxed);
+    header_->publishCount.store(0, std::memory_order_release);
+    slotData_ = static_cast<std::uint8_t*>(mapping_) + sizeof(FrameChannel::Header);
+
+    if (logger) logger->info("Frame channel '{}' created ({}x{} per slot).", name_, maxWidth_, maxHeight_);
+    return true;
+#endif
+}
+
+void FramePublisher::close() {
+#ifndef _WIN32
+    if (mapping_) {
+        munmap(mapping_, mappingSize_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+    if (!name_.empty()) {
+        shm_unlink(name_.c_str());
+        auto logger = Logger::getLogger(Logger::Module::IPC);
+        if (logger) logger->info("Frame channel '{}' closed.", name_);
+    }
+#endif
+    fd_ = -1;
+    mapping_ = nullptr;
+    mappingSize_ = 0;
+    header_ = nullptr;
+    slotData_ = nullptr;
+    name_.clear();
+}
+
+bool FramePublisher::isOpen() const {
+    return header_ != nullptr;
+}
+
+const std::string& FramePublisher::getName() const {
+    return name_;
+}
+
+void FramePublisher::setPalette(const Rule& rule) {
+    if (!header_) return;
+    for (int s = 0; s < 256; ++s) {
+        Color c(255, 0, 255, 255);
+        auto it = rule.getStateColorMap().find(s);
+        if (it != rule.getStateColorMap().end()) {
+            c = it->second;
+        }
+        header_->palette[s][0] = c.r;
+        header_->palette[s][1] = c.g;
+        header_->palette[s][2] = c.b;
+        header_->palette[s][3] = c.a;
+    }
+}
+
+void FramePublisher::publish(const CellSpace& cellSpace, Point worldOrigin, int worldWidth, int worldHeight,
+                             std::uint64_t generation) {
+    if (!header_ || worldWidth <= 0 || worldHeight <= 0) return;
+
+    // Pick the smallest power-of-two LOD step that fits the raster capacity.
+    int step = 1;
+    while ((worldWidth + step - 1) / step > static_cast<int>(maxWidth_) ||
+           (worldHeight + step - 1) / step > static_cast<int>(maxHeight_)) {
+        step *= 2;
+    }
+    const int rasterW = (worldWidth + step - 1) / step;
+    const int rasterH = (worldHeight + step - 1) / step;
+    const int defaultState = cellSpace.getDefaultState();
+    const std::uint8_t defaultByte = static_cast<std::uint8_t>(std::clamp(defaultState, 0, 255));
+
+    scratch_.assign(static_cast<std::size_t>(rasterW) * rasterH, defaultByte);
+
+    const auto& cells = cellSpace.getNonDefaultCells();
+    const long long regionCells = static_cast<long long>(worldWidth) * worldHeight;
+    if (static_cast<long long>(cells.size()) <= regionCells) {
+        // Sparse world: scatter the live cells that fall into the region.
+        for (const auto& pair : cells) {
+            int dx = pair.first.x - worldOrigin.x;
+            int dy = pair.first.y - worldOrigin.y;
+            if (dx < 0 || dy < 0 || dx >= worldWidth || dy >= worldHeight) continue;
+            scratch_[static_cast<std::size_t>(dy / step) * rasterW + dx / step] =
+                static_cast<std::uint8_t>(std::clamp(pair.second, 0, 255));
+        }
+    } else {
+        // Dense world: sample one representative cell per raster pixel.
+        for (int ry = 0; ry < rasterH; ++ry) {
+            for (int rx = 0; rx < rasterW; ++rx) {
+                int state = cellSpace.getCellState(Point(worldOrigin.x + rx * step, worldOrigin.y + ry * step));
+                scratch_[static_cast<std::size_t>(ry) * rasterW + rx] = static_cast<std::uint8_t>(std::clamp(state, 0, 255));
+            }
+        }
+    }
+
+    // Write into the slot after the latest one; readers still copying it will see the odd sequence.
+    std::uint32_t slotIndex = (header_->latestSlot.load(std::memory_order_relaxed) + 1) % FrameChannel::SLOT_COUNT;
+    FrameChannel::SlotHeader& slot = header_->slots[slotIndex];
+    std::uint8_t* dst = slotData_ + static_cast<std::size_t>(slotIndex) * maxWidth_ * maxHeight_;
+
+    std::uint64_t seq = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.generation = generation;
+    slot.worldX = worldOrigin.x;
+    slot.worldY = worldOrigin.y;
+    slot.width = rasterW;
+    slot.height = rasterH;
+    slot.cellsPerPixel = step;
+    slot.defaultState = defaultState;
+    std::memcpy(dst, scratch_.data(), scratch_.size());
+
+    slot.sequence.store(seq + 2, std::memory_order_release);
+    header_->latestSlot.store(slotIndex, std::memory_order_release);
+    header_->publishCount.fetch_add(1, std::memory_order_release);
+}
+
+// --- FrameSubscriber ---
+
+FrameSubscriber::FrameSubscriber()
+    : fd_(-1),
+      mapping_(nullptr),
+      mappingSize_(0),
+      header_(nullptr),
+      slotData_(nullptr) {
+}
+
+FrameSubscriber::~FrameSubscriber() {
+    detach();
+}
+
+bool FrameSubscriber::attach(const std::string& name) {
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+    detach();
+
+#ifdef _WIN32
+    if (logger) logger->error("Shared-memory frame channel is only supported on POSIX systems.");
+    return false;
+#else
+    std::string shmName = FrameChannel::normalizeName(name);
+    fd_ = shm_open(shmName.c_str(), O_RDONLY, 0);
+    if (fd_ < 0) {
+        if (logger) logger->error("Cannot attach to frame channel '{}': {}", shmName, std::strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) != 0 || static_cast<std::size_t>(st.st_size) < sizeof(FrameChannel::Header)) {
+        if (logger) logger->error("Frame channel '{}' is too small to be valid.", shmName);
+        detach();
+        return false;
+    }
+
+    mapping_ = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd_, 0);
+    if (mapping_ == MAP_FAILED) {
+        if (logger) logger->error("mmap failed for '{}': {}", shmName, std::strerror(errno));
+        mapping_ = nullptr;
+        detach();
+        return false;
+    }
+    mappingSize_ = static_cast<std::size_t>(st.st_size);
+    header_ = static_cast<const FrameChannel::Header*>(mapping_);
+
+    if (std::memcmp(header_->magic, FrameChannel::MAGIC, sizeof(header_->magic)) != 0 ||
+        header_->version != FrameChannel::VERSION ||
+        FrameChannel::regionSize(header_->maxWidth, header_->maxHeight) > mappingSize_) {
+        if (logger) logger->error("Frame channel '{}' has an unexpected layout.", shmName);
+        detach();
+        return false;
+    }
+    slotData_ = static_cast<const std::uint8_t*>(mapping_) + sizeof(FrameChannel::Header);
+
+    if (logger) logger->info("Attached read-only to frame channel '{}'.", shmName);
+    return true;
+#endif
+}
+
+void FrameSubscriber::detach() {
+#ifndef _WIN32
+    if (mapping_) {
+        munmap(const_cast<void*>(mapping_), mappingSize_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+#endif
+    fd_ = -1;
+    mapping_ = nullptr;
+    mappingSize_ = 0;
+    header_ = nullptr;
+    slotData_ = nullptr;
+}
+
+bool FrameSubscriber::isAttached() const {
+    return header_ != nullptr;
+}
+
+std::uint64_t FrameSubscriber::getPublishCount() const {
+    return header_ ? header_->publishCount.load(std::memory_order_acquire) : 0;
+}
+
+void FrameSubscriber::getPaletteColor(std::uint8_t state, std::uint8_t rgba[4]) const {
+    if (!header_) {
+        rgba[0] = rgba[1] = rgba[2] = 0;
+        rgba[3] = 255;
+        return;
+    }
+    std::memcpy(rgba, header_->palette[state], 4);
+}
+
+bool FrameSubscriber::readLatest(FrameChannel::Frame& outFrame) const {
+    if (!header_ || header_->publishCount.load(std::memory_order_acquire) == 0) return false;
+
+    const std::size_t slotBytes = static_cast<std::size_t>(header_->maxWidth) * header_->maxHeight;
+    for (int attempt = 0; attempt < 8; ++attempt) {
+        std::uint32_t slotIndex = header_->latestSlot.load(std::memory_order_acquire) % FrameChannel::SLOT_COUNT;
+        const FrameChannel::SlotHeader& slot = header_->slots[slotIndex];
+
+        std::uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1) continue; // Publisher is rewriting this slot right now.
+
+        int w = slot.width;
+        int h = slot.height;
+        if (w <= 0 || h <= 0 || static_cast<std::size_t>(w) * h > slotBytes) continue;
+
+        outFrame.generation = slot.generation;
+        outFrame.worldOrigin = Point(slot.worldX, slot.worldY);
+        outFrame.width = w;
+        outFrame.height = h;
+        outFrame.cellsPerPixel = slot.cellsPerPixel;
+        outFrame.defaultState = slot.defaultState;
+        outFrame.states.resize(static_cast<std::size_t>(w) * h);
+        std::memcpy(outFrame.states.data(), slotData_ + slotIndex * slotBytes, outFrame.states.size());
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
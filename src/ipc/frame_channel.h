@@ -0,0 +1,177 @@
+#ifndef FRAME_CHANNEL_H
+#define FRAME_CHANNEL_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../utils/point.h"
+
+class CellSpace;
+class Rule;
+
+/**
+ * @namespace FrameChannel
+ * @brief Shared-memory layout used to hand rasterized generations to an external viewer.
+ *
+ * The region is a POSIX shared-memory object holding a header followed by three
+ * raster slots (a triple buffer). Every slot is guarded by a sequence number that is
+ * odd while the publisher writes it, so a reader can detect torn copies and retry.
+ * The publisher never waits for readers.
+ */
+namespace FrameChannel {
+
+    constexpr char MAGIC[8] = {'W', 'i', 'C', 'A', 'F', 'R', 'M', '1'};
+    constexpr std::uint32_t VERSION = 1;
+    constexpr int SLOT_COUNT = 3;
+    constexpr int DEFAULT_MAX_WIDTH = 1024;
+    constexpr int DEFAULT_MAX_HEIGHT = 1024;
+
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+                  "Shared-memory frame channel requires lock-free 64-bit atomics.");
+
+    // Per-slot metadata. Fields other than 'sequence' are only valid while 'sequence' is even.
+    struct SlotHeader {
+        std::atomic<std::uint64_t> sequence;
+        std::uint64_t generation;
+        std::int32_t worldX;        // World coordinate covered by raster pixel (0,0)
+        std::int32_t worldY;
+        std::int32_t width;         // Raster dimensions actually in use
+        std::int32_t height;
+        std::int32_t cellsPerPixel; // LOD step: each raster pixel covers cellsPerPixel^2 cells
+        std::int32_t defaultState;
+    };
+
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t maxWidth;
+        std::uint32_t maxHeight;
+        std::uint32_t publisherPid;              // Owning process; a channel whose owner is gone is stale
+        std::atomic<std::uint32_t> latestSlot;
+        std::atomic<std::uint64_t> publishCount; // Bumped after every completed slot
+        std::uint8_t palette[256][4];            // RGBA for states 0..255
+        SlotHeader slots[SLOT_COUNT];
+    };
+
+    /**
+     * @brief A frame copied out of shared memory by a reader.
+     */
+    struct Frame {
+        std::uint64_t generation = 0;
+        Point worldOrigin;
+        int width = 0;
+        int height = 0;
+        int cellsPerPixel = 1;
+        int defaultState = 0;
+        std::vector<std::uint8_t> states; // width*height, row-major
+    };
+
+    // Normalizes a user-supplied name to a POSIX shm name (leading '/').
+    std::string normalizeName(const std::string& name);
+
+    // Total size in bytes of a channel with the given raster capacity.
+    std::size_t regionSize(std::uint32_t maxWidth, std::uint32_t maxHeight);
+
+} // namespace FrameChannel
+
+/**
+ * @class FramePublisher
+ * @brief Owns a shared-memory frame channel and publishes rasterized world regions into it.
+ */
+class FramePublisher {
+private:
+    std::string name_;
+    int fd_;
+    void* mapping_;
+    std::size_t mappingSize_;
+    FrameChannel::Header* header_;
+    std::uint8_t* slotData_;
+    std::uint32_t maxWidth_;
+    std::uint32_t maxHeight_;
+
+    std::vector<std::uint8_t> scratch_;
+
+public:
+    FramePublisher();
+    ~FramePublisher();
+
+    FramePublisher(const FramePublisher&) = delete;
+    FramePublisher& operator=(const FramePublisher&) = delete;
+
+    /**
+     * @brief Creates the shared-memory object. An existing object is only replaced if it is a
+     * stale channel, i.e. its publisher process has exited; a live channel is never taken over.
+     * @param name Channel name; a leading '/' is added when missing.
+     * @return True on success. Errors are logged.
+     */
+    bool open(const std::string& name,
+              std::uint32_t maxWidth = FrameChannel::DEFAULT_MAX_WIDTH,
+              std::uint32_t maxHeight = FrameChannel::DEFAULT_MAX_HEIGHT);
+
+    /**
+     * @brief Unmaps and unlinks the shared-memory object.
+     */
+    void close();
+
+    bool isOpen() const;
+    const std::string& getName() const;
+
+    /**
+     * @brief Writes the palette used by viewers to colorize states.
+     */
+    void setPalette(const Rule& rule);
+
+    /**
+     * @brief Rasterizes the given world rectangle and publishes it as the latest frame.
+     * Regions larger than the channel capacity are downsampled by a power-of-two LOD step.
+     * Never blocks on readers.
+     */
+    void publish(const CellSpace& cellSpace, Point worldOrigin, int worldWidth, int worldHeight,
+                 std::uint64_t generation);
+};
+
+/**
+ * @class FrameSubscriber
+ * @brief Attaches read-only to a frame channel created by a FramePublisher.
+ */
+class FrameSubscriber {
+private:
+    int fd_;
+    const void* mapping_;
+    std::size_t mappingSize_;
+    const FrameChannel::Header* header_;
+    const std::uint8_t* slotData_;
+
+public:
+    FrameSubscriber();
+    ~FrameSubscriber();
+
+    FrameSubscriber(const FrameSubscriber&) = delete;
+    FrameSubscriber& operator=(const FrameSubscriber&) = delete;
+
+    bool attach(const std::string& name);
+    void detach();
+    bool isAttached() const;
+
+    /**
+     * @brief Number of frames completed by the publisher so far.
+     */
+    std::uint64_t getPublishCount() const;
+
+    /**
+     * @brief Copies the palette color for a state.
+     */
+    void getPaletteColor(std::uint8_t state, std::uint8_t rgba[4]) const;
+
+    /**
+     * @brief Copies the latest consistent frame.
+     * @param outFrame Receives the frame on success.
+     * @return False if no consistent frame could be read (e.g. publisher kept overwriting it).
+     */
+    bool readLatest(FrameChannel::Frame& outFrame) const;
+};
+
+#endif // FRAME_CHANNEL_H
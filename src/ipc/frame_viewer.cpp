@@ -0,0 +1,156 @@
+#include "frame_viewer.h"
+#include "../utils/logger.h"
+
+#include <algorithm>
+
+FrameViewer::FrameViewer()
+    : window_(nullptr),
+      sdlRenderer_(nullptr),
+      texture_(nullptr),
+      textureWidth_(0),
+      textureHeight_(0),
+      lastPublishCount_(0),
+      hasFrame_(false) {
+}
+
+FrameViewer::~FrameViewer() {
+    cleanup();
+}
+
+bool FrameViewer::initialize(const std::string& channelName) {
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+
+    if (!subscriber_.attach(channelName)) {
+        if (logger) logger->error("Viewer could not attach to channel '{}'. Is the simulation publishing?", channelName);
+        return false;
+    }
+
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        if (logger) logger->error("SDL_Init failed in viewer mode: {}", SDL_GetError());
+        return false;
+    }
+
+    std::string title = "WiCA Viewer - " + FrameChannel::normalizeName(channelName);
+    window_ = SDL_CreateWindow(title.c_str(), 1024, 768, SDL_WINDOW_RESIZABLE);
+    if (!window_) {
+        if (logger) logger->error("SDL_CreateWindow failed in viewer mode: {}", SDL_GetError());
+        return false;
+    }
+
+    SDL_PropertiesID props = SDL_CreateProperties();
+    SDL_SetPointerProperty(props, SDL_PROP_RENDERER_CREATE_WINDOW_POINTER, window_);
+    SDL_SetNumberProperty(props, SDL_PROP_RENDERER_CREATE_PRESENT_VSYNC_NUMBER, 1);
+    sdlRenderer_ = SDL_CreateRendererWithProperties(props);
+    SDL_DestroyProperties(props);
+    if (!sdlRenderer_) {
+        if (logger) logger->error("Failed to create viewer renderer: {}", SDL_GetError());
+        return false;
+    }
+
+    if (logger) logger->info("Viewer initialized.");
+    return true;
+}
+
+bool FrameViewer::ensureTexture(int width, int height) {
+    if (texture_ && textureWidth_ == width && textureHeight_ == height) {
+        return true;
+    }
+    if (texture_) {
+        SDL_DestroyTexture(texture_);
+        texture_ = nullptr;
+    }
+    texture_ = SDL_CreateTexture(sdlRenderer_, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, width, height);
+    if (!texture_) {
+        auto logger = Logger::getLogger(Logger::Module::IPC);
+        if (logger) logger->error("Failed to create viewer texture: {}", SDL_GetError());
+        return false;
+    }
+    SDL_SetTextureScaleMode(texture_, SDL_SCALEMODE_NEAREST);
+    textureWidth_ = width;
+    textureHeight_ = height;
+    return true;
+}
+
+void FrameViewer::uploadFrame() {
+    if (!ensureTexture(frame_.width, frame_.height)) return;
+
+    // Resolve the palette once per distinct state instead of once per pixel.
+    std::uint8_t lut[256][4];
+    for (int s = 0; s < 256; ++s) {
+        subscriber_.getPaletteColor(static_cast<std::uint8_t>(s), lut[s]);
+    }
+
+    rgbaPixels_.resize(frame_.states.size() * 4);
+    for (std::size_t i = 0; i < frame_.states.size(); ++i) {
+        const std::uint8_t* c = lut[frame_.states[i]];
+        rgbaPixels_[i * 4 + 0] = c[0];
+        rgbaPixels_[i * 4 + 1] = c[1];
+        rgbaPixels_[i * 4 + 2] = c[2];
+        rgbaPixels_[i * 4 + 3] = c[3];
+    }
+    SDL_UpdateTexture(texture_, nullptr, rgbaPixels_.data(), frame_.width * 4);
+}
+
+void FrameViewer::render() {
+    SDL_SetRenderDrawColor(sdlRenderer_, 40, 40, 40, 255);
+    SDL_RenderClear(sdlRenderer_);
+
+    if (hasFrame_ && texture_) {
+        int winW = 0, winH = 0;
+        SDL_GetWindowSize(window_, &winW, &winH);
+        // Keep square cells: fit the raster into the window preserving its aspect ratio.
+        float scale = std::min(static_cast<float>(winW) / frame_.width, static_cast<float>(winH) / frame_.height);
+        SDL_FRect dst;
+        dst.w = frame_.width * scale;
+        dst.h = frame_.height * scale;
+        dst.x = (winW - dst.w) / 2.0f;
+        dst.y = (winH - dst.h) / 2.0f;
+        SDL_RenderTexture(sdlRenderer_, texture_, nullptr, &dst);
+    }
+    SDL_RenderPresent(sdlRenderer_);
+}
+
+void FrameViewer::run() {
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+    bool running = true;
+    while (running) {
+        SDL_Event event;
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_EVENT_QUIT ||
+                (event.type == SDL_EVENT_KEY_DOWN && event.key.key == SDLK_ESCAPE)) {
+                running = false;
+            }
+        }
+
+        std::uint64_t publishCount = subscriber_.getPublishCount();
+        if (publishCount != lastPublishCount_ && subscriber_.readLatest(frame_)) {
+            lastPublishCount_ = publishCount;
+            hasFrame_ = true;
+            uploadFrame();
+            std::string title = "WiCA Viewer - gen " + std::to_string(frame_.generation) +
+                                " (1:" + std::to_string(frame_.cellsPerPixel) + ")";
+            SDL_SetWindowTitle(window_, title.c_str());
+        }
+
+        render();
+        SDL_Delay(16);
+    }
+    if (logger) logger->info("Viewer closed.");
+}
+
+void FrameViewer::cleanup() {
+    if (texture_) {
+        SDL_DestroyTexture(texture_);
+        texture_ = nullptr;
+    }
+    if (sdlRenderer_) {
+        SDL_DestroyRenderer(sdlRenderer_);
+        sdlRenderer_ = nullptr;
+    }
+    if (window_) {
+        SDL_DestroyWindow(window_);
+        window_ = nullptr;
+        SDL_Quit();
+    }
+    subscriber_.detach();
+}
@@ -0,0 +1,58 @@
+#ifndef FRAME_VIEWER_H
+#define FRAME_VIEWER_H
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <SDL3/SDL.h>
+
+#include "frame_channel.h"
+
+/**
+ * @class FrameViewer
+ * @brief Lightweight viewer mode: attaches read-only to a frame channel and displays it.
+ *
+ * The viewer owns its own window and never touches the simulation; it only polls the
+ * shared-memory channel for new frames, so attaching or detaching it does not affect
+ * the publishing process.
+ */
+class FrameViewer {
+private:
+    FrameSubscriber subscriber_;
+    SDL_Window* window_;
+    SDL_Renderer* sdlRenderer_;
+    SDL_Texture* texture_;
+    int textureWidth_;
+    int textureHeight_;
+
+    FrameChannel::Frame frame_;
+    std::vector<std::uint8_t> rgbaPixels_;
+    std::uint64_t lastPublishCount_;
+    bool hasFrame_;
+
+    bool ensureTexture(int width, int height);
+    void uploadFrame();
+    void render();
+    void cleanup();
+
+public:
+    FrameViewer();
+    ~FrameViewer();
+
+    FrameViewer(const FrameViewer&) = delete;
+    FrameViewer& operator=(const FrameViewer&) = delete;
+
+    /**
+     * @brief Attaches to the channel and opens the viewer window.
+     * @param channelName Name passed to the publisher (e.g. "wica").
+     * @return True on success.
+     */
+    bool initialize(const std::string& channelName);
+
+    /**
+     * @brief Runs the viewer loop until the window is closed or Esc is pressed.
+     */
+    void run();
+};
+
+#endif // FRAME_VIEWER_H
@@ -0,0 +1,224 @@
+#include "metrics_exporter.h"
+#include "../utils/metrics.h"
+#include "../utils/logger.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    constexpr int POLL_TIMEOUT_MS = 200;   // Bounds how long stop() waits for the thread
+    constexpr int CLIENT_TIMEOUT_MS = 500; // Slow scrapers are dropped rather than stalling dumps
+}
+
+MetricsExporter::MetricsExporter()
+    : stopRequested_(false),
+      listenFd_(-1),
+      port_(0),
+      dumpInterval_(0) {
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::isServing() const {
+    return listenFd_ >= 0;
+}
+
+bool MetricsExporter::isDumping() const {
+    return !dumpPath_.empty();
+}
+
+int MetricsExporter::getPort() const {
+    return port_;
+}
+
+void MetricsExporter::ensureWorker() {
+    if (worker_.joinable() || (listenFd_ < 0 && dumpPath_.empty())) return;
+    stopRequested_ = false;
+    worker_ = std::thread(&MetricsExporter::workerLoop, this);
+}
+
+void MetricsExporter::stopWorker() {
+    if (!worker_.joinable()) return;
+    stopRequested_ = true;
+    worker_.join();
+}
+
+void MetricsExporter::writeDump(const std::string& path) {
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            auto logger = Logger::getLogger(Logger::Module::IPC);
+            if (logger) logger->warn("Could not write metrics dump '{}'.", tmpPath);
+            return;
+        }
+        out << Metrics::renderPrometheus();
+    }
+    std::rename(tmpPath.c_str(), path.c_str());
+}
+
+#ifndef _WIN32
+
+bool MetricsExporter::startHttp(int port) {
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+    if (port <= 0 || port > 65535) {
+        if (logger) logger->error("Invalid metrics port {}.", port);
+        return false;
+    }
+
+    stopWorker();
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        if (logger) logger->error("socket() failed for metrics listener: {}", std::strerror(errno));
+        ensureWorker();
+        return false;
+    }
+    int reuse = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK); // Never exposed beyond localhost
+
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || ::listen(fd, 8) != 0) {
+        if (logger) logger->error("Could not listen for metrics on 127.0.0.1:{}: {}", port, std::strerror(errno));
+        ::close(fd);
+        port_ = 0;
+        ensureWorker();
+        return false;
+    }
+
+    listenFd_ = fd;
+    port_ = port;
+    if (logger) logger->info("Serving metrics on http://127.0.0.1:{}/metrics", port_);
+    ensureWorker();
+    return true;
+}
+
+void MetricsExporter::serveClient(int clientFd) {
+    // Read (and ignore) the request head; every path returns the same exposition.
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        pollfd pfd{clientFd, POLLIN, 0};
+        if (::poll(&pfd, 1, CLIENT_TIMEOUT_MS) <= 0) return;
+        ssize_t n = ::recv(clientFd, buffer, sizeof(buffer), 0);
+        if (n <= 0) return;
+        request.append(buffer, static_cast<std::size_t>(n));
+    }
+
+    std::string body = Metrics::renderPrometheus();
+    std::string response = "HTTP/1.1 200 OK\r\n"
+                           "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+                           "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           "Connection: close\r\n\r\n" + body;
+
+    std::size_t sent = 0;
+    while (sent < response.size()) {
+        pollfd pfd{clientFd, POLLOUT, 0};
+        if (::poll(&pfd, 1, CLIENT_TIMEOUT_MS) <= 0) return;
+        ssize_t n = ::send(clientFd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        sent += static_cast<std::size_t>(n);
+    }
+}
+
+void MetricsExporter::workerLoop() {
+    auto nextDump = std::chrono::steady_clock::now();
+    while (!stopRequested_) {
+        if (!dumpPath_.empty() && std::chrono::steady_clock::now() >= nextDump) {
+            writeDump(dumpPath_);
+            nextDump = std::chrono::steady_clock::now() + dumpInterval_;
+        }
+
+        if (listenFd_ >= 0) {
+            pollfd pfd{listenFd_, POLLIN, 0};
+            if (::poll(&pfd, 1, POLL_TIMEOUT_MS) > 0 && (pfd.revents & POLLIN)) {
+                int clientFd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+                if (clientFd >= 0) {
+                    serveClient(clientFd);
+                    ::close(clientFd);
+                }
+            }
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(POLL_TIMEOUT_MS));
+        }
+    }
+}
+
+void MetricsExporter::stop() {
+    stopWorker();
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+    }
+    port_ = 0;
+    if (!dumpPath_.empty()) {
+        writeDump(dumpPath_); // Final values for runs that end between intervals
+        dumpPath_.clear();
+    }
+}
+
+#else // _WIN32
+
+bool MetricsExporter::startHttp(int port) {
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+    if (logger) logger->error("Metrics HTTP listener (port {}) is not supported on this platform. Use file dumps.", port);
+    return false;
+}
+
+void MetricsExporter::serveClient(int) {}
+
+void MetricsExporter::workerLoop() {
+    auto nextDump = std::chrono::steady_clock::now();
+    while (!stopRequested_) {
+        if (!dumpPath_.empty() && std::chrono::steady_clock::now() >= nextDump) {
+            writeDump(dumpPath_);
+            nextDump = std::chrono::steady_clock::now() + dumpInterval_;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(POLL_TIMEOUT_MS));
+    }
+}
+
+void MetricsExporter::stop() {
+    stopWorker();
+    if (!dumpPath_.empty()) {
+        writeDump(dumpPath_);
+        dumpPath_.clear();
+    }
+}
+
+#endif // _WIN32
+
+bool MetricsExporter::startFileDump(const std::string& path, std::chrono::milliseconds interval) {
+    auto logger = Logger::getLogger(Logger::Module::IPC);
+    if (path.empty() || interval.count() <= 0) {
+        if (logger) logger->error("Invalid metrics dump configuration.");
+        return false;
+    }
+    stopWorker();
+    dumpPath_ = path;
+    dumpInterval_ = interval;
+    if (logger) logger->info("Dumping metrics to '{}' every {} ms.", dumpPath_, dumpInterval_.count());
+    ensureWorker();
+    return true;
+}
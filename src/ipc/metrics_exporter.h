@@ -0,0 +1,69 @@
+#ifndef METRICS_EXPORTER_H
+#define METRICS_EXPORTER_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+/**
+ * @class MetricsExporter
+ * @brief Publishes the Metrics registry from a background thread.
+ *
+ * Two outputs are supported and may run together:
+ * - A minimal HTTP listener on 127.0.0.1 that answers every request with the
+ *   Prometheus text exposition (scrape target `http://127.0.0.1:<port>/metrics`).
+ * - Periodic dumps to a file, written to a temporary file and renamed so readers
+ *   (e.g. node_exporter's textfile collector) never see a partial file.
+ *
+ * The thread only reads atomics, so the simulation is never blocked by an exporter.
+ * Configuration changes stop and restart the thread, so it never sees them mid-flight.
+ */
+class MetricsExporter {
+private:
+    std::thread worker_;
+    std::atomic<bool> stopRequested_;
+
+    int listenFd_;
+    int port_;
+    std::string dumpPath_;
+    std::chrono::milliseconds dumpInterval_;
+
+    void ensureWorker();
+    void stopWorker();
+    void workerLoop();
+    void serveClient(int clientFd);
+    void writeDump(const std::string& path);
+
+public:
+    MetricsExporter();
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * @brief Starts (or moves) the HTTP listener to the given localhost port.
+     * @return True on success. Errors are logged.
+     */
+    bool startHttp(int port);
+
+    /**
+     * @brief Starts (or reconfigures) periodic dumps.
+     * @param path Output file.
+     * @param interval Time between dumps.
+     * @return True on success.
+     */
+    bool startFileDump(const std::string& path, std::chrono::milliseconds interval);
+
+    /**
+     * @brief Stops both outputs and joins the background thread.
+     */
+    void stop();
+
+    bool isServing() const;
+    bool isDumping() const;
+    int getPort() const;
+};
+
+#endif // METRICS_EXPORTER_H
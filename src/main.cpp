@@ -1,11 +1,14 @@
 #include "utils/logger.h"        // Your new logging system
 #include "core/application.h"    // Your main application class
+#include "ipc/frame_viewer.h"
+#include "ca/engine_fuzzer.h"
 #include "utils/timer.h"
 
 #include <iostream> // Used for emergency output if logger initialization fails
 #include <string>
 #include <vector>
 #include <stdexcept> // For std::exception
+#include <cctype>
 
 int main(int argc, char* argv[]) {
     Logger::initialize("windcell.log", spdlog::level::info);
@@ -26,6 +29,115 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // Command-line options
+    std::string configFilePath="rules/rgb.json";
+    bool ruleGiven = false;
+    bool fuzz = false;
+    EngineFuzzer::Options fuzzOptions;
+    bool headless = false;
+    std::string publishChannel;
+    std::string viewerChannel;
+    std::string controlSocket;
+    int metricsPort = 0;
+    std::string metricsFile;
+    std::string recordFile;
+    std::string replayFile;
+    bool benchmark = false;
+    double frameBudgetMs = 0.0;
+    std::string resumeDirectory;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--headless") {
+            headless = true;
+        } else if (arg == "--rule" && i + 1 < argc) {
+            configFilePath = argv[++i];
+            ruleGiven = true;
+        } else if (arg == "--fuzz") {
+            // Optional positional values: iterations, then seed.
+            fuzz = true;
+            try {
+                if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                    fuzzOptions.iterations = std::stoi(argv[++i]);
+                }
+                if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                    fuzzOptions.seed = std::stoull(argv[++i]);
+                }
+            } catch (const std::exception&) {
+                main_logger->warn("Ignoring invalid --fuzz value: {}", argv[i]);
+            }
+        } else if (arg == "--publish" && i + 1 < argc) {
+            publishChannel = argv[++i];
+        } else if (arg == "--viewer" && i + 1 < argc) {
+            viewerChannel = argv[++i];
+        } else if (arg == "--control" && i + 1 < argc) {
+            controlSocket = argv[++i];
+        } else if (arg == "--metrics-port" && i + 1 < argc) {
+            try {
+                metricsPort = std::stoi(argv[++i]);
+            } catch (const std::exception&) {
+                main_logger->warn("Ignoring invalid --metrics-port value: {}", argv[i]);
+            }
+        } else if (arg == "--metrics-file" && i + 1 < argc) {
+            metricsFile = argv[++i];
+        } else if (arg == "--record" && i + 1 < argc) {
+            recordFile = argv[++i];
+        } else if (arg == "--replay" && i + 1 < argc) {
+            replayFile = argv[++i];
+            benchmark = false;
+        } else if (arg == "--benchmark" && i + 1 < argc) {
+            replayFile = argv[++i];
+            benchmark = true;
+        } else if (arg == "--resume" && i + 1 < argc) {
+            resumeDirectory = argv[++i];
+        } else if (arg == "--frame-budget" && i + 1 < argc) {
+            try {
+                frameBudgetMs = std::stod(argv[++i]);
+            } catch (const std::exception&) {
+                main_logger->warn("Ignoring invalid --frame-budget value: {}", argv[i]);
+            }
+        } else {
+            main_logger->warn("Ignoring unknown argument: {}", arg);
+        }
+    }
+
+    // Differential fuzzing needs no window; the exit code reports the result.
+    if (fuzz) {
+        fuzzOptions.rulePaths = ruleGiven ? std::vector<std::string>{configFilePath}
+                                          : std::vector<std::string>{"rules/life.json", "rules/rgb.json",
+                                                                     "rules/brians_brain.json", "rules/star_wars.json",
+                                                                     "rules/hex_life.json", "rules/triangle_life.json"};
+        fuzzOptions.randomRules = !ruleGiven;
+        Logger::setLevel(Logger::Module::CellSpace, spdlog::level::warn);
+        Logger::setLevel(Logger::Module::RuleEngine, spdlog::level::warn);
+        Logger::setLevel(Logger::Module::Rule, spdlog::level::warn); // One random rule is parsed per iteration
+        main_logger->info("Fuzzing engines: {} soups per rule{}, seed {}.", fuzzOptions.iterations,
+                          fuzzOptions.randomRules ? " and as many random Generations rules" : "", fuzzOptions.seed);
+        EngineFuzzer fuzzer(fuzzOptions);
+        EngineFuzzer::Divergence divergence;
+        bool agreed = fuzzer.run(divergence);
+        if (agreed) {
+            main_logger->info("Fuzzing finished: all engines agreed.");
+        } else {
+            main_logger->error("Fuzzing found a divergence ({}); reproducer: {}", divergence.engineName, fuzzOptions.reproducerPath);
+        }
+        spdlog::shutdown();
+        return agreed ? 0 : 1;
+    }
+
+    // Viewer mode only attaches to a running simulation's frame channel.
+    if (!viewerChannel.empty()) {
+        main_logger->info("Starting in viewer mode on channel '{}'.", viewerChannel);
+        FrameViewer viewer;
+        if (!viewer.initialize(viewerChannel)) {
+            main_logger->error("Could not attach to frame channel '{}'.", viewerChannel);
+            spdlog::shutdown();
+            return 1;
+        }
+        viewer.run();
+        spdlog::shutdown();
+        return 0;
+    }
+
     // 3. Create and run the application instance
     main_logger->info("Creating Application instance...");
     std::unique_ptr<Application> app;
@@ -50,9 +162,32 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    std::string configFilePath="rules/rgb.json";
     if (app) {
-        app->initialize(configFilePath);
+        app->initialize(configFilePath, headless);
+        if (!publishChannel.empty()) {
+            app->startFramePublishing(publishChannel);
+        }
+        if (!controlSocket.empty()) {
+            app->startControlServer(controlSocket);
+        }
+        if (metricsPort > 0) {
+            app->startMetricsServer(metricsPort);
+        }
+        if (!metricsFile.empty()) {
+            app->startMetricsDump(metricsFile, 10.0f);
+        }
+        if (frameBudgetMs > 0.0) {
+            app->setFrameBudget(frameBudgetMs);
+        }
+        if (!resumeDirectory.empty()) {
+            app->resumeFromCheckpoints(resumeDirectory);
+        }
+        if (!recordFile.empty()) {
+            app->startRecording(recordFile);
+        }
+        if (!replayFile.empty()) {
+            app->startReplay(replayFile, benchmark, benchmark);
+        }
         app->run();
     } else {
         main_logger->critical("Application instance was not created. Cannot run.");
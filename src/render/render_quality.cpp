@@ -0,0 +1,105 @@
+#include "render_quality.h"
+#include "../utils/logger.h"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    const char* levelName(RenderQualityController::Level level) {
+        switch (level) {
+            case RenderQualityController::Level::Full: return "full";
+            case RenderQualityController::Level::NoGridLines: return "no grid lines";
+            case RenderQualityController::Level::Lod2: return "LOD 2x";
+            case RenderQualityController::Level::Lod4: return "LOD 4x";
+            case RenderQualityController::Level::Lod8: return "LOD 8x";
+            case RenderQualityController::Level::Lod16: return "LOD 16x";
+        }
+        return "unknown";
+    }
+}
+
+RenderQualityController::RenderQualityController()
+    : budgetMs_(0.0),
+      level_(Level::Full),
+      averageMs_(0.0),
+      framesSinceChange_(0),
+      headroomFrames_(0),
+      upgradeDelay_(MIN_UPGRADE_DELAY),
+      lastChangeWasUpgrade_(false) {
+}
+
+void RenderQualityController::setBudgetMs(double budgetMs) {
+    budgetMs_ = std::max(0.0, budgetMs);
+    level_ = Level::Full;
+    averageMs_ = 0.0;
+    framesSinceChange_ = 0;
+    headroomFrames_ = 0;
+    upgradeDelay_ = MIN_UPGRADE_DELAY;
+    lastChangeWasUpgrade_ = false;
+}
+
+void RenderQualityController::recordFrame(double renderMs) {
+    if (!isEnabled()) return;
+    // The first frame after a change seeds the average, so a new level is judged on its own frames.
+    averageMs_ = framesSinceChange_ == 0 ? renderMs : averageMs_ + SMOOTHING * (renderMs - averageMs_);
+    ++framesSinceChange_;
+
+    if (averageMs_ > budgetMs_) {
+        headroomFrames_ = 0;
+        if (framesSinceChange_ < SETTLE_FRAMES || level_ == Level::Lod16) return;
+        if (lastChangeWasUpgrade_ && framesSinceChange_ <= 2 * SETTLE_FRAMES) {
+            // The last upgrade did not fit; try it again only after a longer stretch of headroom.
+            upgradeDelay_ = std::min(upgradeDelay_ * 2, MAX_UPGRADE_DELAY);
+        }
+        changeLevel(static_cast<Level>(static_cast<int>(level_) + 1));
+        lastChangeWasUpgrade_ = false;
+        return;
+    }
+
+    if (averageMs_ < budgetMs_ * HEADROOM && level_ != Level::Full) {
+        if (++headroomFrames_ >= upgradeDelay_) {
+            changeLevel(static_cast<Level>(static_cast<int>(level_) - 1));
+            lastChangeWasUpgrade_ = true;
+        }
+    } else {
+        headroomFrames_ = 0;
+    }
+    if (lastChangeWasUpgrade_ && framesSinceChange_ > 2 * SETTLE_FRAMES) {
+        upgradeDelay_ = MIN_UPGRADE_DELAY; // The upgrade held
+        lastChangeWasUpgrade_ = false;
+    }
+}
+
+void RenderQualityController::changeLevel(Level level) {
+    auto logger = Logger::getLogger(Logger::Module::Renderer);
+    if (logger) logger->info("Render quality {} -> {} (renderGrid {:.2f} ms, budget {:.2f} ms).",
+                             levelName(level_), levelName(level), averageMs_, budgetMs_);
+    level_ = level;
+    framesSinceChange_ = 0;
+    headroomFrames_ = 0;
+}
+
+int RenderQualityController::getLodStep() const {
+    switch (level_) {
+        case Level::Lod2: return 2;
+        case Level::Lod4: return 4;
+        case Level::Lod8: return 8;
+        case Level::Lod16: return 16;
+        default: return 1;
+    }
+}
+
+std::string RenderQualityController::getIndicator() const {
+    if (!isEnabled() || level_ == Level::Full) return "";
+    char text[64];
+    std::snprintf(text, sizeof(text), "Quality: %s (%.1f/%.1f ms)", levelName(level_), averageMs_, budgetMs_);
+    return text;
+}
+
+std::string RenderQualityController::describe() const {
+    if (!isEnabled()) return "Frame budget off (full quality).";
+    char text[128];
+    std::snprintf(text, sizeof(text), "Frame budget %.1f ms: quality %s, renderGrid averaging %.2f ms.",
+                  budgetMs_, levelName(level_), averageMs_);
+    return text;
+}
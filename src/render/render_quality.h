@@ -0,0 +1,76 @@
+#ifndef RENDER_QUALITY_H
+#define RENDER_QUALITY_H
+
+#include <string>
+
+/**
+ * @class RenderQualityController
+ * @brief Steps grid rendering detail down and up to keep renderGrid within a frame budget.
+ *
+ * Every frame reports its renderGrid time. The controller smooths it and, when the average
+ * exceeds the budget, moves one level down the ladder: grid lines are dropped first, then
+ * cells are drawn at a coarser level of detail where only every 2nd, 4th, 8th or 16th cell
+ * in each direction is drawn as a block of that size. With at least half of the budget left
+ * for a while it moves one level back up. An upgrade that overruns right away is undone and
+ * the next attempt waits twice as long, so a frame time near the budget does not oscillate.
+ * A budget of zero (the default) turns the controller off and keeps full quality.
+ */
+class RenderQualityController {
+public:
+    enum class Level {
+        Full,
+        NoGridLines,
+        Lod2,
+        Lod4,
+        Lod8,
+        Lod16
+    };
+
+    RenderQualityController();
+
+    /**
+     * @brief Sets the target renderGrid time; zero or less turns adaptation off. Resets the level.
+     */
+    void setBudgetMs(double budgetMs);
+    double getBudgetMs() const { return budgetMs_; }
+    bool isEnabled() const { return budgetMs_ > 0.0; }
+
+    /**
+     * @brief Feeds the time one renderGrid call took; may change the level for the next frame.
+     */
+    void recordFrame(double renderMs);
+
+    Level getLevel() const { return level_; }
+    double getAverageMs() const { return averageMs_; }
+
+    /**
+     * @brief Cells per block side at the current level (1 at Full and NoGridLines).
+     */
+    int getLodStep() const;
+    bool areGridLinesAllowed() const { return level_ == Level::Full; }
+
+    /**
+     * @brief Short text for the on-screen indicator, empty at full quality.
+     */
+    std::string getIndicator() const;
+    std::string describe() const;
+
+private:
+    static constexpr double SMOOTHING = 0.2;          // Weight of the newest frame in the average
+    static constexpr double HEADROOM = 0.5;           // Fraction of the budget to use before stepping up
+    static constexpr int SETTLE_FRAMES = 4;           // Frames to wait after any change before stepping down
+    static constexpr int MIN_UPGRADE_DELAY = 60;      // Frames with headroom before stepping up
+    static constexpr int MAX_UPGRADE_DELAY = 960;
+
+    void changeLevel(Level level);
+
+    double budgetMs_;
+    Level level_;
+    double averageMs_;
+    int framesSinceChange_;
+    int headroomFrames_;
+    int upgradeDelay_;
+    bool lastChangeWasUpgrade_;
+};
+
+#endif // RENDER_QUALITY_H
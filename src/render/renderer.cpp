@@ -6,14 +6,16 @@
 #include <vector>
 #include <map>
 #include <unordered_set> // For globallyLoggedMissingColors
+#include <span>
+#include <chrono>
 // #include <random> // No longer needed for sampling
 // #include <thread> // No longer needed for sampling
 
 #include "../utils/timer.h"
+#include "../utils/metrics.h"
 
 // TBB Includes
-#include <tbb/parallel_for_each.h>
-#include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
 
 const std::string ASSETS_FONT_PATH = "assets/fonts/";
 
@@ -40,7 +42,14 @@ Renderer::Renderer()
       currentFontPath_(""),
       currentFontSize_(16),
       gridDisplayMode_(GridDisplayMode::AUTO),
-      gridHideThreshold_(10)
+      gridHideThreshold_(10),
+      fieldTexture_(nullptr),
+      fieldTextureWidth_(0),
+      fieldTextureHeight_(0),
+      fieldTextureVersion_(0),
+      fieldColormap_(Colormap::Grayscale),
+      fieldColormapTable_(buildColormapTable(Colormap::Grayscale)),
+      topRightInset_(0)
 {
 }
 
@@ -462,6 +471,7 @@ void Renderer::renderCells(const CellSpace &cellSpace, const Viewport &viewport)
     int sample_step_y = 1;
     int cell_render_w = 0;
     int cell_render_h = 0;
+    int lodStep = qualityController_.getLodStep(); // Cells per block side when the frame budget is tight
 
     if (actual_cell_w_float <= 0.0f || actual_cell_h_float <= 0.0f)
     {
@@ -488,141 +498,178 @@ void Renderer::renderCells(const CellSpace &cellSpace, const Viewport &viewport)
         if (cell_render_w <= 0 || cell_render_h <= 0)
             return; // Still no renderable area
     }
-
-    tbb::concurrent_vector<CellRenderInfo> cellInfos;
-    tbb::concurrent_vector<PixelRenderInfo> pixelInfos;
-
-    // Estimate size for pixelInfos/cellInfos. This is a rough estimate.
-    if (renderAsPixels)
+    // Hexagon and triangle cells do not tile as square blocks; they keep full detail.
+    if (viewport.getLattice() != Lattice::Square)
+        lodStep = 1;
+    if (lodStep > 1)
     {
-        pixelInfos.reserve(activeCellsMap.size() / (static_cast<size_t>(sample_step_x * sample_step_y)) + 10);
+        // Each drawn cell stands for a lodStep x lodStep block of the cells it was sampled from.
+        sample_step_x *= lodStep;
+        sample_step_y *= lodStep;
+        cell_render_w = std::max(1, static_cast<int>(std::lround(sample_step_x * actual_cell_w_float)));
+        cell_render_h = std::max(1, static_cast<int>(std::lround(sample_step_y * actual_cell_h_float)));
+        renderAsPixels = false;
     }
-    else
+    const bool sampled = sample_step_x > 1 || sample_step_y > 1;
+
+    // Gather the candidate cells into contiguous arrays for the batch transform.
+    // Sub-pixel cells are sampled deterministically on world coordinates so the picture is stable.
+    batchWorld_.clear();
+    batchStates_.clear();
+    batchWorld_.reserve(activeCellsMap.size());
+    batchStates_.reserve(activeCellsMap.size());
+    for (const auto &pair : activeCellsMap)
     {
-        cellInfos.reserve(activeCellsMap.size());
-    }
-
-    tbb::concurrent_vector<int> statesMissingColorLog;
-
-    int sW = viewport.getScreenWidth();
-    int sH = viewport.getScreenHeight();
-    // Parallel calculation
-    tbb::parallel_for_each(activeCellsMap.begin(), activeCellsMap.end(),
-                           [&, this, renderAsPixels, sample_step_x, sample_step_y, cell_render_w, cell_render_h](const auto &pair)
-                           {
-                               Point worldPos = pair.first;
-                               int state = pair.second;
-                               Point screenPosStart = viewport.worldToScreen(worldPos);
-
-                               if (renderAsPixels)
-                               {
-                                   // Deterministic sampling based on world coordinates and step
-                                   // Handles negative coordinates correctly for modulo to ensure consistent grid
-                                   bool x_match = ((worldPos.x % sample_step_x + sample_step_x) % sample_step_x) == 0;
-                                   bool y_match = ((worldPos.y % sample_step_y + sample_step_y) % sample_step_y) == 0;
-
-                                   if (x_match && y_match)
-                                   {
-                                       if (screenPosStart.x >= 0 && screenPosStart.x < sW &&
-                                           screenPosStart.y >= 0 && screenPosStart.y < sH)
-                                       {
-                                           SDL_Color drawColor;
-                                           auto it_color = this->stateSdlColorMap_.find(state);
-                                           if (it_color != this->stateSdlColorMap_.end())
-                                           {
-                                               drawColor = it_color->second;
-                                           }
-                                           else
-                                           {
-                                               drawColor = {255, 0, 255, 255};
-                                               statesMissingColorLog.push_back(state);
-                                           }
-                                           pixelInfos.emplace_back(PixelRenderInfo{screenPosStart, drawColor});
-                                       }
-                                   }
-                               }
-                               else
-                               { // Render as rectangles
-                                   SDL_FRect cellRect;
-                                   cellRect.x = screenPosStart.x;
-                                   cellRect.y = screenPosStart.y;
-                                   cellRect.w = cell_render_w;
-                                   cellRect.h = cell_render_h;
-
-                                   if (cellRect.x < sW && cellRect.y < sH &&
-                                       cellRect.x + cellRect.w > 0 && cellRect.y + cellRect.h > 0)
-                                   {
-                                       SDL_Color drawColor;
-                                       auto it_color = this->stateSdlColorMap_.find(state);
-                                       if (it_color != this->stateSdlColorMap_.end())
-                                       {
-                                           drawColor = it_color->second;
-                                       }
-                                       else
-                                       {
-                                           drawColor = {255, 0, 255, 255};
-                                           statesMissingColorLog.push_back(state);
-                                       }
-                                       cellInfos.emplace_back(CellRenderInfo{cellRect, drawColor});
-                                   }
-                               }
-                           });
-
-    // Log missing colors
-    if (logger)
-    {
-        for (int state_val : statesMissingColorLog)
+        if (sampled)
         {
-            if (Renderer::globallyLoggedMissingColors.find(state_val) == Renderer::globallyLoggedMissingColors.end())
-            {
-                logger->warn("Color for state " + std::to_string(state_val) + " not found. Using fallback magenta.");
-                Renderer::globallyLoggedMissingColors.insert(state_val);
-            }
+            // Handles negative coordinates correctly for modulo to ensure consistent grid
+            bool x_match = ((pair.first.x % sample_step_x + sample_step_x) % sample_step_x) == 0;
+            bool y_match = ((pair.first.y % sample_step_y + sample_step_y) % sample_step_y) == 0;
+            if (!x_match || !y_match)
+                continue;
         }
+        batchWorld_.push_back(pair.first);
+        batchStates_.push_back(pair.second);
     }
 
-    // Batch rendering rectangles
-    if (!renderAsPixels && !cellInfos.empty())
+    const std::size_t candidateCount = batchWorld_.size();
+    if (candidateCount == 0)
+        return;
+    batchScreen_.resize(candidateCount);
+    batchVisible_.resize(candidateCount);
+
+    // Transform and cull in fixed blocks; each block compacts into its own slice of the output.
+    constexpr std::size_t BATCH_BLOCK_SIZE = 16384;
+    const std::size_t blockCount = (candidateCount + BATCH_BLOCK_SIZE - 1) / BATCH_BLOCK_SIZE;
+    int extentX = renderAsPixels ? 1 : cell_render_w;
+    int extentY = renderAsPixels ? 1 : cell_render_h;
+    int marginX = 0;
+    int marginY = 0;
+
+    // Hexagons and triangles are drawn as geometry from per-parity outlines scaled to pixels.
+    const Lattice lattice = viewport.getLattice();
+    const bool renderAsShapes = !renderAsPixels && lattice != Lattice::Square;
+    float shapeX[2][LATTICE_MAX_VERTICES];
+    float shapeY[2][LATTICE_MAX_VERTICES];
+    int shapeVertexCount = 0;
+    if (renderAsShapes)
     {
-        std::map<SDL_Color, std::vector<SDL_FRect>, SdlColorCompare> batchedRects;
-        for (const auto &info : cellInfos)
+        for (int parity = 0; parity < 2; ++parity)
         {
-            batchedRects[info.color].push_back(info.rect);
-        }
-        for (const auto &batch : batchedRects)
-        {
-            const SDL_Color &color = batch.first;
-            const std::vector<SDL_FRect> &rects = batch.second;
-            if (!rects.empty())
+            shapeVertexCount = latticeCellShape(lattice, parity, shapeX[parity], shapeY[parity]);
+            for (int v = 0; v < shapeVertexCount; ++v)
             {
-                SDL_SetRenderDrawColor(sdlRenderer_, color.r, color.g, color.b, color.a);
-                SDL_RenderFillRects(sdlRenderer_, rects.data(), static_cast<int>(rects.size()));
+                shapeX[parity][v] *= actual_cell_w_float;
+                shapeY[parity][v] *= actual_cell_h_float;
             }
         }
+        float minX, minY, maxX, maxY;
+        latticeCellBounds(lattice, minX, minY, maxX, maxY);
+        extentX = static_cast<int>(std::ceil(maxX * actual_cell_w_float)) + 1;
+        extentY = static_cast<int>(std::ceil(maxY * actual_cell_h_float)) + 1;
+        marginX = static_cast<int>(std::ceil(-minX * actual_cell_w_float)) + 1;
+        marginY = static_cast<int>(std::ceil(-minY * actual_cell_h_float)) + 1;
+        geometryVertices_.clear();
+        geometryIndices_.clear();
     }
-
-    // Batch rendering pixels
-    if (renderAsPixels && !pixelInfos.empty())
+    batchBlockCounts_.assign(blockCount, 0);
+    tbb::parallel_for(std::size_t(0), blockCount, [&](std::size_t block)
+                      {
+                          std::size_t begin = block * BATCH_BLOCK_SIZE;
+                          std::size_t length = std::min(BATCH_BLOCK_SIZE, candidateCount - begin);
+                          batchBlockCounts_[block] = viewport.worldToScreenBatch(
+                              std::span<const Point>(batchWorld_).subspan(begin, length),
+                              std::span<SDL_FPoint>(batchScreen_).subspan(begin, length),
+                              std::span<std::uint32_t>(batchVisible_).subspan(begin, length),
+                              extentX, extentY, marginX, marginY);
+                      });
+
+    // Group the visible cells by color; the color lookup runs once per distinct state.
+    std::map<SDL_Color, std::vector<SDL_FRect>, SdlColorCompare> batchedRects;
+    std::map<SDL_Color, std::vector<SDL_FPoint>, SdlColorCompare> batchedPoints;
+    std::unordered_map<int, SDL_Color> stateColors;
+    for (std::size_t block = 0; block < blockCount; ++block)
     {
-        std::map<SDL_Color, std::vector<SDL_FPoint>, SdlColorCompare> batchedPoints;
-        for (const auto &pInfo : pixelInfos)
+        std::size_t begin = block * BATCH_BLOCK_SIZE;
+        for (std::size_t k = begin; k < begin + batchBlockCounts_[block]; ++k)
         {
-            SDL_FPoint newPoint;
-            newPoint.x = pInfo.screenPos.x;
-            newPoint.y = pInfo.screenPos.y;
-            batchedPoints[pInfo.color].push_back(newPoint);
-        }
-        for (const auto &batch : batchedPoints)
-        {
-            const SDL_Color &color = batch.first;
-            const std::vector<SDL_FPoint> &points = batch.second;
-            if (!points.empty())
+            int state = batchStates_[begin + batchVisible_[k]];
+            auto it_cached = stateColors.find(state);
+            if (it_cached == stateColors.end())
             {
-                SDL_SetRenderDrawColor(sdlRenderer_, color.r, color.g, color.b, color.a);
-                SDL_RenderPoints(sdlRenderer_, points.data(), static_cast<int>(points.size()));
+                SDL_Color drawColor;
+                auto it_color = stateSdlColorMap_.find(state);
+                if (it_color != stateSdlColorMap_.end())
+                {
+                    drawColor = it_color->second;
+                }
+                else
+                {
+                    drawColor = {255, 0, 255, 255};
+                    if (logger && Renderer::globallyLoggedMissingColors.insert(state).second)
+                    {
+                        logger->warn("Color for state " + std::to_string(state) + " not found. Using fallback magenta.");
+                    }
+                }
+                it_cached = stateColors.emplace(state, drawColor).first;
+            }
+
+            const SDL_FPoint &screenPos = batchScreen_[k];
+            if (renderAsShapes)
+            {
+                const SDL_Color &c = it_cached->second;
+                const SDL_FColor color{c.r / 255.0f, c.g / 255.0f, c.b / 255.0f, c.a / 255.0f};
+                const int parity = latticeParity(lattice, batchWorld_[begin + batchVisible_[k]]);
+                const int base = static_cast<int>(geometryVertices_.size());
+                for (int v = 0; v < shapeVertexCount; ++v)
+                {
+                    geometryVertices_.push_back(SDL_Vertex{
+                        SDL_FPoint{screenPos.x + shapeX[parity][v], screenPos.y + shapeY[parity][v]}, color, SDL_FPoint{0.0f, 0.0f}});
+                }
+                for (int v = 1; v + 1 < shapeVertexCount; ++v)
+                {
+                    geometryIndices_.push_back(base);
+                    geometryIndices_.push_back(base + v);
+                    geometryIndices_.push_back(base + v + 1);
+                }
+            }
+            else if (renderAsPixels)
+            {
+                batchedPoints[it_cached->second].push_back(screenPos);
+            }
+            else
+            {
+                batchedRects[it_cached->second].push_back(SDL_FRect{screenPos.x, screenPos.y,
+                                                                    static_cast<float>(cell_render_w),
+                                                                    static_cast<float>(cell_render_h)});
             }
         }
     }
+
+    // Batch rendering hexagons/triangles (vertex colors, so one call covers every state)
+    if (renderAsShapes && !geometryIndices_.empty())
+    {
+        SDL_RenderGeometry(sdlRenderer_, nullptr, geometryVertices_.data(), static_cast<int>(geometryVertices_.size()),
+                           geometryIndices_.data(), static_cast<int>(geometryIndices_.size()));
+    }
+
+    // Batch rendering rectangles
+    for (const auto &batch : batchedRects)
+    {
+        const SDL_Color &color = batch.first;
+        const std::vector<SDL_FRect> &rects = batch.second;
+        SDL_SetRenderDrawColor(sdlRenderer_, color.r, color.g, color.b, color.a);
+        SDL_RenderFillRects(sdlRenderer_, rects.data(), static_cast<int>(rects.size()));
+    }
+
+    // Batch rendering pixels
+    for (const auto &batch : batchedPoints)
+    {
+        const SDL_Color &color = batch.first;
+        const std::vector<SDL_FPoint> &points = batch.second;
+        SDL_SetRenderDrawColor(sdlRenderer_, color.r, color.g, color.b, color.a);
+        SDL_RenderPoints(sdlRenderer_, points.data(), static_cast<int>(points.size()));
+    }
 }
 
 // renderGridLines remains the same
@@ -631,6 +678,11 @@ void Renderer::renderGridLines(const Viewport &viewport)
     auto logger = Logger::getLogger(Logger::Module::Renderer);
     if (!sdlRenderer_)
         return;
+    // Square grid lines do not follow hexagon or triangle outlines.
+    if (viewport.getLattice() != Lattice::Square)
+        return;
+    if (!qualityController_.areGridLinesAllowed())
+        return;
 
     float currentCellPixelSize = viewport.getCurrentCellSize();
     int screenW = viewport.getScreenWidth();
@@ -705,6 +757,7 @@ void Renderer::renderGrid(const CellSpace &cellSpace, const Viewport &viewport)
     if (!sdlRenderer_)
         return;
 
+    Metrics::ScopedObservation frameObservation(Metrics::Histogram::FrameSeconds);
     timer.start();
 
     SDL_Color backgroundColor = {220, 220, 220, 255};
@@ -723,9 +776,86 @@ void Renderer::renderGrid(const CellSpace &cellSpace, const Viewport &viewport)
     SDL_SetRenderDrawColor(sdlRenderer_, backgroundColor.r, backgroundColor.g, backgroundColor.b, backgroundColor.a);
     SDL_RenderClear(sdlRenderer_);
 
+    auto frameStart = std::chrono::steady_clock::now();
     renderCells(cellSpace, viewport);
     renderGridLines(viewport);
+    qualityController_.recordFrame(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frameStart).count());
 
+    Metrics::increment(Metrics::Counter::FramesRendered);
+    timer.stop();
+}
+
+void Renderer::renderField(const ReactionDiffusionField &field, const Viewport &viewport)
+{
+    auto logger = Logger::getLogger(Logger::Module::Renderer);
+    auto timer = Timer::getTimer(Timer::Module::renderGrid);
+    if (!sdlRenderer_ || !field.isConfigured())
+        return;
+
+    Metrics::ScopedObservation frameObservation(Metrics::Histogram::FrameSeconds);
+    timer.start();
+
+    const ReactionDiffusionSettings &settings = field.getSettings();
+    const int width = field.getWidth();
+    const int height = field.getHeight();
+    bool upload = field.getVersion() != fieldTextureVersion_;
+    if (settings.colormap != fieldColormap_)
+    {
+        fieldColormap_ = settings.colormap;
+        fieldColormapTable_ = buildColormapTable(fieldColormap_);
+        upload = true;
+    }
+    if (!fieldTexture_ || fieldTextureWidth_ != width || fieldTextureHeight_ != height)
+    {
+        if (fieldTexture_)
+            SDL_DestroyTexture(fieldTexture_);
+        fieldTexture_ = SDL_CreateTexture(sdlRenderer_, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, width, height);
+        if (!fieldTexture_)
+        {
+            if (logger)
+                logger->error("Failed to create field texture: {}", SDL_GetError());
+            timer.stop();
+            return;
+        }
+        SDL_SetTextureScaleMode(fieldTexture_, SDL_SCALEMODE_NEAREST);
+        fieldTextureWidth_ = width;
+        fieldTextureHeight_ = height;
+        upload = true;
+    }
+
+    if (upload)
+    {
+        fieldPixels_.resize(static_cast<std::size_t>(width) * height * 4);
+        const float low = settings.displayMin;
+        const float scale = 255.0f / (settings.displayMax - settings.displayMin);
+        tbb::parallel_for(0, height, [&](int y)
+                          {
+                              const float *row = field.rowV(y);
+                              std::uint8_t *out = fieldPixels_.data() + static_cast<std::size_t>(y) * width * 4;
+                              for (int x = 0; x < width; ++x)
+                              {
+                                  float level = std::clamp((row[x] - low) * scale, 0.0f, 255.0f);
+                                  const std::array<std::uint8_t, 4> &color = fieldColormapTable_[static_cast<int>(level)];
+                                  std::copy(color.begin(), color.end(), out + x * 4);
+                              }
+                          });
+        SDL_UpdateTexture(fieldTexture_, nullptr, fieldPixels_.data(), width * 4);
+        fieldTextureVersion_ = field.getVersion();
+    }
+
+    SDL_SetRenderDrawColor(sdlRenderer_, uiBackgroundColor_.r, uiBackgroundColor_.g, uiBackgroundColor_.b, 255);
+    SDL_RenderClear(sdlRenderer_);
+    const float cellSize = viewport.getCurrentCellSize();
+    const Viewport::PointF offset = viewport.getViewOffsetF();
+    SDL_FRect dst;
+    dst.x = -offset.x * cellSize;
+    dst.y = -offset.y * cellSize;
+    dst.w = width * cellSize;
+    dst.h = height * cellSize;
+    SDL_RenderTexture(sdlRenderer_, fieldTexture_, nullptr, &dst);
+    renderGridLines(viewport);
+
+    Metrics::increment(Metrics::Counter::FramesRendered);
     timer.stop();
 }
 
@@ -853,6 +983,8 @@ void Renderer::renderUI(const std::string &commandText, bool showCommandInput,
         }
     }
 
+    renderQualityIndicator(screenW, UIMargin, textPadding);
+
     int messageRenderedHeight = 0;
     if (!userMessage.empty())
     {
@@ -936,9 +1068,113 @@ void Renderer::renderUI(const std::string &commandText, bool showCommandInput,
     }
 }
 
+// Top-right badge while the frame budget holds grid detail below full quality, below the population graph if shown
+void Renderer::renderQualityIndicator(int screenW, int margin, int padding)
+{
+    std::string indicator = qualityController_.getIndicator();
+    if (indicator.empty())
+        return;
+
+    int top = margin + topRightInset_;
+
+    int textWidth = 0;
+    TTF_MeasureString(uiFont_, indicator.c_str(), indicator.length(), 0, &textWidth, nullptr);
+    int maxWidth = screenW / 3;
+    int x = screenW - margin - std::min(textWidth, maxWidth) - 2 * padding;
+    int renderedHeight = 0;
+    // Measure the wrapped height first, then draw the background and the text over it
+    renderMultiLineText(indicator, x + padding, top + padding, uiMsgColor_, maxWidth, renderedHeight);
+    if (renderedHeight <= 0)
+        return;
+    SDL_FRect bgRect = {static_cast<float>(x), static_cast<float>(top),
+                        static_cast<float>(std::min(textWidth, maxWidth) + 2 * padding),
+                        static_cast<float>(renderedHeight + 2 * padding)};
+    SDL_SetRenderDrawColor(sdlRenderer_, uiBackgroundColor_.r, uiBackgroundColor_.g, uiBackgroundColor_.b, uiBackgroundColor_.a);
+    SDL_RenderFillRect(sdlRenderer_, &bgRect);
+    renderMultiLineText(indicator, x + padding, top + padding, uiMsgColor_, maxWidth, renderedHeight);
+}
+
+void Renderer::renderPopulationGraph(const PopulationHistory &history, const Viewport &viewport)
+{
+    if (!sdlRenderer_ || history.size() < 2 || history.getStates().empty())
+        return;
+
+    const int graphW = 240;
+    const int graphH = 72;
+    const int UIMargin = 10;
+    const int textPadding = 5;
+    SDL_FRect box = {static_cast<float>(viewport.getScreenWidth() - graphW - UIMargin), static_cast<float>(UIMargin),
+                     static_cast<float>(graphW), static_cast<float>(graphH)};
+    if (box.x < 0)
+        return;
+    topRightInset_ = UIMargin + graphH;
+
+    // One sample per pixel column: show the newest samples that fit.
+    const int plotW = graphW - 2 * textPadding;
+    const int plotH = graphH - 2 * textPadding;
+    std::size_t sampleCount = std::min(history.size(), static_cast<std::size_t>(plotW));
+    std::size_t first = history.size() - sampleCount;
+
+    std::size_t maxCount = 1;
+    for (std::size_t i = first; i < history.size(); ++i)
+    {
+        for (std::size_t s = 0; s < history.getStates().size(); ++s)
+            maxCount = std::max(maxCount, history.getCount(i, s));
+    }
+
+    SDL_SetRenderDrawColor(sdlRenderer_, uiBackgroundColor_.r, uiBackgroundColor_.g, uiBackgroundColor_.b, uiBackgroundColor_.a);
+    SDL_RenderFillRect(sdlRenderer_, &box);
+
+    std::vector<SDL_FPoint> line(sampleCount);
+    float left = box.x + textPadding;
+    float bottom = box.y + textPadding + plotH;
+    float xStep = sampleCount > 1 ? static_cast<float>(plotW) / static_cast<float>(sampleCount - 1) : 0.0f;
+    for (std::size_t s = 0; s < history.getStates().size(); ++s)
+    {
+        for (std::size_t i = 0; i < sampleCount; ++i)
+        {
+            float value = static_cast<float>(history.getCount(first + i, s)) / static_cast<float>(maxCount);
+            line[i] = SDL_FPoint{left + xStep * static_cast<float>(i), bottom - value * static_cast<float>(plotH)};
+        }
+        auto it_color = stateSdlColorMap_.find(history.getStates()[s]);
+        SDL_Color color = it_color != stateSdlColorMap_.end() ? it_color->second : SDL_Color{255, 0, 255, 255};
+        SDL_SetRenderDrawColor(sdlRenderer_, color.r, color.g, color.b, 255);
+        SDL_RenderLines(sdlRenderer_, line.data(), static_cast<int>(line.size()));
+    }
+
+    int labelHeight = 0;
+    renderMultiLineText("max " + std::to_string(maxCount), static_cast<int>(box.x) + textPadding,
+                        static_cast<int>(box.y) + textPadding, uiTextColor_, plotW, labelHeight);
+}
+
+void Renderer::renderHighlights(const std::vector<SDL_Rect> &worldRects, const Viewport &viewport)
+{
+    if (!sdlRenderer_ || worldRects.empty())
+        return;
+
+    const float screenW = static_cast<float>(viewport.getScreenWidth());
+    const float screenH = static_cast<float>(viewport.getScreenHeight());
+    const float cellSize = viewport.getCurrentCellSize();
+    std::vector<SDL_FRect> outlines;
+    for (const SDL_Rect &rect : worldRects)
+    {
+        Point topLeft = viewport.worldToScreen(Point(rect.x, rect.y));
+        // At least a few pixels so matches stay visible when zoomed far out.
+        SDL_FRect outline = {static_cast<float>(topLeft.x) - 1.0f, static_cast<float>(topLeft.y) - 1.0f,
+                             std::max(rect.w * cellSize, 3.0f) + 2.0f, std::max(rect.h * cellSize, 3.0f) + 2.0f};
+        if (outline.x < screenW && outline.y < screenH && outline.x + outline.w > 0 && outline.y + outline.h > 0)
+            outlines.push_back(outline);
+    }
+    if (outlines.empty())
+        return;
+    SDL_SetRenderDrawColor(sdlRenderer_, uiMsgColor_.r, uiMsgColor_.g, uiMsgColor_.b, 255);
+    SDL_RenderRects(sdlRenderer_, outlines.data(), static_cast<int>(outlines.size()));
+}
+
 void Renderer::presentScreen()
 {
     auto logger = Logger::getLogger(Logger::Module::Renderer);
+    topRightInset_ = 0; // Recomputed by the overlays of the next frame
     if (sdlRenderer_)
     {
         SDL_RenderPresent(sdlRenderer_);
@@ -962,6 +1198,11 @@ void Renderer::cleanup()
         fontLoadedSuccessfully_ = false;
     }
     cleanupTTF();
+    if (fieldTexture_)
+    {
+        SDL_DestroyTexture(fieldTexture_);
+        fieldTexture_ = nullptr;
+    }
     if (sdlRenderer_)
     {
         SDL_DestroyRenderer(sdlRenderer_);
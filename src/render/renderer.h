@@ -8,11 +8,16 @@
 #include <unordered_map> // For stateSdlColorMap_
 #include <map>             // For batchedRects/Points in renderCells implementation
 #include <unordered_set>   // For globallyLoggedMissingColors
+#include <array>
+#include <cstdint>
 
 #include "../core/rule.h"       // Required for Rule
 #include "../ca/cell_space.h"   // Required for CellSpace
 #include "viewport.h"           // Required for Viewport (includes Point struct)
 #include "../utils/color.h"     // Required for Color
+#include "../ca/population_history.h"
+#include "../ca/reaction_diffusion.h"
+#include "render_quality.h"
 
 // Enum for grid display mode
 enum class GridDisplayMode {
@@ -21,18 +26,6 @@ enum class GridDisplayMode {
     OFF
 };
 
-// Helper struct to store pre-calculated render information for each cell rectangle
-struct CellRenderInfo {
-    SDL_FRect rect;
-    SDL_Color color;
-};
-
-// Helper struct to store pre-calculated render information for each cell pixel
-struct PixelRenderInfo {
-    Point screenPos; // Point struct from viewport.h (likely {int x, int y})
-    SDL_Color color;
-};
-
 // Custom comparator for SDL_Color to use it as a key in std::map
 struct SdlColorCompare {
     bool operator()(const SDL_Color& a, const SDL_Color& b) const {
@@ -71,6 +64,30 @@ private:
     GridDisplayMode gridDisplayMode_;
     int gridHideThreshold_;
 
+    // Scratch buffers for renderCells, reused across frames to avoid per-frame allocation
+    std::vector<Point> batchWorld_;
+    std::vector<int> batchStates_;
+    std::vector<SDL_FPoint> batchScreen_;
+    std::vector<std::uint32_t> batchVisible_;
+    std::vector<std::size_t> batchBlockCounts_;
+    std::vector<SDL_Vertex> geometryVertices_; // Hexagon/triangle cells, one SDL_RenderGeometry call
+    std::vector<int> geometryIndices_;
+
+    // Reaction-diffusion fields are drawn as one colormapped texture, re-uploaded only when the field changes
+    SDL_Texture* fieldTexture_;
+    int fieldTextureWidth_;
+    int fieldTextureHeight_;
+    std::uint64_t fieldTextureVersion_;
+    Colormap fieldColormap_;
+    std::array<std::array<std::uint8_t, 4>, 256> fieldColormapTable_;
+    std::vector<std::uint8_t> fieldPixels_;
+
+    // Lowers grid detail when renderGrid overruns the frame budget
+    RenderQualityController qualityController_;
+
+    // Height taken at the top right by the population graph this frame; overlays there stack below it
+    int topRightInset_;
+
     // Private helper methods
     bool initializeTTF();
     void cleanupTTF();
@@ -81,6 +98,7 @@ private:
     void renderCells(const CellSpace& cellSpace, const Viewport& viewport);
     void renderGridLines(const Viewport& viewport);
     void renderMultiLineText(const std::string& text, int x, int y, SDL_Color color, int maxWidth, int& outHeight);
+    void renderQualityIndicator(int screenW, int margin, int padding);
 
     // Static member to keep track of logged missing colors to avoid spamming logs
     static std::unordered_set<int> globallyLoggedMissingColors;
@@ -96,6 +114,19 @@ public:
     void reinitializeColors(const Rule& newConfig);
 
     void renderGrid(const CellSpace& cellSpace, const Viewport& viewport);
+    /**
+     * @brief Draws a reaction-diffusion field: v is mapped through the rule's colormap and
+     * the field is drawn as a texture covering world cells (0, 0) to (width - 1, height - 1).
+     */
+    void renderField(const ReactionDiffusionField& field, const Viewport& viewport);
+    /**
+     * @brief Draws the recent per-state population as a sparkline in the top-right corner.
+     */
+    void renderPopulationGraph(const PopulationHistory& history, const Viewport& viewport);
+    /**
+     * @brief Outlines world rectangles (e.g. pattern search matches) that are on screen.
+     */
+    void renderHighlights(const std::vector<SDL_Rect>& worldRects, const Viewport& viewport);
     void renderUI(const std::string& commandText, bool showCommandInput,
                   const std::string& userMessage, const std::string& brushInfo,
                   const Viewport& viewport);
@@ -118,6 +149,9 @@ public:
     void setGridLineColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a = 255);
     SDL_Color getGridLineColor() const { return gridLineColor_; }
 
+    RenderQualityController& getQualityController() { return qualityController_; }
+    const RenderQualityController& getQualityController() const { return qualityController_; }
+
     bool isUiReady() const;
     static SDL_Color convertToSdlColor(const Color& color);
 };
@@ -3,6 +3,11 @@
 #include <cmath>     // For std::floor, std::ceil, std::round, std::abs
 #include "../utils/logger.h" // New logger
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define WICA_VIEWPORT_SSE2 1
+#include <emmintrin.h>
+#endif
+
 /**
  * @brief Constructor for Viewport.
  * @param screenWidth Window width in pixels.
@@ -15,7 +20,8 @@ Viewport::Viewport(int sw, int sh, float dcs)
       screenWidth_(sw),
       screenHeight_(sh),
       autoFitEnabled_(false),
-      defaultCellSize_(dcs > 0 ? dcs : 10.0f) { // Ensure defaultCellSize is positive
+      defaultCellSize_(dcs > 0 ? dcs : 10.0f), // Ensure defaultCellSize is positive
+      lattice_(Lattice::Square) {
 }
 
 /**
@@ -199,8 +205,8 @@ void Viewport::updateAutoFit(const CellSpace& cellSpace) {
  */
 Point Viewport::screenToWorld(Point screenPos) const {
     PointF worldF = screenToWorldF(screenPos);
-    // Flooring gives the world grid cell coordinate
-    return Point(static_cast<int>(std::floor(worldF.x)), static_cast<int>(std::floor(worldF.y)));
+    // Flooring gives the world grid cell coordinate on the square lattice
+    return latticePick(lattice_, worldF.x, worldF.y);
 }
 
 /**
@@ -231,6 +237,57 @@ Point Viewport::worldToScreen(Point worldPos) const {
     return Point(screenX, screenY);
 }
 
+std::size_t Viewport::worldToScreenBatch(std::span<const Point> world, std::span<SDL_FPoint> screenOut,
+                                         std::span<std::uint32_t> visibleIndexOut,
+                                         int extentX, int extentY, int marginX, int marginY) const {
+    const std::size_t count = std::min({world.size(), screenOut.size(), visibleIndexOut.size()});
+    const float currentCellPxSize = getCurrentCellSize();
+    std::size_t written = 0;
+    std::size_t i = 0;
+
+#ifdef WICA_VIEWPORT_SSE2
+    static_assert(sizeof(Point) == 2 * sizeof(int), "Point must be two packed ints");
+    static_assert(sizeof(SDL_FPoint) == 2 * sizeof(float), "SDL_FPoint must be two packed floats");
+    // Two points per register, kept interleaved (x0 y0 x1 y1) so no shuffles are needed.
+    const __m128 offset = _mm_setr_ps(viewOffset_.x, viewOffset_.y, viewOffset_.x, viewOffset_.y);
+    const __m128 scale = _mm_set1_ps(currentCellPxSize);
+    const __m128i lower = _mm_setr_epi32(-extentX, -extentY, -extentX, -extentY);
+    const __m128i upper = _mm_setr_epi32(screenWidth_ + marginX, screenHeight_ + marginY,
+                                         screenWidth_ + marginX, screenHeight_ + marginY);
+    for (; i + 2 <= count; i += 2) {
+        __m128i coords = _mm_loadu_si128(reinterpret_cast<const __m128i*>(world.data() + i));
+        __m128 pos = _mm_mul_ps(_mm_sub_ps(_mm_cvtepi32_ps(coords), offset), scale);
+        // floor() without SSE4.1: truncate, then subtract one (add the all-ones mask) where truncation rounded up.
+        __m128i truncated = _mm_cvttps_epi32(pos);
+        __m128i roundedUp = _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), pos));
+        __m128i screen = _mm_add_epi32(truncated, roundedUp);
+        __m128i visible = _mm_and_si128(_mm_cmpgt_epi32(screen, lower), _mm_cmplt_epi32(screen, upper));
+        int mask = _mm_movemask_ps(_mm_castsi128_ps(visible));
+        __m128 screenF = _mm_cvtepi32_ps(screen);
+
+        // Branchless compaction: always store, advance only if both coordinates are in range.
+        _mm_storel_pi(reinterpret_cast<__m64*>(screenOut.data() + written), screenF);
+        visibleIndexOut[written] = static_cast<std::uint32_t>(i);
+        written += (mask & 0x3) == 0x3;
+        _mm_storeh_pi(reinterpret_cast<__m64*>(screenOut.data() + written), screenF);
+        visibleIndexOut[written] = static_cast<std::uint32_t>(i + 1);
+        written += (mask & 0xC) == 0xC;
+    }
+#endif
+
+    for (; i < count; ++i) {
+        float screenX = std::floor((static_cast<float>(world[i].x) - viewOffset_.x) * currentCellPxSize);
+        float screenY = std::floor((static_cast<float>(world[i].y) - viewOffset_.y) * currentCellPxSize);
+        if (screenX > static_cast<float>(-extentX) && screenX < static_cast<float>(screenWidth_ + marginX) &&
+            screenY > static_cast<float>(-extentY) && screenY < static_cast<float>(screenHeight_ + marginY)) {
+            screenOut[written] = SDL_FPoint{screenX, screenY};
+            visibleIndexOut[written] = static_cast<std::uint32_t>(i);
+            ++written;
+        }
+    }
+    return written;
+}
+
 float Viewport::getZoomLevel() const {
     return zoomLevel_;
 }
@@ -297,3 +354,11 @@ int Viewport::getScreenHeight() const {
 bool Viewport::isAutoFitEnabled() const {
     return autoFitEnabled_;
 }
+
+void Viewport::setLattice(Lattice lattice) {
+    lattice_ = lattice;
+}
+
+Lattice Viewport::getLattice() const {
+    return lattice_;
+}
@@ -3,7 +3,10 @@
 
 #include "../utils/point.h"
 #include "../ca/cell_space.h" // Required for autoFit functionality
+#include "../utils/lattice.h"
 #include <SDL3/SDL.h>              // For SDL_Rect
+#include <cstdint>
+#include <span>
 
 /**
  * @class Viewport
@@ -32,6 +35,7 @@ private:
     int screenHeight_;      // Height of the rendering window in pixels.
     bool autoFitEnabled_;   // Flag indicating if auto-fit mode is active.
     float defaultCellSize_; // The size of a cell in pixels at zoomLevel_ = 1.0.
+    Lattice lattice_;       // Cell shape used for picking and rendering.
 
 public:
     /**
@@ -91,7 +95,8 @@ public:
     /**
      * @brief Converts screen coordinates (pixels) to world coordinates (integer grid cells).
      * @param screenPos The Point representing screen coordinates.
-     * @return Point The corresponding world coordinates, floored.
+     * @return Point The cell under the position: floored on the square lattice, the
+     * containing hexagon or triangle otherwise.
      */
     Point screenToWorld(Point screenPos) const;
 
@@ -110,6 +115,23 @@ public:
      */
     Point worldToScreen(Point worldPos) const;
 
+    /**
+     * @brief Converts a batch of world coordinates to screen coordinates, keeping only visible ones.
+     *
+     * A point is kept if a cell of extentX x extentY pixels drawn at its screen position overlaps
+     * the screen. Output is compacted: screenOut[i] is the top-left of world[visibleIndexOut[i]].
+     * Results match worldToScreen() exactly; SSE2 is used when available.
+     * @param screenOut Receives the visible screen positions; must hold world.size() elements.
+     * @param visibleIndexOut Receives the indices (into world) of the visible points; same size.
+     * @param marginX, marginY Pixels a cell's shape extends left of / above its position
+     * (hexagon and triangle outlines), so cells just past the right or bottom edge are kept.
+     * @return Number of visible points written.
+     */
+    std::size_t worldToScreenBatch(std::span<const Point> world, std::span<SDL_FPoint> screenOut,
+                                   std::span<std::uint32_t> visibleIndexOut,
+                                   int extentX = 1, int extentY = 1,
+                                   int marginX = 0, int marginY = 0) const;
+
     /**
      * @brief Gets the current zoom level.
      * @return float The zoom level.
@@ -175,6 +197,9 @@ public:
      * @return True if autofit is enabled, false otherwise.
      */
     bool isAutoFitEnabled() const;
+
+    void setLattice(Lattice lattice);
+    Lattice getLattice() const;
 };
 
 #endif // VIEWPORT_H
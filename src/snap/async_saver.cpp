@@ -0,0 +1,79 @@
+#include "async_saver.h"
+#include "snapshot.h"
+#include "../utils/logger.h"
+#include "../utils/task_arenas.h"
+#include <chrono>
+
+AsyncSnapshotSaver::AsyncSnapshotSaver()
+    : stopRequested_(false),
+      pending_(0) {
+}
+
+AsyncSnapshotSaver::~AsyncSnapshotSaver() {
+    stop();
+}
+
+void AsyncSnapshotSaver::enqueue(const std::string& filePath, PersistentWorld::WorldView view, const std::string& ruleId) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        jobs_.push_back(Job{filePath, ruleId, std::move(view)});
+        ++pending_;
+        if (!worker_.joinable()) {
+            stopRequested_ = false;
+            worker_ = std::thread(&AsyncSnapshotSaver::workerLoop, this);
+        }
+    }
+    wake_.notify_one();
+}
+
+std::vector<AsyncSnapshotSaver::Result> AsyncSnapshotSaver::takeResults() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Result> results;
+    results.swap(results_);
+    return results;
+}
+
+void AsyncSnapshotSaver::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!worker_.joinable()) return;
+        stopRequested_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+}
+
+std::size_t AsyncSnapshotSaver::getPendingCount() const {
+    return pending_.load();
+}
+
+void AsyncSnapshotSaver::workerLoop() {
+    auto logger = Logger::getLogger(Logger::Module::Snapshot);
+    SnapshotManager snapshotManager;
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopRequested_ || !jobs_.empty(); });
+            if (jobs_.empty()) return; // Stop requested and everything written
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+        }
+
+        Result result;
+        result.path = job.path;
+        result.generation = job.view.isValid() ? job.view.getVersion().generation : 0;
+        auto start = std::chrono::steady_clock::now();
+        TaskArenas::execute(TaskArenas::Domain::IO, [&] {
+            result.success = snapshotManager.saveView(job.path, job.view, job.ruleId);
+        });
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        job.view.release(); // Lets the simulation reclaim the chunks of this generation
+        if (logger) logger->info("Background save of generation {} to {} {} in {:.3f} s.", result.generation,
+                                 result.path, result.success ? "finished" : "failed", result.seconds);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_.push_back(std::move(result));
+        --pending_;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef ASYNC_SAVER_H
+#define ASYNC_SAVER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ca/persistent_world.h"
+
+/**
+ * @class AsyncSnapshotSaver
+ * @brief Writes snapshots of pinned world versions on a background thread.
+ *
+ * Each job holds a PersistentWorld::WorldView, so the saved world is exactly the generation
+ * that was current when the save was requested, while the simulation keeps stepping.
+ * Results are collected on the main thread with takeResults().
+ */
+class AsyncSnapshotSaver {
+public:
+    struct Result {
+        std::string path;
+        std::uint64_t generation = 0;
+        bool success = false;
+        double seconds = 0.0;
+    };
+
+private:
+    struct Job {
+        std::string path;
+        std::string ruleId;
+        PersistentWorld::WorldView view;
+    };
+
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<Job> jobs_;
+    std::vector<Result> results_;
+    bool stopRequested_;
+    std::atomic<std::size_t> pending_;
+
+    void workerLoop();
+
+public:
+    AsyncSnapshotSaver();
+    ~AsyncSnapshotSaver();
+
+    AsyncSnapshotSaver(const AsyncSnapshotSaver&) = delete;
+    AsyncSnapshotSaver& operator=(const AsyncSnapshotSaver&) = delete;
+
+    /**
+     * @brief Queues a save of the given view; the view stays pinned until the file is written.
+     */
+    void enqueue(const std::string& filePath, PersistentWorld::WorldView view, const std::string& ruleId);
+
+    /**
+     * @brief Returns the saves finished since the previous call.
+     */
+    std::vector<Result> takeResults();
+
+    /**
+     * @brief Finishes the queued saves and joins the thread.
+     */
+    void stop();
+
+    std::size_t getPendingCount() const;
+};
+
+#endif // ASYNC_SAVER_H
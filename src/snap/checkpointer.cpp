@@ -0,0 +1,266 @@
+#include "checkpointer.h"
+#include "snapshot.h"
+#include "snapshot_io.h"
+#include "../utils/logger.h"
+#include "../utils/task_arenas.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <filesystem>
+#include <tuple>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const std::string CHECKPOINT_PREFIX = "checkpoint-";
+    const std::string CHECKPOINT_SUFFIX = ".snapshot";
+    const std::string PARTIAL_PREFIX = ".partial-";     // Written first, renamed when complete
+
+    // Generation encoded in a checkpoint file name, or false for any other file.
+    bool parseCheckpointName(const std::string& name, std::uint64_t& generation) {
+        if (name.size() <= CHECKPOINT_PREFIX.size() + CHECKPOINT_SUFFIX.size() ||
+            name.compare(0, CHECKPOINT_PREFIX.size(), CHECKPOINT_PREFIX) != 0 ||
+            name.compare(name.size() - CHECKPOINT_SUFFIX.size(), CHECKPOINT_SUFFIX.size(), CHECKPOINT_SUFFIX) != 0) {
+            return false;
+        }
+        std::string digits = name.substr(CHECKPOINT_PREFIX.size(), name.size() - CHECKPOINT_PREFIX.size() - CHECKPOINT_SUFFIX.size());
+        if (digits.size() > 20 || !std::all_of(digits.begin(), digits.end(), [](unsigned char c) { return std::isdigit(c); })) {
+            return false;
+        }
+        generation = std::stoull(digits);
+        return true;
+    }
+
+    // Makes a rename durable: the new directory entry is only on disk once the directory is synced.
+    void syncDirectory(const std::filesystem::path& directory) {
+#ifndef _WIN32
+        int fd = ::open(directory.string().c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+        ::fsync(fd);
+        ::close(fd);
+#else
+        (void)directory;
+#endif
+    }
+}
+
+Checkpointer::Checkpointer()
+    : settings_(),
+      lastGeneration_(0),
+      lastTime_(std::chrono::steady_clock::now()),
+      stopRequested_(false),
+      busy_(false) {
+}
+
+Checkpointer::~Checkpointer() {
+    stop();
+}
+
+bool Checkpointer::configure(const Settings& settings, std::uint64_t generation, std::string& error) {
+    if (settings.every == 0) {
+        error = "interval must be positive";
+        return false;
+    }
+    if (settings.keep == 0) {
+        error = "keep must be at least 1";
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::path directory(settings.directory);
+    std::filesystem::create_directories(directory, ec);
+    if (ec || !std::filesystem::is_directory(directory, ec)) {
+        error = "cannot create directory " + settings.directory;
+        return false;
+    }
+    if (!busy_.load()) {
+        // Left behind when the process died mid-write; never valid checkpoints.
+        for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+            std::string name = entry.path().filename().string();
+            if (name.compare(0, PARTIAL_PREFIX.size() + CHECKPOINT_PREFIX.size(), PARTIAL_PREFIX + CHECKPOINT_PREFIX) == 0) {
+                std::error_code removeError;
+                std::filesystem::remove(entry.path(), removeError);
+            }
+        }
+    }
+
+    settings_ = settings;
+    lastGeneration_ = generation;
+    lastTime_ = std::chrono::steady_clock::now();
+    auto logger = Logger::getLogger(Logger::Module::Snapshot);
+    if (logger) logger->info("{}", describe());
+    return true;
+}
+
+void Checkpointer::disable() {
+    settings_.every = 0;
+}
+
+void Checkpointer::setDirectory(const std::string& directory) {
+    settings_.directory = directory;
+}
+
+bool Checkpointer::isDue(std::uint64_t generation) {
+    if (settings_.every == 0 || busy_.load()) return false;
+    if (settings_.unit == Unit::Seconds) {
+        return std::chrono::steady_clock::now() - lastTime_ >= std::chrono::seconds(settings_.every);
+    }
+    if (generation < lastGeneration_) {
+        lastGeneration_ = generation; // World cleared or an older state loaded; count from here
+        return false;
+    }
+    return generation - lastGeneration_ >= settings_.every;
+}
+
+void Checkpointer::request(PersistentWorld::WorldView view, const std::string& ruleId) {
+    lastGeneration_ = view.isValid() ? view.getVersion().generation : lastGeneration_;
+    lastTime_ = std::chrono::steady_clock::now();
+    busy_.store(true);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        job_ = Job{settings_, ruleId, std::move(view)};
+        if (!worker_.joinable()) {
+            stopRequested_ = false;
+            worker_ = std::thread(&Checkpointer::workerLoop, this);
+        }
+    }
+    wake_.notify_one();
+}
+
+std::vector<Checkpointer::Result> Checkpointer::takeResults() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<Result> results;
+    results.swap(results_);
+    return results;
+}
+
+void Checkpointer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!worker_.joinable()) return;
+        stopRequested_ = true;
+    }
+    wake_.notify_one();
+    worker_.join();
+}
+
+std::string Checkpointer::describe() const {
+    if (settings_.every == 0) return "Autosave off.";
+    std::string text = "Autosave every " + std::to_string(settings_.every) +
+                       (settings_.unit == Unit::Seconds ? " seconds" : " generations") + " into " + settings_.directory +
+                       ", keeping " + std::to_string(settings_.keep) + ", ";
+    if (settings_.bytesPerSecond > 0) {
+        char rate[32];
+        std::snprintf(rate, sizeof(rate), "%.1f", static_cast<double>(settings_.bytesPerSecond) / (1 << 20));
+        text += std::string("at most ") + rate + " MiB/s";
+    } else {
+        text += "unlimited bandwidth";
+    }
+    return text + (busy_.load() ? " (writing)." : ".");
+}
+
+std::string Checkpointer::checkpointFileName(std::uint64_t generation) {
+    char digits[32];
+    std::snprintf(digits, sizeof(digits), "%012llu", static_cast<unsigned long long>(generation));
+    return CHECKPOINT_PREFIX + digits + CHECKPOINT_SUFFIX;
+}
+
+std::vector<std::string> Checkpointer::listCheckpoints(const std::string& directory) {
+    std::vector<std::tuple<std::filesystem::file_time_type, std::uint64_t, std::string>> found;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        std::uint64_t generation = 0;
+        if (!entry.is_regular_file(ec) || !parseCheckpointName(entry.path().filename().string(), generation)) continue;
+        found.emplace_back(entry.last_write_time(ec), generation, entry.path().string());
+    }
+    std::sort(found.begin(), found.end(), [](const auto& a, const auto& b) { return a > b; });
+    std::vector<std::string> paths;
+    paths.reserve(found.size());
+    for (const auto& checkpoint : found) paths.push_back(std::get<2>(checkpoint));
+    return paths;
+}
+
+bool Checkpointer::isComplete(const std::string& path) {
+    SnapshotManager snapshotManager;
+    SnapshotInfo info;
+    if (!snapshotManager.readHeader(path, info)) return false;
+    std::error_code ec;
+    std::uint64_t fileSize = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    return std::all_of(info.chunks.begin(), info.chunks.end(), [&](const SnapshotChunk& chunk) {
+        return chunk.offset <= fileSize && chunk.compressedSize <= fileSize - chunk.offset;
+    });
+}
+
+void Checkpointer::workerLoop() {
+    auto logger = Logger::getLogger(Logger::Module::Snapshot);
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [this] { return stopRequested_ || job_.has_value(); });
+            if (!job_) return; // Stop requested and nothing left to write
+            job = std::move(*job_);
+            job_.reset();
+        }
+
+        Result result = write(job);
+        if (logger) {
+            if (result.success) {
+                logger->info("Checkpoint of generation {} written to {} in {:.3f} s; {} old checkpoint(s) removed.",
+                             result.generation, result.path, result.seconds, result.removed);
+            } else {
+                logger->error("Checkpoint of generation {} to {} failed.", result.generation, result.path);
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        results_.push_back(std::move(result));
+        if (!job_) busy_.store(false);
+    }
+}
+
+Checkpointer::Result Checkpointer::write(Job& job) {
+    auto logger = Logger::getLogger(Logger::Module::Snapshot);
+    Result result;
+    result.generation = job.view.isValid() ? job.view.getVersion().generation : 0;
+    std::filesystem::path directory(job.settings.directory);
+    std::string name = checkpointFileName(result.generation);
+    std::filesystem::path finalPath = directory / name;
+    std::filesystem::path partialPath = directory / (PARTIAL_PREFIX + name);
+    result.path = finalPath.string();
+
+    auto start = std::chrono::steady_clock::now();
+    SnapshotIO::WriteOptions options;
+    options.bytesPerSecond = job.settings.bytesPerSecond;
+    options.sync = true;
+    TaskArenas::execute(TaskArenas::Domain::IO, [&] {
+        SnapshotManager snapshotManager;
+        result.success = snapshotManager.saveView(partialPath.string(), job.view, job.ruleId, options);
+    });
+    job.view.release(); // Lets the simulation reclaim the chunks of this generation
+
+    std::error_code ec;
+    if (result.success) {
+        std::filesystem::rename(partialPath, finalPath, ec);
+        if (ec) {
+            if (logger) logger->error("Cannot rename {} to {}: {}", partialPath.string(), result.path, ec.message());
+            result.success = false;
+        } else {
+            syncDirectory(directory);
+        }
+    }
+    if (!result.success) {
+        std::filesystem::remove(partialPath, ec);
+    } else {
+        std::vector<std::string> checkpoints = listCheckpoints(job.settings.directory);
+        for (std::size_t i = job.settings.keep; i < checkpoints.size(); ++i) {
+            if (std::filesystem::remove(checkpoints[i], ec)) ++result.removed;
+        }
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,134 @@
+#ifndef CHECKPOINTER_H
+#define CHECKPOINTER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ca/persistent_world.h"
+
+/**
+ * @class Checkpointer
+ * @brief Periodic crash-safe checkpoints of the 2D world for unattended runs.
+ *
+ * When a checkpoint is due the simulation thread hands over a pinned world version and keeps
+ * stepping; a background thread writes it to a hidden temporary file in the checkpoint
+ * directory, fsyncs it, renames it to checkpoint-<generation>.snapshot and fsyncs the
+ * directory, so a crash at any point leaves either the old set of checkpoints or the new
+ * one, never a torn file under a checkpoint name. Afterwards all but the newest `keep`
+ * checkpoints are deleted. Writes are paced to the configured bandwidth and run in the
+ * low-priority I/O arena. While a checkpoint is still being written no new one is started.
+ */
+class Checkpointer {
+public:
+    enum class Unit {
+        Generations,
+        Seconds
+    };
+
+    struct Settings {
+        std::string directory = "checkpoints";
+        Unit unit = Unit::Generations;
+        std::uint64_t every = 0;            // 0 = autosave off
+        std::size_t keep = 3;               // Checkpoints kept by rotation, at least 1
+        std::uint64_t bytesPerSecond = 0;   // Write bandwidth cap, 0 = unlimited
+    };
+
+    struct Result {
+        std::string path;
+        std::uint64_t generation = 0;
+        bool success = false;
+        double seconds = 0.0;
+        std::size_t removed = 0;            // Old checkpoints deleted by rotation
+    };
+
+    Checkpointer();
+    ~Checkpointer();
+
+    Checkpointer(const Checkpointer&) = delete;
+    Checkpointer& operator=(const Checkpointer&) = delete;
+
+    /**
+     * @brief Applies settings, creates the directory and removes temporary files left by a crash.
+     * @param generation Current generation; the first checkpoint is due one interval after it.
+     * @return False (with error set) if the directory cannot be used; settings are unchanged then.
+     */
+    bool configure(const Settings& settings, std::uint64_t generation, std::string& error);
+
+    /**
+     * @brief Stops scheduling checkpoints; one being written is still finished.
+     */
+    void disable();
+
+    /**
+     * @brief Directory used by the next configure() call that does not name one.
+     */
+    void setDirectory(const std::string& directory);
+
+    const Settings& getSettings() const { return settings_; }
+    bool isEnabled() const { return settings_.every > 0; }
+
+    /**
+     * @brief Whether a checkpoint should be taken now. Cheap; called after every generation.
+     */
+    bool isDue(std::uint64_t generation);
+
+    /**
+     * @brief Queues a checkpoint of view. The view stays pinned until its file is written.
+     */
+    void request(PersistentWorld::WorldView view, const std::string& ruleId);
+
+    /**
+     * @brief Returns the checkpoints finished since the previous call.
+     */
+    std::vector<Result> takeResults();
+
+    /**
+     * @brief Finishes the checkpoint being written and joins the thread.
+     */
+    void stop();
+
+    std::string describe() const;
+
+    static std::string checkpointFileName(std::uint64_t generation);
+
+    /**
+     * @brief Checkpoint files in directory, newest first (by modification time, then generation).
+     */
+    static std::vector<std::string> listCheckpoints(const std::string& directory);
+
+    /**
+     * @brief Cheap validity check: the header parses and every chunk body lies within the file.
+     */
+    static bool isComplete(const std::string& path);
+
+private:
+    struct Job {
+        Settings settings;
+        std::string ruleId;
+        PersistentWorld::WorldView view;
+    };
+
+    void workerLoop();
+    Result write(Job& job);
+
+    Settings settings_;
+    std::uint64_t lastGeneration_;
+    std::chrono::steady_clock::time_point lastTime_;
+
+    std::thread worker_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::optional<Job> job_;
+    std::vector<Result> results_;
+    bool stopRequested_;
+    std::atomic<bool> busy_;            // A job is queued or being written
+};
+
+#endif // CHECKPOINTER_H
@@ -0,0 +1,150 @@
+#include "lazy_snapshot.h"
+#include "../ca/cell_space.h"
+#include "../utils/logger.h"
+
+namespace {
+    std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+        std::int64_t q = value / divisor;
+        return (value % divisor != 0 && value < 0) ? q - 1 : q;
+    }
+}
+
+LazySnapshotLoader::LazySnapshotLoader()
+    : loadedCount_(0),
+      failedCount_(0) {
+}
+
+std::uint64_t LazySnapshotLoader::packChunkKey(std::int32_t chunkX, std::int32_t chunkY) {
+    return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkX)) << 32) |
+           static_cast<std::uint32_t>(chunkY);
+}
+
+bool LazySnapshotLoader::open(const std::string& filePath) {
+    auto logger = Logger::getLogger(Logger::Module::Snapshot);
+    close();
+
+    SnapshotInfo info;
+    if (!decoder_.readHeader(filePath, info)) {
+        if (logger) logger->error("Lazy loading needs a snapshot with a chunk index: " + filePath);
+        return false;
+    }
+    file_.open(filePath, std::ios::binary);
+    if (!file_.is_open()) {
+        if (logger) logger->error("Failed to open snapshot for lazy loading: " + filePath);
+        return false;
+    }
+
+    info_ = std::move(info);
+    path_ = filePath;
+    chunkIndex_.reserve(info_.chunks.size());
+    for (std::size_t i = 0; i < info_.chunks.size(); ++i) {
+        chunkIndex_[packChunkKey(info_.chunks[i].chunkX, info_.chunks[i].chunkY)] = i;
+    }
+    loaded_.assign(info_.chunks.size(), false);
+    loadedCount_ = 0;
+    failedCount_ = 0;
+    if (logger) logger->info("Lazy snapshot opened: {} ({} chunks).", path_, info_.chunks.size());
+    return true;
+}
+
+void LazySnapshotLoader::close() {
+    if (file_.is_open()) file_.close();
+    path_.clear();
+    info_ = SnapshotInfo();
+    chunkIndex_.clear();
+    loaded_.clear();
+    loadedCount_ = 0;
+    failedCount_ = 0;
+}
+
+bool LazySnapshotLoader::isOpen() const {
+    return file_.is_open();
+}
+
+std::size_t LazySnapshotLoader::loadVisible(CellSpace& cellSpace, int x, int y, int width, int height,
+                                            std::size_t maxChunks) {
+    if (!isOpen() || isExhausted() || width <= 0 || height <= 0) return 0;
+
+    const std::int64_t chunkSize = info_.chunkSize;
+    std::int64_t firstX = floorDiv(x, chunkSize);
+    std::int64_t firstY = floorDiv(y, chunkSize);
+    std::int64_t lastX = floorDiv(static_cast<std::int64_t>(x) + width - 1, chunkSize);
+    std::int64_t lastY = floorDiv(static_cast<std::int64_t>(y) + height - 1, chunkSize);
+
+    std::vector<std::size_t> pending;
+    std::uint64_t rangeCount = static_cast<std::uint64_t>(lastX - firstX + 1) * static_cast<std::uint64_t>(lastY - firstY + 1);
+    if (rangeCount <= info_.chunks.size()) {
+        // Zoomed in: probe only the chunk coordinates under the view.
+        for (std::int64_t cy = firstY; cy <= lastY; ++cy) {
+            for (std::int64_t cx = firstX; cx <= lastX; ++cx) {
+                auto it = chunkIndex_.find(packChunkKey(static_cast<std::int32_t>(cx), static_cast<std::int32_t>(cy)));
+                if (it != chunkIndex_.end() && !loaded_[it->second]) pending.push_back(it->second);
+            }
+        }
+    } else {
+        // Zoomed out: the view covers more coordinates than there are chunks, so scan the table.
+        for (std::size_t i = 0; i < info_.chunks.size(); ++i) {
+            const SnapshotChunk& chunk = info_.chunks[i];
+            if (!loaded_[i] && chunk.chunkX >= firstX && chunk.chunkX <= lastX &&
+                chunk.chunkY >= firstY && chunk.chunkY <= lastY) {
+                pending.push_back(i);
+            }
+        }
+    }
+    if (pending.empty()) return 0;
+    if (pending.size() > maxChunks) pending.resize(maxChunks);
+    return decodeChunks(cellSpace, pending);
+}
+
+std::size_t LazySnapshotLoader::loadRemaining(CellSpace& cellSpace) {
+    if (!isOpen()) return 0;
+    std::vector<std::size_t> pending;
+    for (std::size_t i = 0; i < loaded_.size(); ++i) {
+        if (!loaded_[i]) pending.push_back(i);
+    }
+    if (pending.empty()) return 0;
+    return decodeChunks(cellSpace, pending);
+}
+
+std::size_t LazySnapshotLoader::decodeChunks(CellSpace& cellSpace, const std::vector<std::size_t>& pending) {
+    std::unordered_map<Point, int> cells;
+    std::size_t decoded = 0;
+    for (std::size_t index : pending) {
+        loaded_[index] = true; // A corrupt chunk is not retried every frame
+        if (decoder_.decodeChunk(file_, info_.chunks[index], cells)) {
+            ++decoded;
+            ++loadedCount_;
+        } else {
+            ++failedCount_;
+        }
+    }
+    cellSpace.mergeCells(cells);
+
+    auto logger = Logger::getLogger(Logger::Module::Snapshot);
+    if (logger) logger->debug("Lazy load decoded {} chunks ({}/{} loaded, {} failed).", decoded, loadedCount_, loaded_.size(), failedCount_);
+    return decoded;
+}
+
+const SnapshotInfo& LazySnapshotLoader::getInfo() const {
+    return info_;
+}
+
+const std::string& LazySnapshotLoader::getPath() const {
+    return path_;
+}
+
+std::size_t LazySnapshotLoader::getLoadedChunkCount() const {
+    return loadedCount_;
+}
+
+std::size_t LazySnapshotLoader::getFailedChunkCount() const {
+    return failedCount_;
+}
+
+std::size_t LazySnapshotLoader::getTotalChunkCount() const {
+    return info_.chunks.size();
+}
+
+bool LazySnapshotLoader::isExhausted() const {
+    return loadedCount_ + failedCount_ == loaded_.size();
+}
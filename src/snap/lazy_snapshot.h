@@ -0,0 +1,75 @@
+#ifndef LAZY_SNAPSHOT_H
+#define LAZY_SNAPSHOT_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "snapshot.h"
+
+class CellSpace;
+
+/**
+ * @class LazySnapshotLoader
+ * @brief Streams the chunks of a headered snapshot into a CellSpace as they become visible.
+ *
+ * Opening only reads the header and chunk table. Each call to loadVisible() decodes the
+ * not-yet-loaded chunks intersecting the given world rectangle, up to a per-call budget,
+ * so a very large checkpoint can be inspected without decoding it entirely.
+ */
+class LazySnapshotLoader {
+private:
+    SnapshotManager decoder_;
+    std::ifstream file_;
+    std::string path_;
+    SnapshotInfo info_;
+    std::unordered_map<std::uint64_t, std::size_t> chunkIndex_; // Packed chunk coords -> table index
+    std::vector<bool> loaded_;                                  // Decoded or failed; failed chunks are not retried
+    std::size_t loadedCount_;                                   // Chunks decoded successfully
+    std::size_t failedCount_;                                   // Chunks that could not be decoded
+
+    static std::uint64_t packChunkKey(std::int32_t chunkX, std::int32_t chunkY);
+    std::size_t decodeChunks(CellSpace& cellSpace, const std::vector<std::size_t>& pending);
+
+public:
+    LazySnapshotLoader();
+
+    LazySnapshotLoader(const LazySnapshotLoader&) = delete;
+    LazySnapshotLoader& operator=(const LazySnapshotLoader&) = delete;
+
+    /**
+     * @brief Reads the header of a snapshot and prepares on-demand loading.
+     * @return False for unreadable or legacy (headerless) files. Errors are logged.
+     */
+    bool open(const std::string& filePath);
+    void close();
+    bool isOpen() const;
+
+    /**
+     * @brief Decodes missing chunks intersecting the world rectangle and merges them into cellSpace.
+     * @param maxChunks Decode budget for this call; remaining chunks are picked up by later calls.
+     * @return Number of chunks decoded.
+     */
+    std::size_t loadVisible(CellSpace& cellSpace, int x, int y, int width, int height, std::size_t maxChunks);
+
+    /**
+     * @brief Decodes every chunk not tried yet, wherever it lies, and merges it into cellSpace.
+     * @return Number of chunks decoded; see getFailedChunkCount() for the ones that could not be.
+     */
+    std::size_t loadRemaining(CellSpace& cellSpace);
+
+    const SnapshotInfo& getInfo() const;
+    const std::string& getPath() const;
+    std::size_t getLoadedChunkCount() const;
+    std::size_t getFailedChunkCount() const;
+    std::size_t getTotalChunkCount() const;
+
+    /**
+     * @brief Whether every chunk has been tried, successfully or not.
+     */
+    bool isExhausted() const;
+};
+
+#endif // LAZY_SNAPSHOT_H
@@ -0,0 +1,536 @@
+#include "npy_io.h"
+#include "../utils/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <new>
+
+#include <tbb/parallel_for.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static_assert(std::endian::native == std::endian::little, "uint16 arrays are copied as little-endian '<u2'");
+
+namespace {
+    constexpr char MAGIC[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+    constexpr int CHUNK_SIZE = PersistentWorld::CHUNK_SIZE;
+
+    std::int64_t floorDiv(std::int64_t value, std::int64_t divisor) {
+        std::int64_t q = value / divisor;
+        return (value % divisor != 0 && value < 0) ? q - 1 : q;
+    }
+
+    /**
+     * @brief Byte buffer backed by a file: memory-mapped for large files, staged in memory otherwise.
+     */
+    class FileBuffer {
+    private:
+        std::string path_;
+        std::vector<std::uint8_t> staged_;
+        std::uint8_t* mapping_ = nullptr;
+        std::size_t size_ = 0;
+        int fd_ = -1;
+        bool writing_ = false;
+
+        void unmap() {
+#ifndef _WIN32
+            if (mapping_) munmap(mapping_, size_);
+            if (fd_ >= 0) ::close(fd_);
+#endif
+            mapping_ = nullptr;
+            fd_ = -1;
+        }
+
+        // Drops a file create() could not set up, so no truncated array is left behind.
+        void discard() {
+            unmap();
+            std::error_code ec;
+            std::filesystem::remove(path_, ec);
+        }
+
+    public:
+        FileBuffer() = default;
+        FileBuffer(const FileBuffer&) = delete;
+        FileBuffer& operator=(const FileBuffer&) = delete;
+        ~FileBuffer() { unmap(); }
+
+        std::uint8_t* data() { return mapping_ ? mapping_ : staged_.data(); }
+        std::size_t size() const { return size_; }
+
+        // Creates (truncates) path with size zero bytes; the contents are written by commit().
+        bool create(const std::string& path, std::size_t size) {
+            auto logger = Logger::getLogger(Logger::Module::FileIO);
+            path_ = path;
+            size_ = size;
+            writing_ = true;
+            bool created = false;
+#ifndef _WIN32
+            if (size >= NpyIO::MAPPING_THRESHOLD) {
+                fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (fd_ < 0) {
+                    if (logger) logger->error("Cannot create '{}': {}", path, std::strerror(errno));
+                    return false;
+                }
+                if (ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+                    if (logger) logger->error("Cannot size '{}' to {} bytes: {}", path, size, std::strerror(errno));
+                    discard();
+                    return false;
+                }
+                // A store into a page the file system cannot back raises SIGBUS, so the blocks are
+                // reserved up front; they read as zeros, so default-state regions still cost no I/O.
+                int reserved = posix_fallocate(fd_, 0, static_cast<off_t>(size));
+                if (reserved == 0) {
+                    void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+                    if (mapping == MAP_FAILED) {
+                        if (logger) logger->error("mmap failed for '{}': {}", path, std::strerror(errno));
+                        discard();
+                        return false;
+                    }
+                    mapping_ = static_cast<std::uint8_t*>(mapping);
+                    return true;
+                }
+                if (reserved != EOPNOTSUPP && reserved != EINVAL) {
+                    // Typically ENOSPC: staging the array in memory would only fail later, at the write.
+                    if (logger) logger->error("Cannot reserve {} bytes for '{}': {}", size, path, std::strerror(reserved));
+                    discard();
+                    return false;
+                }
+                // The file system cannot reserve space; write the array from memory instead.
+                if (logger) logger->warn("Cannot reserve space for '{}': {}; writing it from memory.", path, std::strerror(reserved));
+                unmap();
+                created = true;
+            }
+#endif
+            try {
+                staged_.assign(size, 0);
+            } catch (const std::bad_alloc&) {
+                if (logger) logger->error("Not enough memory to stage {} bytes for '{}'.", size, path);
+                if (created) discard();
+                return false;
+            }
+            return true;
+        }
+
+        bool open(const std::string& path) {
+            auto logger = Logger::getLogger(Logger::Module::FileIO);
+            path_ = path;
+            writing_ = false;
+            std::error_code ec;
+            std::uintmax_t fileSize = std::filesystem::file_size(path, ec);
+            if (ec) {
+                if (logger) logger->error("Cannot open '{}': {}", path, ec.message());
+                return false;
+            }
+            size_ = static_cast<std::size_t>(fileSize);
+#ifndef _WIN32
+            if (size_ >= NpyIO::MAPPING_THRESHOLD) {
+                fd_ = ::open(path.c_str(), O_RDONLY);
+                if (fd_ < 0) {
+                    if (logger) logger->error("Cannot open '{}': {}", path, std::strerror(errno));
+                    return false;
+                }
+                void* mapping = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+                if (mapping == MAP_FAILED) {
+                    if (logger) logger->error("mmap failed for '{}': {}", path, std::strerror(errno));
+                    unmap();
+                    return false;
+                }
+                // Chunk rows are consumed top to bottom.
+                madvise(mapping, size_, MADV_SEQUENTIAL);
+                mapping_ = static_cast<std::uint8_t*>(mapping);
+                return true;
+            }
+#endif
+            std::ifstream file(path, std::ios::binary);
+            staged_.resize(size_);
+            if (!file.read(reinterpret_cast<char*>(staged_.data()), static_cast<std::streamsize>(size_))) {
+                if (logger) logger->error("Failed to read '{}'.", path);
+                return false;
+            }
+            return true;
+        }
+
+        // Makes written data durable in the file: unmaps, or writes the staged bytes.
+        bool commit() {
+            auto logger = Logger::getLogger(Logger::Module::FileIO);
+            if (!writing_) return true;
+#ifndef _WIN32
+            if (mapping_) {
+                // Write-back errors surface here rather than as a fault in the export loop.
+                bool ok = true;
+                if (msync(mapping_, size_, MS_SYNC) != 0) {
+                    if (logger) logger->error("Failed to write '{}': msync: {}", path_, std::strerror(errno));
+                    ok = false;
+                }
+                if (munmap(mapping_, size_) != 0 && ok) {
+                    if (logger) logger->error("Failed to write '{}': munmap: {}", path_, std::strerror(errno));
+                    ok = false;
+                }
+                mapping_ = nullptr;
+                if (::close(fd_) != 0 && ok) {
+                    if (logger) logger->error("Failed to write '{}': close: {}", path_, std::strerror(errno));
+                    ok = false;
+                }
+                fd_ = -1;
+                return ok;
+            }
+#endif
+            std::ofstream file(path_, std::ios::binary | std::ios::trunc);
+            if (!file.write(reinterpret_cast<const char*>(staged_.data()), static_cast<std::streamsize>(size_))) {
+                if (logger) logger->error("Failed to write '{}'.", path_);
+                return false;
+            }
+            return true;
+        }
+    };
+
+    // Narrowing row copy. Returns the bits of values that do not fit T, so the loop stays branch-free.
+    template <typename T>
+    unsigned convertRow(const int* __restrict source, T* __restrict target, std::int64_t count) {
+        unsigned overflow = 0;
+        for (std::int64_t i = 0; i < count; ++i) {
+            target[i] = static_cast<T>(source[i]);
+            overflow |= static_cast<unsigned>(source[i]) >> (8 * sizeof(T));
+        }
+        return overflow;
+    }
+
+    template <typename T>
+    bool writeChunks(std::uint8_t* data, const std::vector<const PersistentWorld::Chunk*>& chunks,
+                     std::int64_t x, std::int64_t y, std::int64_t width, std::int64_t height) {
+        T* array = reinterpret_cast<T*>(data);
+        std::atomic<bool> overflow{false};
+        tbb::parallel_for(std::size_t(0), chunks.size(), [&](std::size_t i) {
+            const PersistentWorld::Chunk& chunk = *chunks[i];
+            std::int64_t originX = static_cast<std::int64_t>(chunk.chunkX) * CHUNK_SIZE;
+            std::int64_t originY = static_cast<std::int64_t>(chunk.chunkY) * CHUNK_SIZE;
+            std::int64_t left = std::max(x, originX);
+            std::int64_t right = std::min(x + width, originX + CHUNK_SIZE);
+            std::int64_t top = std::max(y, originY);
+            std::int64_t bottom = std::min(y + height, originY + CHUNK_SIZE);
+            unsigned bits = 0;
+            for (std::int64_t row = top; row < bottom; ++row) {
+                const int* source = chunk.states + (row - originY) * CHUNK_SIZE + (left - originX);
+                T* target = array + (row - y) * width + (left - x);
+                bits |= convertRow(source, target, right - left);
+            }
+            if (bits) overflow.store(true, std::memory_order_relaxed);
+        });
+        return !overflow.load();
+    }
+
+    struct ImportBand {
+        std::vector<std::pair<Point, int>> changes;
+        bool invalid = false;
+        int invalidValue = 0;
+        Point invalidCell;
+    };
+
+    // Compares one band of CHUNK_SIZE array rows (aligned to world chunks) with the current world.
+    template <typename T>
+    void importBand(const T* array, const PersistentWorld::WorldView& view, std::int64_t x, std::int64_t y,
+                    std::int64_t width, std::int64_t top, std::int64_t bottom,
+                    const std::vector<std::uint8_t>& valid, ImportBand& band) {
+        const int defaultState = view.getVersion().defaultState;
+        std::int64_t chunkY = floorDiv(top, CHUNK_SIZE);
+        std::int64_t firstChunkX = floorDiv(x, CHUNK_SIZE);
+        std::int64_t lastChunkX = floorDiv(x + width - 1, CHUNK_SIZE);
+        for (std::int64_t chunkX = firstChunkX; chunkX <= lastChunkX; ++chunkX) {
+            const PersistentWorld::Chunk* chunk = view.findChunk(static_cast<std::int32_t>(chunkX), static_cast<std::int32_t>(chunkY));
+            std::int64_t originX = chunkX * CHUNK_SIZE;
+            std::int64_t left = std::max(x, originX);
+            std::int64_t right = std::min(x + width, originX + CHUNK_SIZE);
+            for (std::int64_t row = top; row < bottom; ++row) {
+                const T* source = array + (row - y) * width + (left - x);
+                const int* current = chunk ? chunk->states + (row - chunkY * CHUNK_SIZE) * CHUNK_SIZE + (left - originX) : nullptr;
+                for (std::int64_t i = 0; i < right - left; ++i) {
+                    int value = source[i];
+                    if (!valid[value]) {
+                        band.invalid = true;
+                        band.invalidValue = value;
+                        band.invalidCell = Point(static_cast<int>(left + i), static_cast<int>(row));
+                        return;
+                    }
+                    if (value != (current ? current[i] : defaultState)) {
+                        band.changes.emplace_back(Point(static_cast<int>(left + i), static_cast<int>(row)), value);
+                    }
+                }
+            }
+        }
+    }
+
+    // Position just after "'key':" (or "\"key\":") in a header dictionary, or npos.
+    std::size_t findValue(const std::string& dictionary, const std::string& key) {
+        for (const char quote : {'\'', '"'}) {
+            std::string pattern = std::string(1, quote) + key + quote;
+            std::size_t position = dictionary.find(pattern);
+            if (position == std::string::npos) continue;
+            position = dictionary.find(':', position + pattern.size());
+            if (position == std::string::npos) return position;
+            return dictionary.find_first_not_of(' ', position + 1);
+        }
+        return std::string::npos;
+    }
+}
+
+namespace NpyIO {
+
+    std::size_t itemSize(DType dtype) {
+        return dtype == DType::UInt16 ? 2 : 1;
+    }
+
+    const char* dtypeName(DType dtype) {
+        return dtype == DType::UInt16 ? "uint16" : "uint8";
+    }
+
+    bool chooseDType(const std::vector<int>& states, DType& dtype) {
+        if (states.empty()) return false;
+        auto [minState, maxState] = std::minmax_element(states.begin(), states.end());
+        if (*minState < 0 || *maxState > std::numeric_limits<std::uint16_t>::max()) return false;
+        dtype = *maxState <= std::numeric_limits<std::uint8_t>::max() ? DType::UInt8 : DType::UInt16;
+        return true;
+    }
+
+    std::string buildHeader(DType dtype, std::int64_t width, std::int64_t height) {
+        std::string dictionary = std::string("{'descr': '") + (dtype == DType::UInt16 ? "<u2" : "|u1") +
+                                 "', 'fortran_order': False, 'shape': (" + std::to_string(height) + ", " +
+                                 std::to_string(width) + "), }";
+        // magic (6) + version (2) + length (2) + dictionary, padded with spaces and ended by '\n'.
+        std::size_t unpadded = 10 + dictionary.size() + 1;
+        std::size_t total = (unpadded + HEADER_ALIGNMENT - 1) / HEADER_ALIGNMENT * HEADER_ALIGNMENT;
+        dictionary.append(total - unpadded, ' ');
+        dictionary.push_back('\n');
+
+        std::uint16_t length = static_cast<std::uint16_t>(dictionary.size());
+        std::string header(MAGIC, sizeof(MAGIC));
+        header.push_back('\x01');
+        header.push_back('\x00');
+        header.push_back(static_cast<char>(length & 0xFF));
+        header.push_back(static_cast<char>(length >> 8));
+        return header + dictionary;
+    }
+
+    bool parseHeader(const std::uint8_t* data, std::size_t size, ArrayHeader& header, std::string& error) {
+        if (size < 10 || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+            error = "not a .npy file";
+            return false;
+        }
+        std::uint8_t major = data[6];
+        std::size_t dictionaryLength = 0;
+        std::size_t dictionaryStart = 0;
+        if (major == 1) {
+            dictionaryLength = data[8] | (static_cast<std::size_t>(data[9]) << 8);
+            dictionaryStart = 10;
+        } else if ((major == 2 || major == 3) && size >= 12) {
+            dictionaryLength = 0;
+            for (int i = 3; i >= 0; --i) dictionaryLength = (dictionaryLength << 8) | data[8 + i];
+            dictionaryStart = 12;
+        } else {
+            error = "unsupported .npy version " + std::to_string(major);
+            return false;
+        }
+        if (dictionaryStart + dictionaryLength > size) {
+            error = "truncated header";
+            return false;
+        }
+        std::string dictionary(reinterpret_cast<const char*>(data + dictionaryStart), dictionaryLength);
+
+        std::size_t descr = findValue(dictionary, "descr");
+        std::size_t order = findValue(dictionary, "fortran_order");
+        std::size_t shape = findValue(dictionary, "shape");
+        if (descr == std::string::npos || order == std::string::npos || shape == std::string::npos) {
+            error = "malformed header";
+            return false;
+        }
+
+        std::size_t descrEnd = dictionary.find(dictionary[descr], descr + 1);
+        std::string type = descrEnd == std::string::npos ? "" : dictionary.substr(descr + 1, descrEnd - descr - 1);
+        if (type == "|u1" || type == "<u1" || type == "u1" || type == "|b1") {
+            header.dtype = DType::UInt8;
+        } else if (type == "<u2") {
+            header.dtype = DType::UInt16;
+        } else {
+            error = "unsupported dtype '" + type + "' (expected uint8, bool or little-endian uint16)";
+            return false;
+        }
+
+        if (dictionary.compare(order, 5, "False") != 0) {
+            error = "Fortran-ordered arrays are not supported";
+            return false;
+        }
+
+        std::vector<std::int64_t> dimensions;
+        std::size_t position = shape + 1;
+        std::size_t shapeEnd = dictionary.find(')', position);
+        if (dictionary[shape] != '(' || shapeEnd == std::string::npos) {
+            error = "malformed shape";
+            return false;
+        }
+        while (position < shapeEnd) {
+            std::size_t digits = dictionary.find_first_of("0123456789", position);
+            if (digits == std::string::npos || digits >= shapeEnd) break;
+            std::size_t end = dictionary.find_first_not_of("0123456789", digits);
+            dimensions.push_back(std::stoll(dictionary.substr(digits, end - digits)));
+            position = end;
+        }
+        if (dimensions.size() != 2) {
+            error = "expected a 2D array, got " + std::to_string(dimensions.size()) + " dimensions";
+            return false;
+        }
+        header.height = dimensions[0];
+        header.width = dimensions[1];
+        header.dataOffset = dictionaryStart + dictionaryLength;
+
+        std::uint64_t elements = static_cast<std::uint64_t>(header.width) * static_cast<std::uint64_t>(header.height);
+        if (header.width != 0 && elements / static_cast<std::uint64_t>(header.width) != static_cast<std::uint64_t>(header.height)) {
+            error = "array too large";
+            return false;
+        }
+        if (elements > (size - header.dataOffset) / itemSize(header.dtype)) {
+            error = "file is shorter than its shape";
+            return false;
+        }
+        return true;
+    }
+
+    bool exportRegion(const std::string& filePath, const PersistentWorld::WorldView& view,
+                      int x, int y, int width, int height, DType dtype) {
+        auto logger = Logger::getLogger(Logger::Module::FileIO);
+        if (!view.isValid() || width <= 0 || height <= 0) {
+            if (logger) logger->error("Invalid region for .npy export.");
+            return false;
+        }
+        const std::int64_t x64 = x, y64 = y, w64 = width, h64 = height;
+        const std::string header = buildHeader(dtype, w64, h64);
+        const std::size_t item = itemSize(dtype);
+
+        FileBuffer file;
+        if (!file.create(filePath, header.size() + static_cast<std::size_t>(w64 * h64) * item)) return false;
+        std::memcpy(file.data(), header.data(), header.size());
+        std::uint8_t* data = file.data() + header.size();
+
+        const int defaultState = view.getVersion().defaultState;
+        if (defaultState != 0) {
+            if (dtype == DType::UInt16) {
+                std::uint16_t* array = reinterpret_cast<std::uint16_t*>(data);
+                std::fill(array, array + w64 * h64, static_cast<std::uint16_t>(defaultState));
+            } else {
+                std::memset(data, defaultState, static_cast<std::size_t>(w64 * h64));
+            }
+        }
+
+        // Look chunks up by coordinate when the region is small, otherwise filter all chunks.
+        std::int64_t firstChunkX = floorDiv(x64, CHUNK_SIZE), lastChunkX = floorDiv(x64 + w64 - 1, CHUNK_SIZE);
+        std::int64_t firstChunkY = floorDiv(y64, CHUNK_SIZE), lastChunkY = floorDiv(y64 + h64 - 1, CHUNK_SIZE);
+        std::uint64_t regionChunks = static_cast<std::uint64_t>(lastChunkX - firstChunkX + 1) *
+                                     static_cast<std::uint64_t>(lastChunkY - firstChunkY + 1);
+        std::vector<const PersistentWorld::Chunk*> chunks;
+        if (regionChunks <= view.getVersion().chunkCount) {
+            for (std::int64_t chunkY = firstChunkY; chunkY <= lastChunkY; ++chunkY) {
+                for (std::int64_t chunkX = firstChunkX; chunkX <= lastChunkX; ++chunkX) {
+                    const PersistentWorld::Chunk* chunk = view.findChunk(static_cast<std::int32_t>(chunkX), static_cast<std::int32_t>(chunkY));
+                    if (chunk) chunks.push_back(chunk);
+                }
+            }
+        } else {
+            view.forEachChunk([&](const PersistentWorld::Chunk& chunk) {
+                if (chunk.chunkX >= firstChunkX && chunk.chunkX <= lastChunkX &&
+                    chunk.chunkY >= firstChunkY && chunk.chunkY <= lastChunkY) {
+                    chunks.push_back(&chunk);
+                }
+            });
+        }
+
+        bool fits = dtype == DType::UInt16 ? writeChunks<std::uint16_t>(data, chunks, x64, y64, w64, h64)
+                                           : writeChunks<std::uint8_t>(data, chunks, x64, y64, w64, h64);
+        if (!fits) {
+            if (logger) logger->error("Region contains states that do not fit {}; export aborted.", dtypeName(dtype));
+            std::error_code ec;
+            std::filesystem::remove(filePath, ec);
+            return false;
+        }
+        if (!file.commit()) {
+            std::error_code ec;
+            std::filesystem::remove(filePath, ec);
+            return false;
+        }
+        if (logger) logger->info("Exported {}x{} {} region at ({}, {}) to '{}' ({} chunks copied).",
+                                 width, height, dtypeName(dtype), x, y, filePath, chunks.size());
+        return true;
+    }
+
+    bool importArray(const std::string& filePath, const PersistentWorld::WorldView& view, int x, int y,
+                     const std::vector<int>& validStates, std::unordered_map<Point, int>& changes,
+                     ArrayHeader* headerOut) {
+        auto logger = Logger::getLogger(Logger::Module::FileIO);
+        if (!view.isValid()) return false;
+        FileBuffer file;
+        if (!file.open(filePath)) return false;
+
+        ArrayHeader header;
+        std::string error;
+        if (!parseHeader(file.data(), file.size(), header, error)) {
+            if (logger) logger->error("Cannot import '{}': {}.", filePath, error);
+            return false;
+        }
+        if (header.width == 0 || header.height == 0) {
+            if (headerOut) *headerOut = header;
+            return true;
+        }
+        const std::int64_t x64 = x, y64 = y;
+        if (x64 + header.width - 1 > std::numeric_limits<int>::max() || y64 + header.height - 1 > std::numeric_limits<int>::max()) {
+            if (logger) logger->error("Cannot import '{}': a {}x{} array at ({}, {}) leaves the coordinate range.",
+                                      filePath, header.width, header.height, x, y);
+            return false;
+        }
+
+        std::vector<std::uint8_t> valid(header.dtype == DType::UInt16 ? 65536 : 256, 0);
+        for (int state : validStates) {
+            if (state >= 0 && static_cast<std::size_t>(state) < valid.size()) valid[state] = 1;
+        }
+
+        // One band per row of world chunks; bands are compared in parallel and merged afterwards.
+        std::int64_t firstChunkY = floorDiv(y64, CHUNK_SIZE);
+        std::int64_t lastChunkY = floorDiv(y64 + header.height - 1, CHUNK_SIZE);
+        std::vector<ImportBand> bands(static_cast<std::size_t>(lastChunkY - firstChunkY + 1));
+        const std::uint8_t* array = file.data() + header.dataOffset;
+        tbb::parallel_for(std::size_t(0), bands.size(), [&](std::size_t i) {
+            std::int64_t top = std::max(y64, (firstChunkY + static_cast<std::int64_t>(i)) * CHUNK_SIZE);
+            std::int64_t bottom = std::min(y64 + header.height, (firstChunkY + static_cast<std::int64_t>(i) + 1) * CHUNK_SIZE);
+            if (header.dtype == DType::UInt16) {
+                importBand(reinterpret_cast<const std::uint16_t*>(array), view, x64, y64, header.width, top, bottom, valid, bands[i]);
+            } else {
+                importBand(array, view, x64, y64, header.width, top, bottom, valid, bands[i]);
+            }
+        });
+
+        for (const ImportBand& band : bands) {
+            if (band.invalid) {
+                if (logger) logger->error("Cannot import '{}': value {} at cell ({}, {}) is not a state of the rule.",
+                                          filePath, band.invalidValue, band.invalidCell.x, band.invalidCell.y);
+                return false;
+            }
+        }
+        std::size_t total = 0;
+        for (const ImportBand& band : bands) total += band.changes.size();
+        changes.reserve(changes.size() + total);
+        for (const ImportBand& band : bands) {
+            for (const auto& change : band.changes) changes[change.first] = change.second;
+        }
+        if (headerOut) *headerOut = header;
+        if (logger) logger->info("Imported {}x{} {} array from '{}' at ({}, {}): {} cells changed.",
+                                 header.width, header.height, dtypeName(header.dtype), filePath, x, y, total);
+        return true;
+    }
+
+} // namespace NpyIO
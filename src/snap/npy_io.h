@@ -0,0 +1,84 @@
+#ifndef NPY_IO_H
+#define NPY_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../ca/persistent_world.h"
+#include "../utils/point.h"
+
+/**
+ * @namespace NpyIO
+ * @brief Dense export and import of world regions as NumPy .npy arrays.
+ *
+ * Files are version 1.0 .npy arrays of shape (height, width) in C order, holding uint8 or
+ * uint16 states, so `np.load(path, mmap_mode='r')` maps them without parsing. The header is
+ * padded to 64 bytes so the data is aligned. Both directions work chunk by chunk against a
+ * published PersistentWorld version: every 32x32 chunk intersecting the region is converted
+ * row by row as a block copy, and chunks that only hold the default state are never visited.
+ * Files of MAPPING_THRESHOLD bytes or more are accessed through a memory mapping (on POSIX),
+ * so multi-gigabyte regions are written and read without staging them in memory. The disk
+ * space of an export is reserved before it is mapped, so a full disk fails the export cleanly;
+ * only on file systems that cannot reserve space is the array staged in memory instead.
+ */
+namespace NpyIO {
+
+    enum class DType {
+        UInt8,
+        UInt16
+    };
+
+    constexpr std::size_t HEADER_ALIGNMENT = 64;
+    constexpr std::size_t MAPPING_THRESHOLD = std::size_t(1) << 20;
+
+    struct ArrayHeader {
+        DType dtype = DType::UInt8;
+        std::int64_t width = 0;       // Second axis
+        std::int64_t height = 0;      // First axis
+        std::size_t dataOffset = 0;   // Byte offset of element (0, 0)
+    };
+
+    std::size_t itemSize(DType dtype);
+    const char* dtypeName(DType dtype);
+
+    /**
+     * @brief Smallest dtype holding every state, or false if a state is negative or above 65535.
+     */
+    bool chooseDType(const std::vector<int>& states, DType& dtype);
+
+    /**
+     * @brief Magic, version and the padded header dictionary for an array of the given shape.
+     */
+    std::string buildHeader(DType dtype, std::int64_t width, std::int64_t height);
+
+    /**
+     * @brief Parses the header of a .npy file. Accepts 2D C-order arrays of bool, uint8 and
+     * little-endian uint16.
+     * @return False (with a reason in error) for anything else.
+     */
+    bool parseHeader(const std::uint8_t* data, std::size_t size, ArrayHeader& header, std::string& error);
+
+    /**
+     * @brief Writes the width x height region with top-left cell (x, y) of view to filePath.
+     * Every state in the region must fit dtype.
+     */
+    bool exportRegion(const std::string& filePath, const PersistentWorld::WorldView& view,
+                      int x, int y, int width, int height, DType dtype);
+
+    /**
+     * @brief Reads an array and places its element (0, 0) at cell (x, y).
+     *
+     * Fills changes with the cells whose state differs from view, which must be the current
+     * state of the world. Fails without touching changes if a value is not in validStates.
+     * @param header Receives the parsed header; may be nullptr.
+     */
+    bool importArray(const std::string& filePath, const PersistentWorld::WorldView& view, int x, int y,
+                     const std::vector<int>& validStates, std::unordered_map<Point, int>& changes,
+                     ArrayHeader* header = nullptr);
+
+} // namespace NpyIO
+
+#endif // NPY_IO_H
@@ -4,11 +4,53 @@
 #include <string>
 #include <vector>
 #include <cstdint> // For uint types
+#include <fstream>
+#include <functional>
+#include <unordered_map>
+
+#include "../ca/persistent_world.h"
+#include "snapshot_io.h"
+#include "../utils/point.h"
 
 // Forward declarations
 class CellSpace; // Manages the grid data to be saved/loaded
+class VoxelSpace; // 3D worlds
+class ReactionDiffusionField; // Float fields
 namespace HuffmanCoding { } // Namespace for compression utilities
 
+/**
+ * @struct SnapshotChunk
+ * @brief Entry of the chunk offset table: where one CHUNK_SIZE x CHUNK_SIZE tile is stored.
+ */
+struct SnapshotChunk {
+    std::int32_t chunkX = 0;          // Chunk coordinates (world coordinate floor-divided by chunk size)
+    std::int32_t chunkY = 0;
+    std::uint32_t cellCount = 0;
+    std::uint64_t offset = 0;         // Absolute file offset of the compressed body
+    std::uint64_t compressedSize = 0;
+};
+
+/**
+ * @struct SnapshotInfo
+ * @brief Everything stored in a snapshot header. Reading it never decodes cell data.
+ */
+struct SnapshotInfo {
+    bool legacy = false;              // Headerless file written before the header was introduced
+    std::uint32_t version = 0;
+    std::string ruleId;               // Rule file name the snapshot was taken with
+    std::uint64_t generation = 0;
+    std::uint64_t population = 0;
+    bool boundsValid = false;
+    Point minBounds;
+    Point maxBounds;
+    std::int32_t defaultState = 0;
+    std::int32_t chunkSize = 0;
+    int thumbnailWidth = 0;
+    int thumbnailHeight = 0;
+    std::vector<std::uint8_t> thumbnail; // Row-major density, 0 = empty, 255 = full
+    std::vector<SnapshotChunk> chunks;
+};
+
 /**
  * @class SnapshotManager
  * @brief Handles saving and loading of the cell space state to/from custom binary snapshot files.
@@ -25,15 +67,29 @@ public:
      */
     SnapshotManager();
 
+    static constexpr std::int32_t CHUNK_SIZE = 256;      // Cells per chunk side
+    static constexpr int THUMBNAIL_MAX_SIZE = 64;        // Longest thumbnail side in pixels
+
     /**
      * @brief Saves the current state of the given CellSpace to a specified file.
      * The data is serialized, compressed using Huffman coding, and then written.
      * @param filePath The path to the file where the snapshot will be saved.
      * The extension ".snapshot" will be appended if not present.
      * @param cellSpace A constant reference to the CellSpace whose state is to be saved.
+     * @param ruleId Rule identifier recorded in the header (e.g. the rule file name).
+     * @param generation Generation number recorded in the header.
      * @return True if saving was successful, false otherwise. Errors are logged.
      */
-    bool saveState(const std::string& filePath, const CellSpace& cellSpace);
+    bool saveState(const std::string& filePath, const CellSpace& cellSpace,
+                   const std::string& ruleId = "", std::uint64_t generation = 0);
+
+    /**
+     * @brief Saves a published world version in the same format as saveState().
+     * Safe to call from another thread while the simulation keeps running: the view is immutable.
+     * @param options Bandwidth cap and fsync for the write, e.g. for background checkpoints.
+     */
+    bool saveView(const std::string& filePath, const PersistentWorld::WorldView& view, const std::string& ruleId = "",
+                  const SnapshotIO::WriteOptions& options = SnapshotIO::WriteOptions());
 
     /**
      * @brief Loads a cell space state from a specified snapshot file into the given CellSpace.
@@ -42,11 +98,95 @@ public:
      * @param filePath The path to the snapshot file to load.
      * @param cellSpace A reference to the CellSpace object that will be populated with the loaded state.
      * Any existing state in cellSpace will be cleared.
+     * @param info Optional; receives the header (legacy files only fill bounds and population).
      * @return True if loading was successful, false otherwise. Errors are logged.
      */
-    bool loadState(const std::string& filePath, CellSpace& cellSpace);
+    bool loadState(const std::string& filePath, CellSpace& cellSpace, SnapshotInfo* info = nullptr);
+
+    /**
+     * @brief Reads only the header and chunk table of a snapshot.
+     * @return False for unreadable files and for legacy files (info.legacy is set for the latter).
+     */
+    bool readHeader(const std::string& filePath, SnapshotInfo& info) const;
+
+    /**
+     * @brief Loads the cells inside a world rectangle. Only the chunks intersecting it are decoded;
+     * legacy files are decoded fully. Either way cells outside the rectangle are dropped.
+     * @return True on success. cellSpace is replaced by the loaded cells.
+     */
+    bool loadRegion(const std::string& filePath, CellSpace& cellSpace,
+                    int x, int y, int width, int height, SnapshotInfo* info = nullptr);
+
+    /**
+     * @brief Decodes one chunk body from an open snapshot stream.
+     * @param cells Receives the chunk's cells (existing entries are kept).
+     */
+    bool decodeChunk(std::ifstream& inFile, const SnapshotChunk& chunk,
+                     std::unordered_map<Point, int>& cells) const;
+
+    /**
+     * @brief Renders a header thumbnail as ASCII art (two thumbnail rows per text line).
+     */
+    static std::string thumbnailToAscii(const SnapshotInfo& info);
+
+    /**
+     * @brief Saves a 3D world. Format (little-endian):
+     * - "WICAVOX1" (8 bytes), rule id (uint32 length + bytes), generation (uint64),
+     *   population (uint64), chunk size (int32), chunk count (uint32)
+     * - Per chunk: chunk x/y/z (3 x int32), compressed size (uint64), Huffman-compressed
+     *   chunk size^3 uint8 states in (z, y, x) order
+     * @return True on success. Errors are logged.
+     */
+    bool saveVoxelState(const std::string& filePath, const VoxelSpace& voxelSpace,
+                        const std::string& ruleId = "", std::uint64_t generation = 0);
+
+    /**
+     * @brief Loads a 3D world saved by saveVoxelState(), replacing the contents of voxelSpace.
+     * @param info Optional; receives rule id, generation and population.
+     */
+    bool loadVoxelState(const std::string& filePath, VoxelSpace& voxelSpace, SnapshotInfo* info = nullptr);
+
+    /**
+     * @brief True if the file starts with the 3D snapshot magic.
+     */
+    static bool isVoxelSnapshot(const std::string& filePath);
+
+    /**
+     * @brief Saves a reaction-diffusion field. Format (little-endian):
+     * - "WICAFLD1" (8 bytes), rule id (uint32 length + bytes), generation (uint64),
+     *   width and height (int32), channel count (int32, 2)
+     * - Each channel (u, then v) as width * height IEEE float32 values in row-major order
+     * Floats are stored uncompressed; they do not share the byte redundancy Huffman coding relies on.
+     * @return True on success. Errors are logged.
+     */
+    bool saveFieldState(const std::string& filePath, const ReactionDiffusionField& field,
+                        const std::string& ruleId = "", std::uint64_t generation = 0);
+
+    /**
+     * @brief Loads a field saved by saveFieldState(). The field must already be configured
+     * with the same size.
+     * @param info Optional; receives rule id and generation.
+     */
+    bool loadFieldState(const std::string& filePath, ReactionDiffusionField& field, SnapshotInfo* info = nullptr);
+
+    /**
+     * @brief True if the file starts with the float field snapshot magic.
+     */
+    static bool isFieldSnapshot(const std::string& filePath);
 
 private:
+    /**
+     * @brief World contents for writeChunkedFile(): header fields and a visitor over non-default cells.
+     */
+    struct CellSource {
+        std::function<void(const std::function<void(Point, int)>&)> forEachCell;
+        std::uint64_t population = 0;
+        bool boundsValid = false;
+        Point minBounds;
+        Point maxBounds;
+        std::int32_t defaultState = 0;
+    };
+
     // Helper methods for serialization and deserialization
 
     /**
@@ -78,6 +218,29 @@ private:
     void writeInt32(std::vector<std::uint8_t>& buffer, std::int32_t value) const;
     // Helper to read a 32-bit integer from a byte vector (little-endian)
     std::int32_t readInt32(const std::vector<std::uint8_t>& buffer, size_t& offset) const;
+    void writeUint64(std::vector<std::uint8_t>& buffer, std::uint64_t value) const;
+    std::uint64_t readUint64(const std::vector<std::uint8_t>& buffer, size_t& offset) const;
+
+    /**
+     * @brief Writes the chunked file through SnapshotIO, appending ".snapshot" to the path if
+     * missing: magic, header, thumbnail, chunk table, bodies.
+     * Format (all little-endian):
+     * - "WICASNAP" (8 bytes), version (uint32), header payload size (uint32)
+     * - Header payload: rule id (uint32 length + bytes), generation (uint64), population (uint64),
+     *   bounds valid (int32), min/max bounds (4 x int32), default state (int32), chunk size (int32),
+     *   thumbnail width/height (2 x int32) + bytes, chunk count (uint32),
+     *   chunk table entries (int32 x, int32 y, uint32 cells, uint64 offset, uint64 size)
+     * - Chunk bodies: Huffman-compressed records of uint16 local x, uint16 local y, int32 state
+     */
+    bool writeChunkedFile(const std::string& filePath, const CellSource& source, const std::string& ruleId,
+                          std::uint64_t generation,
+                          const SnapshotIO::WriteOptions& options = SnapshotIO::WriteOptions()) const;
+
+    /**
+     * @brief Parses the header payload; rejects chunk table entries that do not lie within fileSize bytes.
+     */
+    bool parseHeader(const std::vector<std::uint8_t>& payload, std::uint64_t fileSize, SnapshotInfo& info) const;
+    bool loadLegacy(const std::vector<std::uint8_t>& fileData, CellSpace& cellSpace, SnapshotInfo* info) const;
 };
 
 #endif // SNAPSHOT_MANAGER_H
@@ -0,0 +1,599 @@
+#include "snapshot_io.h"
+#include "../utils/logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+namespace {
+    constexpr std::size_t READ_PIECE = std::size_t(1) << 20;   // Bytes per io_uring read request
+
+    std::atomic<SnapshotIO::Backend> s_backend{SnapshotIO::Backend::Auto};
+    std::atomic<std::uint64_t> s_directThreshold{0};
+
+    std::uint8_t* allocateAligned(std::size_t alignment, std::size_t size) {
+#ifdef _WIN32
+        return static_cast<std::uint8_t*>(_aligned_malloc(size, alignment));
+#else
+        return static_cast<std::uint8_t*>(std::aligned_alloc(alignment, size));
+#endif
+    }
+
+    void freeAligned(std::uint8_t* data) {
+#ifdef _WIN32
+        _aligned_free(data);
+#else
+        std::free(data);
+#endif
+    }
+}
+
+namespace SnapshotIO {
+
+#ifdef __linux__
+    /**
+     * @brief Minimal io_uring over the raw system calls: one submission and one completion ring.
+     * Only the thread owning the ring submits and reaps, so no locking is needed.
+     */
+    struct Ring {
+        int fd = -1;
+        void* sqMap = MAP_FAILED;
+        std::size_t sqMapSize = 0;
+        void* cqMap = MAP_FAILED;
+        std::size_t cqMapSize = 0;
+        io_uring_sqe* sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+        std::size_t sqesSize = 0;
+        unsigned* sqTail = nullptr;
+        unsigned* sqMask = nullptr;
+        unsigned* sqArray = nullptr;
+        unsigned* cqHead = nullptr;
+        unsigned* cqTail = nullptr;
+        unsigned* cqMask = nullptr;
+        io_uring_cqe* cqes = nullptr;
+
+        ~Ring() {
+            if (sqes != MAP_FAILED) munmap(sqes, sqesSize);
+            if (cqMap != MAP_FAILED && cqMap != sqMap) munmap(cqMap, cqMapSize);
+            if (sqMap != MAP_FAILED) munmap(sqMap, sqMapSize);
+            if (fd >= 0) ::close(fd);
+        }
+
+        bool setup(unsigned entries, std::string& error) {
+            io_uring_params params;
+            std::memset(&params, 0, sizeof(params));
+            fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+            if (fd < 0) {
+                error = std::strerror(errno);
+                return false;
+            }
+            sqMapSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+            cqMapSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+            bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+            if (singleMap) sqMapSize = cqMapSize = std::max(sqMapSize, cqMapSize);
+            sqMap = mmap(nullptr, sqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+            if (sqMap == MAP_FAILED) {
+                error = std::strerror(errno);
+                return false;
+            }
+            cqMap = singleMap ? sqMap
+                              : mmap(nullptr, cqMapSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cqMap == MAP_FAILED) {
+                error = std::strerror(errno);
+                return false;
+            }
+            sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+            sqes = static_cast<io_uring_sqe*>(mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES));
+            if (sqes == MAP_FAILED) {
+                error = std::strerror(errno);
+                return false;
+            }
+            auto* sq = static_cast<std::uint8_t*>(sqMap);
+            auto* cq = static_cast<std::uint8_t*>(cqMap);
+            sqTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+            sqMask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+            sqArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+            cqHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+            cqTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+            cqMask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+            cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+            return true;
+        }
+
+        bool registerBuffers(const iovec* buffers, unsigned count) {
+            return syscall(__NR_io_uring_register, fd, IORING_REGISTER_BUFFERS, buffers, count) == 0;
+        }
+
+        // Queues one request and submits it. Callers never have more requests in flight than entries.
+        bool submit(const io_uring_sqe& request) {
+            unsigned tail = *sqTail;
+            unsigned index = tail & *sqMask;
+            sqes[index] = request;
+            sqArray[index] = index;
+            __atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+            for (;;) {
+                long submitted = syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0);
+                if (submitted >= 0) return true;
+                if (errno != EINTR && errno != EAGAIN) return false;
+            }
+        }
+
+        bool waitForCompletion() {
+            for (;;) {
+                long result = syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (result >= 0) return true;
+                if (errno != EINTR) return false;
+            }
+        }
+
+        bool popCompletion(io_uring_cqe& completion) {
+            unsigned head = *cqHead;
+            if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) return false;
+            completion = cqes[head & *cqMask];
+            __atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+            return true;
+        }
+    };
+#else
+    struct Ring {};
+#endif
+
+    const char* backendName(Backend backend) {
+        switch (backend) {
+            case Backend::IoUring: return "uring";
+            case Backend::PWrite: return "pwrite";
+            default: return "auto";
+        }
+    }
+
+    bool parseBackend(const std::string& text, Backend& backend) {
+        for (Backend candidate : {Backend::Auto, Backend::IoUring, Backend::PWrite}) {
+            if (text == backendName(candidate)) {
+                backend = candidate;
+                return true;
+            }
+        }
+        if (text == "io_uring") {
+            backend = Backend::IoUring;
+            return true;
+        }
+        return false;
+    }
+
+    void setBackend(Backend backend) {
+        s_backend.store(backend);
+    }
+
+    Backend getBackend() {
+        return s_backend.load();
+    }
+
+    void setDirectThreshold(std::uint64_t bytes) {
+        s_directThreshold.store(bytes);
+    }
+
+    std::uint64_t getDirectThreshold() {
+        return s_directThreshold.load();
+    }
+
+    bool isIoUringAvailable() {
+#ifdef __linux__
+        static std::once_flag probed;
+        static bool available = false;
+        std::call_once(probed, [] {
+            Ring ring;
+            std::string error;
+            available = ring.setup(1, error);
+            auto logger = Logger::getLogger(Logger::Module::Snapshot);
+            if (!available && logger) logger->info("io_uring unavailable ({}); snapshots use pwrite.", error);
+        });
+        return available;
+#else
+        return false;
+#endif
+    }
+
+    FileWriter::FileWriter()
+        : fd_(-1),
+          direct_(false),
+          registered_(false),
+          current_(STAGING_BLOCK_COUNT),
+          inFlight_(0),
+          position_(0),
+          headerSize_(0),
+          submittedBytes_(0),
+          failed_(false) {
+    }
+
+    FileWriter::~FileWriter() {
+        closeFile();
+        ring_.reset();
+        for (Block& block : blocks_) freeAligned(block.data);
+    }
+
+    bool FileWriter::fail(const std::string& message) {
+        auto logger = Logger::getLogger(Logger::Module::Snapshot);
+        if (logger && !failed_) logger->error("Snapshot write to {} failed: {}", path_, message);
+        failed_ = true;
+        return false;
+    }
+
+    void FileWriter::closeFile() {
+#ifdef __linux__
+        // The kernel may still be writing from our blocks; wait for every request, failed or not,
+        // before they can be reused or freed.
+        while (ring_ && inFlight_ > 0) {
+            if (!ring_->waitForCompletion()) break; // Only fails if the ring itself is unusable
+            reapCompletions(false);
+        }
+#endif
+#ifndef _WIN32
+        if (fd_ >= 0) ::close(fd_);
+#endif
+        fd_ = -1;
+        if (stream_.is_open()) stream_.close();
+    }
+
+    bool FileWriter::open(const std::string& path, std::uint64_t headerSize, std::uint64_t expectedSize,
+                          const WriteOptions& options) {
+        path_ = path;
+        headerSize_ = headerSize;
+        position_ = 0;
+        current_ = STAGING_BLOCK_COUNT;
+        options_ = options;
+        started_ = std::chrono::steady_clock::now();
+        submittedBytes_ = 0;
+        failed_ = false;
+        for (Block& block : blocks_) {
+            if (!block.data) block.data = allocateAligned(DIRECT_ALIGNMENT, STAGING_BLOCK_SIZE);
+            if (!block.data) return fail("out of memory for I/O blocks");
+        }
+
+#ifndef _WIN32
+        std::uint64_t threshold = getDirectThreshold();
+        direct_ = false;
+#ifdef O_DIRECT
+        if (threshold > 0 && expectedSize >= threshold) {
+            fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC | O_DIRECT, 0644);
+            direct_ = fd_ >= 0;
+            if (!direct_) {
+                auto logger = Logger::getLogger(Logger::Module::Snapshot);
+                if (logger) logger->warn("O_DIRECT not supported for {} ({}); using the page cache.", path, std::strerror(errno));
+            }
+        }
+#else
+        (void)threshold;
+        (void)expectedSize;
+#endif
+        if (fd_ < 0) fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd_ < 0) return fail(std::string("cannot create file: ") + std::strerror(errno));
+#else
+        (void)expectedSize;
+        stream_.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+        if (!stream_.is_open()) return fail("cannot create file");
+#endif
+
+#ifdef __linux__
+        Backend backend = getBackend();
+        ring_.reset();
+        registered_ = false;
+        if (backend != Backend::PWrite && isIoUringAvailable()) {
+            ring_ = std::make_unique<Ring>();
+            std::string error;
+            if (!ring_->setup(STAGING_BLOCK_COUNT, error)) {
+                ring_.reset();
+            } else {
+                iovec buffers[STAGING_BLOCK_COUNT];
+                for (std::size_t i = 0; i < STAGING_BLOCK_COUNT; ++i) buffers[i] = iovec{blocks_[i].data, STAGING_BLOCK_SIZE};
+                registered_ = ring_->registerBuffers(buffers, STAGING_BLOCK_COUNT);
+            }
+        }
+        if (backend == Backend::IoUring && !ring_) {
+            auto logger = Logger::getLogger(Logger::Module::Snapshot);
+            if (logger) logger->warn("io_uring requested but unavailable; writing {} with pwrite.", path);
+        }
+#endif
+
+        // The header is only known at the end; its space is written as zeros so that every
+        // block, including the first, starts at an aligned offset for O_DIRECT.
+        static const std::uint8_t zeros[4096] = {};
+        for (std::uint64_t remaining = headerSize; remaining > 0;) {
+            std::size_t piece = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, sizeof(zeros)));
+            if (!append(zeros, piece)) return false;
+            remaining -= piece;
+        }
+        return true;
+    }
+
+    bool FileWriter::append(const std::uint8_t* data, std::size_t size) {
+        if (failed_) return false;
+        while (size > 0) {
+            if (current_ == STAGING_BLOCK_COUNT && !acquireBlock()) return false;
+            Block& block = blocks_[current_];
+            std::size_t piece = std::min(size, STAGING_BLOCK_SIZE - block.length);
+            std::memcpy(block.data + block.length, data, piece);
+            block.length += piece;
+            position_ += piece;
+            data += piece;
+            size -= piece;
+            if (block.length == STAGING_BLOCK_SIZE && !submitBlock(current_, false)) return false;
+        }
+        return true;
+    }
+
+    bool FileWriter::acquireBlock() {
+        for (;;) {
+            for (std::size_t i = 0; i < STAGING_BLOCK_COUNT; ++i) {
+                if (!blocks_[i].inFlight) {
+                    blocks_[i].fileOffset = position_;
+                    blocks_[i].length = 0;
+                    current_ = i;
+                    return true;
+                }
+            }
+            if (!reapCompletions(true)) return false;
+        }
+    }
+
+    bool FileWriter::submitBlock(std::size_t index, bool last) {
+        Block& block = blocks_[index];
+        current_ = STAGING_BLOCK_COUNT;
+        block.submitted = block.length;
+        if (direct_ && last) {
+            // O_DIRECT lengths must be aligned; finish() truncates the padding away.
+            block.submitted = (block.length + DIRECT_ALIGNMENT - 1) / DIRECT_ALIGNMENT * DIRECT_ALIGNMENT;
+            std::memset(block.data + block.length, 0, block.submitted - block.length);
+        }
+        if (options_.bytesPerSecond > 0) {
+            // Hold the block back until the average rate since open() is within the cap. This
+            // stalls append() and with it the producer, which is the point for background writes.
+            auto due = started_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                      std::chrono::duration<double>(static_cast<double>(submittedBytes_) / options_.bytesPerSecond));
+            std::this_thread::sleep_until(due);
+        }
+        submittedBytes_ += block.submitted;
+#ifdef __linux__
+        if (ring_) {
+            io_uring_sqe request;
+            std::memset(&request, 0, sizeof(request));
+            request.opcode = registered_ ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+            request.fd = fd_;
+            request.addr = reinterpret_cast<std::uint64_t>(block.data);
+            request.len = static_cast<std::uint32_t>(block.submitted);
+            request.off = block.fileOffset;
+            request.buf_index = static_cast<std::uint16_t>(index);
+            request.user_data = index;
+            if (!ring_->submit(request)) return fail(std::string("io_uring submit: ") + std::strerror(errno));
+            block.inFlight = true;
+            ++inFlight_;
+            return reapCompletions(false);
+        }
+#endif
+        bool written = writeAt(block.fileOffset, block.data, block.submitted);
+        block.length = 0;
+        return written;
+    }
+
+    bool FileWriter::reapCompletions(bool wait) {
+#ifdef __linux__
+        if (!ring_) return true;
+        if (wait && inFlight_ > 0 && !ring_->waitForCompletion()) {
+            return fail(std::string("io_uring wait: ") + std::strerror(errno));
+        }
+        // Pop every completion so inFlight_ stays exact; the first error is reported afterwards.
+        int error = 0;
+        io_uring_cqe completion;
+        while (ring_->popCompletion(completion)) {
+            Block& block = blocks_[completion.user_data];
+            block.inFlight = false;
+            --inFlight_;
+            if (completion.res < 0) {
+                if (error == 0) error = -completion.res;
+                continue;
+            }
+            std::size_t done = static_cast<std::size_t>(completion.res);
+            // Short writes are rare on regular files; finish them synchronously.
+            if (!failed_ && error == 0 && done < block.submitted) {
+                writeAt(block.fileOffset + done, block.data + done, block.submitted - done);
+            }
+        }
+        if (error != 0) fail(std::strerror(error));
+#else
+        (void)wait;
+#endif
+        return !failed_;
+    }
+
+    bool FileWriter::writeAt(std::uint64_t offset, const std::uint8_t* data, std::size_t size) {
+#ifndef _WIN32
+        while (size > 0) {
+            ssize_t written = ::pwrite(fd_, data, size, static_cast<off_t>(offset));
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return fail(std::string("pwrite: ") + std::strerror(errno));
+            }
+            if (written == 0) return fail("pwrite wrote nothing (disk full?)");
+            data += written;
+            offset += static_cast<std::uint64_t>(written);
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+#else
+        stream_.seekp(static_cast<std::streamoff>(offset));
+        stream_.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+        return stream_.good() ? true : fail("write error");
+#endif
+    }
+
+    bool FileWriter::finish(const std::vector<std::uint8_t>& header) {
+        if (failed_) {
+            closeFile();
+            return false;
+        }
+        if (header.size() != headerSize_) {
+            closeFile();
+            return fail("header size changed while writing");
+        }
+        if (current_ != STAGING_BLOCK_COUNT && blocks_[current_].length > 0 && !submitBlock(current_, true)) {
+            closeFile();
+            return false;
+        }
+        while (inFlight_ > 0) {
+            if (!reapCompletions(true)) {
+                closeFile();
+                return false;
+            }
+        }
+#ifndef _WIN32
+        if (direct_) {
+            // The header is not block aligned; write it and trim the padding through the page cache.
+            int flags = fcntl(fd_, F_GETFL);
+#ifdef O_DIRECT
+            if (flags >= 0) fcntl(fd_, F_SETFL, flags & ~O_DIRECT);
+#endif
+            if (ftruncate(fd_, static_cast<off_t>(position_)) != 0) {
+                closeFile();
+                return fail(std::string("ftruncate: ") + std::strerror(errno));
+            }
+        }
+#endif
+        bool written = writeAt(0, header.data(), header.size());
+        if (written && options_.sync) {
+#ifdef _WIN32
+            stream_.flush();
+            written = stream_.good() ? true : fail("flush failed");
+#else
+            written = ::fsync(fd_) == 0 ? true : fail(std::string("fsync: ") + std::strerror(errno));
+#endif
+        }
+        closeFile();
+        return written;
+    }
+
+    std::string FileWriter::describe() const {
+        std::string text = ring_ ? (registered_ ? "io_uring, registered buffers" : "io_uring") : "pwrite";
+        if (direct_) text += ", O_DIRECT";
+        return text;
+    }
+
+    bool readFile(const std::string& path, std::vector<std::uint8_t>& data) {
+        auto logger = Logger::getLogger(Logger::Module::Snapshot);
+#ifndef _WIN32
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            if (logger) logger->error("Failed to open file for loading: {} ({})", path, std::strerror(errno));
+            return false;
+        }
+        struct stat status;
+        if (fstat(fd, &status) != 0) {
+            ::close(fd);
+            return false;
+        }
+        const std::size_t size = static_cast<std::size_t>(status.st_size);
+        data.resize(size);
+        std::size_t done = 0;
+
+#ifdef __linux__
+        if (size > READ_PIECE && getBackend() != Backend::PWrite && isIoUringAvailable()) {
+            Ring ring;
+            std::string error;
+            if (ring.setup(STAGING_BLOCK_COUNT, error)) {
+                // Pieces are requested in order with STAGING_BLOCK_COUNT in flight; a short read is resubmitted for its remainder.
+                std::vector<std::size_t> progress((size + READ_PIECE - 1) / READ_PIECE, 0);
+                std::size_t nextPiece = 0;
+                std::size_t inFlight = 0;
+                std::size_t completed = 0;
+                bool ok = true;
+                auto request = [&](std::size_t piece) {
+                    std::size_t begin = piece * READ_PIECE + progress[piece];
+                    std::size_t end = std::min(size, (piece + 1) * READ_PIECE);
+                    io_uring_sqe sqe;
+                    std::memset(&sqe, 0, sizeof(sqe));
+                    sqe.opcode = IORING_OP_READ;
+                    sqe.fd = fd;
+                    sqe.addr = reinterpret_cast<std::uint64_t>(data.data() + begin);
+                    sqe.len = static_cast<std::uint32_t>(end - begin);
+                    sqe.off = begin;
+                    sqe.user_data = piece;
+                    if (!ring.submit(sqe)) return false;
+                    ++inFlight;
+                    return true;
+                };
+                while (ok && completed < progress.size()) {
+                    while (ok && inFlight < STAGING_BLOCK_COUNT && nextPiece < progress.size()) ok = request(nextPiece++);
+                    if (!ok || !ring.waitForCompletion()) {
+                        ok = false;
+                        break;
+                    }
+                    io_uring_cqe completion;
+                    while (ok && ring.popCompletion(completion)) {
+                        --inFlight;
+                        std::size_t piece = static_cast<std::size_t>(completion.user_data);
+                        if (completion.res <= 0) {
+                            ok = false;
+                            break;
+                        }
+                        progress[piece] += static_cast<std::size_t>(completion.res);
+                        if (piece * READ_PIECE + progress[piece] >= std::min(size, (piece + 1) * READ_PIECE)) {
+                            ++completed;
+                        } else {
+                            ok = request(piece);
+                        }
+                    }
+                }
+                // Drain before the ring and buffer go away.
+                io_uring_cqe completion;
+                while (inFlight > 0 && ring.waitForCompletion()) {
+                    while (ring.popCompletion(completion)) --inFlight;
+                }
+                if (ok) done = size;
+            }
+        }
+#endif
+        while (done < size) {
+            ssize_t count = ::pread(fd, data.data() + done, size - done, static_cast<off_t>(done));
+            if (count < 0 && errno == EINTR) continue;
+            if (count <= 0) {
+                if (logger) logger->error("Failed to read data from file: {}", path);
+                ::close(fd);
+                return false;
+            }
+            done += static_cast<std::size_t>(count);
+        }
+        ::close(fd);
+        return true;
+#else
+        std::ifstream inFile(path, std::ios::binary | std::ios::ate);
+        if (!inFile.is_open()) {
+            if (logger) logger->error("Failed to open file for loading: " + path);
+            return false;
+        }
+        std::streamsize size = inFile.tellg();
+        inFile.seekg(0, std::ios::beg);
+        data.resize(static_cast<std::size_t>(size));
+        if (!inFile.read(reinterpret_cast<char*>(data.data()), size)) {
+            if (logger) logger->error("Failed to read data from file: " + path);
+            return false;
+        }
+        return true;
+#endif
+    }
+
+} // namespace SnapshotIO
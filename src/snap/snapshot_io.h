@@ -0,0 +1,139 @@
+#ifndef SNAPSHOT_IO_H
+#define SNAPSHOT_IO_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @namespace SnapshotIO
+ * @brief File I/O backend for snapshots: io_uring on Linux, pwrite/pread elsewhere or as fallback.
+ *
+ * A FileWriter takes the file sequentially through append(), staging it in a few aligned
+ * blocks. A full block is submitted right away and the next free block is filled while it
+ * is written, so compression and disk overlap with up to STAGING_BLOCK_COUNT writes in flight. With io_uring the blocks are registered buffers (fixed
+ * writes, no per-request page pinning); if registering fails (RLIMIT_MEMLOCK) plain io_uring
+ * writes are used, and without io_uring (old kernel, seccomp, io_uring_disabled) every block
+ * is written with pwrite on the calling thread. Files expected to reach the O_DIRECT
+ * threshold bypass the page cache; the padded last block is truncated afterwards.
+ * The file header is written last, at offset 0, into space reserved by open().
+ */
+namespace SnapshotIO {
+
+    enum class Backend {
+        Auto,      // io_uring when the kernel allows it, pwrite otherwise
+        IoUring,
+        PWrite
+    };
+
+    // Not BLOCK_SIZE: <linux/fs.h>, pulled in by <linux/io_uring.h>, defines that as a macro.
+    constexpr std::size_t STAGING_BLOCK_SIZE = std::size_t(512) << 10;
+    constexpr std::size_t STAGING_BLOCK_COUNT = 8;       // Registered buffers, also the io_uring queue depth
+    constexpr std::size_t DIRECT_ALIGNMENT = 4096;
+
+    const char* backendName(Backend backend);
+    bool parseBackend(const std::string& text, Backend& backend);
+
+    void setBackend(Backend backend);
+    Backend getBackend();
+
+    /**
+     * @brief Files expected to be at least this large are written with O_DIRECT; 0 disables it.
+     */
+    void setDirectThreshold(std::uint64_t bytes);
+    std::uint64_t getDirectThreshold();
+
+    /**
+     * @brief Whether io_uring can be set up in this process (probed once).
+     */
+    bool isIoUringAvailable();
+
+    /**
+     * @brief Settings for one FileWriter, given to open().
+     */
+    struct WriteOptions {
+        std::uint64_t bytesPerSecond = 0;   // Paces block submission; 0 = as fast as the disk allows
+        bool sync = false;                  // fsync the file before finish() returns
+    };
+
+    struct Ring; // io_uring instance, defined in the .cpp
+
+    class FileWriter {
+    public:
+        FileWriter();
+        ~FileWriter();
+
+        FileWriter(const FileWriter&) = delete;
+        FileWriter& operator=(const FileWriter&) = delete;
+
+        /**
+         * @brief Creates (truncates) path; appended data starts at offset headerSize.
+         * @param expectedSize Estimate of the final size, used for the O_DIRECT decision.
+         */
+        bool open(const std::string& path, std::uint64_t headerSize, std::uint64_t expectedSize,
+                  const WriteOptions& options = WriteOptions());
+
+        bool append(const std::uint8_t* data, std::size_t size);
+
+        /**
+         * @brief File offset the next append() writes to.
+         */
+        std::uint64_t position() const { return position_; }
+
+        /**
+         * @brief Waits for every write, writes header at offset 0 and closes the file.
+         * header must be exactly the headerSize given to open().
+         */
+        bool finish(const std::vector<std::uint8_t>& header);
+
+        /**
+         * @brief e.g. "io_uring, registered buffers, O_DIRECT".
+         */
+        std::string describe() const;
+
+    private:
+        struct Block {
+            std::uint8_t* data = nullptr;
+            std::uint64_t fileOffset = 0;
+            std::size_t length = 0;       // Bytes filled
+            std::size_t submitted = 0;    // Bytes in the request, padded for O_DIRECT
+            bool inFlight = false;
+        };
+
+        bool fail(const std::string& message);
+        bool acquireBlock();
+        bool submitBlock(std::size_t index, bool last);
+        bool reapCompletions(bool wait);
+        bool writeAt(std::uint64_t offset, const std::uint8_t* data, std::size_t size);
+        void closeFile();
+
+        std::string path_;
+        int fd_;
+        std::fstream stream_;   // Used where POSIX file descriptors are unavailable
+        bool direct_;
+        std::unique_ptr<Ring> ring_;
+        bool registered_;
+        std::array<Block, STAGING_BLOCK_COUNT> blocks_;
+        std::size_t current_;   // Block being filled, STAGING_BLOCK_COUNT if none
+        std::size_t inFlight_;
+        std::uint64_t position_;
+        std::uint64_t headerSize_;
+        WriteOptions options_;
+        std::chrono::steady_clock::time_point started_;
+        std::uint64_t submittedBytes_;   // Total handed to the disk, for pacing
+        bool failed_;
+    };
+
+    /**
+     * @brief Reads a whole file, with several io_uring reads in flight for large files.
+     */
+    bool readFile(const std::string& path, std::vector<std::uint8_t>& data);
+
+} // namespace SnapshotIO
+
+#endif // SNAPSHOT_IO_H
@@ -0,0 +1,80 @@
+#ifndef COLORMAP_H
+#define COLORMAP_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <string>
+
+/**
+ * @enum Colormap
+ * @brief Continuous color scales used to draw float fields.
+ */
+enum class Colormap {
+    Grayscale,
+    Viridis,
+    Inferno,
+    Coolwarm
+};
+
+inline bool parseColormap(const std::string& name, Colormap& colormap) {
+    if (name == "grayscale" || name == "gray") colormap = Colormap::Grayscale;
+    else if (name == "viridis") colormap = Colormap::Viridis;
+    else if (name == "inferno") colormap = Colormap::Inferno;
+    else if (name == "coolwarm") colormap = Colormap::Coolwarm;
+    else return false;
+    return true;
+}
+
+inline const char* colormapName(Colormap colormap) {
+    switch (colormap) {
+        case Colormap::Viridis: return "viridis";
+        case Colormap::Inferno: return "inferno";
+        case Colormap::Coolwarm: return "coolwarm";
+        default: return "grayscale";
+    }
+}
+
+/**
+ * @brief 256-entry RGBA lookup table of a colormap; entry 0 is the low end of the scale.
+ *
+ * Built by linear interpolation between 9 evenly spaced control colors, which is close
+ * enough to the published scales for display.
+ */
+inline std::array<std::array<std::uint8_t, 4>, 256> buildColormapTable(Colormap colormap) {
+    static constexpr std::uint8_t VIRIDIS[9][3] = {
+        {68, 1, 84}, {71, 44, 122}, {59, 81, 139}, {44, 113, 142}, {33, 144, 141},
+        {39, 173, 129}, {92, 200, 99}, {170, 220, 50}, {253, 231, 37}};
+    static constexpr std::uint8_t INFERNO[9][3] = {
+        {0, 0, 4}, {31, 12, 72}, {85, 15, 109}, {136, 34, 106}, {186, 54, 85},
+        {227, 89, 51}, {249, 140, 10}, {249, 201, 50}, {252, 255, 164}};
+    static constexpr std::uint8_t COOLWARM[9][3] = {
+        {59, 76, 192}, {98, 130, 234}, {141, 176, 254}, {184, 208, 249}, {221, 221, 221},
+        {245, 196, 173}, {244, 154, 123}, {222, 96, 77}, {180, 4, 38}};
+    static constexpr std::uint8_t GRAYSCALE[9][3] = {
+        {0, 0, 0}, {32, 32, 32}, {64, 64, 64}, {96, 96, 96}, {128, 128, 128},
+        {159, 159, 159}, {191, 191, 191}, {223, 223, 223}, {255, 255, 255}};
+
+    const std::uint8_t (*stops)[3] = GRAYSCALE;
+    switch (colormap) {
+        case Colormap::Viridis: stops = VIRIDIS; break;
+        case Colormap::Inferno: stops = INFERNO; break;
+        case Colormap::Coolwarm: stops = COOLWARM; break;
+        default: break;
+    }
+
+    std::array<std::array<std::uint8_t, 4>, 256> table{};
+    for (int i = 0; i < 256; ++i) {
+        float position = static_cast<float>(i) * 8.0f / 255.0f;
+        int low = std::min(static_cast<int>(position), 7);
+        float t = position - static_cast<float>(low);
+        for (int c = 0; c < 3; ++c) {
+            float value = stops[low][c] + (stops[low + 1][c] - stops[low][c]) * t;
+            table[i][c] = static_cast<std::uint8_t>(value + 0.5f);
+        }
+        table[i][3] = 255;
+    }
+    return table;
+}
+
+#endif // COLORMAP_H
@@ -0,0 +1,122 @@
+#include "epoch_manager.h"
+#include <algorithm>
+#include <limits>
+#include <thread>
+
+EpochManager::Guard::Guard()
+    : manager_(nullptr),
+      slot_(-1) {
+}
+
+EpochManager::Guard::Guard(EpochManager* manager, int slot)
+    : manager_(manager),
+      slot_(slot) {
+}
+
+EpochManager::Guard::Guard(Guard&& other) noexcept
+    : manager_(other.manager_),
+      slot_(other.slot_) {
+    other.manager_ = nullptr;
+    other.slot_ = -1;
+}
+
+EpochManager::Guard& EpochManager::Guard::operator=(Guard&& other) noexcept {
+    if (this != &other) {
+        release();
+        manager_ = other.manager_;
+        slot_ = other.slot_;
+        other.manager_ = nullptr;
+        other.slot_ = -1;
+    }
+    return *this;
+}
+
+EpochManager::Guard::~Guard() {
+    release();
+}
+
+void EpochManager::Guard::release() {
+    if (manager_) {
+        manager_->slots_[slot_].store(0);
+        manager_ = nullptr;
+        slot_ = -1;
+    }
+}
+
+bool EpochManager::Guard::isActive() const {
+    return manager_ != nullptr;
+}
+
+EpochManager::EpochManager()
+    : globalEpoch_(1) {
+    for (auto& slot : slots_) slot.store(0);
+}
+
+EpochManager::~EpochManager() {
+    for (const Retired& entry : retired_) {
+        entry.deleter(entry.object);
+    }
+}
+
+EpochManager::Guard EpochManager::pin() {
+    for (;;) {
+        Guard guard = tryPin();
+        if (guard.isActive()) return guard;
+        std::this_thread::yield();
+    }
+}
+
+EpochManager::Guard EpochManager::tryPin() {
+    std::uint64_t epoch = globalEpoch_.load();
+    for (int i = 0; i < MAX_READERS; ++i) {
+        std::uint64_t expected = 0;
+        if (slots_[i].load() == 0 && slots_[i].compare_exchange_strong(expected, epoch)) {
+            return Guard(this, i);
+        }
+    }
+    return Guard();
+}
+
+void EpochManager::retire(void* object, void (*deleter)(void*)) {
+    if (!object) return;
+    retired_.push_back({object, deleter, globalEpoch_.load()});
+}
+
+std::size_t EpochManager::advance() {
+    globalEpoch_.fetch_add(1);
+    return reclaim();
+}
+
+std::size_t EpochManager::reclaim() {
+    if (retired_.empty()) return 0;
+    std::uint64_t oldestPinned = std::numeric_limits<std::uint64_t>::max();
+    for (const auto& slot : slots_) {
+        std::uint64_t epoch = slot.load();
+        if (epoch != 0) oldestPinned = std::min(oldestPinned, epoch);
+    }
+    // A reader pinned at epoch e may hold anything retired at epoch >= e.
+    auto firstKept = std::partition(retired_.begin(), retired_.end(),
+                                    [oldestPinned](const Retired& entry) { return entry.epoch < oldestPinned; });
+    std::size_t freed = static_cast<std::size_t>(firstKept - retired_.begin());
+    for (auto it = retired_.begin(); it != firstKept; ++it) {
+        it->deleter(it->object);
+    }
+    retired_.erase(retired_.begin(), firstKept);
+    return freed;
+}
+
+std::uint64_t EpochManager::getEpoch() const {
+    return globalEpoch_.load();
+}
+
+std::size_t EpochManager::getRetiredCount() const {
+    return retired_.size();
+}
+
+int EpochManager::getPinnedCount() const {
+    int count = 0;
+    for (const auto& slot : slots_) {
+        if (slot.load() != 0) ++count;
+    }
+    return count;
+}
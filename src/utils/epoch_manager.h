@@ -0,0 +1,104 @@
+#ifndef EPOCH_MANAGER_H
+#define EPOCH_MANAGER_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class EpochManager
+ * @brief Epoch-based reclamation for structures with one writer and lock-free readers.
+ *
+ * A reader pins the current epoch before loading a shared pointer and unpins when done.
+ * The writer retires objects it has unlinked, tagged with the epoch at retirement; an
+ * object is freed once every pinned reader started in a later epoch, i.e. after the
+ * unlink, so no reader can still reach it. pin() may be called from any thread; retire(),
+ * advance() and reclaim() only from the writer thread. All atomics are sequentially
+ * consistent: a reader's pin is ordered before its pointer load, and the writer's unlink
+ * before its scan of the pins.
+ */
+class EpochManager {
+public:
+    static constexpr int MAX_READERS = 64;
+
+    /**
+     * @brief A pinned reader slot; the epoch stays pinned until the guard is destroyed or released.
+     */
+    class Guard {
+    private:
+        EpochManager* manager_;
+        int slot_;
+
+    public:
+        Guard();
+        Guard(EpochManager* manager, int slot);
+        Guard(Guard&& other) noexcept;
+        Guard& operator=(Guard&& other) noexcept;
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+        ~Guard();
+
+        void release();
+        bool isActive() const;
+    };
+
+private:
+    struct Retired {
+        void* object;
+        void (*deleter)(void*);
+        std::uint64_t epoch;
+    };
+
+    std::atomic<std::uint64_t> globalEpoch_;
+    std::array<std::atomic<std::uint64_t>, MAX_READERS> slots_; // Pinned epoch per reader, 0 = free
+    std::vector<Retired> retired_;                               // Writer thread only
+
+public:
+    EpochManager();
+    /**
+     * @brief Frees everything still retired. No reader may be pinned.
+     */
+    ~EpochManager();
+
+    EpochManager(const EpochManager&) = delete;
+    EpochManager& operator=(const EpochManager&) = delete;
+
+    /**
+     * @brief Pins the current epoch. Spins if all MAX_READERS slots are taken; see tryPin().
+     */
+    Guard pin();
+
+    /**
+     * @brief Pins the current epoch, or returns an inactive guard if all MAX_READERS slots are taken.
+     */
+    Guard tryPin();
+
+    /**
+     * @brief Schedules an unlinked object for deletion once no reader can hold it.
+     */
+    void retire(void* object, void (*deleter)(void*));
+
+    template <typename T>
+    void retire(const T* object) {
+        retire(const_cast<T*>(object), [](void* pointer) { delete static_cast<T*>(pointer); });
+    }
+
+    /**
+     * @brief Starts a new epoch and frees what became unreachable.
+     * @return Number of objects freed.
+     */
+    std::size_t advance();
+
+    /**
+     * @brief Frees retired objects older than every pinned reader.
+     * @return Number of objects freed.
+     */
+    std::size_t reclaim();
+
+    std::uint64_t getEpoch() const;
+    std::size_t getRetiredCount() const;
+    int getPinnedCount() const;
+};
+
+#endif // EPOCH_MANAGER_H
@@ -0,0 +1,183 @@
+#ifndef LATTICE_H
+#define LATTICE_H
+
+#include <cmath>
+#include <string>
+#include "point.h"
+
+/**
+ * @enum Lattice
+ * @brief Cell lattice of a rule. Cells are always addressed by integer (x, y) offset coordinates.
+ *
+ * - Square: the usual grid.
+ * - Hex: pointy-top hexagons in "odd-r" layout; odd rows are shifted right by half a cell.
+ * - Triangle: cell (x, y) points up when x + y is even and down otherwise; cells next to
+ *   each other in a row share an edge.
+ *
+ * In world units every cell keeps the bounding row/column of the square cell (x, y), so
+ * bounds, autofit and snapshots work unchanged; only the drawn shape and picking differ.
+ */
+enum class Lattice {
+    Square,
+    Hex,
+    Triangle
+};
+
+constexpr int LATTICE_MAX_VERTICES = 6;
+
+inline bool parseLattice(const std::string& name, Lattice& lattice) {
+    if (name == "square") lattice = Lattice::Square;
+    else if (name == "hex" || name == "hexagonal") lattice = Lattice::Hex;
+    else if (name == "triangle" || name == "triangular") lattice = Lattice::Triangle;
+    else return false;
+    return true;
+}
+
+inline const char* latticeName(Lattice lattice) {
+    switch (lattice) {
+        case Lattice::Hex: return "hex";
+        case Lattice::Triangle: return "triangle";
+        default: return "square";
+    }
+}
+
+/**
+ * @brief Compile-time neighborhood kernel of a lattice.
+ *
+ * Rule neighborhoods are written for parity-0 cells (even rows on Hex, up-pointing
+ * triangles on Triangle). neighborOffset() maps such an offset to the equivalent offset
+ * for a cell of the given parity; for Square it is the identity and compiles away.
+ */
+template <Lattice L>
+struct LatticeKernel;
+
+template <>
+struct LatticeKernel<Lattice::Square> {
+    static constexpr int PARITY_COUNT = 1;
+    static int parity(Point) { return 0; }
+    static Point neighborOffset(Point offset, int) { return offset; }
+};
+
+template <>
+struct LatticeKernel<Lattice::Hex> {
+    static constexpr int PARITY_COUNT = 2;
+    static int parity(Point cell) { return cell.y & 1; }
+    // From an odd row, the rows above and below start half a cell further left, so odd dy shifts by one.
+    static Point neighborOffset(Point offset, int parity) {
+        return Point(offset.x + (parity & offset.y & 1), offset.y);
+    }
+};
+
+template <>
+struct LatticeKernel<Lattice::Triangle> {
+    static constexpr int PARITY_COUNT = 2;
+    static int parity(Point cell) { return (cell.x + cell.y) & 1; }
+    // A down triangle is an up triangle mirrored vertically.
+    static Point neighborOffset(Point offset, int parity) {
+        return Point(offset.x, parity ? -offset.y : offset.y);
+    }
+};
+
+inline int latticeParity(Lattice lattice, Point cell) {
+    switch (lattice) {
+        case Lattice::Hex: return LatticeKernel<Lattice::Hex>::parity(cell);
+        case Lattice::Triangle: return LatticeKernel<Lattice::Triangle>::parity(cell);
+        default: return 0;
+    }
+}
+
+inline Point latticeNeighborOffset(Lattice lattice, Point offset, int parity) {
+    switch (lattice) {
+        case Lattice::Hex: return LatticeKernel<Lattice::Hex>::neighborOffset(offset, parity);
+        case Lattice::Triangle: return LatticeKernel<Lattice::Triangle>::neighborOffset(offset, parity);
+        default: return offset;
+    }
+}
+
+/**
+ * @brief Outline of a cell of the given parity, in world units relative to the top-left
+ * of its square cell. Hexagons are stretched to a pitch of one unit per row.
+ * @return Number of vertices written (at most LATTICE_MAX_VERTICES).
+ */
+inline int latticeCellShape(Lattice lattice, int parity, float outX[LATTICE_MAX_VERTICES],
+                            float outY[LATTICE_MAX_VERTICES]) {
+    switch (lattice) {
+        case Lattice::Hex: {
+            const float shift = parity ? 0.5f : 0.0f;
+            const float xs[6] = {0.5f, 1.0f, 1.0f, 0.5f, 0.0f, 0.0f};
+            const float ys[6] = {-1.0f / 6.0f, 1.0f / 6.0f, 5.0f / 6.0f, 7.0f / 6.0f, 5.0f / 6.0f, 1.0f / 6.0f};
+            for (int i = 0; i < 6; ++i) {
+                outX[i] = xs[i] + shift;
+                outY[i] = ys[i];
+            }
+            return 6;
+        }
+        case Lattice::Triangle:
+            outX[0] = 0.5f;  outY[0] = parity ? 1.0f : 0.0f;
+            outX[1] = 1.5f;  outY[1] = parity ? 0.0f : 1.0f;
+            outX[2] = -0.5f; outY[2] = parity ? 0.0f : 1.0f;
+            return 3;
+        default:
+            outX[0] = 0.0f; outY[0] = 0.0f;
+            outX[1] = 1.0f; outY[1] = 0.0f;
+            outX[2] = 1.0f; outY[2] = 1.0f;
+            outX[3] = 0.0f; outY[3] = 1.0f;
+            return 4;
+    }
+}
+
+/**
+ * @brief Extent of any cell outline relative to the top-left of its square cell, in world units.
+ */
+inline void latticeCellBounds(Lattice lattice, float& minX, float& minY, float& maxX, float& maxY) {
+    switch (lattice) {
+        case Lattice::Hex:
+            minX = 0.0f; maxX = 1.5f; minY = -1.0f / 6.0f; maxY = 7.0f / 6.0f;
+            break;
+        case Lattice::Triangle:
+            minX = -0.5f; maxX = 1.5f; minY = 0.0f; maxY = 1.0f;
+            break;
+        default:
+            minX = 0.0f; maxX = 1.0f; minY = 0.0f; maxY = 1.0f;
+            break;
+    }
+}
+
+/**
+ * @brief Returns the cell containing the world position (wx, wy).
+ */
+inline Point latticePick(Lattice lattice, float wx, float wy) {
+    const int floorX = static_cast<int>(std::floor(wx));
+    const int floorY = static_cast<int>(std::floor(wy));
+    if (lattice == Lattice::Square) return Point(floorX, floorY);
+
+    auto contains = [&](Point cell) {
+        float xs[LATTICE_MAX_VERTICES], ys[LATTICE_MAX_VERTICES];
+        int count = latticeCellShape(lattice, latticeParity(lattice, cell), xs, ys);
+        float px = wx - static_cast<float>(cell.x);
+        float py = wy - static_cast<float>(cell.y);
+        bool anyNegative = false, anyPositive = false;
+        for (int i = 0; i < count; ++i) {
+            int j = (i + 1) % count;
+            float cross = (xs[j] - xs[i]) * (py - ys[i]) - (ys[j] - ys[i]) * (px - xs[i]);
+            anyNegative |= cross < 0.0f;
+            anyPositive |= cross > 0.0f;
+        }
+        return !(anyNegative && anyPositive);
+    };
+
+    if (lattice == Lattice::Hex) {
+        // The hexagon of a row covers its band horizontally; the zigzag edges overlap the adjacent rows.
+        for (int row = floorY - 1; row <= floorY + 1; ++row) {
+            Point cell(static_cast<int>(std::floor(wx - ((row & 1) ? 0.5f : 0.0f))), row);
+            if (contains(cell)) return cell;
+        }
+    } else {
+        for (int x = floorX - 1; x <= floorX + 1; ++x) {
+            if (contains(Point(x, floorY))) return Point(x, floorY);
+        }
+    }
+    return Point(floorX, floorY);
+}
+
+#endif // LATTICE_H
@@ -25,6 +25,7 @@ std::string ModuleToString(Module module) {
         case Module::ErrorHandler:    return "ErrorHandler";
         case Module::Rule:            return "Rule";
         case Module::Huffman:         return "Huffman";
+        case Module::IPC:             return "IPC";
         default:                      return "Unknown";
     }
 }
@@ -50,7 +51,8 @@ void initialize(const std::string& logFilePath, spdlog::level::level_enum global
             Module::Core, Module::Renderer, Module::Input, Module::UI,
             Module::CommandParser, Module::CellSpace, Module::RuleEngine,
             Module::Snapshot, Module::FileIO, Module::Utils, Module::Main,
-            Module::ErrorHandler, Module::Rule, Module::Huffman
+            Module::ErrorHandler, Module::Rule, Module::Huffman,
+            Module::IPC
         };
 
         for (Module mod : all_modules) {
@@ -25,7 +25,8 @@ enum class Module {
     Main,
     ErrorHandler,
     Rule,
-    Huffman
+    Huffman,
+    IPC
 };
 
 /**
@@ -0,0 +1,210 @@
+#include "metrics.h"
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace Metrics {
+
+namespace {
+
+    constexpr std::size_t COUNTER_COUNT = static_cast<std::size_t>(Counter::__COUNT__);
+    constexpr std::size_t GAUGE_COUNT = static_cast<std::size_t>(Gauge::__COUNT__);
+    constexpr std::size_t HISTOGRAM_COUNT = static_cast<std::size_t>(Histogram::__COUNT__);
+
+    struct HistogramData {
+        std::array<std::atomic<std::uint64_t>, HISTOGRAM_BUCKETS + 1> buckets{}; // Last one is +Inf
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> sumNanoseconds{0};
+    };
+
+    std::array<std::atomic<std::uint64_t>, COUNTER_COUNT> s_Counters{};
+    std::array<std::atomic<double>, GAUGE_COUNT> s_Gauges{};
+    std::array<HistogramData, HISTOGRAM_COUNT> s_Histograms{};
+
+    struct Description {
+        const char* name;
+        const char* help;
+    };
+
+    Description describe(Counter counter) {
+        switch (counter) {
+            case Counter::Generations:    return {"wica_generations_total", "Generations computed."};
+            case Counter::CellsEvaluated: return {"wica_cells_evaluated_total", "Cells evaluated by the rule function."};
+            case Counter::CellsChanged:   return {"wica_cells_changed_total", "Cell state changes applied."};
+            case Counter::FramesRendered: return {"wica_frames_rendered_total", "Frames rendered."};
+            default:                      return {"wica_unknown_total", ""};
+        }
+    }
+
+    Description describe(Gauge gauge) {
+        switch (gauge) {
+            case Gauge::Population:  return {"wica_population", "Cells not in the default state."};
+            case Gauge::ActiveCells: return {"wica_active_cells", "Cells queued for evaluation in the next generation."};
+            default:                 return {"wica_unknown", ""};
+        }
+    }
+
+    Description describe(Histogram histogram) {
+        switch (histogram) {
+            case Histogram::StepSeconds:  return {"wica_step_seconds", "Time to compute one generation."};
+            case Histogram::ApplySeconds: return {"wica_apply_seconds", "Time to apply one generation's changes."};
+            case Histogram::FrameSeconds: return {"wica_frame_seconds", "Time to render the grid for one frame."};
+            default:                      return {"wica_unknown_seconds", ""};
+        }
+    }
+
+    // Upper bound of bucket i in seconds.
+    double bucketBound(int i) {
+        return std::ldexp(1e-6, i);
+    }
+
+    // Resident and virtual memory of this process in bytes, read from /proc (0 if unavailable).
+    void readProcessMemory(std::uint64_t& residentBytes, std::uint64_t& virtualBytes) {
+        residentBytes = 0;
+        virtualBytes = 0;
+#ifndef _WIN32
+        std::ifstream statm("/proc/self/statm");
+        std::uint64_t sizePages = 0, residentPages = 0;
+        if (statm >> sizePages >> residentPages) {
+            std::uint64_t pageSize = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+            residentBytes = residentPages * pageSize;
+            virtualBytes = sizePages * pageSize;
+        }
+#endif
+    }
+
+    std::string formatDouble(double value) {
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+        return buffer;
+    }
+
+} // namespace
+
+void increment(Counter counter, std::uint64_t amount) {
+    s_Counters[static_cast<std::size_t>(counter)].fetch_add(amount, std::memory_order_relaxed);
+}
+
+void setGauge(Gauge gauge, double value) {
+    s_Gauges[static_cast<std::size_t>(gauge)].store(value, std::memory_order_relaxed);
+}
+
+void observe(Histogram histogram, std::chrono::nanoseconds duration) {
+    HistogramData& data = s_Histograms[static_cast<std::size_t>(histogram)];
+    std::uint64_t ns = duration.count() > 0 ? static_cast<std::uint64_t>(duration.count()) : 0;
+    // Bucket i holds durations <= 2^i microseconds.
+    std::uint64_t micros = (ns + 999) / 1000;
+    int bucket = micros <= 1 ? 0 : static_cast<int>(std::bit_width(micros - 1));
+    if (bucket > HISTOGRAM_BUCKETS) bucket = HISTOGRAM_BUCKETS;
+    data.buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    data.count.fetch_add(1, std::memory_order_relaxed);
+    data.sumNanoseconds.fetch_add(ns, std::memory_order_relaxed);
+}
+
+std::uint64_t getCounter(Counter counter) {
+    return s_Counters[static_cast<std::size_t>(counter)].load(std::memory_order_relaxed);
+}
+
+double getGauge(Gauge gauge) {
+    return s_Gauges[static_cast<std::size_t>(gauge)].load(std::memory_order_relaxed);
+}
+
+double quantile(Histogram histogram, double q) {
+    const HistogramData& data = s_Histograms[static_cast<std::size_t>(histogram)];
+    std::array<std::uint64_t, HISTOGRAM_BUCKETS + 1> counts;
+    std::uint64_t total = 0;
+    for (int i = 0; i <= HISTOGRAM_BUCKETS; ++i) {
+        counts[i] = data.buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) return 0.0;
+
+    double rank = q * static_cast<double>(total);
+    std::uint64_t cumulative = 0;
+    for (int i = 0; i <= HISTOGRAM_BUCKETS; ++i) {
+        if (counts[i] == 0) continue;
+        if (static_cast<double>(cumulative + counts[i]) >= rank) {
+            if (i == HISTOGRAM_BUCKETS) return bucketBound(HISTOGRAM_BUCKETS - 1); // +Inf: report the largest finite bound
+            double lower = i == 0 ? 0.0 : bucketBound(i - 1);
+            double upper = bucketBound(i);
+            double fraction = (rank - static_cast<double>(cumulative)) / static_cast<double>(counts[i]);
+            return lower + (upper - lower) * fraction;
+        }
+        cumulative += counts[i];
+    }
+    return bucketBound(HISTOGRAM_BUCKETS - 1);
+}
+
+std::string renderPrometheus() {
+    std::ostringstream out;
+
+    for (std::size_t i = 0; i < COUNTER_COUNT; ++i) {
+        Description d = describe(static_cast<Counter>(i));
+        out << "# HELP " << d.name << ' ' << d.help << '\n'
+            << "# TYPE " << d.name << " counter\n"
+            << d.name << ' ' << s_Counters[i].load(std::memory_order_relaxed) << '\n';
+    }
+
+    for (std::size_t i = 0; i < GAUGE_COUNT; ++i) {
+        Description d = describe(static_cast<Gauge>(i));
+        out << "# HELP " << d.name << ' ' << d.help << '\n'
+            << "# TYPE " << d.name << " gauge\n"
+            << d.name << ' ' << formatDouble(s_Gauges[i].load(std::memory_order_relaxed)) << '\n';
+    }
+
+    for (std::size_t i = 0; i < HISTOGRAM_COUNT; ++i) {
+        Description d = describe(static_cast<Histogram>(i));
+        const HistogramData& data = s_Histograms[i];
+        out << "# HELP " << d.name << ' ' << d.help << '\n'
+            << "# TYPE " << d.name << " histogram\n";
+        std::uint64_t cumulative = 0;
+        for (int b = 0; b < HISTOGRAM_BUCKETS; ++b) {
+            cumulative += data.buckets[b].load(std::memory_order_relaxed);
+            out << d.name << "_bucket{le=\"" << formatDouble(bucketBound(b)) << "\"} " << cumulative << '\n';
+        }
+        cumulative += data.buckets[HISTOGRAM_BUCKETS].load(std::memory_order_relaxed);
+        out << d.name << "_bucket{le=\"+Inf\"} " << cumulative << '\n'
+            << d.name << "_sum " << formatDouble(data.sumNanoseconds.load(std::memory_order_relaxed) * 1e-9) << '\n'
+            << d.name << "_count " << cumulative << '\n';
+
+        // Pre-computed p99 for consumers that read dumps directly instead of running histogram_quantile().
+        out << "# HELP " << d.name << "_p99 Estimated 99th percentile of " << d.name << ".\n"
+            << "# TYPE " << d.name << "_p99 gauge\n"
+            << d.name << "_p99 " << formatDouble(quantile(static_cast<Histogram>(i), 0.99)) << '\n';
+    }
+
+    std::uint64_t residentBytes = 0, virtualBytes = 0;
+    readProcessMemory(residentBytes, virtualBytes);
+    out << "# HELP process_resident_memory_bytes Resident memory size in bytes.\n"
+        << "# TYPE process_resident_memory_bytes gauge\n"
+        << "process_resident_memory_bytes " << residentBytes << '\n'
+        << "# HELP process_virtual_memory_bytes Virtual memory size in bytes.\n"
+        << "# TYPE process_virtual_memory_bytes gauge\n"
+        << "process_virtual_memory_bytes " << virtualBytes << '\n';
+
+    return out.str();
+}
+
+std::string summary() {
+    std::uint64_t residentBytes = 0, virtualBytes = 0;
+    readProcessMemory(residentBytes, virtualBytes);
+    char buffer[256];
+    std::snprintf(buffer, sizeof(buffer),
+                  "gens %llu | pop %.0f | active %.0f | step p99 %.3f ms | frame p99 %.3f ms | rss %.1f MiB",
+                  static_cast<unsigned long long>(getCounter(Counter::Generations)),
+                  getGauge(Gauge::Population), getGauge(Gauge::ActiveCells),
+                  quantile(Histogram::StepSeconds, 0.99) * 1000.0,
+                  quantile(Histogram::FrameSeconds, 0.99) * 1000.0,
+                  residentBytes / (1024.0 * 1024.0));
+    return buffer;
+}
+
+} // namespace Metrics
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @namespace Metrics
+ * @brief Process-wide registry of run metrics, exported in Prometheus text format.
+ *
+ * All values are fixed-size arrays of relaxed atomics indexed by enum, so recording
+ * from the hot paths never takes a lock or allocates. Histograms use fixed
+ * power-of-two buckets starting at 1 microsecond.
+ */
+namespace Metrics {
+
+enum class Counter {
+    Generations,        // Generations computed
+    CellsEvaluated,     // Cells passed to the rule function
+    CellsChanged,       // State changes applied by updateCells
+    FramesRendered,
+    __COUNT__
+};
+
+enum class Gauge {
+    Population,         // Non-default cells
+    ActiveCells,        // Cells queued for evaluation in the next generation
+    __COUNT__
+};
+
+enum class Histogram {
+    StepSeconds,        // RuleEngine::calculateForUpdate
+    ApplySeconds,       // CellSpace::updateCells
+    FrameSeconds,       // Renderer::renderGrid
+    __COUNT__
+};
+
+constexpr int HISTOGRAM_BUCKETS = 24; // Upper bounds 1us * 2^i, i = 0..23 (~8.4s), plus +Inf
+
+void increment(Counter counter, std::uint64_t amount = 1);
+void setGauge(Gauge gauge, double value);
+void observe(Histogram histogram, std::chrono::nanoseconds duration);
+
+std::uint64_t getCounter(Counter counter);
+double getGauge(Gauge gauge);
+
+/**
+ * @brief Estimates a quantile (0..1) of a histogram in seconds, interpolating inside the bucket.
+ * @return 0 if nothing was observed yet.
+ */
+double quantile(Histogram histogram, double q);
+
+/**
+ * @brief Renders every metric, plus process memory usage, in Prometheus text exposition format.
+ */
+std::string renderPrometheus();
+
+/**
+ * @brief Short human-readable summary for the overlay.
+ */
+std::string summary();
+
+/**
+ * @class ScopedObservation
+ * @brief Records the lifetime of the object into a histogram, including early returns.
+ */
+class ScopedObservation {
+private:
+    Histogram histogram_;
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    explicit ScopedObservation(Histogram histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedObservation() {
+        observe(histogram_, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_));
+    }
+
+    ScopedObservation(const ScopedObservation&) = delete;
+    ScopedObservation& operator=(const ScopedObservation&) = delete;
+};
+
+} // namespace Metrics
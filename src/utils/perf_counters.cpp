@@ -0,0 +1,270 @@
+#include "perf_counters.h"
+#include "logger.h"
+#include "timer.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <tbb/task_scheduler_observer.h>
+#endif
+
+namespace {
+    constexpr std::size_t ZONE_COUNT = static_cast<std::size_t>(Timer::Module::__MODULE_COUNT__);
+
+    struct ZoneTotals {
+        std::array<std::uint64_t, PerfCounters::EVENT_COUNT> values{};
+        std::uint64_t calls = 0;
+        std::uint64_t items = 0;
+    };
+
+    std::atomic<bool> s_enabled{false};
+    std::mutex s_mutex; // Guards everything below
+    std::array<ZoneTotals, ZONE_COUNT> s_totals;
+    std::array<bool, PerfCounters::EVENT_COUNT> s_available{};
+
+#ifdef __linux__
+    struct ThreadGroup {
+        int leader = -1;
+        std::array<int, PerfCounters::EVENT_COUNT> fds;
+        std::array<int, PerfCounters::EVENT_COUNT> slots; // Position in the group's read buffer, -1 if absent
+        int members = 0;
+
+        ThreadGroup() {
+            fds.fill(-1);
+            slots.fill(-1);
+        }
+    };
+
+    std::vector<ThreadGroup> s_groups;
+    std::uint64_t s_session = 0;                 // Bumped by enable() so threads reopen after a disable
+    thread_local std::uint64_t t_openedSession = 0;
+
+    long perfEventOpen(perf_event_attr* attr, pid_t pid, int cpu, int groupFd, unsigned long flags) {
+        return syscall(SYS_perf_event_open, attr, pid, cpu, groupFd, flags);
+    }
+
+    void describe(PerfCounters::Event event, perf_event_attr& attr) {
+        switch (event) {
+            case PerfCounters::Event::Cycles:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CPU_CYCLES;
+                break;
+            case PerfCounters::Event::Instructions:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+                break;
+            case PerfCounters::Event::L1DMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+            case PerfCounters::Event::LLCMisses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_CACHE_MISSES;
+                break;
+            case PerfCounters::Event::BranchMisses:
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // Opens a group on the calling thread; only the cycles leader is mandatory.
+    bool openGroup(ThreadGroup& group, std::string& error) {
+        for (std::size_t i = 0; i < PerfCounters::EVENT_COUNT; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            describe(static_cast<PerfCounters::Event>(i), attr);
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            int fd = static_cast<int>(perfEventOpen(&attr, 0, -1, group.leader, PERF_FLAG_FD_CLOEXEC));
+            if (fd < 0) {
+                if (group.leader < 0) {
+                    error = std::strerror(errno);
+                    if (errno == EACCES || errno == EPERM) error += " (check /proc/sys/kernel/perf_event_paranoid)";
+                    if (errno == ENOENT || errno == EOPNOTSUPP) error += " (no hardware counters; virtual machine?)";
+                    return false;
+                }
+                continue;
+            }
+            if (group.leader < 0) group.leader = fd;
+            group.fds[i] = fd;
+            group.slots[i] = group.members++;
+        }
+        return true;
+    }
+
+    void closeGroup(const ThreadGroup& group) {
+        for (int fd : group.fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+
+    // Caller holds s_mutex.
+    void openForCurrentThread() {
+        if (t_openedSession == s_session) return;
+        t_openedSession = s_session; // Also on failure, so a thread does not retry on every entry
+        ThreadGroup group;
+        std::string error;
+        if (!openGroup(group, error)) {
+            auto logger = Logger::getLogger(Logger::Module::Utils);
+            if (logger) logger->warn("Performance counters unavailable on a worker thread: {}", error);
+            return;
+        }
+        s_groups.push_back(group);
+    }
+
+    class WorkerObserver : public tbb::task_scheduler_observer {
+    public:
+        void on_scheduler_entry(bool) override {
+            PerfCounters::attachCurrentThread();
+        }
+    };
+
+    std::unique_ptr<WorkerObserver> s_observer;
+#endif
+
+    double ratio(std::uint64_t numerator, std::uint64_t denominator) {
+        return denominator ? static_cast<double>(numerator) / static_cast<double>(denominator) : 0.0;
+    }
+}
+
+namespace PerfCounters {
+
+    bool enable(std::string& error) {
+#ifdef __linux__
+        auto logger = Logger::getLogger(Logger::Module::Utils);
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            if (s_enabled.load()) return true;
+            ThreadGroup group;
+            if (!openGroup(group, error)) {
+                if (logger) logger->error("perf_event_open failed: {}", error);
+                return false;
+            }
+            ++s_session;
+            t_openedSession = s_session;
+            s_groups.push_back(group);
+            for (std::size_t i = 0; i < EVENT_COUNT; ++i) s_available[i] = group.fds[i] >= 0;
+            s_enabled.store(true);
+        }
+        s_observer = std::make_unique<WorkerObserver>();
+        s_observer->observe(true);
+        if (logger) logger->info("Performance counters enabled ({} of {} events available).", s_groups.front().members, EVENT_COUNT);
+        return true;
+#else
+        error = "hardware counters need Linux perf_event_open";
+        return false;
+#endif
+    }
+
+    void disable() {
+#ifdef __linux__
+        if (s_observer) {
+            s_observer->observe(false);
+            s_observer.reset();
+        }
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_enabled.store(false);
+        for (const ThreadGroup& group : s_groups) closeGroup(group);
+        s_groups.clear();
+#endif
+    }
+
+    bool isEnabled() {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+
+    void attachCurrentThread() {
+#ifdef __linux__
+        if (!s_enabled.load(std::memory_order_relaxed)) return;
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (s_enabled.load(std::memory_order_relaxed)) openForCurrentThread();
+#endif
+    }
+
+    Sample read() {
+        Sample sample;
+#ifdef __linux__
+        if (!isEnabled()) return sample;
+        struct {
+            std::uint64_t count;
+            std::uint64_t timeEnabled;
+            std::uint64_t timeRunning;
+            std::uint64_t values[EVENT_COUNT];
+        } buffer;
+        std::lock_guard<std::mutex> lock(s_mutex);
+        for (const ThreadGroup& group : s_groups) {
+            if (::read(group.leader, &buffer, sizeof(buffer)) <= 0 || buffer.timeRunning == 0) continue;
+            double scale = static_cast<double>(buffer.timeEnabled) / static_cast<double>(buffer.timeRunning);
+            for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+                if (group.slots[i] < 0) continue;
+                sample.values[i] += static_cast<std::uint64_t>(static_cast<double>(buffer.values[group.slots[i]]) * scale);
+            }
+        }
+        sample.valid = !s_groups.empty();
+#endif
+        return sample;
+    }
+
+    void record(std::size_t zone, const Sample& begin, const Sample& end, std::uint64_t items) {
+        if (!begin.valid || !end.valid || zone >= ZONE_COUNT) return;
+        std::lock_guard<std::mutex> lock(s_mutex);
+        ZoneTotals& totals = s_totals[zone];
+        for (std::size_t i = 0; i < EVENT_COUNT; ++i) {
+            // Scaling can make a multiplexed counter step back slightly; never go negative.
+            if (end.values[i] > begin.values[i]) totals.values[i] += end.values[i] - begin.values[i];
+        }
+        ++totals.calls;
+        totals.items += items;
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        s_totals = {};
+    }
+
+    std::string report() {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        std::string text;
+        char line[256];
+        for (std::size_t zone = 0; zone < ZONE_COUNT; ++zone) {
+            const ZoneTotals& totals = s_totals[zone];
+            if (totals.calls == 0) continue;
+            const auto& v = totals.values;
+            std::uint64_t per = totals.items ? totals.items : totals.calls;
+            auto perItem = [&](Event event) -> std::string {
+                std::size_t i = static_cast<std::size_t>(event);
+                if (!s_available[i]) return "n/a";
+                char value[32];
+                std::snprintf(value, sizeof(value), "%.2f", ratio(v[i], per));
+                return value;
+            };
+            std::size_t cycles = static_cast<std::size_t>(Event::Cycles);
+            std::size_t instructions = static_cast<std::size_t>(Event::Instructions);
+            std::snprintf(line, sizeof(line), "%s: %llu calls, IPC %.2f, per %s: cycles %s, L1D miss %s, LLC miss %s, branch miss %s\n",
+                          Timer::moduleToString(static_cast<Timer::Module>(zone)).c_str(),
+                          static_cast<unsigned long long>(totals.calls),
+                          s_available[instructions] ? ratio(v[instructions], v[cycles]) : 0.0,
+                          totals.items ? "cell" : "call",
+                          perItem(Event::Cycles).c_str(), perItem(Event::L1DMisses).c_str(),
+                          perItem(Event::LLCMisses).c_str(), perItem(Event::BranchMisses).c_str());
+            text += line;
+        }
+        if (text.empty()) text = "No counter data recorded yet.\n";
+        return text;
+    }
+
+} // namespace PerfCounters
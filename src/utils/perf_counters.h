@@ -0,0 +1,81 @@
+#ifndef PERF_COUNTERS_H
+#define PERF_COUNTERS_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @namespace PerfCounters
+ * @brief Optional hardware performance counters (Linux perf_event_open) attributed to Timer zones.
+ *
+ * When enabled, every thread that runs simulation work gets one counter group (cycles,
+ * instructions, L1D read misses, last-level cache misses, branch misses): the enabling thread
+ * directly, TBB workers when they enter the scheduler. A Timer reads the sum over all groups
+ * when it starts and stops, so a zone includes the work its parallel loops hand to workers.
+ * Groups are read with their enabled and running times and scaled, which compensates for the
+ * kernel multiplexing counters when more events are requested than the PMU has. Events the
+ * CPU or hypervisor does not provide are left out. Disabled (the default), Timers pay one
+ * relaxed atomic load.
+ */
+namespace PerfCounters {
+
+    enum class Event {
+        Cycles,
+        Instructions,
+        L1DMisses,
+        LLCMisses,
+        BranchMisses,
+        __COUNT__
+    };
+
+    constexpr std::size_t EVENT_COUNT = static_cast<std::size_t>(Event::__COUNT__);
+
+    /**
+     * @brief Counter values summed over all threads, scaled for multiplexing.
+     */
+    struct Sample {
+        std::array<std::uint64_t, EVENT_COUNT> values{};
+        bool valid = false;
+    };
+
+    /**
+     * @brief Opens counters for the calling thread and starts following TBB workers.
+     * @param error Receives the reason on failure (no PMU, perf_event_paranoid, not Linux).
+     */
+    bool enable(std::string& error);
+
+    /**
+     * @brief Closes every counter group. Totals are kept until reset().
+     */
+    void disable();
+    bool isEnabled();
+
+    /**
+     * @brief Opens counters for the calling thread if enabled and not done yet. Called by
+     * scheduler observers of arenas other than the implicit one.
+     */
+    void attachCurrentThread();
+
+    /**
+     * @brief Current counter values; invalid while disabled.
+     */
+    Sample read();
+
+    /**
+     * @brief Adds the difference of two samples to a zone (a Timer::Module index), with the
+     * number of items (cells) processed.
+     */
+    void record(std::size_t zone, const Sample& begin, const Sample& end, std::uint64_t items);
+
+    void reset();
+
+    /**
+     * @brief One line per zone: calls, IPC, and cycles and misses per item (per call when a zone has no items).
+     */
+    std::string report();
+
+} // namespace PerfCounters
+
+#endif // PERF_COUNTERS_H
@@ -0,0 +1,45 @@
+#ifndef POINT3_H
+#define POINT3_H
+
+#include <cstddef>    // Required for std::size_t
+#include <functional> // Required for std::hash
+
+// Defines a simple 3D point/vector structure for voxel coordinates.
+struct Point3 {
+    int x, y, z;
+
+    Point3() : x(0), y(0), z(0) {}
+    Point3(int x_val, int y_val, int z_val) : x(x_val), y(y_val), z(z_val) {}
+
+    bool operator==(const Point3& other) const {
+        return x == other.x && y == other.y && z == other.z;
+    }
+
+    bool operator!=(const Point3& other) const {
+        return !(*this == other);
+    }
+
+    Point3 operator+(const Point3& other) const {
+        return Point3(x + other.x, y + other.y, z + other.z);
+    }
+
+    Point3 operator-(const Point3& other) const {
+        return Point3(x - other.x, y - other.y, z - other.z);
+    }
+};
+
+// Custom hash function for Point3 to be used with std::unordered_map
+namespace std {
+    template <>
+    struct hash<Point3> {
+        std::size_t operator()(const Point3& p) const {
+            std::size_t seed = 0;
+            seed ^= std::hash<int>{}(p.x) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= std::hash<int>{}(p.y) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            seed ^= std::hash<int>{}(p.z) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+            return seed;
+        }
+    };
+}
+
+#endif // POINT3_H
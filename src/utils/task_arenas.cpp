@@ -0,0 +1,168 @@
+#include "task_arenas.h"
+#include "logger.h"
+#include "perf_counters.h"
+
+#include <algorithm>
+#include <array>
+#include <mutex>
+
+#include <tbb/info.h>
+#include <tbb/task_scheduler_observer.h>
+
+namespace {
+    constexpr std::size_t DOMAIN_COUNT = static_cast<std::size_t>(TaskArenas::Domain::__COUNT__);
+
+    // Workers entering an arena get their hardware counters, as in the implicit arena.
+    class ArenaObserver : public tbb::task_scheduler_observer {
+    public:
+        explicit ArenaObserver(tbb::task_arena& arena) : tbb::task_scheduler_observer(arena) {}
+
+        void on_scheduler_entry(bool) override {
+            PerfCounters::attachCurrentThread();
+        }
+    };
+
+    // The observer is declared after the arena so it stops observing before the arena goes away.
+    struct ArenaEntry {
+        tbb::task_arena arena;
+        ArenaObserver observer;
+
+        ArenaEntry(const TaskArenas::Settings& settings, tbb::task_arena::priority priority)
+            : arena(settings.threads, 1, priority),
+              observer(arena) {
+            arena.initialize();
+            observer.observe(true);
+        }
+
+        ~ArenaEntry() {
+            observer.observe(false);
+        }
+    };
+
+    struct Slot {
+        TaskArenas::Settings settings;
+        std::shared_ptr<tbb::task_arena> arena;
+    };
+
+    std::mutex s_mutex;
+    bool s_defaultsApplied = false;
+    std::array<Slot, DOMAIN_COUNT> s_slots;
+
+    tbb::task_arena::priority toTbb(TaskArenas::Priority priority) {
+        switch (priority) {
+            case TaskArenas::Priority::Low: return tbb::task_arena::priority::low;
+            case TaskArenas::Priority::High: return tbb::task_arena::priority::high;
+            default: return tbb::task_arena::priority::normal;
+        }
+    }
+
+    // Caller holds s_mutex.
+    void applyDefaults() {
+        if (s_defaultsApplied) return;
+        s_defaultsApplied = true;
+        int cores = std::max(1, tbb::info::default_concurrency());
+        s_slots[static_cast<std::size_t>(TaskArenas::Domain::Simulation)].settings = {cores, TaskArenas::Priority::Normal};
+        s_slots[static_cast<std::size_t>(TaskArenas::Domain::Render)].settings = {std::max(1, cores / 2), TaskArenas::Priority::High};
+        s_slots[static_cast<std::size_t>(TaskArenas::Domain::IO)].settings = {std::max(1, cores / 4), TaskArenas::Priority::Low};
+    }
+
+    std::shared_ptr<tbb::task_arena> createArena(const TaskArenas::Settings& settings) {
+        auto entry = std::make_shared<ArenaEntry>(settings, toTbb(settings.priority));
+        return std::shared_ptr<tbb::task_arena>(entry, &entry->arena);
+    }
+}
+
+namespace TaskArenas {
+
+    const char* domainName(Domain domain) {
+        switch (domain) {
+            case Domain::Simulation: return "simulation";
+            case Domain::Render: return "render";
+            case Domain::IO: return "io";
+            default: return "unknown";
+        }
+    }
+
+    const char* priorityName(Priority priority) {
+        switch (priority) {
+            case Priority::Low: return "low";
+            case Priority::High: return "high";
+            default: return "normal";
+        }
+    }
+
+    bool parseDomain(const std::string& text, Domain& domain) {
+        for (std::size_t i = 0; i < DOMAIN_COUNT; ++i) {
+            if (text == domainName(static_cast<Domain>(i))) {
+                domain = static_cast<Domain>(i);
+                return true;
+            }
+        }
+        if (text == "sim") {
+            domain = Domain::Simulation;
+            return true;
+        }
+        return false;
+    }
+
+    bool parsePriority(const std::string& text, Priority& priority) {
+        for (Priority candidate : {Priority::Low, Priority::Normal, Priority::High}) {
+            if (text == priorityName(candidate)) {
+                priority = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Settings getSettings(Domain domain) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        applyDefaults();
+        return s_slots[static_cast<std::size_t>(domain)].settings;
+    }
+
+    bool configure(Domain domain, const Settings& settings, std::string& error) {
+        if (domain == Domain::__COUNT__) {
+            error = "unknown arena";
+            return false;
+        }
+        if (settings.threads < 1) {
+            error = "an arena needs at least one thread";
+            return false;
+        }
+        std::shared_ptr<tbb::task_arena> replaced;
+        {
+            std::lock_guard<std::mutex> lock(s_mutex);
+            applyDefaults();
+            Slot& slot = s_slots[static_cast<std::size_t>(domain)];
+            slot.settings = settings;
+            replaced = std::move(slot.arena); // Recreated on next use; released outside the lock
+        }
+        auto logger = Logger::getLogger(Logger::Module::Utils);
+        if (logger) logger->info("Task arena '{}' set to {} threads, {} priority.", domainName(domain),
+                                 settings.threads, priorityName(settings.priority));
+        return true;
+    }
+
+    std::string describe() {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        applyDefaults();
+        std::string text;
+        for (std::size_t i = 0; i < DOMAIN_COUNT; ++i) {
+            const Slot& slot = s_slots[i];
+            text += std::string(domainName(static_cast<Domain>(i))) + ": " + std::to_string(slot.settings.threads) +
+                    " threads, " + priorityName(slot.settings.priority) + " priority" +
+                    (slot.arena ? "" : " (not started)") + "\n";
+        }
+        return text;
+    }
+
+    std::shared_ptr<tbb::task_arena> acquire(Domain domain) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        applyDefaults();
+        Slot& slot = s_slots[static_cast<std::size_t>(domain)];
+        if (!slot.arena) slot.arena = createArena(slot.settings);
+        return slot.arena;
+    }
+
+} // namespace TaskArenas
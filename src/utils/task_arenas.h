@@ -0,0 +1,77 @@
+#ifndef TASK_ARENAS_H
+#define TASK_ARENAS_H
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <tbb/task_arena.h>
+
+/**
+ * @namespace TaskArenas
+ * @brief Separate TBB arenas for simulation, rendering and snapshot I/O.
+ *
+ * Each domain runs its parallel loops in its own tbb::task_arena with a thread quota and a
+ * priority, so a long generation step cannot occupy every worker while a frame is waiting:
+ * work submitted to the render arena is only ever taken by threads in that arena, and the
+ * scheduler hands free workers to higher-priority arenas first. Defaults are all cores for
+ * simulation (normal priority), half of them for rendering (high) and a quarter for I/O (low).
+ * Arenas are created on first use and replaced by configure(); a thread already executing in
+ * an old arena finishes there, because execute() keeps it alive until the work returns.
+ */
+namespace TaskArenas {
+
+    enum class Domain {
+        Simulation,
+        Render,
+        IO,
+        __COUNT__
+    };
+
+    enum class Priority {
+        Low,
+        Normal,
+        High
+    };
+
+    struct Settings {
+        int threads = 1;   // Concurrency of the arena, including the thread that calls execute()
+        Priority priority = Priority::Normal;
+    };
+
+    const char* domainName(Domain domain);
+    const char* priorityName(Priority priority);
+    bool parseDomain(const std::string& text, Domain& domain);
+    bool parsePriority(const std::string& text, Priority& priority);
+
+    Settings getSettings(Domain domain);
+
+    /**
+     * @brief Replaces the arena of a domain.
+     * @return False (with a reason in error) if threads is below 1.
+     */
+    bool configure(Domain domain, const Settings& settings, std::string& error);
+
+    /**
+     * @brief One line per domain with its thread quota and priority.
+     */
+    std::string describe();
+
+    /**
+     * @brief The current arena of a domain, created on first use.
+     */
+    std::shared_ptr<tbb::task_arena> acquire(Domain domain);
+
+    /**
+     * @brief Runs work on the calling thread inside the arena of a domain; parallel loops in
+     * work are executed by that arena's threads only.
+     */
+    template <typename F>
+    void execute(Domain domain, F&& work) {
+        std::shared_ptr<tbb::task_arena> arena = acquire(domain);
+        arena->execute(std::forward<F>(work));
+    }
+
+} // namespace TaskArenas
+
+#endif // TASK_ARENAS_H
@@ -35,6 +35,9 @@ void Timer::start() {
         throw std::runtime_error("Timer for module " + moduleToString(module_) +
                                  " has already been stopped. Create a new Timer instance for a new measurement.");
     }
+    if (PerfCounters::isEnabled()) {
+        perfStart_ = PerfCounters::read();
+    }
     startTimePoint_ = std::chrono::high_resolution_clock::now();
     isRunning_ = true;
 }
@@ -49,6 +52,9 @@ void Timer::stop() {
 
     auto endTimePoint = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double, std::milli> duration = endTimePoint - startTimePoint_;
+    if (perfStart_.valid) {
+        PerfCounters::record(static_cast<std::size_t>(module_), perfStart_, PerfCounters::read(), itemCount_);
+    }
 
     {
         std::lock_guard<std::mutex> lock(s_mutex_);
@@ -59,6 +65,10 @@ void Timer::stop() {
     hasBeenStopped_ = true;
 }
 
+void Timer::setItemCount(std::uint64_t items) {
+    itemCount_ = items;
+}
+
 std::map<Timer::Module, std::chrono::duration<double, std::milli>> Timer::getAccumulatedTimes() {
     std::lock_guard<std::mutex> lock(s_mutex_);
     return s_accumulatedTimes_; // 返回一个副本
@@ -8,6 +8,8 @@
 #include <mutex>
 #include <stdexcept> // For std::runtime_error
 #include <iostream>  // For default ostream in printReport
+#include <cstdint>
+#include "perf_counters.h"
 
 class Timer {
 public:
@@ -40,8 +42,12 @@ public:
     void start();
 
     // 停止计时并将持续时间添加到模块的全局累积时间
+    // 若已启用硬件计数器（PerfCounters），同时记录本次计时区间的计数器增量
     void stop();
 
+    // 设置本次计时区间处理的元素数量（如被评估的元胞数），用于按元素归一化硬件计数器
+    void setItemCount(std::uint64_t items);
+
     // --- 静态方法用于全局统计 ---
 
     // 获取所有模块的累积时间（单位：毫秒）
@@ -62,6 +68,8 @@ private:
     std::chrono::time_point<std::chrono::high_resolution_clock> startTimePoint_;
     bool isRunning_ = false;
     bool hasBeenStopped_ = false; // 标记此实例是否已调用过 stop()
+    std::uint64_t itemCount_ = 0;
+    PerfCounters::Sample perfStart_; // start() 时的计数器读数；未启用时无效
 
     // 静态成员变量，用于存储所有模块的累积时间
     // 使用指针确保在首次使用前初始化，并管理生命周期（可选，直接静态成员也可以）
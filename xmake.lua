@@ -33,18 +33,46 @@ target("WiCA")
         "src/core/rule.cpp",
         "src/ca/cell_space.cpp",
         "src/ca/rule_engine.cpp",
+        "src/ca/cycle_detector.cpp",
+        "src/ca/population_history.cpp",
+        "src/ca/pattern_search.cpp",
+        "src/ca/engine_fuzzer.cpp",
+        "src/ca/generations_engine.cpp",
+        "src/ca/voxel_space.cpp",
+        "src/ca/persistent_world.cpp",
+        "src/ca/graph_space.cpp",
+        "src/ca/reaction_diffusion.cpp",
         "src/render/renderer.cpp",
+        "src/render/render_quality.cpp",
         "src/render/viewport.cpp",
         "src/input/input_handler.cpp",
+        "src/input/brush_stroke.cpp",
+        "src/input/input_recorder.cpp",
         "src/input/command_parser.cpp",
         "src/snap/snapshot.cpp",
+        "src/snap/snapshot_io.cpp",
         "src/snap/huffman_coding.cpp",
+        "src/snap/lazy_snapshot.cpp",
+        "src/snap/npy_io.cpp",
+        "src/snap/async_saver.cpp",
+        "src/snap/checkpointer.cpp",
+        "src/ipc/frame_channel.cpp",
+        "src/ipc/frame_viewer.cpp",
+        "src/ipc/control_server.cpp",
+        "src/ipc/metrics_exporter.cpp",
+        "src/utils/epoch_manager.cpp",
         "src/utils/error_handler.cpp",
         "src/utils/logger.cpp",
+        "src/utils/metrics.cpp",
+        "src/utils/perf_counters.cpp",
+        "src/utils/task_arenas.cpp",
         "src/utils/timer.cpp"
     )
     add_includedirs("src")
     add_packages("sdl3", "sdl3_image", "sdl3_ttf", "nlohmann_json", "spdlog", "fmt", "tbb")
+    if is_plat("linux") then
+        add_syslinks("rt", "pthread") -- shm_open for the frame channel
+    end
     after_build(function (target)
         print("Copying assets and rules to build directory...")
         os.cp("assets", target:targetdir())
@@ -52,6 +80,34 @@ target("WiCA")
     end)
 	set_targetdir("$(buildir)")
 
+-- Embeddable C API (src/api/wica.h); no SDL dependency
+target("wica")
+    set_kind("shared")
+    add_files(
+        "src/api/wica.cpp",
+        "src/core/rule.cpp",
+        "src/ca/cell_space.cpp",
+        "src/ca/rule_engine.cpp",
+        "src/ca/generations_engine.cpp",
+        "src/ca/voxel_space.cpp",
+        "src/ca/reaction_diffusion.cpp",
+        "src/ca/persistent_world.cpp",
+        "src/snap/snapshot.cpp",
+        "src/snap/snapshot_io.cpp",
+        "src/snap/huffman_coding.cpp",
+        "src/utils/epoch_manager.cpp",
+        "src/utils/logger.cpp",
+        "src/utils/metrics.cpp",
+        "src/utils/perf_counters.cpp",
+        "src/utils/timer.cpp"
+    )
+    add_includedirs("src")
+    add_headerfiles("src/api/wica.h")
+    add_defines("WICA_BUILD_LIBRARY")
+    add_cxflags("-fvisibility=hidden", {tools = {"gcc", "clang"}})
+    add_packages("nlohmann_json", "spdlog", "fmt", "tbb")
+    set_targetdir("$(buildir)")
+
 rule("plugin")
     on_load(
 		function(target)
@@ -72,3 +128,10 @@ target("rgb_plugin")
     set_filename("rgb")
     add_files("plugins/rgb.cpp")
     add_defines("RGB_PLUGIN_EXPORTS")
+
+target("lattice_life_plugin")
+    set_kind("shared")
+    set_rules("plugin")
+    set_filename("lattice_life")
+    add_files("plugins/lattice_life.cpp")
+    add_defines("LATTICE_LIFE_PLUGIN_EXPORTS")